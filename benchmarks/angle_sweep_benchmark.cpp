@@ -0,0 +1,88 @@
+/**
+ * Compares generating rotation matrices over a dense angle grid with the
+ * incremental sweeps in angle_sweep.hpp against evaluating sin and cos and
+ * deriving the matrix at every step.
+ */
+
+#include <evspace.hpp>
+#include <bench_helpers.hpp>
+#include <cmath>
+#include <cstdio>
+
+namespace evs = evspace;
+
+int main() {
+    const std::size_t steps = 1000000;
+    const double start = -1.0, step = 2e-6;
+    typedef evs::_EulerAngleDelegate<evs::ZXZ, evs::IntrinsicRotation> delegate;
+
+    double ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (std::size_t k = 0; k < steps; k++) {
+            sum += evs::compute_rotation_matrix<evs::ZAxis>(start + k * step)(0, 1);
+        }
+        bench_sink = sum;
+    });
+    bench_report("compute_rotation_matrix<ZAxis> per step", ms, steps);
+
+    ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        evs::SingleAxisSweep<evs::ZAxis> sweep(start, step);
+        for (std::size_t k = 0; k < steps; k++, sweep.next()) {
+            sum += sweep.matrix()(0, 1);
+        }
+        bench_sink = sum;
+    });
+    bench_report("SingleAxisSweep<ZAxis>::matrix", ms, steps);
+
+    ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (std::size_t k = 0; k < steps; k++) {
+            sum += delegate::derive_matrix(0.3, start + k * step, 1.2)(2, 0);
+        }
+        bench_sink = sum;
+    });
+    bench_report("ZXZ derive_matrix(alpha, beta, gamma) per step", ms, steps);
+
+    ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        evs::EulerAngleSweep<evs::ZXZ> sweep(evs::EulerAngles(0.3, start, 1.2), 1, step);
+        for (std::size_t k = 0; k < steps; k++, sweep.next()) {
+            sum += sweep.matrix()(2, 0);
+        }
+        bench_sink = sum;
+    });
+    bench_report("EulerAngleSweep<ZXZ>::matrix, beta swept", ms, steps);
+
+    // Raw matrix generation into a MatrixArray, no Matrix allocations.
+    evs::MatrixArray matrices(steps);
+    ms = bench_time_ms([&]() {
+        double* planes[9];
+        for (std::size_t c = 0; c < 9; c++) {
+            planes[c] = matrices.plane(c / 3, c % 3);
+        }
+        const double fixed_c[2] = { std::cos(0.3), std::cos(1.2) };
+        const double fixed_s[2] = { std::sin(0.3), std::sin(1.2) };
+        for (std::size_t k = 0; k < steps; k++) {
+            const double beta = start + k * step;
+            const double cosines[3] = { fixed_c[0], std::cos(beta), fixed_c[1] };
+            const double sines[3] = { fixed_s[0], std::sin(beta), fixed_s[1] };
+            double m[9];
+            delegate::derive_matrix(cosines, sines, m);
+            for (std::size_t c = 0; c < 9; c++) {
+                planes[c][k] = m[c];
+            }
+        }
+        bench_sink = matrices.plane(2, 0)[steps - 1];
+    });
+    bench_report("ZXZ closed form with sin/cos per step", ms, steps);
+
+    ms = bench_time_ms([&]() {
+        evs::EulerAngleSweep<evs::ZXZ> sweep(evs::EulerAngles(0.3, start, 1.2), 1, step);
+        sweep.generate(matrices);
+        bench_sink = matrices.plane(2, 0)[steps - 1];
+    });
+    bench_report("EulerAngleSweep<ZXZ>::generate", ms, steps);
+
+    return 0;
+}
@@ -0,0 +1,124 @@
+/**
+ * Solves 20k Wahba problems of 6 observed star directions each, comparing
+ * TRIAD, QUEST and Kabsch one problem at a time from spans of vectors
+ * with the batch profile accumulation and solvers.
+ */
+
+#include <evspace.hpp>
+#include <bench_helpers.hpp>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace evs = evspace;
+
+int main() {
+    const std::size_t count = 20000;
+    const std::size_t pairs = 6;
+    const int steps = 5;
+
+    std::vector<evs::Vector> observations, references;
+    std::vector<evs::Vector> first_observations, second_observations, first_references, second_references;
+    std::vector<double> weights;
+    std::vector<std::size_t> offsets = { 0 };
+    for (std::size_t i = 0; i < count; i++) {
+        const double t = static_cast<double>(i);
+        const evs::Matrix attitude = evs::compute_rotation_matrix<evs::ZYX>(
+            evs::EulerAngles(0.3 + 1e-4 * t, -0.2 + 2e-4 * t, 0.1 - 1e-4 * t));
+        for (std::size_t pair = 0; pair < pairs; pair++) {
+            const double s = t + 1.7 * static_cast<double>(pair);
+            const evs::Vector reference = evs::Vector(std::cos(s) * std::cos(0.6 * s),
+                                                      std::sin(s) * std::cos(0.6 * s), std::sin(0.6 * s)).norm();
+            const evs::Vector noise(1e-4 * std::sin(3.1 * s), 1e-4 * std::cos(2.3 * s), 1e-4 * std::sin(1.3 * s));
+            references.push_back(reference);
+            observations.push_back((evs::rotate_to(attitude, reference) + noise).norm());
+            weights.push_back(1.0 + 0.1 * static_cast<double>(pair));
+        }
+        offsets.push_back(observations.size());
+        first_observations.push_back(observations[i * pairs]);
+        second_observations.push_back(observations[i * pairs + 1]);
+        first_references.push_back(references[i * pairs]);
+        second_references.push_back(references[i * pairs + 1]);
+    }
+
+    const evs::VectorArray observation_array(observations), reference_array(references);
+    const evs::VectorArray first_observation_array(first_observations), second_observation_array(second_observations);
+    const evs::VectorArray first_reference_array(first_references), second_reference_array(second_references);
+    const evs::span_t<const evs::Vector> all_observations(observations), all_references(references);
+    const evs::span_t<const double> all_weights(weights);
+    evs::MatrixArray profiles, attitudes;
+    std::vector<std::uint8_t> status(count);
+
+    double ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (int step = 0; step < steps; step++) {
+            for (std::size_t i = 0; i < count; i++) {
+                sum += evs::triad(first_observations[i], second_observations[i], first_references[i],
+                                  second_references[i])(0, 1);
+            }
+        }
+        bench_sink = sum;
+    });
+    bench_report("triad(Vector x 4)", ms, steps * count);
+
+    ms = bench_time_ms([&]() {
+        for (int step = 0; step < steps; step++) {
+            evs::triad(first_observation_array, second_observation_array, first_reference_array,
+                       second_reference_array, attitudes, status);
+        }
+        bench_sink = attitudes.plane(0, 1)[count / 2];
+    });
+    bench_report("triad(VectorArray x 4)", ms, steps * count);
+
+    ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (int step = 0; step < steps; step++) {
+            for (std::size_t i = 0; i < count; i++) {
+                sum += evs::quest(all_observations.subspan(i * pairs, pairs), all_references.subspan(i * pairs, pairs),
+                                  all_weights.subspan(i * pairs, pairs))(0, 1);
+            }
+        }
+        bench_sink = sum;
+    });
+    bench_report("quest(spans)", ms, steps * count);
+
+    ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (int step = 0; step < steps; step++) {
+            for (std::size_t i = 0; i < count; i++) {
+                sum += evs::kabsch(all_observations.subspan(i * pairs, pairs), all_references.subspan(i * pairs, pairs),
+                                   all_weights.subspan(i * pairs, pairs))(0, 1);
+            }
+        }
+        bench_sink = sum;
+    });
+    bench_report("kabsch(spans)", ms, steps * count);
+
+    ms = bench_time_ms([&]() {
+        for (int step = 0; step < steps; step++) {
+            evs::attitude_profile(observation_array, reference_array, weights, offsets, profiles);
+        }
+        bench_sink = profiles.plane(0, 1)[count / 2];
+    });
+    bench_report("attitude_profile(VectorArray)", ms, steps * count);
+
+    evs::attitude_profile(observation_array, reference_array, weights, offsets, profiles);
+    ms = bench_time_ms([&]() {
+        for (int step = 0; step < steps; step++) {
+            evs::quest(profiles, attitudes);
+        }
+        bench_sink = attitudes.plane(0, 1)[count / 2];
+    });
+    bench_report("quest(MatrixArray)", ms, steps * count);
+
+    ms = bench_time_ms([&]() {
+        for (int step = 0; step < steps; step++) {
+            evs::kabsch(profiles, attitudes);
+        }
+        bench_sink = attitudes.plane(0, 1)[count / 2];
+    });
+    bench_report("kabsch(MatrixArray)", ms, steps * count);
+
+    return 0;
+}
@@ -0,0 +1,86 @@
+/**
+ * Propagating 100k body attitudes from constant body rates, ten substeps
+ * per run: integrating Euler angle rates through ReferenceFrameArray
+ * frames and set_angles, against the batch exponential and RK4 quaternion
+ * steps, and converting the result to matrices and ZYX frames.
+ */
+
+#include <evspace.hpp>
+#include <bench_helpers.hpp>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace evs = evspace;
+
+int main() {
+    const std::size_t count = 100000;
+    const int steps = 10;
+    const double dt = 0.01;
+
+    std::vector<evs::Quaternion> attitudes;
+    std::vector<evs::Vector> rates;
+    evs::ReferenceFrameArray<evs::ZYX> frames(count);
+    for (std::size_t i = 0; i < count; i++) {
+        const double t = static_cast<double>(i);
+        const evs::EulerAngles angles(0.3 + 1e-5 * t, -0.2 + 2e-5 * t, 0.1 - 1e-5 * t);
+        frames[i].set_angles(angles);
+        attitudes.push_back(evs::compute_rotation_quaternion<evs::ZYX>(angles));
+        rates.push_back(evs::Vector(0.1 + std::sin(t), -0.2, 0.5 * std::cos(t)));
+    }
+    const evs::VectorArray rate_array(rates);
+
+    double ms = bench_time_ms([&]() {
+        for (int step = 0; step < steps; step++) {
+            for (std::size_t i = 0; i < count; i++) {
+                auto frame = frames[i];
+                const evs::EulerAngles angles = frame.get_angles();
+                const evs::Vector angle_rates = evs::euler_rates<evs::ZYX>(angles, rates[i]);
+                frame.set_angles(evs::EulerAngles(angles[0] + dt * angle_rates[0], angles[1] + dt * angle_rates[1],
+                                                  angles[2] + dt * angle_rates[2]));
+            }
+        }
+        bench_sink = frames.matrices().plane(0, 1)[count / 2];
+    });
+    bench_report("euler_rates + Frame::set_angles", ms, steps * count);
+
+    evs::QuaternionArray array(attitudes);
+    ms = bench_time_ms([&]() {
+        for (int step = 0; step < steps; step++) {
+            evs::integrate_exponential(array, rate_array, dt);
+        }
+        bench_sink = array.x()[count / 2];
+    });
+    bench_report("integrate_exponential", ms, steps * count);
+
+    ms = bench_time_ms([&]() {
+        for (int step = 0; step < steps; step++) {
+            evs::integrate_rk4(array, rate_array, rate_array, rate_array, dt);
+        }
+        bench_sink = array.x()[count / 2];
+    });
+    bench_report("integrate_rk4", ms, steps * count);
+
+    ms = bench_time_ms([&]() {
+        for (int step = 0; step < steps; step++) {
+            array.normalize();
+        }
+        bench_sink = array.x()[count / 2];
+    });
+    bench_report("QuaternionArray::normalize", ms, steps * count);
+
+    evs::MatrixArray matrices;
+    ms = bench_time_ms([&]() {
+        array.to_matrices(matrices);
+        bench_sink = matrices.plane(0, 1)[count / 2];
+    });
+    bench_report("QuaternionArray::to_matrices", ms, count);
+
+    ms = bench_time_ms([&]() {
+        evs::to_frames(array, frames);
+        bench_sink = frames.matrices().plane(0, 1)[count / 2];
+    });
+    bench_report("to_frames<ZYX>", ms, count);
+
+    return 0;
+}
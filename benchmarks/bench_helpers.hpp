@@ -0,0 +1,35 @@
+#ifndef _EVSPACE_BENCH_HELPERS_H_
+#define _EVSPACE_BENCH_HELPERS_H_
+
+#include <chrono>       // std::chrono::steady_clock
+#include <cstddef>      // std::size_t
+#include <cstdio>       // std::printf
+
+// Sink for benchmark results so the optimizer can't remove the work.
+inline volatile double bench_sink = 0.0;
+
+// Runs func `repeats` times and returns the fastest run in milliseconds.
+template<typename Func>
+double bench_time_ms(Func&& func, int repeats = 5) {
+    double best = 0.0;
+    for (int i = 0; i < repeats; i++) {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        auto stop = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double, std::milli>(stop - start).count();
+        if (i == 0 || elapsed < best) {
+            best = elapsed;
+        }
+    }
+
+    return best;
+}
+
+// Prints a result line as the time per operation and operations per second.
+inline void bench_report(const char* name, double milliseconds, std::size_t operations) {
+    double ns_per_op = milliseconds * 1e6 / static_cast<double>(operations);
+    double mops = static_cast<double>(operations) / (milliseconds * 1e3);
+    std::printf("%-48s %10.3f ms %10.2f ns/op %10.2f Mop/s\n", name, milliseconds, ns_per_op, mops);
+}
+
+#endif // _EVSPACE_BENCH_HELPERS_H_
@@ -0,0 +1,111 @@
+/**
+ * Dispersing a vector through two uncertain frames with 1M samples: a
+ * scalar loop drawing std::normal_distribution errors from std::mt19937_64,
+ * correlating them by hand, rotating each sample with rotate_between and
+ * storing them all for a two pass mean and covariance, against
+ * disperse_between, which streams the samples through the batch kernels in
+ * constant memory. Also 100k Cholesky factors one at a time and batched.
+ */
+
+#include <evspace.hpp>
+#include <bench_helpers.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace evs = evspace;
+
+int main() {
+    const std::size_t samples = 1000000;
+
+    evs::FrameUncertainty from, to;
+    from.angles = evs::EulerAngles(0.4, -1.1, 2.3);
+    from.angle_covariance = evs::SymmetricMatrix(1e-6, 2e-7, 0.0, 4e-6, -1e-7, 1e-6);
+    from.offset = evs::Vector(1.0, -2.0, 0.5);
+    from.offset_covariance = evs::SymmetricMatrix(0.04, 0.01, 0.0, 0.09, -0.02, 0.01);
+    to.angles = evs::EulerAngles(-0.7, 0.3, 1.9);
+    to.angle_covariance = evs::SymmetricMatrix(2e-6, 0.0, 0.0, 1e-6, 0.0, 3e-6);
+    to.offset_covariance = evs::SymmetricMatrix(0.01, 0.0, 0.005, 0.01, 0.0, 0.01);
+    const evs::Vector vector(2.0, 1.0, -1.5);
+    const evs::SymmetricMatrix vector_covariance(0.25, 0.1, 0.05, 0.16, 0.0, 0.04);
+
+    const evs::SymmetricMatrix* covariances[5] = { &from.angle_covariance, &from.offset_covariance,
+                                                   &to.angle_covariance, &to.offset_covariance, &vector_covariance };
+    evs::Matrix factors[5];
+    for (std::size_t k = 0; k < 5; k++) {
+        factors[k] = evs::cholesky(*covariances[k]);
+    }
+
+    std::mt19937_64 engine(1);
+    std::normal_distribution<double> normal;
+    std::vector<evs::Vector> stored(samples);
+    double ms = bench_time_ms([&]() {
+        for (std::size_t i = 0; i < samples; i++) {
+            evs::Vector errors[5];
+            for (std::size_t k = 0; k < 5; k++) {
+                const evs::Vector z(normal(engine), normal(engine), normal(engine));
+                errors[k] = factors[k] * z;
+            }
+            const evs::EulerAngles angles_from(from.angles[0] + errors[0][0], from.angles[1] + errors[0][1],
+                                               from.angles[2] + errors[0][2]);
+            const evs::EulerAngles angles_to(to.angles[0] + errors[2][0], to.angles[1] + errors[2][1],
+                                             to.angles[2] + errors[2][2]);
+            stored[i] = evs::rotate_between<evs::ZXZ, evs::XYZ>(angles_from, angles_to, vector + errors[4],
+                                                                from.offset + errors[1], to.offset + errors[3]);
+        }
+
+        double mean[3] = { 0.0, 0.0, 0.0 }, covariance[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+        for (const evs::Vector& sample : stored) {
+            for (std::size_t k = 0; k < 3; k++) {
+                mean[k] += sample[k] / samples;
+            }
+        }
+        for (const evs::Vector& sample : stored) {
+            const double d[3] = { sample[0] - mean[0], sample[1] - mean[1], sample[2] - mean[2] };
+            for (std::size_t row = 0, entry = 0; row < 3; row++) {
+                for (std::size_t col = row; col < 3; col++, entry++) {
+                    covariance[entry] += d[row] * d[col] / (samples - 1);
+                }
+            }
+        }
+        bench_sink = mean[0] + covariance[1];
+    }, 3);
+    bench_report("mt19937_64 + rotate_between, stored samples", ms, samples);
+
+    evs::Philox generator(1);
+    ms = bench_time_ms([&]() {
+        const evs::DispersionStatistics result = evs::disperse_between<evs::ZXZ, evs::XYZ>(
+            generator, samples, from, to, vector, vector_covariance);
+        bench_sink = result.mean()[0] + result.covariance()(0, 1);
+    }, 3);
+    bench_report("disperse_between", ms, samples);
+
+    const std::size_t count = 100000;
+    std::vector<evs::SymmetricMatrix> matrices;
+    for (std::size_t i = 0; i < count; i++) {
+        matrices.push_back(*covariances[i % 5] * (1.0 + 1e-6 * static_cast<double>(i)));
+    }
+    const evs::SymmetricMatrixArray array(matrices);
+
+    evs::Matrix single;
+    ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < count; i++) {
+            single = evs::cholesky(matrices[i]);
+            sum += single(2, 1);
+        }
+        bench_sink = sum;
+    });
+    bench_report("cholesky (single)", ms, count);
+
+    evs::MatrixArray lower;
+    std::vector<std::uint8_t> status(count);
+    ms = bench_time_ms([&]() {
+        evs::cholesky(array, lower, status);
+        bench_sink = lower.plane(2, 1)[count / 2];
+    });
+    bench_report("cholesky (batch)", ms, count);
+
+    return 0;
+}
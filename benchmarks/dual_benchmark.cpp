@@ -0,0 +1,120 @@
+/**
+ * Jacobians of rotate_to<ZYX>(angles, vector) with respect to the three
+ * angles and three vector components for 100k inputs, comparing forward
+ * and central finite differences over the public API with one pass of
+ * six-derivative dual numbers. The largest error of each against the
+ * dual result is printed after the timings.
+ */
+
+#include <evspace.hpp>
+#include <bench_helpers.hpp>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace evs = evspace;
+
+namespace {
+
+    // Finite difference Jacobians, central when central is true and
+    // forward otherwise.
+    void finite_difference(const evs::EulerAngles& angles, const evs::Vector& vector, bool central,
+                           evs::Matrix& angle_jacobian, evs::Matrix& vector_jacobian)
+    {
+        const double step = central ? 1e-5 : 1e-8;
+        const evs::Vector value = evs::rotate_to<evs::ZYX>(angles, vector);
+        for (std::size_t col = 0; col < 3; col++) {
+            evs::EulerAngles angles_plus = angles, angles_minus = angles;
+            angles_plus[col] += step;
+            angles_minus[col] -= step;
+            evs::Vector vector_plus = vector, vector_minus = vector;
+            vector_plus[col] += step;
+            vector_minus[col] -= step;
+
+            const evs::Vector angle_slope = central
+                ? (evs::rotate_to<evs::ZYX>(angles_plus, vector) - evs::rotate_to<evs::ZYX>(angles_minus, vector)) / (2.0 * step)
+                : (evs::rotate_to<evs::ZYX>(angles_plus, vector) - value) / step;
+            const evs::Vector vector_slope = central
+                ? (evs::rotate_to<evs::ZYX>(angles, vector_plus) - evs::rotate_to<evs::ZYX>(angles, vector_minus)) / (2.0 * step)
+                : (evs::rotate_to<evs::ZYX>(angles, vector_plus) - value) / step;
+            for (std::size_t row = 0; row < 3; row++) {
+                angle_jacobian(row, col) = angle_slope[row];
+                vector_jacobian(row, col) = vector_slope[row];
+            }
+        }
+    }
+
+    double largest_difference(const evs::Matrix& lhs, const evs::Matrix& rhs) {
+        double largest = 0.0;
+        for (std::size_t row = 0; row < 3; row++) {
+            for (std::size_t col = 0; col < 3; col++) {
+                const double difference = std::fabs(lhs(row, col) - rhs(row, col));
+                largest = difference > largest ? difference : largest;
+            }
+        }
+
+        return largest;
+    }
+
+}
+
+int main() {
+    const std::size_t count = 100000;
+
+    std::vector<evs::EulerAngles> angles;
+    std::vector<evs::Vector> vectors;
+    for (std::size_t i = 0; i < count; i++) {
+        const double t = static_cast<double>(i);
+        angles.push_back(evs::EulerAngles(0.3 + 1e-5 * t, -0.2 + 2e-5 * t, 0.1 - 1e-5 * t));
+        vectors.push_back(evs::Vector(1.0 + std::sin(t), -2.0, 0.5 * std::cos(t)));
+    }
+
+    evs::Matrix angle_jacobian, vector_jacobian;
+    double ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < count; i++) {
+            finite_difference(angles[i], vectors[i], false, angle_jacobian, vector_jacobian);
+            sum += angle_jacobian(0, 1) + vector_jacobian(1, 2);
+        }
+        bench_sink = sum;
+    });
+    bench_report("forward differences (7 rotate_to)", ms, count);
+
+    ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < count; i++) {
+            finite_difference(angles[i], vectors[i], true, angle_jacobian, vector_jacobian);
+            sum += angle_jacobian(0, 1) + vector_jacobian(1, 2);
+        }
+        bench_sink = sum;
+    });
+    bench_report("central differences (13 rotate_to)", ms, count);
+
+    ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < count; i++) {
+            sum += evs::rotate_to_jacobian<evs::ZYX>(angles[i], vectors[i], angle_jacobian, vector_jacobian)[0]
+                + angle_jacobian(0, 1) + vector_jacobian(1, 2);
+        }
+        bench_sink = sum;
+    });
+    bench_report("rotate_to_jacobian (Dual<6>)", ms, count);
+
+    double forward_error = 0.0, central_error = 0.0;
+    for (std::size_t i = 0; i < count; i += 97) {
+        evs::Matrix dual_angle, dual_vector;
+        evs::rotate_to_jacobian<evs::ZYX>(angles[i], vectors[i], dual_angle, dual_vector);
+        for (int central = 0; central < 2; central++) {
+            finite_difference(angles[i], vectors[i], central == 1, angle_jacobian, vector_jacobian);
+            double error = largest_difference(angle_jacobian, dual_angle);
+            const double vector_error = largest_difference(vector_jacobian, dual_vector);
+            error = vector_error > error ? vector_error : error;
+            double& largest = central == 1 ? central_error : forward_error;
+            largest = error > largest ? error : largest;
+        }
+    }
+    std::printf("\nlargest difference from the dual Jacobian: forward %.3e, central %.3e\n",
+                forward_error, central_error);
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+/**
+ * Euler angle rates of 100k ZYX angle sets and body rates, through the
+ * closed form inverse one angle set at a time and batched, against
+ * inverting the angular velocity matrix with Matrix::inverse, and the
+ * batch rotation and kinematic matrices against the rotations alone.
+ */
+
+#include <evspace.hpp>
+#include <bench_helpers.hpp>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace evs = evspace;
+
+int main() {
+    const std::size_t count = 100000;
+    const int steps = 10;
+
+    std::vector<evs::EulerAngles> angles;
+    std::vector<double> alphas, betas, gammas;
+    std::vector<evs::Vector> omegas;
+    evs::ReferenceFrameArray<evs::ZYX> frames(count);
+    for (std::size_t i = 0; i < count; i++) {
+        const double t = static_cast<double>(i);
+        angles.push_back(evs::EulerAngles(0.3 + 1e-5 * t, -0.2 + 2e-5 * t, 0.1 - 1e-5 * t));
+        alphas.push_back(angles.back()[0]);
+        betas.push_back(angles.back()[1]);
+        gammas.push_back(angles.back()[2]);
+        frames.alpha()[i] = alphas.back();
+        frames.beta()[i] = betas.back();
+        frames.gamma()[i] = gammas.back();
+        omegas.push_back(evs::Vector(1.0 + std::sin(t), -2.0, 0.5 * std::cos(t)));
+    }
+    const evs::VectorArray omega_array(omegas);
+
+    double ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (int step = 0; step < steps; step++) {
+            for (std::size_t i = 0; i < count; i++) {
+                const evs::Matrix inverse = evs::angular_velocity_matrix<evs::ZYX>(angles[i]).inverse();
+                sum += (inverse * omegas[i])[1];
+            }
+        }
+        bench_sink = sum;
+    });
+    bench_report("angular_velocity_matrix().inverse() * omega", ms, steps * count);
+
+    ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (int step = 0; step < steps; step++) {
+            for (std::size_t i = 0; i < count; i++) {
+                sum += evs::euler_rates<evs::ZYX>(angles[i], omegas[i])[1];
+            }
+        }
+        bench_sink = sum;
+    });
+    bench_report("euler_rates<ZYX>", ms, steps * count);
+
+    std::vector<std::uint8_t> status(count);
+    evs::VectorArray rates;
+    ms = bench_time_ms([&]() {
+        for (int step = 0; step < steps; step++) {
+            evs::euler_rates<evs::ZYX>(alphas, betas, gammas, omega_array, rates, status);
+        }
+        bench_sink = rates.y()[count / 2];
+    });
+    bench_report("euler_rates<ZYX> (batch)", ms, steps * count);
+
+    ms = bench_time_ms([&]() {
+        for (int step = 0; step < steps; step++) {
+            frames.update_all();
+        }
+        bench_sink = frames.matrices().plane(0, 1)[count / 2];
+    });
+    bench_report("ReferenceFrameArray::update_all (matrix only)", ms, steps * count);
+
+    evs::MatrixArray rotations, matrices;
+    ms = bench_time_ms([&]() {
+        for (int step = 0; step < steps; step++) {
+            evs::euler_rate_matrix<evs::ZYX>(alphas, betas, gammas, rotations, matrices, status);
+        }
+        bench_sink = matrices.plane(0, 1)[count / 2];
+    });
+    bench_report("euler_rate_matrix<ZYX> (batch, with rotations)", ms, steps * count);
+
+    return 0;
+}
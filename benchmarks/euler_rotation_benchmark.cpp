@@ -0,0 +1,92 @@
+/**
+ * Compares rotating vectors by Euler angles with the fused planar kernels
+ * (three elementary rotations applied directly to each vector) against
+ * building the rotation matrix once and multiplying every vector by it,
+ * for a growing number of vectors sharing the same angles. The first
+ * section times the public single vector functions.
+ */
+
+#include <evspace.hpp>
+#include <bench_helpers.hpp>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace evs = evspace;
+
+int main() {
+    const std::size_t repeats = 2000000;
+    const evs::Vector vector(1.0, 2.0, 3.0);
+
+    double ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (std::size_t r = 0; r < repeats; r++) {
+            evs::EulerAngles angles(0.1 + r * 1e-7, 0.2, 0.3);
+            evs::Matrix matrix = evs::compute_rotation_matrix<evs::XYZ>(angles);
+            sum += evs::rotate_to(matrix, vector)[0];
+        }
+        bench_sink = sum;
+    });
+    bench_report("compute_rotation_matrix + rotate_to", ms, repeats);
+
+    ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (std::size_t r = 0; r < repeats; r++) {
+            evs::EulerAngles angles(0.1 + r * 1e-7, 0.2, 0.3);
+            sum += evs::rotate_to<evs::XYZ>(angles, vector)[0];
+        }
+        bench_sink = sum;
+    });
+    bench_report("fused rotate_to<XYZ>", ms, repeats);
+
+    // With the trig shared, the fused kernels cost 12 multiplies per vector
+    // while the matrix costs its construction once plus 9 per vector.
+    std::printf("\nvectors per angle set, trig precomputed (ns per angle set):\n");
+    typedef evs::_EulerAngleDelegate<evs::XYZ, evs::IntrinsicRotation> delegate;
+    const double cosines[3] = { std::cos(0.1), std::cos(0.2), std::cos(0.3) };
+    const double sines[3] = { std::sin(0.1), std::sin(0.2), std::sin(0.3) };
+
+    for (std::size_t count : { 1, 2, 3, 4, 6, 8, 16, 32 }) {
+        std::vector<double> vectors(3 * count);
+        for (std::size_t i = 0; i < 3 * count; i++) {
+            vectors[i] = 1.0 + static_cast<double>(i);
+        }
+        const std::size_t sets = repeats / count;
+
+        double fused_ms = bench_time_ms([&]() {
+            double sum = 0.0;
+            for (std::size_t r = 0; r < sets; r++) {
+                // perturb the input so the compiler can't hoist the work
+                const double perturb = static_cast<double>(r & 7) * 1e-9;
+                for (std::size_t i = 0; i < count; i++) {
+                    double v[3] = { vectors[3 * i] + perturb, vectors[3 * i + 1], vectors[3 * i + 2] };
+                    delegate::rotate_to(cosines, sines, v);
+                    sum += v[0] + v[1] + v[2];
+                }
+            }
+            bench_sink = sum;
+        });
+
+        double matrix_ms = bench_time_ms([&]() {
+            double sum = 0.0;
+            for (std::size_t r = 0; r < sets; r++) {
+                const double perturb = static_cast<double>(r & 7) * 1e-9;
+                double c[3] = { cosines[0] + perturb, cosines[1], cosines[2] };
+                double m[9];
+                delegate::derive_matrix(c, sines, m);
+                for (std::size_t i = 0; i < count; i++) {
+                    const double* v = &vectors[3 * i];
+                    sum += v[0] * m[0] + v[1] * m[3] + v[2] * m[6]
+                         + v[0] * m[1] + v[1] * m[4] + v[2] * m[7]
+                         + v[0] * m[2] + v[1] * m[5] + v[2] * m[8];
+                }
+            }
+            bench_sink = sum;
+        });
+
+        std::printf("  %2zu vectors: fused %8.2f ns   matrix %8.2f ns   %s\n", count,
+            fused_ms * 1e6 / sets, matrix_ms * 1e6 / sets, fused_ms <= matrix_ms ? "fused" : "matrix");
+    }
+
+    return 0;
+}
@@ -0,0 +1,118 @@
+/**
+ * Composes 100k pairs of rotation matrices per tick, comparing a loop of
+ * Matrix::operator* against the batched MatrixArray products. Build with
+ * ENABLE_AVX2 and ENABLE_OPENMP to measure the vectorized and threaded
+ * kernels.
+ */
+
+#include <evspace.hpp>
+#include <bench_helpers.hpp>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+namespace evs = evspace;
+
+int main() {
+#if defined(_OPENMP)
+    std::printf("threads: %d\n", omp_get_max_threads());
+#else
+    std::printf("threads: 1 (built without OpenMP)\n");
+#endif
+    const std::size_t count = 100000;
+    const int ticks = 20;
+
+    std::vector<evs::Matrix> mountings, attitudes;
+    for (std::size_t i = 0; i < count; i++) {
+        const double t = static_cast<double>(i);
+        mountings.push_back(evs::compute_rotation_matrix<evs::XYZ>(evs::EulerAngles(0.1 * t, 0.2, -0.3 * t)));
+        attitudes.push_back(evs::compute_rotation_matrix<evs::ZXZ>(evs::EulerAngles(0.7 * t, 0.5 * t, 1.3)));
+    }
+
+    double ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (int tick = 0; tick < ticks; tick++) {
+            for (std::size_t i = 0; i < count; i++) {
+                sum += (mountings[i] * attitudes[i])(1, 1);
+            }
+        }
+        bench_sink = sum;
+    });
+    bench_report("Matrix::operator* (allocates)", ms, ticks * count);
+
+    std::vector<evs::Matrix> products(count);
+    ms = bench_time_ms([&]() {
+        for (int tick = 0; tick < ticks; tick++) {
+            for (std::size_t i = 0; i < count; i++) {
+                products[i] = mountings[i];
+                products[i] *= attitudes[i];
+            }
+        }
+        bench_sink = products[count / 2](1, 1);
+    });
+    bench_report("Matrix::operator*= into preallocated", ms, ticks * count);
+
+    ms = bench_time_ms([&]() {
+        evs::MatrixArray array(mountings);
+        bench_sink = array.plane(1, 1)[count / 2];
+    });
+    bench_report("MatrixArray from Matrix span", ms, count);
+
+    const evs::MatrixArray mounting_array(mountings), attitude_array(attitudes);
+    evs::MatrixArray output(count);
+    ms = bench_time_ms([&]() {
+        for (int tick = 0; tick < ticks; tick++) {
+            evs::multiply(mounting_array, attitude_array, output);
+        }
+        bench_sink = output.plane(1, 1)[count / 2];
+    });
+    bench_report("multiply(MatrixArray)", ms, ticks * count);
+
+    ms = bench_time_ms([&]() {
+        for (int tick = 0; tick < ticks; tick++) {
+            evs::transpose_multiply(mounting_array, attitude_array, output);
+        }
+        bench_sink = output.plane(1, 1)[count / 2];
+    });
+    bench_report("transpose_multiply(MatrixArray)", ms, ticks * count);
+
+    evs::MatrixArray in_place = attitude_array;
+    ms = bench_time_ms([&]() {
+        for (int tick = 0; tick < ticks; tick++) {
+            evs::multiply(mounting_array, in_place, in_place);
+        }
+        bench_sink = in_place.plane(1, 1)[count / 2];
+    });
+    bench_report("multiply(MatrixArray), in place", ms, ticks * count);
+
+    // a batch small enough to stay in cache, limited by arithmetic rather
+    // than memory bandwidth
+    const std::size_t small = 1024;
+    const int repeats = 2000;
+    const evs::MatrixArray small_lhs(evs::span_t<const evs::Matrix>(mountings.data(), small));
+    const evs::MatrixArray small_rhs(evs::span_t<const evs::Matrix>(attitudes.data(), small));
+    evs::MatrixArray small_output(small);
+    ms = bench_time_ms([&]() {
+        for (int r = 0; r < repeats; r++) {
+            for (std::size_t i = 0; i < small; i++) {
+                products[i] = mountings[i];
+                products[i] *= attitudes[i];
+            }
+        }
+        bench_sink = products[small / 2](1, 1);
+    });
+    bench_report("Matrix::operator*=, 1024 in cache", ms, repeats * small);
+
+    ms = bench_time_ms([&]() {
+        for (int r = 0; r < repeats; r++) {
+            evs::multiply(small_lhs, small_rhs, small_output);
+        }
+        bench_sink = small_output.plane(1, 1)[small / 2];
+    });
+    bench_report("multiply(MatrixArray), 1024 in cache", ms, repeats * small);
+
+    return 0;
+}
@@ -0,0 +1,97 @@
+/**
+ * Inverts and solves 100k small matrices per step, comparing loops over
+ * Matrix::determinate() and Matrix::inverse() with the batch kernels.
+ */
+
+#include <evspace.hpp>
+#include <bench_helpers.hpp>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace evs = evspace;
+
+int main() {
+    const std::size_t count = 100000;
+    const int steps = 20;
+
+    std::vector<evs::Matrix> matrices;
+    std::vector<evs::Vector> vectors;
+    for (std::size_t i = 0; i < count; i++) {
+        evs::Matrix matrix = evs::Matrix::IDENTITY * 2.0;
+        for (std::size_t component = 0; component < 9; component++) {
+            matrix.data()[component] += std::sin(0.61 * static_cast<double>(9 * i + component));
+        }
+        matrices.push_back(matrix);
+        vectors.push_back(evs::Vector(std::cos(0.1 * i), std::sin(0.2 * i), 1.0));
+    }
+
+    const evs::MatrixArray array(matrices);
+    const evs::VectorArray rhs(vectors);
+    std::vector<double> determinants(count);
+    std::vector<std::uint8_t> status(count);
+    evs::MatrixArray inverses(count);
+    evs::VectorArray solution(count);
+
+    double ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (int step = 0; step < steps; step++) {
+            for (std::size_t i = 0; i < count; i++) {
+                sum += matrices[i].determinate();
+            }
+        }
+        bench_sink = sum;
+    });
+    bench_report("Matrix::determinate", ms, steps * count);
+
+    ms = bench_time_ms([&]() {
+        for (int step = 0; step < steps; step++) {
+            evs::determinate(array, determinants);
+        }
+        bench_sink = determinants[count / 2];
+    });
+    bench_report("determinate(MatrixArray)", ms, steps * count);
+
+    ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (int step = 0; step < steps; step++) {
+            for (std::size_t i = 0; i < count; i++) {
+                sum += matrices[i].inverse()(1, 1);
+            }
+        }
+        bench_sink = sum;
+    });
+    bench_report("Matrix::inverse (allocates, throws)", ms, steps * count);
+
+    ms = bench_time_ms([&]() {
+        std::size_t flagged = 0;
+        for (int step = 0; step < steps; step++) {
+            flagged += evs::inverse(array, inverses, status);
+        }
+        bench_sink = inverses.plane(1, 1)[count / 2] + static_cast<double>(flagged);
+    });
+    bench_report("inverse(MatrixArray) with status", ms, steps * count);
+
+    ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (int step = 0; step < steps; step++) {
+            for (std::size_t i = 0; i < count; i++) {
+                sum += (matrices[i].inverse() * vectors[i])[1];
+            }
+        }
+        bench_sink = sum;
+    });
+    bench_report("Matrix::inverse() * Vector", ms, steps * count);
+
+    ms = bench_time_ms([&]() {
+        std::size_t flagged = 0;
+        for (int step = 0; step < steps; step++) {
+            flagged += evs::solve(array, rhs, solution, status);
+        }
+        bench_sink = solution.y()[count / 2] + static_cast<double>(flagged);
+    });
+    bench_report("solve(MatrixArray, VectorArray) with status", ms, steps * count);
+
+    return 0;
+}
@@ -0,0 +1,76 @@
+/**
+ * Decomposes 100k matrices per step, comparing loops over the single
+ * svd() and nearest_rotation() with the batch versions over a
+ * MatrixArray, re-orthonormalizing drifted rotation matrices in place.
+ */
+
+#include <evspace.hpp>
+#include <bench_helpers.hpp>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace evs = evspace;
+
+int main() {
+    const std::size_t count = 100000;
+    const int steps = 10;
+
+    std::vector<evs::Matrix> matrices;
+    for (std::size_t i = 0; i < count; i++) {
+        const double t = static_cast<double>(i);
+        evs::Matrix drifted = evs::compute_rotation_matrix<evs::ZYX>(
+            evs::EulerAngles(0.3 + 1e-4 * t, -0.2 + 3e-5 * t, 0.1 - 2e-4 * t));
+        for (std::size_t component = 0; component < 9; component++) {
+            drifted.data()[component] += 1e-6 * std::sin(0.37 * static_cast<double>(9 * i + component));
+        }
+        matrices.push_back(drifted);
+    }
+
+    const evs::MatrixArray array(matrices);
+    evs::MatrixArray u(count), v(count), rotations(count);
+    evs::VectorArray sigma(count);
+    evs::Matrix single_u, single_v;
+    evs::Vector single_sigma;
+
+    double ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (int step = 0; step < steps; step++) {
+            for (std::size_t i = 0; i < count; i++) {
+                evs::svd(matrices[i], single_u, single_sigma, single_v);
+                sum += single_sigma[2] + single_u(0, 1);
+            }
+        }
+        bench_sink = sum;
+    });
+    bench_report("svd(Matrix)", ms, steps * count);
+
+    ms = bench_time_ms([&]() {
+        for (int step = 0; step < steps; step++) {
+            evs::svd(array, u, sigma, v);
+        }
+        bench_sink = sigma.z()[count / 2] + u.plane(0, 1)[count / 2];
+    });
+    bench_report("svd(MatrixArray)", ms, steps * count);
+
+    ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (int step = 0; step < steps; step++) {
+            for (std::size_t i = 0; i < count; i++) {
+                sum += evs::nearest_rotation(matrices[i])(0, 1);
+            }
+        }
+        bench_sink = sum;
+    });
+    bench_report("nearest_rotation(Matrix)", ms, steps * count);
+
+    ms = bench_time_ms([&]() {
+        for (int step = 0; step < steps; step++) {
+            evs::nearest_rotation(array, rotations);
+        }
+        bench_sink = rotations.plane(0, 1)[count / 2];
+    });
+    bench_report("nearest_rotation(MatrixArray)", ms, steps * count);
+
+    return 0;
+}
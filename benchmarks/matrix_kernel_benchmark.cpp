@@ -0,0 +1,125 @@
+/**
+ * Compares the scalar and dispatched (AVX2/FMA when built with
+ * ENABLE_AVX2) single 3x3 product kernels, and the Matrix operators built
+ * on them.
+ */
+
+#include <evspace.hpp>
+#include <bench_helpers.hpp>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace evs = evspace;
+
+int main() {
+#if defined(EVSPACE_MATRIX_AVX2)
+    std::printf("kernels: AVX2/FMA\n");
+#else
+    std::printf("kernels: scalar\n");
+#endif
+    const std::size_t count = 10000000;
+    double a[9], b[9], v[3] = { 0.3, -0.2, 0.9 };
+    for (int i = 0; i < 9; i++) {
+        a[i] = std::sin(0.7 * i);
+        b[i] = std::cos(1.1 * i) * 0.5;
+    }
+
+    double ms = bench_time_ms([&]() {
+        double m[9];
+        std::memcpy(m, a, sizeof(m));
+        for (std::size_t i = 0; i < count; i++) {
+            evs::_matrix_exec::_multiply_scalar(m, b, m);
+        }
+        bench_sink = m[4];
+    });
+    bench_report("_multiply_scalar, chained in place", ms, count);
+
+    ms = bench_time_ms([&]() {
+        double m[9];
+        std::memcpy(m, a, sizeof(m));
+        for (std::size_t i = 0; i < count; i++) {
+            evs::_matrix_exec::_multiply(m, b, m);
+        }
+        bench_sink = m[4];
+    });
+    bench_report("_multiply, chained in place", ms, count);
+
+    ms = bench_time_ms([&]() {
+        double x[3] = { v[0], v[1], v[2] };
+        for (std::size_t i = 0; i < count; i++) {
+            evs::_matrix_exec::_vector_multiply(x, b, x);
+        }
+        bench_sink = x[0];
+    });
+    bench_report("_vector_multiply, chained", ms, count);
+
+    // independent products, limited by throughput rather than latency
+    const std::size_t batch = 4096;
+    std::vector<double> lhs_batch(9 * batch), rhs_batch(9 * batch), out_batch(9 * batch);
+    for (std::size_t i = 0; i < 9 * batch; i++) {
+        lhs_batch[i] = std::sin(0.3 * i);
+        rhs_batch[i] = std::cos(0.7 * i);
+    }
+
+    ms = bench_time_ms([&]() {
+        for (std::size_t r = 0; r < count / batch; r++) {
+            for (std::size_t i = 0; i < batch; i++) {
+                evs::_matrix_exec::_multiply_scalar(&lhs_batch[9 * i], &rhs_batch[9 * i], &out_batch[9 * i]);
+            }
+        }
+        bench_sink = out_batch[4];
+    });
+    bench_report("_multiply_scalar, independent", ms, count / batch * batch);
+
+    ms = bench_time_ms([&]() {
+        for (std::size_t r = 0; r < count / batch; r++) {
+            for (std::size_t i = 0; i < batch; i++) {
+                evs::_matrix_exec::_multiply(&lhs_batch[9 * i], &rhs_batch[9 * i], &out_batch[9 * i]);
+            }
+        }
+        bench_sink = out_batch[4];
+    });
+    bench_report("_multiply, independent", ms, count / batch * batch);
+
+    ms = bench_time_ms([&]() {
+        for (std::size_t r = 0; r < count / batch; r++) {
+            for (std::size_t i = 0; i < batch; i++) {
+                evs::_matrix_exec::_vector_multiply_scalar(v, &lhs_batch[9 * i], &out_batch[3 * i]);
+            }
+        }
+        bench_sink = out_batch[4];
+    });
+    bench_report("_vector_multiply_scalar, independent", ms, count / batch * batch);
+
+    ms = bench_time_ms([&]() {
+        for (std::size_t r = 0; r < count / batch; r++) {
+            for (std::size_t i = 0; i < batch; i++) {
+                evs::_matrix_exec::_vector_multiply(v, &lhs_batch[9 * i], &out_batch[3 * i]);
+            }
+        }
+        bench_sink = out_batch[4];
+    });
+    bench_report("_vector_multiply, independent", ms, count / batch * batch);
+
+    const evs::Matrix lhs(a), rhs(b);
+    ms = bench_time_ms([&]() {
+        evs::Matrix m = lhs;
+        for (std::size_t i = 0; i < count; i++) {
+            m *= rhs;
+        }
+        bench_sink = m(1, 1);
+    });
+    bench_report("Matrix::operator*=", ms, count);
+
+    ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < count / 10; i++) {
+            sum += (lhs * rhs)(1, 1);
+        }
+        bench_sink = sum;
+    }) * 10;
+    bench_report("Matrix::operator* (allocates)", ms, count);
+
+    return 0;
+}
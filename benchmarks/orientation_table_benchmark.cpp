@@ -0,0 +1,68 @@
+/**
+ * Compares approximate rotation matrices looked up from an OrientationTable
+ * with exact matrices from compute_rotation_matrix and the batched closed
+ * form derivation of ReferenceFrameArray.
+ */
+
+#include <evspace.hpp>
+#include <bench_helpers.hpp>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace evs = evspace;
+
+int main() {
+    const std::size_t count = 1000000;
+    const evs::EulerAngles lower(-0.5, -0.5, -0.5), upper(0.5, 0.5, 0.5);
+    // spacing of 1 / 28 rad keeps the error below 1e-6 rad
+    evs::OrientationTable<evs::ZYX> table(lower, upper, 29, 29, 29);
+    std::printf("table of %zu nodes, error bound %.3e rad\n", table.size(), table.error_bound());
+
+    std::mt19937_64 generator(7);
+    std::uniform_real_distribution<double> uniform(-0.5, 0.5);
+    std::vector<double> alphas(count), betas(count), gammas(count);
+    for (std::size_t i = 0; i < count; i++) {
+        alphas[i] = uniform(generator);
+        betas[i] = uniform(generator);
+        gammas[i] = uniform(generator);
+    }
+
+    double ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < count; i++) {
+            sum += evs::compute_rotation_matrix<evs::ZYX>(evs::EulerAngles(alphas[i], betas[i], gammas[i]))(0, 1);
+        }
+        bench_sink = sum;
+    });
+    bench_report("compute_rotation_matrix<ZYX>", ms, count);
+
+    ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < count; i++) {
+            sum += table.lookup(evs::EulerAngles(alphas[i], betas[i], gammas[i]))(0, 1);
+        }
+        bench_sink = sum;
+    });
+    bench_report("OrientationTable::lookup", ms, count);
+
+    evs::MatrixArray matrices(count);
+    ms = bench_time_ms([&]() {
+        double* planes[9];
+        for (std::size_t c = 0; c < 9; c++) {
+            planes[c] = matrices.plane(c / 3, c % 3);
+        }
+        evs::_rotation_exec::_derive_matrix_planes<evs::ZYX, evs::IntrinsicRotation>(
+            alphas.data(), betas.data(), gammas.data(), count, planes);
+        bench_sink = matrices.plane(0, 1)[count - 1];
+    });
+    bench_report("closed form derive into MatrixArray", ms, count);
+
+    ms = bench_time_ms([&]() {
+        table.lookup(alphas, betas, gammas, matrices);
+        bench_sink = matrices.plane(0, 1)[count - 1];
+    });
+    bench_report("OrientationTable batch lookup", ms, count);
+
+    return 0;
+}
@@ -0,0 +1,81 @@
+/**
+ * Drawing 100k random rotations: uniform Euler angles from std::mt19937_64
+ * through compute_rotation_matrix (fast, but not uniform over SO(3)),
+ * against the Philox batch generators for rotation matrices, quaternions,
+ * unit vectors and Gaussian perturbations about a mean rotation.
+ */
+
+#include <evspace.hpp>
+#include <bench_helpers.hpp>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace evs = evspace;
+
+int main() {
+    const std::size_t count = 100000;
+    const int steps = 10;
+
+    std::mt19937_64 engine(1);
+    std::uniform_real_distribution<double> angle(-3.14159265358979323846, 3.14159265358979323846);
+    double ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (int step = 0; step < steps; step++) {
+            for (std::size_t i = 0; i < count; i++) {
+                const evs::EulerAngles angles(angle(engine), angle(engine), angle(engine));
+                sum += evs::compute_rotation_matrix<evs::ZYX>(angles)(0, 1);
+            }
+        }
+        bench_sink = sum;
+    });
+    bench_report("mt19937_64 angles + compute_rotation_matrix", ms, steps * count);
+
+    evs::Philox generator(1);
+    evs::MatrixArray matrices;
+    ms = bench_time_ms([&]() {
+        for (int step = 0; step < steps; step++) {
+            evs::random_rotations(generator, count, matrices);
+        }
+        bench_sink = matrices.plane(0, 1)[count / 2];
+    });
+    bench_report("random_rotations (MatrixArray)", ms, steps * count);
+
+    evs::QuaternionArray quaternions;
+    ms = bench_time_ms([&]() {
+        for (int step = 0; step < steps; step++) {
+            evs::random_rotations(generator, count, quaternions);
+        }
+        bench_sink = quaternions.x()[count / 2];
+    });
+    bench_report("random_rotations (QuaternionArray)", ms, steps * count);
+
+    evs::VectorArray vectors;
+    ms = bench_time_ms([&]() {
+        for (int step = 0; step < steps; step++) {
+            evs::random_unit_vectors(generator, count, vectors);
+        }
+        bench_sink = vectors.x()[count / 2];
+    });
+    bench_report("random_unit_vectors", ms, steps * count);
+
+    ms = bench_time_ms([&]() {
+        for (int step = 0; step < steps; step++) {
+            evs::random_normal_vectors(generator, count, vectors);
+        }
+        bench_sink = vectors.x()[count / 2];
+    });
+    bench_report("random_normal_vectors", ms, steps * count);
+
+    const evs::Matrix mean = evs::compute_rotation_matrix<evs::ZYX>(evs::EulerAngles(0.4, -0.3, 1.2));
+    const evs::Vector sigmas(1e-3, 2e-3, 5e-4);
+    ms = bench_time_ms([&]() {
+        for (int step = 0; step < steps; step++) {
+            evs::random_perturbations(generator, mean, sigmas, count, matrices);
+        }
+        bench_sink = matrices.plane(0, 1)[count / 2];
+    });
+    bench_report("random_perturbations", ms, steps * count);
+
+    return 0;
+}
@@ -0,0 +1,98 @@
+/**
+ * Compares the memory footprint and rotation throughput of ReferenceFrame
+ * against CompactReferenceFrame for a large population of frames.
+ */
+
+#include <evspace.hpp>
+#include <bench_helpers.hpp>
+#include <cstdio>
+#include <vector>
+
+namespace evs = evspace;
+
+// Approximate heap cost of a `new double[n]` allocation, glibc malloc rounds
+// requests up to 16 bytes and adds an 8 byte header.
+static std::size_t heap_block_bytes(std::size_t doubles) {
+    std::size_t request = doubles * sizeof(double) + 8;
+    return (request + 15) / 16 * 16;
+}
+
+int main() {
+    const std::size_t frame_count = 1000000;
+    const evs::Vector vector(1.0, 2.0, 3.0);
+
+    std::vector<evs::ReferenceFrame<evs::XYZ>> frames;
+    std::vector<evs::CompactReferenceFrame<evs::XYZ>> compact_frames;
+    frames.reserve(frame_count);
+    compact_frames.reserve(frame_count);
+    for (std::size_t i = 0; i < frame_count; i++) {
+        double t = static_cast<double>(i) * 1e-6;
+        evs::EulerAngles angles(0.1 + t, 0.2 - t, 0.3 + 2 * t);
+        evs::Vector offset(t, 2 * t, 3 * t);
+        frames.emplace_back(angles, offset);
+        compact_frames.emplace_back(angles, offset);
+    }
+
+    std::size_t full_bytes = sizeof(evs::ReferenceFrame<evs::XYZ>) + heap_block_bytes(3) + heap_block_bytes(9);
+    std::size_t compact_bytes = sizeof(evs::CompactReferenceFrame<evs::XYZ>);
+    std::printf("ReferenceFrame:        sizeof %zu, with heap blocks ~%zu bytes per frame\n",
+        sizeof(evs::ReferenceFrame<evs::XYZ>), full_bytes);
+    std::printf("CompactReferenceFrame: sizeof %zu, no heap blocks, %zu bytes per frame\n",
+        sizeof(evs::CompactReferenceFrame<evs::XYZ>), compact_bytes);
+    std::printf("%zu frames: %.1f MB vs %.1f MB\n\n", frame_count,
+        full_bytes * frame_count / 1e6, compact_bytes * frame_count / 1e6);
+
+    double ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (const auto& frame : frames) {
+            sum += frame.rotate_to(vector)[0];
+        }
+        bench_sink = sum;
+    });
+    bench_report("ReferenceFrame::rotate_to, one vector/frame", ms, frame_count);
+
+    ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (const auto& frame : compact_frames) {
+            sum += frame.rotate_to(vector)[0];
+        }
+        bench_sink = sum;
+    });
+    bench_report("CompactReferenceFrame::rotate_to, one vector/frame", ms, frame_count);
+
+    ms = bench_time_ms([&]() {
+        for (auto& frame : frames) {
+            frame.set_angles(evs::EulerAngles(0.4, 0.5, 0.6));
+        }
+    });
+    bench_report("ReferenceFrame::set_angles", ms, frame_count);
+
+    ms = bench_time_ms([&]() {
+        for (auto& frame : compact_frames) {
+            frame.set_angles(evs::EulerAngles(0.4, 0.5, 0.6));
+        }
+    });
+    bench_report("CompactReferenceFrame::set_angles", ms, frame_count);
+
+    // hot frames reusing a small cache of derived matrices
+    evs::DerivedMatrixCache<8> cache;
+    ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < frame_count; i++) {
+            sum += compact_frames[i % 8].get_matrix(cache).data()[0];
+        }
+        bench_sink = sum;
+    });
+    bench_report("CompactReferenceFrame::get_matrix, 8 hot frames", ms, frame_count);
+
+    // batch application of a single frame
+    const std::size_t vector_count = 1000000;
+    evs::VectorArray vectors(vector_count), output(vector_count);
+    ms = bench_time_ms([&]() {
+        compact_frames[0].rotate_to(vectors, output);
+        bench_sink = output.x()[0];
+    });
+    bench_report("CompactReferenceFrame batch rotate_to", ms, vector_count);
+
+    return 0;
+}
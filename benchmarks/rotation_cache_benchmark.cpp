@@ -0,0 +1,60 @@
+/**
+ * Compares deriving rotation matrices from a small set of repeated Euler
+ * angles with looking them up in a RotationMatrixCache.
+ */
+
+#include <evspace.hpp>
+#include <bench_helpers.hpp>
+#include <vector>
+
+namespace evs = evspace;
+
+int main() {
+    const std::size_t lookups = 1000000, distinct = 2000;
+    std::vector<evs::EulerAngles> angles;
+    for (std::size_t i = 0; i < distinct; i++) {
+        angles.emplace_back(0.001 * i, 0.5 - 0.0003 * i, 1.0 + 0.0007 * i);
+    }
+
+    double ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (std::size_t k = 0; k < lookups; k++) {
+            sum += evs::compute_rotation_matrix<evs::ZYX>(angles[(k * 7) % distinct])(0, 1);
+        }
+        bench_sink = sum;
+    });
+    bench_report("compute_rotation_matrix<ZYX>", ms, lookups);
+
+    evs::RotationMatrixCache cache(4096);
+    ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (std::size_t k = 0; k < lookups; k++) {
+            sum += evs::compute_rotation_matrix<evs::ZYX>(angles[(k * 7) % distinct], cache)(0, 1);
+        }
+        bench_sink = sum;
+    });
+    bench_report("compute_rotation_matrix<ZYX> cached", ms, lookups);
+
+    ms = bench_time_ms([&]() {
+        double sum = 0.0, matrix[9];
+        for (std::size_t k = 0; k < lookups; k++) {
+            cache.lookup<evs::ZYX>(angles[(k * 7) % distinct], matrix);
+            sum += matrix[1];
+        }
+        bench_sink = sum;
+    });
+    bench_report("RotationMatrixCache::lookup into buffer", ms, lookups);
+
+    evs::RotationMatrixCache small(256);
+    ms = bench_time_ms([&]() {
+        double sum = 0.0, matrix[9];
+        for (std::size_t k = 0; k < lookups; k++) {
+            small.lookup<evs::ZYX>(angles[(k * 7) % distinct], matrix);
+            sum += matrix[1];
+        }
+        bench_sink = sum;
+    });
+    bench_report("lookup, working set 8x capacity", ms, lookups);
+
+    return 0;
+}
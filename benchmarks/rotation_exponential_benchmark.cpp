@@ -0,0 +1,72 @@
+/**
+ * exp(Omega t) of one angular velocity at 100k times, rebuilding
+ * compute_rotation_matrix(angle, axis) for each time against the cached
+ * RotationExponential one time at a time and batched, and the batch
+ * exponentials of 100k different angular velocities.
+ */
+
+#include <evspace.hpp>
+#include <bench_helpers.hpp>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace evs = evspace;
+
+int main() {
+    const std::size_t count = 100000;
+    const int steps = 10;
+
+    const evs::Vector omega(0.3, -1.2, 0.5);
+    std::vector<double> times;
+    std::vector<evs::Vector> omegas;
+    for (std::size_t i = 0; i < count; i++) {
+        const double t = static_cast<double>(i);
+        times.push_back(1e-3 * t);
+        omegas.push_back(evs::Vector(1.0 + std::sin(t), -2.0, 0.5 * std::cos(t)));
+    }
+    const evs::VectorArray omega_array(omegas);
+
+    double ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        const double rate = omega.magnitude();
+        for (int step = 0; step < steps; step++) {
+            for (std::size_t i = 0; i < count; i++) {
+                sum += evs::compute_rotation_matrix(rate * times[i], omega)(0, 1);
+            }
+        }
+        bench_sink = sum;
+    });
+    bench_report("compute_rotation_matrix(angle, axis)", ms, steps * count);
+
+    const evs::RotationExponential exponential(omega);
+    ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (int step = 0; step < steps; step++) {
+            for (std::size_t i = 0; i < count; i++) {
+                sum += exponential.at(times[i])(0, 1);
+            }
+        }
+        bench_sink = sum;
+    });
+    bench_report("RotationExponential::at", ms, steps * count);
+
+    evs::MatrixArray matrices;
+    ms = bench_time_ms([&]() {
+        for (int step = 0; step < steps; step++) {
+            exponential.at(times, matrices);
+        }
+        bench_sink = matrices.plane(0, 1)[count / 2];
+    });
+    bench_report("RotationExponential::at (batch)", ms, steps * count);
+
+    ms = bench_time_ms([&]() {
+        for (int step = 0; step < steps; step++) {
+            evs::compute_rotation_exponential(omega_array, times, matrices);
+        }
+        bench_sink = matrices.plane(0, 1)[count / 2];
+    });
+    bench_report("compute_rotation_exponential (batch)", ms, steps * count);
+
+    return 0;
+}
@@ -0,0 +1,116 @@
+/**
+ * Rotation matrices of 100k ZYX angle sets with and without their three
+ * closed form partials, one angle set at a time and batched, against
+ * three-derivative dual numbers and the batch matrices alone.
+ */
+
+#include <evspace.hpp>
+#include <bench_helpers.hpp>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace evs = evspace;
+
+int main() {
+    const std::size_t count = 100000;
+    const int steps = 10;
+
+    std::vector<evs::EulerAngles> angles;
+    std::vector<double> alphas, betas, gammas;
+    std::vector<evs::Vector> vectors;
+    evs::ReferenceFrameArray<evs::ZYX> frames(count);
+    for (std::size_t i = 0; i < count; i++) {
+        const double t = static_cast<double>(i);
+        angles.push_back(evs::EulerAngles(0.3 + 1e-5 * t, -0.2 + 2e-5 * t, 0.1 - 1e-5 * t));
+        alphas.push_back(angles.back()[0]);
+        betas.push_back(angles.back()[1]);
+        gammas.push_back(angles.back()[2]);
+        frames.alpha()[i] = alphas.back();
+        frames.beta()[i] = betas.back();
+        frames.gamma()[i] = gammas.back();
+        vectors.push_back(evs::Vector(1.0 + std::sin(t), -2.0, 0.5 * std::cos(t)));
+    }
+    const evs::VectorArray vector_array(vectors);
+
+    double ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (int step = 0; step < steps; step++) {
+            for (std::size_t i = 0; i < count; i++) {
+                sum += evs::compute_rotation_matrix<evs::ZYX>(angles[i])(0, 1);
+            }
+        }
+        bench_sink = sum;
+    });
+    bench_report("compute_rotation_matrix<ZYX>", ms, steps * count);
+
+    evs::Matrix rotation, d_alpha, d_beta, d_gamma;
+    ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (int step = 0; step < steps; step++) {
+            for (std::size_t i = 0; i < count; i++) {
+                evs::compute_rotation_partials<evs::ZYX>(angles[i], rotation, d_alpha, d_beta, d_gamma);
+                sum += rotation(0, 1) + d_beta(1, 2);
+            }
+        }
+        bench_sink = sum;
+    });
+    bench_report("compute_rotation_partials<ZYX>", ms, steps * count);
+
+    ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (int step = 0; step < steps; step++) {
+            for (std::size_t i = 0; i < count; i++) {
+                const std::array<evs::Dual<3>, 3> dual_angles = { evs::Dual<3>(angles[i][0], 0),
+                    evs::Dual<3>(angles[i][1], 1), evs::Dual<3>(angles[i][2], 2) };
+                const std::array<evs::Dual<3>, 9> dual = evs::compute_rotation_matrix<evs::ZYX>(dual_angles);
+                sum += dual[1].value() + dual[5].derivative(1);
+            }
+        }
+        bench_sink = sum;
+    });
+    bench_report("compute_rotation_matrix<ZYX> (Dual<3>)", ms, steps * count);
+
+    evs::Matrix jacobian;
+    ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (int step = 0; step < steps; step++) {
+            for (std::size_t i = 0; i < count; i++) {
+                sum += evs::rotate_to_partials<evs::ZYX>(angles[i], vectors[i], jacobian)[0] + jacobian(1, 2);
+            }
+        }
+        bench_sink = sum;
+    });
+    bench_report("rotate_to_partials<ZYX>", ms, steps * count);
+
+    ms = bench_time_ms([&]() {
+        for (int step = 0; step < steps; step++) {
+            frames.update_all();
+        }
+        bench_sink = frames.matrices().plane(0, 1)[count / 2];
+    });
+    bench_report("ReferenceFrameArray::update_all (matrix only)", ms, steps * count);
+
+    evs::MatrixArray rotations, alpha_partials, beta_partials, gamma_partials;
+    ms = bench_time_ms([&]() {
+        for (int step = 0; step < steps; step++) {
+            evs::compute_rotation_partials<evs::ZYX>(alphas, betas, gammas, rotations, alpha_partials,
+                                                     beta_partials, gamma_partials);
+        }
+        bench_sink = beta_partials.plane(0, 1)[count / 2];
+    });
+    bench_report("compute_rotation_partials<ZYX> (batch)", ms, steps * count);
+
+    evs::VectorArray rotated, alpha_derivatives, beta_derivatives, gamma_derivatives;
+    ms = bench_time_ms([&]() {
+        for (int step = 0; step < steps; step++) {
+            evs::rotate_to_partials<evs::ZYX>(alphas, betas, gammas, vector_array, rotated, alpha_derivatives,
+                                              beta_derivatives, gamma_derivatives);
+        }
+        bench_sink = beta_derivatives.x()[count / 2];
+    });
+    bench_report("rotate_to_partials<ZYX> (batch)", ms, steps * count);
+
+    return 0;
+}
@@ -0,0 +1,94 @@
+/**
+ * Compares the small angle Taylor approximations with exact trig for
+ * corrections on the order of 1e-4 rad.
+ */
+
+#include <evspace.hpp>
+#include <bench_helpers.hpp>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace evs = evspace;
+
+int main() {
+    const std::size_t count = 1000000;
+    const double tolerance = 1e-15;
+    std::mt19937_64 generator(3);
+    std::uniform_real_distribution<double> uniform(-2e-4, 2e-4);
+    std::vector<double> angles(count), sines(count), cosines(count);
+    for (double& angle : angles) {
+        angle = uniform(generator);
+    }
+    const evs::Vector vector(1, 2, 3), axis(0.3, -0.4, 0.5);
+
+    double ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < count; i++) {
+            sum += std::sin(angles[i]) + std::cos(angles[i]);
+        }
+        bench_sink = sum;
+    });
+    bench_report("std::sin + std::cos", ms, count);
+
+    ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < count; i++) {
+            double s, c;
+            evs::small_angle_sincos(angles[i], tolerance, s, c);
+            sum += s + c;
+        }
+        bench_sink = sum;
+    });
+    bench_report("small_angle_sincos", ms, count);
+
+    ms = bench_time_ms([&]() {
+        evs::sincos(angles, sines, cosines);
+        bench_sink = sines[count - 1];
+    });
+    bench_report("sincos batch", ms, count);
+
+    ms = bench_time_ms([&]() {
+        evs::small_angle_sincos(angles, tolerance, sines, cosines);
+        bench_sink = sines[count - 1];
+    });
+    bench_report("small_angle_sincos batch", ms, count);
+
+    ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < count; i++) {
+            sum += evs::rotate_from<evs::YAxis>(angles[i], vector)[0];
+        }
+        bench_sink = sum;
+    });
+    bench_report("rotate_from<YAxis>", ms, count);
+
+    ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < count; i++) {
+            sum += evs::small_angle_rotate_from<evs::YAxis>(angles[i], vector, tolerance)[0];
+        }
+        bench_sink = sum;
+    });
+    bench_report("small_angle_rotate_from<YAxis>", ms, count);
+
+    ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < count; i++) {
+            sum += evs::compute_rotation_matrix(angles[i], axis)(0, 1);
+        }
+        bench_sink = sum;
+    });
+    bench_report("compute_rotation_matrix(angle, axis)", ms, count);
+
+    ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < count; i++) {
+            sum += evs::compute_small_angle_matrix(angles[i], axis, tolerance)(0, 1);
+        }
+        bench_sink = sum;
+    });
+    bench_report("compute_small_angle_matrix(angle, axis)", ms, count);
+
+    return 0;
+}
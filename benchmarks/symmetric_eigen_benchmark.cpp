@@ -0,0 +1,55 @@
+/**
+ * Eigendecomposes 100k inertia tensors per step, comparing a loop over
+ * the single eigen_decomposition() with the batch version over a
+ * SymmetricMatrixArray.
+ */
+
+#include <evspace.hpp>
+#include <bench_helpers.hpp>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace evs = evspace;
+
+int main() {
+    const std::size_t count = 100000;
+    const int steps = 10;
+
+    std::vector<evs::SymmetricMatrix> tensors;
+    for (std::size_t i = 0; i < count; i++) {
+        const double t = static_cast<double>(i);
+        const evs::Matrix rotation = evs::compute_rotation_matrix<evs::ZYX>(
+            evs::EulerAngles(0.3 + 1e-4 * t, -0.2 + 3e-5 * t, 0.1 - 2e-4 * t));
+        tensors.push_back(evs::rotate_from(rotation, evs::SymmetricMatrix(2.0 + std::sin(0.1 * t), 0.0, 0.0,
+                                                                         3.0, 0.0, 1.0 + std::cos(0.2 * t))));
+    }
+
+    const evs::SymmetricMatrixArray array(tensors);
+    evs::VectorArray values(count);
+    evs::MatrixArray vectors(count);
+    evs::Vector single_values;
+    evs::Matrix single_vectors;
+
+    double ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (int step = 0; step < steps; step++) {
+            for (std::size_t i = 0; i < count; i++) {
+                evs::eigen_decomposition(tensors[i], single_values, single_vectors);
+                sum += single_values[0] + single_vectors(0, 1);
+            }
+        }
+        bench_sink = sum;
+    });
+    bench_report("eigen_decomposition(SymmetricMatrix)", ms, steps * count);
+
+    ms = bench_time_ms([&]() {
+        for (int step = 0; step < steps; step++) {
+            evs::eigen_decomposition(array, values, vectors);
+        }
+        bench_sink = values.x()[count / 2] + vectors.plane(0, 1)[count / 2];
+    });
+    bench_report("eigen_decomposition(SymmetricMatrixArray)", ms, steps * count);
+
+    return 0;
+}
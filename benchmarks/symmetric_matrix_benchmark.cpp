@@ -0,0 +1,76 @@
+/**
+ * Rotates 100k covariance tensors per step, comparing the two general
+ * products R * P * R^T on full Matrix objects with the fused symmetric
+ * rotation, one matrix at a time and batched.
+ */
+
+#include <evspace.hpp>
+#include <bench_helpers.hpp>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace evs = evspace;
+
+int main() {
+    const std::size_t count = 100000;
+    const int steps = 20;
+
+    std::vector<evs::Matrix> rotations;
+    std::vector<evs::SymmetricMatrix> tensors;
+    std::vector<evs::Matrix> full_tensors;
+    for (std::size_t i = 0; i < count; i++) {
+        const double t = static_cast<double>(i);
+        rotations.push_back(evs::compute_rotation_matrix<evs::XYZ>(
+            evs::EulerAngles(0.3 + 1e-5 * t, -0.2 + 2e-5 * t, 0.1 - 1e-5 * t)));
+        const evs::SymmetricMatrix tensor(2.0 + std::sin(0.1 * t), 0.1 * std::cos(0.3 * t), 0.05,
+                                          3.0 + std::cos(0.2 * t), -0.2 * std::sin(0.7 * t), 1.5);
+        tensors.push_back(tensor);
+        full_tensors.push_back(tensor.to_matrix());
+    }
+
+    const evs::Matrix rotation = rotations[count / 3];
+    const evs::MatrixArray rotation_array(rotations);
+    const evs::SymmetricMatrixArray tensor_array(tensors);
+    evs::SymmetricMatrixArray output(count);
+
+    double ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (int step = 0; step < steps; step++) {
+            for (std::size_t i = 0; i < count; i++) {
+                sum += (rotations[i] * full_tensors[i] * rotations[i].transpose())(0, 1);
+            }
+        }
+        bench_sink = sum;
+    });
+    bench_report("Matrix R * P * R^T (allocates)", ms, steps * count);
+
+    ms = bench_time_ms([&]() {
+        double sum = 0.0;
+        for (int step = 0; step < steps; step++) {
+            for (std::size_t i = 0; i < count; i++) {
+                sum += evs::rotate_from(rotations[i], tensors[i])(0, 1);
+            }
+        }
+        bench_sink = sum;
+    });
+    bench_report("rotate_from(Matrix, SymmetricMatrix)", ms, steps * count);
+
+    ms = bench_time_ms([&]() {
+        for (int step = 0; step < steps; step++) {
+            evs::rotate_from(rotation, tensor_array, output);
+        }
+        bench_sink = output.plane(0, 1)[count / 2];
+    });
+    bench_report("rotate_from(Matrix, SymmetricMatrixArray)", ms, steps * count);
+
+    ms = bench_time_ms([&]() {
+        for (int step = 0; step < steps; step++) {
+            evs::rotate_from(rotation_array, tensor_array, output);
+        }
+        bench_sink = output.plane(0, 1)[count / 2];
+    });
+    bench_report("rotate_from(MatrixArray, SymmetricMatrixArray)", ms, steps * count);
+
+    return 0;
+}
@@ -0,0 +1,309 @@
+#ifndef _EVSPACE_ANGLE_SWEEP_H_
+#define _EVSPACE_ANGLE_SWEEP_H_
+
+#include <angles.hpp>
+#include <matrix.hpp>
+#include <vector.hpp>
+#include <matrix_array.hpp>
+#include <rotation.hpp>
+#include <cmath>        // std::cos, std::sin
+#include <cstddef>      // std::size_t
+#include <stdexcept>    // std::out_of_range
+
+namespace evspace {
+
+    namespace _sweep_exec {
+
+        // Advances (c, s) = (cos(a), sin(a)) to (cos(a + d), sin(a + d))
+        // with the angle addition formulas, then pulls the pair back onto
+        // the unit circle with one Newton step of 1 / sqrt(c^2 + s^2). The
+        // rescale removes magnitude drift, the phase error of the recurrence
+        // still grows by about an ulp per step.
+        inline void _advance(double& c, double& s, double step_c, double step_s) noexcept {
+            const double next_c = c * step_c - s * step_s;
+            const double next_s = s * step_c + c * step_s;
+            const double scale = 1.5 - 0.5 * (next_c * next_c + next_s * next_s);
+            c = next_c * scale;
+            s = next_s * scale;
+        }
+
+    }
+
+    // Generates the rotations about _axis by the angles start + k * step
+    // for k = 0, 1, 2, ... without evaluating sin and cos at every step.
+    // Each call to next() advances the cosine and sine with the angle
+    // addition formulas. Every resync_interval steps the pair is recomputed
+    // from the exact angle to bound the accumulated error, a resync_interval
+    // of zero never resyncs.
+    template<typename _axis>
+    class SingleAxisSweep {
+    private:
+        double m_start;
+        double m_step;
+        double m_step_cos;
+        double m_step_sin;
+        double m_cos;
+        double m_sin;
+        std::size_t m_index;
+        std::size_t m_resync_interval;
+
+        void resync() noexcept;
+
+    public:
+        SingleAxisSweep(double, double, std::size_t = 64) noexcept;
+
+        std::size_t index() const noexcept;
+        double angle() const noexcept;
+        double cosine() const noexcept;
+        double sine() const noexcept;
+
+        // Advances to the next angle of the sweep.
+        SingleAxisSweep& next() noexcept;
+        // Moves to the angle at index, recomputing it exactly.
+        void seek(std::size_t) noexcept;
+
+        Matrix matrix() const;
+        Vector rotate_from(const Vector&) const;
+        Vector rotate_to(const Vector&) const;
+        // Writes the matrices of the next output.size() angles, starting
+        // with the current one, and advances past them.
+        void generate(MatrixArray&) noexcept;
+
+        typedef _axis Axis;
+    };
+
+    // Generates the rotations of a set of Euler angles where one angle,
+    // chosen by angle_index, sweeps by start + k * step while the other two
+    // stay fixed. The cosines and sines of the fixed angles are computed
+    // once, the swept angle advances as in SingleAxisSweep, and matrices
+    // are formed with the closed form Euler composition.
+    template<typename _rotation_order, typename _rotation_type=IntrinsicRotation>
+    class EulerAngleSweep {
+    private:
+        double m_start[3];
+        double m_step;
+        double m_step_cos;
+        double m_step_sin;
+        double m_cosines[3];
+        double m_sines[3];
+        std::size_t m_angle_index;
+        std::size_t m_index;
+        std::size_t m_resync_interval;
+
+        void resync() noexcept;
+
+    public:
+        EulerAngleSweep(const EulerAngles&, std::size_t, double, std::size_t = 64);
+
+        std::size_t index() const noexcept;
+        EulerAngles angles() const;
+
+        EulerAngleSweep& next() noexcept;
+        void seek(std::size_t) noexcept;
+
+        Matrix matrix() const;
+        Vector rotate_from(const Vector&) const;
+        Vector rotate_to(const Vector&) const;
+        void generate(MatrixArray&) noexcept;
+
+        typedef _rotation_order  RotationOrder;
+        typedef _rotation_type   RotationType;
+    };
+
+    /**
+     * SingleAxisSweep implementations.
+     */
+
+    template<typename axis>
+    SingleAxisSweep<axis>::SingleAxisSweep(double start, double step, std::size_t resync_interval) noexcept
+        : m_start(start), m_step(step), m_step_cos(std::cos(step)), m_step_sin(std::sin(step)),
+          m_cos(), m_sin(), m_index(0), m_resync_interval(resync_interval)
+    {
+        this->resync();
+    }
+
+    template<typename axis>
+    void SingleAxisSweep<axis>::resync() noexcept {
+        _rotation_exec::_axis_trig(this->angle(), this->m_cos, this->m_sin);
+    }
+
+    template<typename axis>
+    std::size_t SingleAxisSweep<axis>::index() const noexcept {
+        return this->m_index;
+    }
+
+    template<typename axis>
+    double SingleAxisSweep<axis>::angle() const noexcept {
+        return this->m_start + static_cast<double>(this->m_index) * this->m_step;
+    }
+
+    template<typename axis>
+    double SingleAxisSweep<axis>::cosine() const noexcept {
+        return this->m_cos;
+    }
+
+    template<typename axis>
+    double SingleAxisSweep<axis>::sine() const noexcept {
+        return this->m_sin;
+    }
+
+    template<typename axis>
+    SingleAxisSweep<axis>& SingleAxisSweep<axis>::next() noexcept {
+        this->m_index++;
+        if (this->m_resync_interval != 0 && this->m_index % this->m_resync_interval == 0) {
+            this->resync();
+        }
+        else {
+            _sweep_exec::_advance(this->m_cos, this->m_sin, this->m_step_cos, this->m_step_sin);
+        }
+
+        return *this;
+    }
+
+    template<typename axis>
+    void SingleAxisSweep<axis>::seek(std::size_t index) noexcept {
+        this->m_index = index;
+        this->resync();
+    }
+
+    template<typename axis>
+    Matrix SingleAxisSweep<axis>::matrix() const {
+        Matrix result;
+        _rotation_exec::_elementary_matrix<axis>(this->m_cos, this->m_sin, result.data().data());
+        return result;
+    }
+
+    template<typename axis>
+    Vector SingleAxisSweep<axis>::rotate_from(const Vector& vector) const {
+        Vector result = vector;
+        _rotation_exec::_rotate_elementary_from<axis>(this->m_cos, this->m_sin, result.data().data());
+        return result;
+    }
+
+    template<typename axis>
+    Vector SingleAxisSweep<axis>::rotate_to(const Vector& vector) const {
+        Vector result = vector;
+        _rotation_exec::_rotate_elementary_to<axis>(this->m_cos, this->m_sin, result.data().data());
+        return result;
+    }
+
+    template<typename axis>
+    void SingleAxisSweep<axis>::generate(MatrixArray& output) noexcept {
+        double* planes[9];
+        for (std::size_t component = 0; component < 9; component++) {
+            planes[component] = output.plane(component / 3, component % 3);
+        }
+
+        for (std::size_t i = 0; i < output.size(); i++) {
+            double m[9];
+            _rotation_exec::_elementary_matrix<axis>(this->m_cos, this->m_sin, m);
+            for (std::size_t component = 0; component < 9; component++) {
+                planes[component][i] = m[component];
+            }
+            this->next();
+        }
+    }
+
+    /**
+     * EulerAngleSweep implementations.
+     */
+
+    template<typename rotation_order, typename rotation_type>
+    EulerAngleSweep<rotation_order, rotation_type>::EulerAngleSweep(
+        const EulerAngles& start, std::size_t angle_index, double step, std::size_t resync_interval)
+        : m_start{ start[0], start[1], start[2] }, m_step(step), m_step_cos(std::cos(step)),
+          m_step_sin(std::sin(step)), m_cosines(), m_sines(), m_angle_index(angle_index), m_index(0),
+          m_resync_interval(resync_interval)
+    {
+        if (angle_index > 2) {
+            throw std::out_of_range("Angle index out of range");
+        }
+
+        for (std::size_t i = 0; i < 3; i++) {
+            _rotation_exec::_axis_trig(this->m_start[i], this->m_cosines[i], this->m_sines[i]);
+        }
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    void EulerAngleSweep<rotation_order, rotation_type>::resync() noexcept {
+        const std::size_t a = this->m_angle_index;
+        _rotation_exec::_axis_trig(this->m_start[a] + static_cast<double>(this->m_index) * this->m_step,
+                                   this->m_cosines[a], this->m_sines[a]);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    std::size_t EulerAngleSweep<rotation_order, rotation_type>::index() const noexcept {
+        return this->m_index;
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    EulerAngles EulerAngleSweep<rotation_order, rotation_type>::angles() const {
+        EulerAngles result(this->m_start[0], this->m_start[1], this->m_start[2]);
+        result[this->m_angle_index] += static_cast<double>(this->m_index) * this->m_step;
+        return result;
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    EulerAngleSweep<rotation_order, rotation_type>& EulerAngleSweep<rotation_order, rotation_type>::next() noexcept {
+        this->m_index++;
+        if (this->m_resync_interval != 0 && this->m_index % this->m_resync_interval == 0) {
+            this->resync();
+        }
+        else {
+            const std::size_t a = this->m_angle_index;
+            _sweep_exec::_advance(this->m_cosines[a], this->m_sines[a], this->m_step_cos, this->m_step_sin);
+        }
+
+        return *this;
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    void EulerAngleSweep<rotation_order, rotation_type>::seek(std::size_t index) noexcept {
+        this->m_index = index;
+        this->resync();
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    Matrix EulerAngleSweep<rotation_order, rotation_type>::matrix() const {
+        Matrix result;
+        _EulerAngleDelegate<rotation_order, rotation_type>::derive_matrix(
+            this->m_cosines, this->m_sines, result.data().data());
+        return result;
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    Vector EulerAngleSweep<rotation_order, rotation_type>::rotate_from(const Vector& vector) const {
+        Vector result = vector;
+        _EulerAngleDelegate<rotation_order, rotation_type>::rotate_from(
+            this->m_cosines, this->m_sines, result.data().data());
+        return result;
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    Vector EulerAngleSweep<rotation_order, rotation_type>::rotate_to(const Vector& vector) const {
+        Vector result = vector;
+        _EulerAngleDelegate<rotation_order, rotation_type>::rotate_to(
+            this->m_cosines, this->m_sines, result.data().data());
+        return result;
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    void EulerAngleSweep<rotation_order, rotation_type>::generate(MatrixArray& output) noexcept {
+        double* planes[9];
+        for (std::size_t component = 0; component < 9; component++) {
+            planes[component] = output.plane(component / 3, component % 3);
+        }
+
+        for (std::size_t i = 0; i < output.size(); i++) {
+            double m[9];
+            _EulerAngleDelegate<rotation_order, rotation_type>::derive_matrix(this->m_cosines, this->m_sines, m);
+            for (std::size_t component = 0; component < 9; component++) {
+                planes[component][i] = m[component];
+            }
+            this->next();
+        }
+    }
+
+}   // namespace evspace
+
+#endif // _EVSPACE_ANGLE_SWEEP_H_
@@ -0,0 +1,491 @@
+#ifndef _EVSPACE_ATTITUDE_DETERMINATION_H_
+#define _EVSPACE_ATTITUDE_DETERMINATION_H_
+
+#include <evspace_common.hpp>
+#include <angles.hpp>
+#include <matrix.hpp>
+#include <vector.hpp>
+#include <rotation.hpp>
+#include <quaternion.hpp>
+#include <matrix_array.hpp>
+#include <vector_array.hpp>
+#include <matrix_array_solve.hpp>
+#include <matrix_decomposition.hpp>
+#include <cmath>        // std::sqrt, std::fabs, HUGE_VAL
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint8_t
+#include <stdexcept>    // std::out_of_range, std::invalid_argument
+
+namespace evspace {
+
+    /**
+     * Solvers for Wahba's problem: given observations of unit vectors in a
+     * body frame and the same directions known in a reference frame, find
+     * the rotation matrix of the body frame that best maps one onto the
+     * other. The result uses the same convention as the rest of the
+     * library, so rotate_from(attitude, observation) is the reference
+     * vector and rotate_to(attitude, reference) the observation, and
+     * compute_euler_angles() of it gives the body frame's angles.
+     *
+     * Every weighted solver reduces the pairs in a single pass to the
+     * attitude profile matrix, sum(weight * reference * observation^T),
+     * and maximizes trace(attitude^T * profile) from that alone.
+     */
+
+    // The attitude profile matrix of the weighted observation and reference
+    // vector pairs. The spans must all be the same size.
+    Matrix attitude_profile(span_t<const Vector>, span_t<const Vector>, span_t<const double>);
+    // Batch attitude profile matrices, one for each problem. Problem i is
+    // made of the pairs in [offsets[i], offsets[i + 1]), so offsets has one
+    // more entry than there are problems and must not decrease or pass the
+    // end of the pairs. profiles is resized to match.
+    void attitude_profile(const VectorArray&, const VectorArray&, span_t<const double>,
+                          span_t<const std::size_t>, MatrixArray&);
+
+    // TRIAD attitude from two observation and reference pairs. The first
+    // pair is matched exactly and the second only fixes the rotation about
+    // it, so the more accurate measurement should be first. Throws
+    // std::invalid_argument if either pair of vectors is zero or parallel.
+    Matrix triad(const Vector&, const Vector&, const Vector&, const Vector&);
+    // Batch TRIAD attitudes of every element of the arrays, in the same
+    // order as above, writing a MatrixStatus for each to status and
+    // returning the number which are MATRIX_SINGULAR. An element with zero
+    // or parallel vectors is MATRIX_SINGULAR and has a zero attitude.
+    std::size_t triad(const VectorArray&, const VectorArray&, const VectorArray&, const VectorArray&,
+                      MatrixArray&, span_t<std::uint8_t>);
+
+    // QUEST attitude of weighted observation and reference pairs. The
+    // largest eigenvalue of Davenport's matrix is found by Newton's method
+    // on its characteristic polynomial and the optimal quaternion read off
+    // the adjugate column as in ESOQ, which unlike the classic Rodrigues
+    // parameter form has no trouble with rotations near 180 degrees.
+    Matrix quest(span_t<const Vector>, span_t<const Vector>, span_t<const double>);
+    // QUEST attitude of an attitude profile matrix.
+    Matrix quest(const Matrix&);
+    // Batch QUEST attitudes of attitude profile matrices, resizing the
+    // output to match.
+    void quest(const MatrixArray&, MatrixArray&);
+
+    // Kabsch attitude of weighted observation and reference pairs, the
+    // nearest proper rotation to the attitude profile matrix found by its
+    // singular value decomposition. It gives the same optimum as quest()
+    // and is the more robust of the two for poorly observed problems.
+    Matrix kabsch(span_t<const Vector>, span_t<const Vector>, span_t<const double>);
+    // Kabsch attitude of an attitude profile matrix.
+    Matrix kabsch(const Matrix&);
+    // Batch Kabsch attitudes of attitude profile matrices, resizing the
+    // output to match. The output may be the input.
+    void kabsch(const MatrixArray&, MatrixArray&);
+
+    // The solvers above returning the Euler angles of the attitude rather
+    // than its matrix.
+    template<typename rotation_order, typename rotation_type = IntrinsicRotation>
+    EulerAngles triad(const Vector&, const Vector&, const Vector&, const Vector&);
+    template<typename rotation_order, typename rotation_type = IntrinsicRotation>
+    EulerAngles quest(span_t<const Vector>, span_t<const Vector>, span_t<const double>);
+    template<typename rotation_order, typename rotation_type = IntrinsicRotation>
+    EulerAngles kabsch(span_t<const Vector>, span_t<const Vector>, span_t<const double>);
+
+    namespace _attitude_exec {
+
+        // Newton's method on the characteristic polynomial converges from
+        // above in a few steps for well observed problems, but only
+        // linearly on the double root of a degenerate one.
+        constexpr std::size_t _newton_iterations = 64;
+
+        // Vectors closer to parallel than this leave the TRIAD normal to
+        // rounding error, which isn't always exactly zero once the cross
+        // product's products are fused.
+        constexpr double _parallel_sine = 1e-12;
+
+        inline void _check_sizes(std::size_t observations, std::size_t references, std::size_t weights) {
+            if (observations != references || observations != weights) {
+                throw std::out_of_range("observations, references and weights must be the same size");
+            }
+        }
+
+        // Adds weight * reference * observation^T to the row-major profile.
+        inline void _accumulate(const double* observation, const double* reference, double weight,
+                                double* profile) noexcept
+        {
+            for (std::size_t row = 0; row < 3; row++) {
+                const double scaled = weight * reference[row];
+                for (std::size_t col = 0; col < 3; col++) {
+                    profile[row * 3 + col] += scaled * observation[col];
+                }
+            }
+        }
+
+        // The attitude profile of the pairs, into the row-major profile.
+        inline void _profile(span_t<const Vector> observations, span_t<const Vector> references,
+                             span_t<const double> weights, double* profile)
+        {
+            _check_sizes(observations.size(), references.size(), weights.size());
+            for (std::size_t k = 0; k < 9; k++) {
+                profile[k] = 0.0;
+            }
+            for (std::size_t i = 0; i < observations.size(); i++) {
+                _accumulate(observations[i].data().data(), references[i].data().data(), weights[i], profile);
+            }
+        }
+
+        // Adds the outer product first * second^T to the row-major matrix.
+        inline void _add_outer(const double* first, const double* second, double* matrix) noexcept {
+            for (std::size_t row = 0; row < 3; row++) {
+                for (std::size_t col = 0; col < 3; col++) {
+                    matrix[row * 3 + col] += first[row] * second[col];
+                }
+            }
+        }
+
+        // Builds the orthonormal triad of first and second, the unit first,
+        // the unit normal of their plane and the third completing it.
+        // Returns false if it doesn't exist.
+        inline bool _triad_basis(const double* first, const double* second, double* basis) noexcept {
+            const double normal[3] = {
+                first[1] * second[2] - first[2] * second[1],
+                first[2] * second[0] - first[0] * second[2],
+                first[0] * second[1] - first[1] * second[0]
+            };
+            const double first_length = std::sqrt(first[0] * first[0] + first[1] * first[1] + first[2] * first[2]);
+            const double second_length = std::sqrt(second[0] * second[0] + second[1] * second[1]
+                                                   + second[2] * second[2]);
+            const double normal_length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1]
+                                                   + normal[2] * normal[2]);
+            // a zero, infinite or NaN length fails one of the comparisons
+            const bool valid = (normal_length > _parallel_sine * first_length * second_length)
+                             & (normal_length < HUGE_VAL);
+
+            for (std::size_t k = 0; k < 3; k++) {
+                basis[k] = first[k] / first_length;
+                basis[3 + k] = normal[k] / normal_length;
+            }
+            basis[6] = basis[1] * basis[5] - basis[2] * basis[4];
+            basis[7] = basis[2] * basis[3] - basis[0] * basis[5];
+            basis[8] = basis[0] * basis[4] - basis[1] * basis[3];
+
+            return valid;
+        }
+
+        // The attitude taking each observation triad vector onto its
+        // reference one, sum(reference_k * observation_k^T). Returns false,
+        // leaving attitude zero, if either triad doesn't exist.
+        inline bool _triad(const double* observation1, const double* observation2, const double* reference1,
+                           const double* reference2, double* attitude) noexcept
+        {
+            double observation_basis[9], reference_basis[9];
+            const bool valid = _triad_basis(observation1, observation2, observation_basis)
+                             & _triad_basis(reference1, reference2, reference_basis);
+
+            for (std::size_t k = 0; k < 9; k++) {
+                attitude[k] = 0.0;
+            }
+            if (valid) {
+                for (std::size_t k = 0; k < 3; k++) {
+                    _add_outer(reference_basis + 3 * k, observation_basis + 3 * k, attitude);
+                }
+            }
+
+            return valid;
+        }
+
+        // The 3x3 minor of the symmetric, row-major 4x4 h without row and
+        // col, signed as the cofactor.
+        inline double _cofactor(const double* h, std::size_t row, std::size_t col) noexcept {
+            std::size_t rows[3], cols[3];
+            for (std::size_t k = 0, r = 0, c = 0; k < 4; k++) {
+                if (k != row) {
+                    rows[r++] = k;
+                }
+                if (k != col) {
+                    cols[c++] = k;
+                }
+            }
+
+            const double minor =
+                h[rows[0] * 4 + cols[0]] * (h[rows[1] * 4 + cols[1]] * h[rows[2] * 4 + cols[2]]
+                                            - h[rows[1] * 4 + cols[2]] * h[rows[2] * 4 + cols[1]])
+                - h[rows[0] * 4 + cols[1]] * (h[rows[1] * 4 + cols[0]] * h[rows[2] * 4 + cols[2]]
+                                              - h[rows[1] * 4 + cols[2]] * h[rows[2] * 4 + cols[0]])
+                + h[rows[0] * 4 + cols[2]] * (h[rows[1] * 4 + cols[0]] * h[rows[2] * 4 + cols[1]]
+                                              - h[rows[1] * 4 + cols[1]] * h[rows[2] * 4 + cols[0]]);
+
+            return (row + col) % 2 == 0 ? minor : -minor;
+        }
+
+        // The unit quaternion [ w, x, y, z ] maximizing
+        // trace(attitude^T * profile), with w non-negative.
+        //
+        // Writing the quaternion's rotation matrix out term by term turns
+        // the trace into the quadratic form q^T * k * q of Davenport's
+        // traceless matrix k, maximized by the eigenvector of its largest
+        // eigenvalue.
+        inline void _quest(const double* b, double* q) noexcept {
+            const double k[16] = {
+                b[0] + b[4] + b[8], b[7] - b[5], b[2] - b[6], b[3] - b[1],
+                b[7] - b[5], b[0] - b[4] - b[8], b[1] + b[3], b[2] + b[6],
+                b[2] - b[6], b[1] + b[3], b[4] - b[0] - b[8], b[5] + b[7],
+                b[3] - b[1], b[2] + b[6], b[5] + b[7], b[8] - b[0] - b[4]
+            };
+
+            // the power sums of the eigenvalues, trace(k^n), give the
+            // characteristic polynomial by Newton's identities
+            double p2 = 0.0, p3 = 0.0, p4 = 0.0;
+            for (std::size_t row = 0; row < 4; row++) {
+                for (std::size_t col = 0; col < 4; col++) {
+                    double square = 0.0;
+                    for (std::size_t n = 0; n < 4; n++) {
+                        square += k[row * 4 + n] * k[n * 4 + col];
+                    }
+                    p2 += k[row * 4 + col] * k[row * 4 + col];
+                    p3 += square * k[row * 4 + col];
+                    p4 += square * square;
+                }
+            }
+            const double c2 = -0.5 * p2, c1 = -p3 / 3.0, c0 = 0.125 * p2 * p2 - 0.25 * p4;
+
+            // the other three eigenvalues sum to minus the largest, so the
+            // largest is at most sqrt(3 / 4 * p2), with equality for noise
+            // free observations. From above Newton's method decreases
+            // monotonically to it and stops once rounding won't let it.
+            double lambda = std::sqrt(0.75 * p2);
+            for (std::size_t iteration = 0; iteration < _newton_iterations; iteration++) {
+                const double value = ((lambda * lambda + c2) * lambda + c1) * lambda + c0;
+                const double slope = (4.0 * lambda * lambda + 2.0 * c2) * lambda + c1;
+                const double next = lambda - value / slope;
+                if (!(next < lambda)) {
+                    break;
+                }
+                lambda = next;
+            }
+
+            // every column of adj(k - lambda * I) is parallel to the
+            // eigenvector, the one with the largest diagonal entry is
+            // furthest from zero
+            double h[16];
+            for (std::size_t n = 0; n < 16; n++) {
+                h[n] = k[n];
+            }
+            for (std::size_t n = 0; n < 4; n++) {
+                h[n * 5] -= lambda;
+            }
+            std::size_t pivot = 0;
+            double largest = std::fabs(_cofactor(h, 0, 0));
+            for (std::size_t n = 1; n < 4; n++) {
+                const double diagonal = std::fabs(_cofactor(h, n, n));
+                if (diagonal > largest) {
+                    largest = diagonal;
+                    pivot = n;
+                }
+            }
+
+            double length_squared = 0.0;
+            for (std::size_t n = 0; n < 4; n++) {
+                q[n] = _cofactor(h, n, pivot);
+                length_squared += q[n] * q[n];
+            }
+            const double length = std::sqrt(length_squared);
+            if (!(length > 0.0) || !(length < HUGE_VAL)) {
+                // no observations to speak of
+                q[0] = 1.0;
+                q[1] = q[2] = q[3] = 0.0;
+                return;
+            }
+            const double scale = q[0] < 0.0 ? -1.0 / length : 1.0 / length;
+            for (std::size_t n = 0; n < 4; n++) {
+                q[n] *= scale;
+            }
+        }
+
+        inline void _quest_matrix(const double* profile, double* attitude) noexcept {
+            double q[4];
+            _quest(profile, q);
+            _quaternion_exec::_to_matrix(q, attitude);
+        }
+
+    }
+
+    inline Matrix attitude_profile(span_t<const Vector> observations, span_t<const Vector> references,
+                                   span_t<const double> weights)
+    {
+        double profile[9];
+        _attitude_exec::_profile(observations, references, weights, profile);
+
+        return Matrix(profile);
+    }
+
+    inline void attitude_profile(const VectorArray& observations, const VectorArray& references,
+                                 span_t<const double> weights, span_t<const std::size_t> offsets,
+                                 MatrixArray& profiles)
+    {
+        _attitude_exec::_check_sizes(observations.size(), references.size(), weights.size());
+        if (offsets.size() == 0) {
+            throw std::out_of_range("offsets must have an entry past the last problem");
+        }
+        for (std::size_t i = 0; i + 1 < offsets.size(); i++) {
+            if (offsets[i] > offsets[i + 1]) {
+                throw std::out_of_range("offsets must not decrease");
+            }
+        }
+        if (offsets[offsets.size() - 1] > observations.size()) {
+            throw std::out_of_range("offsets must not pass the end of the vectors");
+        }
+
+        const std::size_t count = offsets.size() - 1;
+        profiles.resize(count);
+        const double* observation_planes[3] = { observations.x(), observations.y(), observations.z() };
+        const double* reference_planes[3] = { references.x(), references.y(), references.z() };
+        double* profile_planes[9];
+        _decomposition_exec::_matrix_planes(profiles, profile_planes);
+
+        _EVSPACE_PARALLEL_FOR_IF(count >= _EVSPACE_PARALLEL_MINIMUM)
+        for (std::size_t i = 0; i < count; i++) {
+            double profile[9]{};
+            for (std::size_t pair = offsets[i]; pair < offsets[i + 1]; pair++) {
+                const double observation[3] = {
+                    observation_planes[0][pair], observation_planes[1][pair], observation_planes[2][pair]
+                };
+                const double reference[3] = {
+                    reference_planes[0][pair], reference_planes[1][pair], reference_planes[2][pair]
+                };
+                _attitude_exec::_accumulate(observation, reference, weights[pair], profile);
+            }
+            for (std::size_t k = 0; k < 9; k++) {
+                profile_planes[k][i] = profile[k];
+            }
+        }
+    }
+
+    inline Matrix triad(const Vector& observation1, const Vector& observation2, const Vector& reference1,
+                        const Vector& reference2)
+    {
+        double attitude[9];
+        if (!_attitude_exec::_triad(observation1.data().data(), observation2.data().data(),
+                                    reference1.data().data(), reference2.data().data(), attitude))
+        {
+            throw std::invalid_argument("TRIAD vectors must not be zero or parallel");
+        }
+
+        return Matrix(attitude);
+    }
+
+    inline std::size_t triad(const VectorArray& observations1, const VectorArray& observations2,
+                             const VectorArray& references1, const VectorArray& references2,
+                             MatrixArray& attitudes, span_t<std::uint8_t> status)
+    {
+        const std::size_t count = observations1.size();
+        if (observations2.size() != count || references1.size() != count || references2.size() != count) {
+            throw std::out_of_range("observations and references must be the same size");
+        }
+        if (status.size() != count) {
+            throw std::out_of_range("status must be the same size as the VectorArray");
+        }
+
+        attitudes.resize(count);
+        const VectorArray* inputs[4] = { &observations1, &observations2, &references1, &references2 };
+        const double* planes[4][3];
+        for (std::size_t n = 0; n < 4; n++) {
+            planes[n][0] = inputs[n]->x();
+            planes[n][1] = inputs[n]->y();
+            planes[n][2] = inputs[n]->z();
+        }
+        double* attitude_planes[9];
+        _decomposition_exec::_matrix_planes(attitudes, attitude_planes);
+        std::uint8_t* flags = status.data();
+
+        _EVSPACE_PARALLEL_FOR_IF(count >= _EVSPACE_PARALLEL_MINIMUM)
+        for (std::size_t i = 0; i < count; i++) {
+            double vectors[4][3], attitude[9];
+            for (std::size_t n = 0; n < 4; n++) {
+                for (std::size_t k = 0; k < 3; k++) {
+                    vectors[n][k] = planes[n][k][i];
+                }
+            }
+            const bool valid = _attitude_exec::_triad(vectors[0], vectors[1], vectors[2], vectors[3], attitude);
+            for (std::size_t k = 0; k < 9; k++) {
+                attitude_planes[k][i] = attitude[k];
+            }
+            flags[i] = valid ? MATRIX_OK : MATRIX_SINGULAR;
+        }
+
+        return _matrix_solve_exec::_count_flagged(flags, count);
+    }
+
+    inline Matrix quest(span_t<const Vector> observations, span_t<const Vector> references,
+                        span_t<const double> weights)
+    {
+        double profile[9], attitude[9];
+        _attitude_exec::_profile(observations, references, weights, profile);
+        _attitude_exec::_quest_matrix(profile, attitude);
+
+        return Matrix(attitude);
+    }
+
+    inline Matrix quest(const Matrix& profile) {
+        double attitude[9];
+        _attitude_exec::_quest_matrix(profile.data().data(), attitude);
+
+        return Matrix(attitude);
+    }
+
+    inline void quest(const MatrixArray& profiles, MatrixArray& attitudes) {
+        const std::size_t count = profiles.size();
+        attitudes.resize(count);
+
+        const double* planes[9];
+        double* attitude_planes[9];
+        _decomposition_exec::_matrix_planes(profiles, planes);
+        _decomposition_exec::_matrix_planes(attitudes, attitude_planes);
+
+        _EVSPACE_PARALLEL_FOR_IF(count >= _EVSPACE_PARALLEL_MINIMUM)
+        for (std::size_t i = 0; i < count; i++) {
+            double profile[9], attitude[9];
+            for (std::size_t k = 0; k < 9; k++) {
+                profile[k] = planes[k][i];
+            }
+            _attitude_exec::_quest_matrix(profile, attitude);
+            for (std::size_t k = 0; k < 9; k++) {
+                attitude_planes[k][i] = attitude[k];
+            }
+        }
+    }
+
+    inline Matrix kabsch(span_t<const Vector> observations, span_t<const Vector> references,
+                         span_t<const double> weights)
+    {
+        return nearest_rotation(attitude_profile(observations, references, weights));
+    }
+
+    inline Matrix kabsch(const Matrix& profile) {
+        return nearest_rotation(profile);
+    }
+
+    inline void kabsch(const MatrixArray& profiles, MatrixArray& attitudes) {
+        nearest_rotation(profiles, attitudes);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    EulerAngles triad(const Vector& observation1, const Vector& observation2, const Vector& reference1,
+                      const Vector& reference2)
+    {
+        return compute_euler_angles<rotation_order, rotation_type>(
+            triad(observation1, observation2, reference1, reference2));
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    EulerAngles quest(span_t<const Vector> observations, span_t<const Vector> references,
+                      span_t<const double> weights)
+    {
+        return compute_euler_angles<rotation_order, rotation_type>(quest(observations, references, weights));
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    EulerAngles kabsch(span_t<const Vector> observations, span_t<const Vector> references,
+                       span_t<const double> weights)
+    {
+        return compute_euler_angles<rotation_order, rotation_type>(kabsch(observations, references, weights));
+    }
+
+}   // namespace evspace
+
+#endif // _EVSPACE_ATTITUDE_DETERMINATION_H_
@@ -0,0 +1,207 @@
+#ifndef _EVSPACE_ATTITUDE_INTEGRATOR_H_
+#define _EVSPACE_ATTITUDE_INTEGRATOR_H_
+
+#include <evspace_common.hpp>
+#include <angles.hpp>
+#include <matrix.hpp>
+#include <vector_array.hpp>
+#include <quaternion.hpp>
+#include <quaternion_array.hpp>
+#include <reference_frame_array.hpp>
+#include <rotation.hpp>
+#include <sincos.hpp>
+#include <cmath>        // std::sqrt
+#include <cstddef>      // std::size_t
+#include <stdexcept>    // std::out_of_range
+
+namespace evspace {
+
+    /**
+     * Batch attitude propagation of many bodies from their body frame
+     * angular velocities. Attitudes are unit quaternions in the
+     * rotate_from sense, body to reference, whose kinematics
+     *
+     *      q' = q * (0, omega) / 2
+     *
+     * have no singularity, unlike Euler angle rates. Each step works on the
+     * quaternion planes in chunks, splits the chunks across threads for
+     * large batches and renormalizes the result before storing it.
+     */
+
+    // Advances every attitude by dt with its body rate held constant over
+    // the step, q = q * exp(omega * dt / 2), which is exact for constant
+    // rates whatever the step size. The rates must be the same size as the
+    // attitudes.
+    void integrate_exponential(QuaternionArray&, const VectorArray&, double);
+    // Advances every attitude by dt with the classic fourth order Runge
+    // Kutta method, given the body rates at the start, middle and end of
+    // the step. The rates must be the same size as the attitudes.
+    void integrate_rk4(QuaternionArray&, const VectorArray&, const VectorArray&, const VectorArray&, double);
+
+    // Writes the Euler angles of every attitude to the frames and updates
+    // their matrices, resizing the frames to match and keeping their
+    // offsets. For the matrices alone use QuaternionArray::to_matrices.
+    template<typename rotation_order, typename rotation_type>
+    void to_frames(const QuaternionArray&, ReferenceFrameArray<rotation_order, rotation_type>&);
+
+    namespace _integrator_exec {
+
+        constexpr std::size_t _chunk_size = 256;
+
+        inline void _check_rates(std::size_t attitudes, std::size_t rates) {
+            if (rates != attitudes) {
+                throw std::out_of_range("body rates must be the same size as the attitudes");
+            }
+        }
+
+        // dq = q * (0, omega) / 2
+        inline void _derivative(const double* q, const double* omega, double* dq) noexcept {
+            dq[0] = -0.5 * (q[1] * omega[0] + q[2] * omega[1] + q[3] * omega[2]);
+            dq[1] = 0.5 * (q[0] * omega[0] + q[2] * omega[2] - q[3] * omega[1]);
+            dq[2] = 0.5 * (q[0] * omega[1] - q[1] * omega[2] + q[3] * omega[0]);
+            dq[3] = 0.5 * (q[0] * omega[2] + q[1] * omega[1] - q[2] * omega[0]);
+        }
+
+        // Stores the chunk of updated quaternions to the planes from start,
+        // scaled to unit length. The kernels gather their results in a
+        // local buffer first so their loops vectorize without runtime alias
+        // checks against the planes.
+        inline void _store_normalized(const double (*result)[_chunk_size], std::size_t chunk,
+                                      double* const* planes, std::size_t start) noexcept
+        {
+            double* w = planes[0] + start;
+            double* x = planes[1] + start;
+            double* y = planes[2] + start;
+            double* z = planes[3] + start;
+            for (std::size_t i = 0; i < chunk; i++) {
+                const double scale = 1.0 / std::sqrt(result[0][i] * result[0][i] + result[1][i] * result[1][i]
+                                                     + result[2][i] * result[2][i] + result[3][i] * result[3][i]);
+                w[i] = result[0][i] * scale;
+                x[i] = result[1][i] * scale;
+                y[i] = result[2][i] * scale;
+                z[i] = result[3][i] * scale;
+            }
+        }
+
+        // Runs kernel(start, chunk) over the count bodies a chunk at a time.
+        template<typename Kernel>
+        inline void _for_each_chunk(std::size_t count, Kernel&& kernel) {
+            const std::size_t chunk_count = (count + _chunk_size - 1) / _chunk_size;
+
+            _EVSPACE_PARALLEL_FOR_IF(count >= _EVSPACE_PARALLEL_MINIMUM)
+            for (std::size_t chunk_index = 0; chunk_index < chunk_count; chunk_index++) {
+                const std::size_t start = chunk_index * _chunk_size;
+                kernel(start, count - start < _chunk_size ? count - start : _chunk_size);
+            }
+        }
+
+    }
+
+    inline void integrate_exponential(QuaternionArray& attitudes, const VectorArray& rates, double dt) {
+        const std::size_t count = attitudes.size();
+        _integrator_exec::_check_rates(count, rates.size());
+        double* const planes[4] = { attitudes.w(), attitudes.x(), attitudes.y(), attitudes.z() };
+        const double* omega[3] = { rates.x(), rates.y(), rates.z() };
+
+        _integrator_exec::_for_each_chunk(count, [&](std::size_t start, std::size_t chunk) {
+            double norms[_integrator_exec::_chunk_size], half_angles[_integrator_exec::_chunk_size];
+            double sines[_integrator_exec::_chunk_size], cosines[_integrator_exec::_chunk_size];
+            for (std::size_t i = 0; i < chunk; i++) {
+                const double x = omega[0][start + i], y = omega[1][start + i], z = omega[2][start + i];
+                norms[i] = std::sqrt(x * x + y * y + z * z);
+                half_angles[i] = 0.5 * dt * norms[i];
+            }
+            sincos(span_t<const double>(half_angles, chunk), span_t<double>(sines, chunk),
+                   span_t<double>(cosines, chunk));
+
+            double result[4][_integrator_exec::_chunk_size];
+            for (std::size_t i = 0; i < chunk; i++) {
+                const std::size_t index = start + i;
+                // sin(|omega| dt / 2) / |omega|, which tends to dt / 2
+                const double scale = norms[i] > 0.0 ? sines[i] / norms[i] : 0.5 * dt;
+                const double step[4] = { cosines[i], scale * omega[0][index], scale * omega[1][index],
+                                         scale * omega[2][index] };
+                const double q[4] = { planes[0][index], planes[1][index], planes[2][index], planes[3][index] };
+                double product[4];
+                _quaternion_exec::_multiply(q, step, product);
+                for (std::size_t k = 0; k < 4; k++) {
+                    result[k][i] = product[k];
+                }
+            }
+            _integrator_exec::_store_normalized(result, chunk, planes, start);
+        });
+    }
+
+    inline void integrate_rk4(QuaternionArray& attitudes, const VectorArray& start_rates,
+                              const VectorArray& middle_rates, const VectorArray& end_rates, double dt)
+    {
+        const std::size_t count = attitudes.size();
+        _integrator_exec::_check_rates(count, start_rates.size());
+        _integrator_exec::_check_rates(count, middle_rates.size());
+        _integrator_exec::_check_rates(count, end_rates.size());
+        double* const planes[4] = { attitudes.w(), attitudes.x(), attitudes.y(), attitudes.z() };
+        const VectorArray* rates[3] = { &start_rates, &middle_rates, &end_rates };
+        const double* omega[3][3];
+        for (std::size_t n = 0; n < 3; n++) {
+            omega[n][0] = rates[n]->x();
+            omega[n][1] = rates[n]->y();
+            omega[n][2] = rates[n]->z();
+        }
+
+        _integrator_exec::_for_each_chunk(count, [&](std::size_t start, std::size_t chunk) {
+            double result[4][_integrator_exec::_chunk_size];
+            for (std::size_t i = start; i < start + chunk; i++) {
+                const double q[4] = { planes[0][i], planes[1][i], planes[2][i], planes[3][i] };
+                const double w0[3] = { omega[0][0][i], omega[0][1][i], omega[0][2][i] };
+                const double w1[3] = { omega[1][0][i], omega[1][1][i], omega[1][2][i] };
+                const double w2[3] = { omega[2][0][i], omega[2][1][i], omega[2][2][i] };
+
+                double k1[4], k2[4], k3[4], k4[4], stage[4];
+                _integrator_exec::_derivative(q, w0, k1);
+                for (std::size_t k = 0; k < 4; k++) {
+                    stage[k] = q[k] + 0.5 * dt * k1[k];
+                }
+                _integrator_exec::_derivative(stage, w1, k2);
+                for (std::size_t k = 0; k < 4; k++) {
+                    stage[k] = q[k] + 0.5 * dt * k2[k];
+                }
+                _integrator_exec::_derivative(stage, w1, k3);
+                for (std::size_t k = 0; k < 4; k++) {
+                    stage[k] = q[k] + dt * k3[k];
+                }
+                _integrator_exec::_derivative(stage, w2, k4);
+
+                for (std::size_t k = 0; k < 4; k++) {
+                    result[k][i - start] = q[k] + dt / 6.0 * (k1[k] + 2.0 * (k2[k] + k3[k]) + k4[k]);
+                }
+            }
+            _integrator_exec::_store_normalized(result, chunk, planes, start);
+        });
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    void to_frames(const QuaternionArray& attitudes, ReferenceFrameArray<rotation_order, rotation_type>& frames) {
+        const std::size_t count = attitudes.size();
+        frames.resize(count);
+        const double* planes[4] = { attitudes.w(), attitudes.x(), attitudes.y(), attitudes.z() };
+        double* angles[3] = { frames.alpha(), frames.beta(), frames.gamma() };
+
+        _integrator_exec::_for_each_chunk(count, [&](std::size_t start, std::size_t chunk) {
+            Matrix matrix;
+            double* data = matrix.data().data();
+            for (std::size_t i = start; i < start + chunk; i++) {
+                const double q[4] = { planes[0][i], planes[1][i], planes[2][i], planes[3][i] };
+                _quaternion_exec::_to_matrix(q, data);
+                const EulerAngles euler = compute_euler_angles<rotation_order, rotation_type>(matrix);
+                for (std::size_t a = 0; a < 3; a++) {
+                    angles[a][i] = euler[a];
+                }
+            }
+        });
+
+        frames.update_all();
+    }
+
+}   // namespace evspace
+
+#endif // _EVSPACE_ATTITUDE_INTEGRATOR_H_
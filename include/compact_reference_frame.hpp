@@ -0,0 +1,268 @@
+#ifndef _EVSPACE_COMPACT_REFERENCE_FRAME_H_
+#define _EVSPACE_COMPACT_REFERENCE_FRAME_H_
+
+#include <angles.hpp>
+#include <matrix.hpp>
+#include <vector.hpp>
+#include <vector_array.hpp>
+#include <rotation.hpp>
+#include <quaternion.hpp>
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint64_t
+#include <cstring>      // std::memcmp, std::memcpy
+
+namespace evspace {
+
+    // Small fixed capacity least recently used cache of rotation matrices
+    // derived from quaternions. Lookups compare quaternions bit for bit, so
+    // a hit always returns exactly the matrix that would have been derived.
+    // This is not thread safe, each thread should own its own cache.
+    template<std::size_t _capacity>
+    class DerivedMatrixCache {
+    private:
+        struct Entry {
+            double key[4];
+            double matrix[9];
+            std::uint64_t last_used;
+        };
+
+        Entry m_entries[_capacity];
+        std::size_t m_size;
+        std::uint64_t m_clock;
+        std::uint64_t m_hits;
+        std::uint64_t m_misses;
+
+    public:
+        static_assert(_capacity > 0, "DerivedMatrixCache capacity must be positive");
+
+        DerivedMatrixCache() noexcept;
+
+        // Returns the row-major matrix for quaternion, deriving and
+        // inserting it (evicting the least recently used entry) on a miss.
+        // The pointer is valid until the next call to lookup.
+        const double* lookup(const Quaternion&) noexcept;
+        void clear() noexcept;
+
+        std::size_t size() const noexcept;
+        std::uint64_t hits() const noexcept;
+        std::uint64_t misses() const noexcept;
+
+        static constexpr std::size_t capacity = _capacity;
+    };
+
+    // Memory compact alternative to ReferenceFrame. The orientation is stored
+    // as a unit quaternion and the offset inline, so a frame is 56 bytes with
+    // no heap allocations (ReferenceFrame owns two separate heap blocks). The
+    // rotation matrix is derived on demand, once per call or once per batch,
+    // or can be looked up from a DerivedMatrixCache.
+    //
+    // The Euler angles are not stored. get_angles() returns an equivalent set
+    // of angles, which may differ from those used to construct the frame
+    // when they are outside the principal ranges of compute_euler_angles.
+    template<typename _rotation_order, typename _rotation_type=IntrinsicRotation>
+    class CompactReferenceFrame {
+    private:
+        Quaternion m_rotation;
+        double m_offset[3];
+
+    public:
+        CompactReferenceFrame() = delete;
+        CompactReferenceFrame(const EulerAngles&, const Vector & = _zero_vector);
+        template<typename offset_type>
+        explicit CompactReferenceFrame(const ReferenceFrame<_rotation_order, _rotation_type, offset_type>&);
+
+        EulerAngles get_angles() const;
+        Vector get_offset() const;
+        const Quaternion& get_quaternion() const noexcept;
+        Matrix get_matrix() const;
+        template<std::size_t capacity>
+        Matrix get_matrix(DerivedMatrixCache<capacity>&) const;
+        void set_angles(const EulerAngles&);
+        void set_offset(const Vector&);
+
+        Vector rotate_to(const Vector&) const;
+        template<typename param_order, typename param_type>
+        Vector rotate_to(const CompactReferenceFrame<param_order, param_type>&, const Vector&) const;
+        Vector rotate_from(const Vector&) const;
+        template<typename param_order, typename param_type>
+        Vector rotate_from(const CompactReferenceFrame<param_order, param_type>&, const Vector&) const;
+
+        // Batch rotations derive the rotation matrix once and apply it to
+        // every vector. The output array is resized to match the input and
+        // may be the input array.
+        void rotate_to(const VectorArray&, VectorArray&) const;
+        void rotate_from(const VectorArray&, VectorArray&) const;
+
+        typedef _rotation_order  RotationOrder;
+        typedef _rotation_type   RotationType;
+    };
+
+    /**
+     * DerivedMatrixCache implementations.
+     */
+
+    template<std::size_t _capacity>
+    DerivedMatrixCache<_capacity>::DerivedMatrixCache() noexcept
+        : m_entries(), m_size(0), m_clock(0), m_hits(0), m_misses(0) { }
+
+    template<std::size_t _capacity>
+    const double* DerivedMatrixCache<_capacity>::lookup(const Quaternion& quaternion) noexcept {
+        const double* key = quaternion.data().data();
+        this->m_clock++;
+
+        std::size_t oldest = 0;
+        for (std::size_t i = 0; i < this->m_size; i++) {
+            Entry& entry = this->m_entries[i];
+            if (std::memcmp(entry.key, key, sizeof(entry.key)) == 0) {
+                entry.last_used = this->m_clock;
+                this->m_hits++;
+                return entry.matrix;
+            }
+            if (entry.last_used < this->m_entries[oldest].last_used) {
+                oldest = i;
+            }
+        }
+
+        this->m_misses++;
+        std::size_t index = this->m_size < _capacity ? this->m_size++ : oldest;
+        Entry& entry = this->m_entries[index];
+        std::memcpy(entry.key, key, sizeof(entry.key));
+        _quaternion_exec::_to_matrix(key, entry.matrix);
+        entry.last_used = this->m_clock;
+
+        return entry.matrix;
+    }
+
+    template<std::size_t _capacity>
+    void DerivedMatrixCache<_capacity>::clear() noexcept {
+        this->m_size = 0;
+    }
+
+    template<std::size_t _capacity>
+    std::size_t DerivedMatrixCache<_capacity>::size() const noexcept {
+        return this->m_size;
+    }
+
+    template<std::size_t _capacity>
+    std::uint64_t DerivedMatrixCache<_capacity>::hits() const noexcept {
+        return this->m_hits;
+    }
+
+    template<std::size_t _capacity>
+    std::uint64_t DerivedMatrixCache<_capacity>::misses() const noexcept {
+        return this->m_misses;
+    }
+
+    /**
+     * CompactReferenceFrame implementations.
+     */
+
+    template<typename rotation_order, typename rotation_type>
+    CompactReferenceFrame<rotation_order, rotation_type>::CompactReferenceFrame(
+        const EulerAngles& angles, const Vector& offset)
+        : m_rotation(compute_rotation_quaternion<rotation_order, rotation_type>(angles)),
+          m_offset{ offset[0], offset[1], offset[2] } { }
+
+    template<typename rotation_order, typename rotation_type>
+    template<typename offset_type>
+    CompactReferenceFrame<rotation_order, rotation_type>::CompactReferenceFrame(
+        const ReferenceFrame<rotation_order, rotation_type, offset_type>& frame)
+        : CompactReferenceFrame(frame.get_angles(), frame.get_offset()) { }
+
+    template<typename rotation_order, typename rotation_type>
+    EulerAngles CompactReferenceFrame<rotation_order, rotation_type>::get_angles() const {
+        return compute_euler_angles<rotation_order, rotation_type>(this->get_matrix());
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    Vector CompactReferenceFrame<rotation_order, rotation_type>::get_offset() const {
+        return Vector(this->m_offset[0], this->m_offset[1], this->m_offset[2]);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    const Quaternion& CompactReferenceFrame<rotation_order, rotation_type>::get_quaternion() const noexcept {
+        return this->m_rotation;
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    Matrix CompactReferenceFrame<rotation_order, rotation_type>::get_matrix() const {
+        return this->m_rotation.to_matrix();
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    template<std::size_t capacity>
+    Matrix CompactReferenceFrame<rotation_order, rotation_type>::get_matrix(DerivedMatrixCache<capacity>& cache) const {
+        Matrix result;
+        std::memcpy(result.data().data(), cache.lookup(this->m_rotation), 9 * sizeof(double));
+        return result;
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    void CompactReferenceFrame<rotation_order, rotation_type>::set_angles(const EulerAngles& angles) {
+        this->m_rotation = compute_rotation_quaternion<rotation_order, rotation_type>(angles);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    void CompactReferenceFrame<rotation_order, rotation_type>::set_offset(const Vector& offset) {
+        this->m_offset[0] = offset[0];
+        this->m_offset[1] = offset[1];
+        this->m_offset[2] = offset[2];
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    Vector CompactReferenceFrame<rotation_order, rotation_type>::rotate_to(const Vector& vector) const {
+        const double* v = vector.data().data();
+        const double shifted[3] = { v[0] - this->m_offset[0], v[1] - this->m_offset[1], v[2] - this->m_offset[2] };
+        Vector result;
+        _quaternion_exec::_rotate_to(this->m_rotation.data().data(), shifted, result.data().data());
+        return result;
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    Vector CompactReferenceFrame<rotation_order, rotation_type>::rotate_from(const Vector& vector) const {
+        Vector result;
+        double* r = result.data().data();
+        _quaternion_exec::_rotate_from(this->m_rotation.data().data(), vector.data().data(), r);
+        r[0] += this->m_offset[0];
+        r[1] += this->m_offset[1];
+        r[2] += this->m_offset[2];
+        return result;
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    template<typename _o, typename _t>
+    Vector CompactReferenceFrame<rotation_order, rotation_type>::rotate_to(
+        const CompactReferenceFrame<_o, _t>& frame, const Vector& vector) const
+    {
+        return frame.rotate_to(this->rotate_from(vector));
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    template<typename _o, typename _t>
+    Vector CompactReferenceFrame<rotation_order, rotation_type>::rotate_from(
+        const CompactReferenceFrame<_o, _t>& frame, const Vector& vector) const
+    {
+        return this->rotate_to(frame.rotate_from(vector));
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    void CompactReferenceFrame<rotation_order, rotation_type>::rotate_to(
+        const VectorArray& vectors, VectorArray& output) const
+    {
+        double matrix[9];
+        _quaternion_exec::_to_matrix(this->m_rotation.data().data(), matrix);
+        _rotation_exec::_rotate_batch_exec(matrix, this->m_offset, false, vectors, output);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    void CompactReferenceFrame<rotation_order, rotation_type>::rotate_from(
+        const VectorArray& vectors, VectorArray& output) const
+    {
+        double matrix[9];
+        _quaternion_exec::_to_matrix(this->m_rotation.data().data(), matrix);
+        _rotation_exec::_rotate_batch_exec(matrix, this->m_offset, true, vectors, output);
+    }
+
+}   // namespace evspace
+
+#endif // _EVSPACE_COMPACT_REFERENCE_FRAME_H_
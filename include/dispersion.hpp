@@ -0,0 +1,335 @@
+#ifndef _EVSPACE_DISPERSION_H_
+#define _EVSPACE_DISPERSION_H_
+
+#include <evspace_common.hpp>
+#include <angles.hpp>
+#include <matrix.hpp>
+#include <vector.hpp>
+#include <vector_array.hpp>
+#include <rotation.hpp>
+#include <symmetric_matrix.hpp>
+#include <matrix_decomposition.hpp>
+#include <random_rotation.hpp>
+#include <sincos.hpp>
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint64_t
+
+namespace evspace {
+
+    /**
+     * Monte Carlo dispersion of a vector rotated between two uncertain
+     * reference frames. The Euler angles and offsets of both frames, and
+     * the vector itself, are drawn from Gaussian distributions about their
+     * nominal values, each sample is carried through rotate_between, and
+     * the results are reduced to their mean and covariance as they are
+     * made, so memory does not grow with the sample count.
+     *
+     * Correlated errors are the Cholesky factor of their covariance times
+     * standard normal vectors from the Philox generator, and the samples
+     * are rotated a chunk at a time by the closed form Euler rotation
+     * kernels with the vectorized sincos. Each sample uses five draws, one
+     * for each uncertain quantity, at fixed positions of the stream, and
+     * the chunks are reduced in a fixed number of blocks merged in order,
+     * so the result is the same whatever the thread count.
+     */
+
+    // Gaussian uncertainty of a reference frame, its nominal Euler angles
+    // and offset with the covariances of their errors. The covariances
+    // default to zero, which makes the frame exact.
+    struct FrameUncertainty {
+        EulerAngles angles;
+        Vector offset;
+        SymmetricMatrix angle_covariance;
+        SymmetricMatrix offset_covariance;
+    };
+
+    // Running mean and covariance of a set of vectors in constant memory.
+    // Sets are combined with the pairwise update of Chan et al., which
+    // keeps the sum of squared deviations from the mean rather than raw
+    // second moments, so a small spread about a large mean keeps its
+    // digits.
+    class DispersionStatistics {
+    private:
+        std::size_t m_count;
+        double m_mean[3];
+        // sum of (v - mean) (v - mean)^T, in SymmetricMatrix storage order
+        double m_scatter[6];
+
+    public:
+        DispersionStatistics() noexcept;
+
+        std::size_t count() const noexcept;
+        Vector mean() const;
+        // The unbiased sample covariance, zero with fewer than two samples.
+        SymmetricMatrix covariance() const;
+
+        void add(const Vector&) noexcept;
+        void add(const VectorArray&) noexcept;
+        // Adds the count vectors held as separate x, y and z planes, such
+        // as a chunk of a VectorArray.
+        void add(const double*, const double*, const double*, std::size_t) noexcept;
+        // Adds the vectors of another set, as if they had been added here.
+        void merge(const DispersionStatistics&) noexcept;
+    };
+
+    // Mean and covariance of rotate_between(from.angles, to.angles, vector,
+    // from.offset, to.offset) over samples draws of the uncertain angles,
+    // offsets and vector. Sample i uses the draws position() + k * samples
+    // + i for k = 0 to 4, the errors of the from angles, from offset, to
+    // angles, to offset and vector in turn, and the generator is advanced
+    // by five times samples. Throws std::runtime_error if a covariance is
+    // not positive semi-definite.
+    template<typename rotation_from, typename rotation_to, typename from_type = IntrinsicRotation,
+             typename to_type = IntrinsicRotation>
+    DispersionStatistics disperse_between(Philox&, std::size_t, const FrameUncertainty&, const FrameUncertainty&,
+                                          const Vector&, const SymmetricMatrix& = SymmetricMatrix());
+
+    namespace _dispersion_exec {
+
+        constexpr std::size_t _chunk_size = 256;
+        // Number of partial results a dispersion is reduced in, fixed so the
+        // order of the merges does not depend on the thread count.
+        constexpr std::size_t _block_count = 64;
+
+        // Merges the moments of a second set into the first.
+        inline void _combine(std::size_t& count, double* mean, double* scatter, std::size_t other_count,
+                             const double* other_mean, const double* other_scatter) noexcept
+        {
+            if (other_count == 0) {
+                return;
+            }
+
+            const std::size_t total = count + other_count;
+            const double weight = static_cast<double>(other_count) / static_cast<double>(total);
+            const double cross = static_cast<double>(count) * weight;
+            double delta[3];
+            for (std::size_t k = 0; k < 3; k++) {
+                delta[k] = other_mean[k] - mean[k];
+                mean[k] += delta[k] * weight;
+            }
+            for (std::size_t row = 0; row < 3; row++) {
+                for (std::size_t col = row; col < 3; col++) {
+                    const std::size_t entry = _symmetric_exec::_INDEX[row][col];
+                    scatter[entry] += other_scatter[entry] + cross * delta[row] * delta[col];
+                }
+            }
+            count = total;
+        }
+
+        // Mean and scatter of the count vectors of a chunk, with a second
+        // pass over the deviations from the mean.
+        inline void _moments(const double* x, const double* y, const double* z, std::size_t count, double* mean,
+                             double* scatter) noexcept
+        {
+            double sum_x = 0.0, sum_y = 0.0, sum_z = 0.0;
+            for (std::size_t i = 0; i < count; i++) {
+                sum_x += x[i];
+                sum_y += y[i];
+                sum_z += z[i];
+            }
+            const double inverse = 1.0 / static_cast<double>(count);
+            mean[0] = sum_x * inverse;
+            mean[1] = sum_y * inverse;
+            mean[2] = sum_z * inverse;
+
+            double xx = 0.0, xy = 0.0, xz = 0.0, yy = 0.0, yz = 0.0, zz = 0.0;
+            for (std::size_t i = 0; i < count; i++) {
+                const double dx = x[i] - mean[0], dy = y[i] - mean[1], dz = z[i] - mean[2];
+                xx += dx * dx;
+                xy += dx * dy;
+                xz += dx * dz;
+                yy += dy * dy;
+                yz += dy * dz;
+                zz += dz * dz;
+            }
+            scatter[0] = xx;
+            scatter[1] = xy;
+            scatter[2] = xz;
+            scatter[3] = yy;
+            scatter[4] = yz;
+            scatter[5] = zz;
+        }
+
+        // The lower Cholesky factor of a covariance, returning false when it
+        // is zero and its quantity exact.
+        inline bool _factor(const SymmetricMatrix& covariance, double* factor) {
+            const Matrix lower = cholesky(covariance);
+            const double* data = lower.data().data();
+            bool active = false;
+            for (std::size_t k = 0; k < 9; k++) {
+                factor[k] = data[k];
+                active |= data[k] != 0.0;
+            }
+
+            return active;
+        }
+
+        // Adds sign * l * z to the chunk of vectors, with l a lower factor
+        // and z the standard normal vector of each draw.
+        inline void _add_correlated(const _random_exec::_Draws& draws, const double* l, double sign,
+                                    std::size_t chunk, double (*vectors)[_chunk_size]) noexcept
+        {
+            const double l00 = sign * l[0], l10 = sign * l[3], l11 = sign * l[4];
+            const double l20 = sign * l[6], l21 = sign * l[7], l22 = sign * l[8];
+            double* x = vectors[0];
+            double* y = vectors[1];
+            double* z = vectors[2];
+            for (std::size_t i = 0; i < chunk; i++) {
+                double normal[3];
+                _random_exec::_normal_vector(draws, i, normal);
+                x[i] += l00 * normal[0];
+                y[i] += l10 * normal[0] + l11 * normal[1];
+                z[i] += l20 * normal[0] + l21 * normal[1] + l22 * normal[2];
+            }
+        }
+
+        inline void _fill(const double* values, std::size_t chunk, double (*vectors)[_chunk_size]) noexcept {
+            for (std::size_t k = 0; k < 3; k++) {
+                for (std::size_t i = 0; i < chunk; i++) {
+                    vectors[k][i] = values[k];
+                }
+            }
+        }
+
+    }
+
+    inline DispersionStatistics::DispersionStatistics() noexcept
+        : m_count(0), m_mean{ 0.0, 0.0, 0.0 }, m_scatter{ 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 } { }
+
+    inline std::size_t DispersionStatistics::count() const noexcept {
+        return this->m_count;
+    }
+
+    inline Vector DispersionStatistics::mean() const {
+        return Vector(this->m_mean[0], this->m_mean[1], this->m_mean[2]);
+    }
+
+    inline SymmetricMatrix DispersionStatistics::covariance() const {
+        const double scale = this->m_count > 1 ? 1.0 / static_cast<double>(this->m_count - 1) : 0.0;
+        const double* s = this->m_scatter;
+        return SymmetricMatrix(s[0] * scale, s[1] * scale, s[2] * scale, s[3] * scale, s[4] * scale, s[5] * scale);
+    }
+
+    inline void DispersionStatistics::add(const Vector& vector) noexcept {
+        const double* data = vector.data().data();
+        const double zero[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+        _dispersion_exec::_combine(this->m_count, this->m_mean, this->m_scatter, 1, data, zero);
+    }
+
+    inline void DispersionStatistics::add(const VectorArray& vectors) noexcept {
+        this->add(vectors.x(), vectors.y(), vectors.z(), vectors.size());
+    }
+
+    inline void DispersionStatistics::add(const double* x, const double* y, const double* z,
+                                          std::size_t count) noexcept
+    {
+        const std::size_t chunk_size = _dispersion_exec::_chunk_size;
+        for (std::size_t start = 0; start < count; start += chunk_size) {
+            const std::size_t chunk = count - start < chunk_size ? count - start : chunk_size;
+            double mean[3], scatter[6];
+            _dispersion_exec::_moments(x + start, y + start, z + start, chunk, mean, scatter);
+            _dispersion_exec::_combine(this->m_count, this->m_mean, this->m_scatter, chunk, mean, scatter);
+        }
+    }
+
+    inline void DispersionStatistics::merge(const DispersionStatistics& other) noexcept {
+        _dispersion_exec::_combine(this->m_count, this->m_mean, this->m_scatter, other.m_count, other.m_mean,
+                                   other.m_scatter);
+    }
+
+    template<typename rotation_from, typename rotation_to, typename from_type, typename to_type>
+    DispersionStatistics disperse_between(Philox& generator, std::size_t samples, const FrameUncertainty& from,
+                                          const FrameUncertainty& to, const Vector& vector,
+                                          const SymmetricMatrix& vector_covariance)
+    {
+        using _dispersion_exec::_chunk_size;
+        using _dispersion_exec::_block_count;
+
+        // from angles, from offset, to angles, to offset and vector, the
+        // order of their draws
+        double factors[5][9];
+        const bool active[5] = {
+            _dispersion_exec::_factor(from.angle_covariance, factors[0]),
+            _dispersion_exec::_factor(from.offset_covariance, factors[1]),
+            _dispersion_exec::_factor(to.angle_covariance, factors[2]),
+            _dispersion_exec::_factor(to.offset_covariance, factors[3]),
+            _dispersion_exec::_factor(vector_covariance, factors[4])
+        };
+        const double from_angles[3] = { from.angles[0], from.angles[1], from.angles[2] };
+        const double to_angles[3] = { to.angles[0], to.angles[1], to.angles[2] };
+        const double* from_offset = from.offset.data().data();
+        const double* to_offset = to.offset.data().data();
+        const double shift[3] = { from_offset[0] - to_offset[0], from_offset[1] - to_offset[1],
+                                  from_offset[2] - to_offset[2] };
+        const double* nominal = vector.data().data();
+
+        const std::uint64_t first = generator.position();
+        const Philox& source = generator;
+        const std::size_t chunk_count = (samples + _chunk_size - 1) / _chunk_size;
+        DispersionStatistics partials[_block_count];
+
+        _EVSPACE_PARALLEL_FOR_IF(samples >= _EVSPACE_PARALLEL_MINIMUM)
+        for (std::size_t block = 0; block < _block_count; block++) {
+            const std::size_t chunk_end = (block + 1) * chunk_count / _block_count;
+            for (std::size_t chunk_index = block * chunk_count / _block_count; chunk_index < chunk_end; chunk_index++) {
+                const std::size_t start = chunk_index * _chunk_size;
+                const std::size_t chunk = samples - start < _chunk_size ? samples - start : _chunk_size;
+                // angles[0] and angles[1] are the from and to angles, the
+                // vectors are rotated in place and the shift is the
+                // difference of the offsets
+                double angles[2][3][_chunk_size], shifts[3][_chunk_size], vectors[3][_chunk_size];
+                _dispersion_exec::_fill(from_angles, chunk, angles[0]);
+                _dispersion_exec::_fill(to_angles, chunk, angles[1]);
+                _dispersion_exec::_fill(shift, chunk, shifts);
+                _dispersion_exec::_fill(nominal, chunk, vectors);
+
+                double (*targets[5])[_chunk_size] = { angles[0], shifts, angles[1], shifts, vectors };
+                const double signs[5] = { 1.0, 1.0, 1.0, -1.0, 1.0 };
+                _random_exec::_Draws draws;
+                for (std::size_t k = 0; k < 5; k++) {
+                    if (active[k]) {
+                        _random_exec::_fill_draws(source, first + k * samples + start, chunk, draws);
+                        _dispersion_exec::_add_correlated(draws, factors[k], signs[k], chunk, targets[k]);
+                    }
+                }
+
+                double cosines[2][3][_chunk_size], sines[2][3][_chunk_size];
+                for (std::size_t frame = 0; frame < 2; frame++) {
+                    for (std::size_t a = 0; a < 3; a++) {
+                        sincos(span_t<const double>(angles[frame][a], chunk), span_t<double>(sines[frame][a], chunk),
+                               span_t<double>(cosines[frame][a], chunk));
+                    }
+                }
+
+                for (std::size_t i = 0; i < chunk; i++) {
+                    double v[3] = { vectors[0][i], vectors[1][i], vectors[2][i] };
+                    const double c_from[3] = { cosines[0][0][i], cosines[0][1][i], cosines[0][2][i] };
+                    const double s_from[3] = { sines[0][0][i], sines[0][1][i], sines[0][2][i] };
+                    const double c_to[3] = { cosines[1][0][i], cosines[1][1][i], cosines[1][2][i] };
+                    const double s_to[3] = { sines[1][0][i], sines[1][1][i], sines[1][2][i] };
+                    _EulerAngleDelegate<rotation_from, from_type>::rotate_from(c_from, s_from, v);
+                    for (std::size_t k = 0; k < 3; k++) {
+                        v[k] += shifts[k][i];
+                    }
+                    _EulerAngleDelegate<rotation_to, to_type>::rotate_to(c_to, s_to, v);
+                    for (std::size_t k = 0; k < 3; k++) {
+                        vectors[k][i] = v[k];
+                    }
+                }
+
+                partials[block].add(vectors[0], vectors[1], vectors[2], chunk);
+            }
+        }
+
+        generator.seek(first + 5 * static_cast<std::uint64_t>(samples));
+        DispersionStatistics result;
+        for (std::size_t block = 0; block < _block_count; block++) {
+            result.merge(partials[block]);
+        }
+
+        return result;
+    }
+
+}   // namespace evspace
+
+#endif // _EVSPACE_DISPERSION_H_
@@ -0,0 +1,432 @@
+#ifndef _EVSPACE_DUAL_H_
+#define _EVSPACE_DUAL_H_
+
+#include <evspace_common.hpp>
+#include <angles.hpp>
+#include <matrix.hpp>
+#include <vector.hpp>
+#include <rotation.hpp>
+#include <array>        // std::array
+#include <cmath>        // std::sin, std::cos, std::sqrt
+#include <cstddef>      // std::size_t
+#include <ostream>      // std::ostream
+#include <stdexcept>    // std::out_of_range
+
+namespace evspace {
+
+    // Dual number carrying a value and its derivatives with respect to N
+    // independent variables, for forward mode automatic differentiation.
+    // Evaluating a function on duals seeded as its inputs gives its value
+    // and its whole gradient in one pass, exact to rounding, where finite
+    // differences need an evaluation per input and lose half the digits.
+    template<std::size_t N>
+    class Dual {
+    private:
+        double m_value;
+        double m_derivatives[N];
+
+    public:
+        // Constructs the constant zero.
+        constexpr Dual() noexcept;
+        // Constructs a constant, whose derivatives are all zero. Implicit so
+        // constants mix with duals in expressions.
+        constexpr Dual(double) noexcept;
+        // Constructs independent variable index with value, its derivative
+        // with respect to itself one and the others zero. Throws
+        // std::out_of_range if index isn't less than N.
+        Dual(double, std::size_t);
+
+        double value() const noexcept;
+        // The derivative with respect to independent variable index.
+        double& derivative(std::size_t);
+        const double& derivative(std::size_t) const;
+
+        // The dual of f(*this), from the value and slope of f at value(),
+        // by the chain rule. Differentiable functions beyond those below
+        // are written in terms of this.
+        Dual chain(double, double) const noexcept;
+
+        Dual operator-() const noexcept;
+        Dual& operator+=(const Dual&) noexcept;
+        Dual& operator-=(const Dual&) noexcept;
+        Dual& operator*=(const Dual&) noexcept;
+        Dual& operator/=(const Dual&) noexcept;
+        Dual& operator*=(double) noexcept;
+        Dual& operator/=(double) noexcept;
+    };
+
+    template<std::size_t N>
+    std::ostream& operator<<(std::ostream& out, const Dual<N>& dual) {
+        out << dual.value() << " [ ";
+        for (std::size_t i = 0; i < N; i++) {
+            out << dual.derivative(i) << (i + 1 < N ? ", " : " ");
+        }
+        out << "]";
+        return out;
+    }
+
+    template<std::size_t N>
+    Dual<N> operator+(const Dual<N>&, const Dual<N>&) noexcept;
+    template<std::size_t N>
+    Dual<N> operator-(const Dual<N>&, const Dual<N>&) noexcept;
+    template<std::size_t N>
+    Dual<N> operator*(const Dual<N>&, const Dual<N>&) noexcept;
+    template<std::size_t N>
+    Dual<N> operator/(const Dual<N>&, const Dual<N>&) noexcept;
+    // Products with a constant skip the derivatives it doesn't have.
+    template<std::size_t N>
+    Dual<N> operator*(const Dual<N>&, double) noexcept;
+    template<std::size_t N>
+    Dual<N> operator*(double, const Dual<N>&) noexcept;
+    template<std::size_t N>
+    Dual<N> operator/(const Dual<N>&, double) noexcept;
+
+    template<std::size_t N>
+    Dual<N> sin(const Dual<N>&) noexcept;
+    template<std::size_t N>
+    Dual<N> cos(const Dual<N>&) noexcept;
+    template<std::size_t N>
+    Dual<N> sqrt(const Dual<N>&) noexcept;
+
+    /**
+     * Rotations of dual numbers. These run the same elementary rotation
+     * kernels as the Euler angle and single axis delegates, so their
+     * values match the double versions and their derivatives are those
+     * of the angles and vector components the inputs were seeded with.
+     * Vectors are three duals and matrices nine in row-major order.
+     */
+
+    template<typename axis, std::size_t N>
+    std::array<Dual<N>, 9> compute_rotation_matrix(const Dual<N>&);
+    template<typename rotation_order, typename rotation_type = IntrinsicRotation, std::size_t N>
+    std::array<Dual<N>, 9> compute_rotation_matrix(const std::array<Dual<N>, 3>&);
+
+    template<typename axis, std::size_t N>
+    std::array<Dual<N>, 3> rotate_from(const Dual<N>&, const std::array<Dual<N>, 3>&);
+    template<typename axis, std::size_t N>
+    std::array<Dual<N>, 3> rotate_to(const Dual<N>&, const std::array<Dual<N>, 3>&);
+    template<typename rotation_order, typename rotation_type = IntrinsicRotation, std::size_t N>
+    std::array<Dual<N>, 3> rotate_from(const std::array<Dual<N>, 3>&, const std::array<Dual<N>, 3>&);
+    template<typename rotation_order, typename rotation_type = IntrinsicRotation, std::size_t N>
+    std::array<Dual<N>, 3> rotate_to(const std::array<Dual<N>, 3>&, const std::array<Dual<N>, 3>&);
+
+    // rotate_from(angles, vector) along with its Jacobians with respect to
+    // the angles and to the vector, row i of each the gradient of component
+    // i of the result, from a single pass of six dual derivatives.
+    template<typename rotation_order, typename rotation_type = IntrinsicRotation>
+    Vector rotate_from_jacobian(const EulerAngles&, const Vector&, Matrix&, Matrix&);
+    // rotate_to(angles, vector) along with its Jacobians, as above.
+    template<typename rotation_order, typename rotation_type = IntrinsicRotation>
+    Vector rotate_to_jacobian(const EulerAngles&, const Vector&, Matrix&, Matrix&);
+
+    /**
+     * Dual implementation.
+     */
+
+    template<std::size_t N>
+    inline constexpr Dual<N>::Dual() noexcept
+        : m_value(0.0), m_derivatives{} { }
+
+    template<std::size_t N>
+    inline constexpr Dual<N>::Dual(double value) noexcept
+        : m_value(value), m_derivatives{} { }
+
+    template<std::size_t N>
+    inline Dual<N>::Dual(double value, std::size_t index)
+        : m_value(value), m_derivatives{}
+    {
+        if (index >= N) {
+            throw std::out_of_range("Dual variable index out of range");
+        }
+
+        this->m_derivatives[index] = 1.0;
+    }
+
+    template<std::size_t N>
+    inline double Dual<N>::value() const noexcept {
+        return this->m_value;
+    }
+
+    template<std::size_t N>
+    inline double& Dual<N>::derivative(std::size_t index) {
+        if (index >= N) {
+            throw std::out_of_range("Dual derivative index out of range");
+        }
+
+        return this->m_derivatives[index];
+    }
+
+    template<std::size_t N>
+    inline const double& Dual<N>::derivative(std::size_t index) const {
+        if (index >= N) {
+            throw std::out_of_range("Dual derivative index out of range");
+        }
+
+        return this->m_derivatives[index];
+    }
+
+    template<std::size_t N>
+    inline Dual<N> Dual<N>::chain(double value, double slope) const noexcept {
+        Dual<N> result(value);
+        for (std::size_t i = 0; i < N; i++) {
+            result.m_derivatives[i] = slope * this->m_derivatives[i];
+        }
+
+        return result;
+    }
+
+    template<std::size_t N>
+    inline Dual<N> Dual<N>::operator-() const noexcept {
+        return this->chain(-this->m_value, -1.0);
+    }
+
+    template<std::size_t N>
+    inline Dual<N>& Dual<N>::operator+=(const Dual<N>& rhs) noexcept {
+        this->m_value += rhs.m_value;
+        for (std::size_t i = 0; i < N; i++) {
+            this->m_derivatives[i] += rhs.m_derivatives[i];
+        }
+
+        return *this;
+    }
+
+    template<std::size_t N>
+    inline Dual<N>& Dual<N>::operator-=(const Dual<N>& rhs) noexcept {
+        this->m_value -= rhs.m_value;
+        for (std::size_t i = 0; i < N; i++) {
+            this->m_derivatives[i] -= rhs.m_derivatives[i];
+        }
+
+        return *this;
+    }
+
+    template<std::size_t N>
+    inline Dual<N>& Dual<N>::operator*=(const Dual<N>& rhs) noexcept {
+        for (std::size_t i = 0; i < N; i++) {
+            this->m_derivatives[i] = this->m_derivatives[i] * rhs.m_value + this->m_value * rhs.m_derivatives[i];
+        }
+        this->m_value *= rhs.m_value;
+
+        return *this;
+    }
+
+    template<std::size_t N>
+    inline Dual<N>& Dual<N>::operator/=(const Dual<N>& rhs) noexcept {
+        // (u / v)' = (u' - (u / v) * v') / v
+        const double inverse = 1.0 / rhs.m_value;
+        this->m_value *= inverse;
+        for (std::size_t i = 0; i < N; i++) {
+            this->m_derivatives[i] = (this->m_derivatives[i] - this->m_value * rhs.m_derivatives[i]) * inverse;
+        }
+
+        return *this;
+    }
+
+    template<std::size_t N>
+    inline Dual<N>& Dual<N>::operator*=(double rhs) noexcept {
+        this->m_value *= rhs;
+        for (std::size_t i = 0; i < N; i++) {
+            this->m_derivatives[i] *= rhs;
+        }
+
+        return *this;
+    }
+
+    template<std::size_t N>
+    inline Dual<N>& Dual<N>::operator/=(double rhs) noexcept {
+        return *this *= 1.0 / rhs;
+    }
+
+    template<std::size_t N>
+    inline Dual<N> operator+(const Dual<N>& lhs, const Dual<N>& rhs) noexcept {
+        Dual<N> result = lhs;
+        return result += rhs;
+    }
+
+    template<std::size_t N>
+    inline Dual<N> operator-(const Dual<N>& lhs, const Dual<N>& rhs) noexcept {
+        Dual<N> result = lhs;
+        return result -= rhs;
+    }
+
+    template<std::size_t N>
+    inline Dual<N> operator*(const Dual<N>& lhs, const Dual<N>& rhs) noexcept {
+        Dual<N> result = lhs;
+        return result *= rhs;
+    }
+
+    template<std::size_t N>
+    inline Dual<N> operator/(const Dual<N>& lhs, const Dual<N>& rhs) noexcept {
+        Dual<N> result = lhs;
+        return result /= rhs;
+    }
+
+    template<std::size_t N>
+    inline Dual<N> operator*(const Dual<N>& lhs, double rhs) noexcept {
+        Dual<N> result = lhs;
+        return result *= rhs;
+    }
+
+    template<std::size_t N>
+    inline Dual<N> operator*(double lhs, const Dual<N>& rhs) noexcept {
+        Dual<N> result = rhs;
+        return result *= lhs;
+    }
+
+    template<std::size_t N>
+    inline Dual<N> operator/(const Dual<N>& lhs, double rhs) noexcept {
+        Dual<N> result = lhs;
+        return result /= rhs;
+    }
+
+    template<std::size_t N>
+    inline Dual<N> sin(const Dual<N>& x) noexcept {
+        return x.chain(std::sin(x.value()), std::cos(x.value()));
+    }
+
+    template<std::size_t N>
+    inline Dual<N> cos(const Dual<N>& x) noexcept {
+        return x.chain(std::cos(x.value()), -std::sin(x.value()));
+    }
+
+    template<std::size_t N>
+    inline Dual<N> sqrt(const Dual<N>& x) noexcept {
+        const double root = std::sqrt(x.value());
+        return x.chain(root, 0.5 / root);
+    }
+
+    /**
+     * Dual rotation implementation.
+     */
+
+    namespace _dual_exec {
+
+        // Cosine and sine of angle sharing one evaluation of each, with the
+        // values exact for multiples of pi / 2 like the double rotations.
+        template<std::size_t N>
+        inline void _trig(const Dual<N>& angle, Dual<N>& c, Dual<N>& s) noexcept {
+            double cos_angle, sin_angle;
+            _rotation_exec::_axis_trig(angle.value(), cos_angle, sin_angle);
+            c = angle.chain(cos_angle, -sin_angle);
+            s = angle.chain(sin_angle, cos_angle);
+        }
+
+        template<std::size_t N>
+        inline void _euler_trig(const std::array<Dual<N>, 3>& angles, Dual<N>* cosines, Dual<N>* sines) noexcept {
+            for (std::size_t i = 0; i < 3; i++) {
+                _trig(angles[i], cosines[i], sines[i]);
+            }
+        }
+
+        // The six dual inputs of a Jacobian, the angles seeded as variables
+        // zero to two and the vector as three to five.
+        inline void _seed(const EulerAngles& angles, const Vector& vector, std::array<Dual<6>, 3>& dual_angles,
+                          std::array<Dual<6>, 3>& dual_vector)
+        {
+            for (std::size_t i = 0; i < 3; i++) {
+                dual_angles[i] = Dual<6>(angles[i], i);
+                dual_vector[i] = Dual<6>(vector[i], 3 + i);
+            }
+        }
+
+        // Splits the dual result into its value and the two Jacobians.
+        inline Vector _unpack(const std::array<Dual<6>, 3>& result, Matrix& angle_jacobian, Matrix& vector_jacobian) {
+            double* angle_data = angle_jacobian.data().data();
+            double* vector_data = vector_jacobian.data().data();
+            for (std::size_t row = 0; row < 3; row++) {
+                for (std::size_t col = 0; col < 3; col++) {
+                    angle_data[row * 3 + col] = result[row].derivative(col);
+                    vector_data[row * 3 + col] = result[row].derivative(3 + col);
+                }
+            }
+
+            return Vector(result[0].value(), result[1].value(), result[2].value());
+        }
+
+    }
+
+    template<typename axis, std::size_t N>
+    std::array<Dual<N>, 9> compute_rotation_matrix(const Dual<N>& angle) {
+        Dual<N> c, s;
+        _dual_exec::_trig(angle, c, s);
+
+        std::array<Dual<N>, 9> result;
+        _rotation_exec::_elementary_matrix<axis>(c, s, result.data());
+        return result;
+    }
+
+    template<typename rotation_order, typename rotation_type, std::size_t N>
+    std::array<Dual<N>, 9> compute_rotation_matrix(const std::array<Dual<N>, 3>& angles) {
+        Dual<N> cosines[3], sines[3];
+        _dual_exec::_euler_trig(angles, cosines, sines);
+
+        std::array<Dual<N>, 9> result;
+        _EulerAngleDelegate<rotation_order, rotation_type>::derive_matrix(cosines, sines, result.data());
+        return result;
+    }
+
+    template<typename axis, std::size_t N>
+    std::array<Dual<N>, 3> rotate_from(const Dual<N>& angle, const std::array<Dual<N>, 3>& vector) {
+        Dual<N> c, s;
+        _dual_exec::_trig(angle, c, s);
+
+        std::array<Dual<N>, 3> result = vector;
+        _rotation_exec::_rotate_elementary_from<axis>(c, s, result.data());
+        return result;
+    }
+
+    template<typename axis, std::size_t N>
+    std::array<Dual<N>, 3> rotate_to(const Dual<N>& angle, const std::array<Dual<N>, 3>& vector) {
+        Dual<N> c, s;
+        _dual_exec::_trig(angle, c, s);
+
+        std::array<Dual<N>, 3> result = vector;
+        _rotation_exec::_rotate_elementary_to<axis>(c, s, result.data());
+        return result;
+    }
+
+    template<typename rotation_order, typename rotation_type, std::size_t N>
+    std::array<Dual<N>, 3> rotate_from(const std::array<Dual<N>, 3>& angles, const std::array<Dual<N>, 3>& vector) {
+        Dual<N> cosines[3], sines[3];
+        _dual_exec::_euler_trig(angles, cosines, sines);
+
+        std::array<Dual<N>, 3> result = vector;
+        _EulerAngleDelegate<rotation_order, rotation_type>::rotate_from(cosines, sines, result.data());
+        return result;
+    }
+
+    template<typename rotation_order, typename rotation_type, std::size_t N>
+    std::array<Dual<N>, 3> rotate_to(const std::array<Dual<N>, 3>& angles, const std::array<Dual<N>, 3>& vector) {
+        Dual<N> cosines[3], sines[3];
+        _dual_exec::_euler_trig(angles, cosines, sines);
+
+        std::array<Dual<N>, 3> result = vector;
+        _EulerAngleDelegate<rotation_order, rotation_type>::rotate_to(cosines, sines, result.data());
+        return result;
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    Vector rotate_from_jacobian(const EulerAngles& angles, const Vector& vector, Matrix& angle_jacobian,
+                                Matrix& vector_jacobian)
+    {
+        std::array<Dual<6>, 3> dual_angles, dual_vector;
+        _dual_exec::_seed(angles, vector, dual_angles, dual_vector);
+
+        return _dual_exec::_unpack(rotate_from<rotation_order, rotation_type>(dual_angles, dual_vector),
+                                   angle_jacobian, vector_jacobian);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    Vector rotate_to_jacobian(const EulerAngles& angles, const Vector& vector, Matrix& angle_jacobian,
+                              Matrix& vector_jacobian)
+    {
+        std::array<Dual<6>, 3> dual_angles, dual_vector;
+        _dual_exec::_seed(angles, vector, dual_angles, dual_vector);
+
+        return _dual_exec::_unpack(rotate_to<rotation_order, rotation_type>(dual_angles, dual_vector),
+                                   angle_jacobian, vector_jacobian);
+    }
+
+}   // namespace evspace
+
+#endif // _EVSPACE_DUAL_H_
@@ -0,0 +1,485 @@
+#ifndef _EVSPACE_DYNAMIC_REFERENCE_FRAME_H_
+#define _EVSPACE_DYNAMIC_REFERENCE_FRAME_H_
+
+#include <angles.hpp>
+#include <matrix.hpp>
+#include <vector.hpp>
+#include <vector_array.hpp>
+#include <rotation.hpp>
+#include <sincos.hpp>
+#include <reference_frame_array.hpp>
+#include <array>        // std::array
+#include <cstddef>      // std::size_t
+#include <cstring>      // std::memcpy
+#include <stdexcept>    // std::out_of_range
+#include <tuple>        // std::tuple, std::tuple_element_t
+#include <type_traits>  // std::conditional_t
+#include <utility>      // std::index_sequence, std::make_index_sequence
+#include <vector>       // std::vector
+
+namespace evspace {
+
+    /**
+     * Runtime identifiers of the compile time rotation orders and types.
+     */
+
+    enum class RotationOrderId {
+        XYZ, XZY, YXZ, YZX, ZXY, ZYX,
+        XYX, XZX, YXY, YZY, ZXZ, ZYZ
+    };
+
+    enum class RotationTypeId {
+        Intrinsic,
+        Extrinsic
+    };
+
+    namespace _dynamic_frame_exec {
+
+        // Rotation orders in RotationOrderId order.
+        typedef std::tuple<XYZ, XZY, YXZ, YZX, ZXY, ZYX, XYX, XZX, YXY, YZY, ZXZ, ZYZ> _order_list;
+
+        constexpr std::size_t _combination_count = 2 * std::tuple_size<_order_list>::value;
+
+        // Index of an order and type combination in the dispatch tables.
+        constexpr std::size_t _combination_index(RotationOrderId order, RotationTypeId type) noexcept {
+            return 2 * static_cast<std::size_t>(order) + static_cast<std::size_t>(type);
+        }
+
+        // Whether order and type are each a named enumerator. Checking only
+        // the combined index would let an out of range type alias the next
+        // order's intrinsic combination.
+        constexpr bool _valid_combination(RotationOrderId order, RotationTypeId type) noexcept {
+            return static_cast<std::size_t>(order) < std::tuple_size_v<_order_list>
+                && (type == RotationTypeId::Intrinsic || type == RotationTypeId::Extrinsic);
+        }
+
+        template<std::size_t _index>
+        struct _combination {
+            typedef std::tuple_element_t<_index / 2, _order_list> order;
+            typedef std::conditional_t<_index % 2 == 0, IntrinsicRotation, ExtrinsicRotation> type;
+        };
+
+        template<typename rotation_order, std::size_t _index = 0>
+        constexpr RotationOrderId _order_id() noexcept {
+            if constexpr (std::is_same_v<rotation_order, std::tuple_element_t<_index, _order_list>>) {
+                return static_cast<RotationOrderId>(_index);
+            }
+            else {
+                return _order_id<rotation_order, _index + 1>();
+            }
+        }
+
+        template<typename rotation_type>
+        constexpr RotationTypeId _type_id() noexcept {
+            return std::is_same_v<rotation_type, ExtrinsicRotation> ? RotationTypeId::Extrinsic
+                                                                    : RotationTypeId::Intrinsic;
+        }
+
+        // Derives the row-major matrix of a single set of angles.
+        typedef void (*_derive_function)(const double*, double*);
+        // Derives the matrices of count sets of angles stored as planes.
+        typedef void (*_derive_planes_function)(const double*, const double*, const double*,
+                                                std::size_t, double* const*);
+
+        template<std::size_t _index>
+        void _derive_entry(const double* angles, double* matrix) {
+            double cosines[3], sines[3];
+            sincos(angles[0], sines[0], cosines[0]);
+            sincos(angles[1], sines[1], cosines[1]);
+            sincos(angles[2], sines[2], cosines[2]);
+            _EulerAngleDelegate<typename _combination<_index>::order, typename _combination<_index>::type>
+                ::derive_matrix(cosines, sines, matrix);
+        }
+
+        template<std::size_t _index>
+        void _derive_planes_entry(const double* alpha, const double* beta, const double* gamma,
+                                  std::size_t count, double* const* planes)
+        {
+            _rotation_exec::_derive_matrix_planes<typename _combination<_index>::order,
+                                                  typename _combination<_index>::type>(
+                alpha, beta, gamma, count, planes);
+        }
+
+        template<std::size_t... _indices>
+        constexpr std::array<_derive_function, sizeof...(_indices)>
+        _make_derive_table(std::index_sequence<_indices...>) noexcept {
+            return { { &_derive_entry<_indices>... } };
+        }
+
+        template<std::size_t... _indices>
+        constexpr std::array<_derive_planes_function, sizeof...(_indices)>
+        _make_derive_planes_table(std::index_sequence<_indices...>) noexcept {
+            return { { &_derive_planes_entry<_indices>... } };
+        }
+
+        // Jump tables to the kernels specialized for each combination,
+        // indexed by _combination_index.
+        inline constexpr std::array<_derive_function, _combination_count> _derive_table
+            = _make_derive_table(std::make_index_sequence<_combination_count>{});
+        inline constexpr std::array<_derive_planes_function, _combination_count> _derive_planes_table
+            = _make_derive_planes_table(std::make_index_sequence<_combination_count>{});
+
+        // Applies a row-major matrix and offset to a single vector through
+        // the Matrix product kernels, so the results match ReferenceFrame's
+        // bit for bit.
+        inline Vector _rotate_from_exec(const double* m, const double* o, const Vector& vector) {
+            Vector result;
+            double* r = result.data().data();
+            _matrix_exec::_multiply_vector(m, vector.data().data(), r);
+            r[0] += o[0];
+            r[1] += o[1];
+            r[2] += o[2];
+            return result;
+        }
+
+        inline Vector _rotate_to_exec(const double* m, const double* o, const Vector& vector) {
+            const double* v = vector.data().data();
+            const double d[3] = { v[0] - o[0], v[1] - o[1], v[2] - o[2] };
+            Vector result;
+            _matrix_exec::_vector_multiply(d, m, result.data().data());
+            return result;
+        }
+
+    }
+
+    // Reference frame whose rotation order and type are chosen at runtime,
+    // for frames read from configuration rather than known at compile time.
+    // The rotation matrix is derived through a jump table to the kernel
+    // specialized for the order and type, once each time the angles change.
+    // Rotations use the stored matrix, so single and batch rotations cost
+    // the same as a ReferenceFrame and no per vector dispatch is made.
+    class DynamicReferenceFrame {
+    private:
+        RotationOrderId m_order;
+        RotationTypeId m_type;
+        double m_angles[3];
+        double m_offset[3];
+        double m_matrix[9];
+
+        void update_matrix() noexcept;
+
+    public:
+        DynamicReferenceFrame() = delete;
+        DynamicReferenceFrame(RotationOrderId, RotationTypeId, const EulerAngles&, const Vector & = _zero_vector);
+        template<typename rotation_order, typename rotation_type, typename offset_type>
+        explicit DynamicReferenceFrame(const ReferenceFrame<rotation_order, rotation_type, offset_type>&);
+
+        RotationOrderId get_order() const noexcept;
+        RotationTypeId get_type() const noexcept;
+        EulerAngles get_angles() const;
+        Vector get_offset() const;
+        Matrix get_matrix() const;
+        void set_angles(std::size_t, double);
+        void set_angles(const EulerAngles&);
+        void set_offset(const Vector&);
+
+        Vector rotate_to(const Vector&) const;
+        Vector rotate_to(const DynamicReferenceFrame&, const Vector&) const;
+        Vector rotate_from(const Vector&) const;
+        Vector rotate_from(const DynamicReferenceFrame&, const Vector&) const;
+
+        // Batch rotations apply the stored matrix to every vector. The
+        // output array is resized to match the input and may be the input
+        // array.
+        void rotate_to(const VectorArray&, VectorArray&) const;
+        void rotate_from(const VectorArray&, VectorArray&) const;
+
+        friend class DynamicReferenceFrameArray;
+    };
+
+    // Heterogeneous collection of DynamicReferenceFrames. Frames are stored
+    // in one structure of arrays group per order and type combination, so
+    // update_all() makes a single dispatch per group and derives every
+    // matrix of the group in a vectorized pass, as ReferenceFrameArray does.
+    //
+    // Frames are addressed by the index returned from push_back, which is
+    // the insertion order. Setting a frame's angles re-derives its matrix,
+    // so every accessor sees the same frame.
+    class DynamicReferenceFrameArray {
+    private:
+        struct Group {
+            std::vector<double> angles[3];
+            std::vector<double> offsets[3];
+            std::vector<double> matrices[9];
+        };
+
+        struct Location {
+            std::size_t group;
+            std::size_t index;
+        };
+
+        Group m_groups[_dynamic_frame_exec::_combination_count];
+        std::vector<Location> m_locations;
+
+        const Location& locate(std::size_t) const;
+        std::size_t append(std::size_t, const double*, const double*, const double*);
+
+    public:
+        DynamicReferenceFrameArray() = default;
+
+        std::size_t size() const noexcept;
+        // Number of frames with the rotation order and type.
+        std::size_t group_size(RotationOrderId, RotationTypeId) const noexcept;
+
+        // Appends a frame and returns its index.
+        std::size_t push_back(const DynamicReferenceFrame&);
+        std::size_t push_back(RotationOrderId, RotationTypeId, const EulerAngles&, const Vector & = _zero_vector);
+
+        // Copies the frame at index.
+        DynamicReferenceFrame get(std::size_t) const;
+        EulerAngles get_angles(std::size_t) const;
+        Vector get_offset(std::size_t) const;
+        Matrix get_matrix(std::size_t) const;
+        // Sets the angles of the frame at index and re-derives its matrix
+        // with a single dispatch.
+        void set_angles(std::size_t, const EulerAngles&);
+        void set_offset(std::size_t, const Vector&);
+
+        // Recomputes the rotation matrix of every frame from its angles,
+        // with one dispatch and a vectorized pass per group.
+        void update_all();
+
+        Vector rotate_to(std::size_t, const Vector&) const;
+        Vector rotate_from(std::size_t, const Vector&) const;
+    };
+
+    /**
+     * DynamicReferenceFrame implementations.
+     */
+
+    inline DynamicReferenceFrame::DynamicReferenceFrame(RotationOrderId order, RotationTypeId type,
+                                                        const EulerAngles& angles, const Vector& offset)
+        : m_order(order), m_type(type), m_angles{ angles[0], angles[1], angles[2] },
+          m_offset{ offset[0], offset[1], offset[2] }, m_matrix()
+    {
+        if (!_dynamic_frame_exec::_valid_combination(order, type)) {
+            throw std::out_of_range("Invalid rotation order or type");
+        }
+
+        this->update_matrix();
+    }
+
+    template<typename rotation_order, typename rotation_type, typename offset_type>
+    DynamicReferenceFrame::DynamicReferenceFrame(const ReferenceFrame<rotation_order, rotation_type, offset_type>& frame)
+        : DynamicReferenceFrame(_dynamic_frame_exec::_order_id<rotation_order>(),
+                                _dynamic_frame_exec::_type_id<rotation_type>(),
+                                frame.get_angles(), frame.get_offset()) { }
+
+    inline void DynamicReferenceFrame::update_matrix() noexcept {
+        _dynamic_frame_exec::_derive_table[_dynamic_frame_exec::_combination_index(this->m_order, this->m_type)](
+            this->m_angles, this->m_matrix);
+    }
+
+    inline RotationOrderId DynamicReferenceFrame::get_order() const noexcept {
+        return this->m_order;
+    }
+
+    inline RotationTypeId DynamicReferenceFrame::get_type() const noexcept {
+        return this->m_type;
+    }
+
+    inline EulerAngles DynamicReferenceFrame::get_angles() const {
+        return EulerAngles(this->m_angles[0], this->m_angles[1], this->m_angles[2]);
+    }
+
+    inline Vector DynamicReferenceFrame::get_offset() const {
+        return Vector(this->m_offset[0], this->m_offset[1], this->m_offset[2]);
+    }
+
+    inline Matrix DynamicReferenceFrame::get_matrix() const {
+        Matrix result;
+        std::memcpy(result.data().data(), this->m_matrix, sizeof(this->m_matrix));
+        return result;
+    }
+
+    inline void DynamicReferenceFrame::set_angles(std::size_t index, double value) {
+        if (index > 2) {
+            throw std::out_of_range("Angle index out of range");
+        }
+
+        this->m_angles[index] = value;
+        this->update_matrix();
+    }
+
+    inline void DynamicReferenceFrame::set_angles(const EulerAngles& angles) {
+        this->m_angles[0] = angles[0];
+        this->m_angles[1] = angles[1];
+        this->m_angles[2] = angles[2];
+        this->update_matrix();
+    }
+
+    inline void DynamicReferenceFrame::set_offset(const Vector& offset) {
+        this->m_offset[0] = offset[0];
+        this->m_offset[1] = offset[1];
+        this->m_offset[2] = offset[2];
+    }
+
+    inline Vector DynamicReferenceFrame::rotate_to(const Vector& vector) const {
+        return _dynamic_frame_exec::_rotate_to_exec(this->m_matrix, this->m_offset, vector);
+    }
+
+    inline Vector DynamicReferenceFrame::rotate_from(const Vector& vector) const {
+        return _dynamic_frame_exec::_rotate_from_exec(this->m_matrix, this->m_offset, vector);
+    }
+
+    inline Vector DynamicReferenceFrame::rotate_to(const DynamicReferenceFrame& frame, const Vector& vector) const {
+        return frame.rotate_to(this->rotate_from(vector));
+    }
+
+    inline Vector DynamicReferenceFrame::rotate_from(const DynamicReferenceFrame& frame, const Vector& vector) const {
+        return this->rotate_to(frame.rotate_from(vector));
+    }
+
+    inline void DynamicReferenceFrame::rotate_to(const VectorArray& vectors, VectorArray& output) const {
+        _rotation_exec::_rotate_batch_exec(this->m_matrix, this->m_offset, false, vectors, output);
+    }
+
+    inline void DynamicReferenceFrame::rotate_from(const VectorArray& vectors, VectorArray& output) const {
+        _rotation_exec::_rotate_batch_exec(this->m_matrix, this->m_offset, true, vectors, output);
+    }
+
+    /**
+     * DynamicReferenceFrameArray implementations.
+     */
+
+    inline const DynamicReferenceFrameArray::Location&
+    DynamicReferenceFrameArray::locate(std::size_t index) const {
+        if (index >= this->m_locations.size()) {
+            throw std::out_of_range("DynamicReferenceFrameArray index out of range");
+        }
+
+        return this->m_locations[index];
+    }
+
+    inline std::size_t DynamicReferenceFrameArray::append(std::size_t group_index, const double* angles,
+                                                          const double* offset, const double* matrix)
+    {
+        Group& group = this->m_groups[group_index];
+        for (std::size_t i = 0; i < 3; i++) {
+            group.angles[i].push_back(angles[i]);
+            group.offsets[i].push_back(offset[i]);
+        }
+        for (std::size_t component = 0; component < 9; component++) {
+            group.matrices[component].push_back(matrix[component]);
+        }
+
+        this->m_locations.push_back(Location{ group_index, group.angles[0].size() - 1 });
+        return this->m_locations.size() - 1;
+    }
+
+    inline std::size_t DynamicReferenceFrameArray::size() const noexcept {
+        return this->m_locations.size();
+    }
+
+    inline std::size_t DynamicReferenceFrameArray::group_size(RotationOrderId order, RotationTypeId type) const noexcept {
+        if (!_dynamic_frame_exec::_valid_combination(order, type)) {
+            return 0;
+        }
+
+        return this->m_groups[_dynamic_frame_exec::_combination_index(order, type)].angles[0].size();
+    }
+
+    inline std::size_t DynamicReferenceFrameArray::push_back(const DynamicReferenceFrame& frame) {
+        return this->append(_dynamic_frame_exec::_combination_index(frame.m_order, frame.m_type),
+                            frame.m_angles, frame.m_offset, frame.m_matrix);
+    }
+
+    inline std::size_t DynamicReferenceFrameArray::push_back(RotationOrderId order, RotationTypeId type,
+                                                             const EulerAngles& angles, const Vector& offset)
+    {
+        return this->push_back(DynamicReferenceFrame(order, type, angles, offset));
+    }
+
+    inline DynamicReferenceFrame DynamicReferenceFrameArray::get(std::size_t index) const {
+        const Location& location = this->locate(index);
+
+        return DynamicReferenceFrame(
+            static_cast<RotationOrderId>(location.group / 2),
+            static_cast<RotationTypeId>(location.group % 2),
+            this->get_angles(index), this->get_offset(index)
+        );
+    }
+
+    inline EulerAngles DynamicReferenceFrameArray::get_angles(std::size_t index) const {
+        const Location& location = this->locate(index);
+        const Group& group = this->m_groups[location.group];
+
+        return EulerAngles(group.angles[0][location.index], group.angles[1][location.index],
+                           group.angles[2][location.index]);
+    }
+
+    inline Vector DynamicReferenceFrameArray::get_offset(std::size_t index) const {
+        const Location& location = this->locate(index);
+        const Group& group = this->m_groups[location.group];
+
+        return Vector(group.offsets[0][location.index], group.offsets[1][location.index],
+                      group.offsets[2][location.index]);
+    }
+
+    inline Matrix DynamicReferenceFrameArray::get_matrix(std::size_t index) const {
+        const Location& location = this->locate(index);
+        const Group& group = this->m_groups[location.group];
+
+        Matrix result;
+        double* data = result.data().data();
+        for (std::size_t component = 0; component < 9; component++) {
+            data[component] = group.matrices[component][location.index];
+        }
+
+        return result;
+    }
+
+    inline void DynamicReferenceFrameArray::set_angles(std::size_t index, const EulerAngles& angles) {
+        const Location& location = this->locate(index);
+        Group& group = this->m_groups[location.group];
+
+        double frame_angles[3], matrix[9];
+        for (std::size_t i = 0; i < 3; i++) {
+            frame_angles[i] = angles[i];
+            group.angles[i][location.index] = angles[i];
+        }
+
+        _dynamic_frame_exec::_derive_table[location.group](frame_angles, matrix);
+        for (std::size_t component = 0; component < 9; component++) {
+            group.matrices[component][location.index] = matrix[component];
+        }
+    }
+
+    inline void DynamicReferenceFrameArray::set_offset(std::size_t index, const Vector& offset) {
+        const Location& location = this->locate(index);
+        Group& group = this->m_groups[location.group];
+
+        for (std::size_t i = 0; i < 3; i++) {
+            group.offsets[i][location.index] = offset[i];
+        }
+    }
+
+    inline void DynamicReferenceFrameArray::update_all() {
+        for (std::size_t group_index = 0; group_index < _dynamic_frame_exec::_combination_count; group_index++) {
+            Group& group = this->m_groups[group_index];
+            const std::size_t count = group.angles[0].size();
+            if (count == 0) {
+                continue;
+            }
+
+            double* planes[9];
+            for (std::size_t component = 0; component < 9; component++) {
+                planes[component] = group.matrices[component].data();
+            }
+
+            _dynamic_frame_exec::_derive_planes_table[group_index](
+                group.angles[0].data(), group.angles[1].data(), group.angles[2].data(), count, planes);
+        }
+    }
+
+    inline Vector DynamicReferenceFrameArray::rotate_to(std::size_t index, const Vector& vector) const {
+        return _rotation_exec::_rotate_to_exec(this->get_matrix(index), vector, this->get_offset(index));
+    }
+
+    inline Vector DynamicReferenceFrameArray::rotate_from(std::size_t index, const Vector& vector) const {
+        return _rotation_exec::_rotate_from_exec(this->get_matrix(index), vector, this->get_offset(index));
+    }
+
+}   // namespace evspace
+
+#endif // _EVSPACE_DYNAMIC_REFERENCE_FRAME_H_
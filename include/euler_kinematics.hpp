@@ -0,0 +1,299 @@
+#ifndef _EVSPACE_EULER_KINEMATICS_H_
+#define _EVSPACE_EULER_KINEMATICS_H_
+
+#include <evspace_common.hpp>
+#include <angles.hpp>
+#include <matrix.hpp>
+#include <vector.hpp>
+#include <matrix_array.hpp>
+#include <vector_array.hpp>
+#include <matrix_array_solve.hpp>
+#include <rotation.hpp>
+#include <rotation_partials.hpp>
+#include <cmath>        // std::fabs, std::isfinite
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint8_t
+#include <stdexcept>    // std::out_of_range, std::runtime_error
+
+namespace evspace {
+
+    /**
+     * Kinematics of Euler angles. Each angle rate turns the frame about
+     * that angle's axis, so the body frame angular velocity is
+     *
+     *      omega = M * (alpha', beta', gamma'),
+     *
+     * the columns of M being the three axes seen from the body frame.
+     * Angle rates are carried in a Vector in the same order as the angles.
+     * The determinant of M is +-cos(beta) for Tait-Bryan orders and
+     * +-sin(beta) for proper Euler orders, so M can't be inverted at gimbal
+     * lock, where the first and last axes line up and only their sum of
+     * rates is defined. The angular velocity in the reference frame is
+     * rotate_from(angles, omega).
+     */
+
+    // Default smallest magnitude of the kinematic determinant for the angle
+    // rates to be computed, about 1e-10 radians from gimbal lock.
+    constexpr double DEFAULT_GIMBAL_TOLERANCE = 1e-10;
+
+    // The determinant of the kinematic matrix of angles, zero at gimbal lock.
+    template<typename rotation_order, typename rotation_type = IntrinsicRotation>
+    double kinematic_determinant(const EulerAngles&);
+    // The matrix mapping angle rates to the body frame angular velocity.
+    template<typename rotation_order, typename rotation_type = IntrinsicRotation>
+    Matrix angular_velocity_matrix(const EulerAngles&);
+    // The matrix mapping the body frame angular velocity to angle rates,
+    // the inverse of the above. Throws std::runtime_error if the magnitude
+    // of the kinematic determinant is not above tolerance.
+    template<typename rotation_order, typename rotation_type = IntrinsicRotation>
+    Matrix euler_rate_matrix(const EulerAngles&, double tolerance = DEFAULT_GIMBAL_TOLERANCE);
+
+    // The body frame angular velocity of the angle rates.
+    template<typename rotation_order, typename rotation_type = IntrinsicRotation>
+    Vector angular_velocity(const EulerAngles&, const Vector&);
+    // The angle rates of the body frame angular velocity, throwing as
+    // euler_rate_matrix() does.
+    template<typename rotation_order, typename rotation_type = IntrinsicRotation>
+    Vector euler_rates(const EulerAngles&, const Vector&, double tolerance = DEFAULT_GIMBAL_TOLERANCE);
+
+    // Batch rotation matrices and angular velocity matrices of the angle
+    // sets in the alpha, beta and gamma spans, from the same sines and
+    // cosines, resizing the outputs to match. The spans must be the same
+    // size.
+    template<typename rotation_order, typename rotation_type = IntrinsicRotation>
+    void angular_velocity_matrix(span_t<const double>, span_t<const double>, span_t<const double>,
+                                 MatrixArray&, MatrixArray&);
+    // Batch rotation matrices and euler rate matrices, as above, writing a
+    // MatrixStatus for each to status and returning the number which are
+    // MATRIX_SINGULAR. An angle set within tolerance of gimbal lock is
+    // MATRIX_SINGULAR and has a zero euler rate matrix.
+    template<typename rotation_order, typename rotation_type = IntrinsicRotation>
+    std::size_t euler_rate_matrix(span_t<const double>, span_t<const double>, span_t<const double>,
+                                  MatrixArray&, MatrixArray&, span_t<std::uint8_t>,
+                                  double tolerance = DEFAULT_GIMBAL_TOLERANCE);
+    // Batch angle rates of each body frame angular velocity at its angle
+    // set, resizing the output to match. Statuses and the return value are
+    // as above, with zero rates for MATRIX_SINGULAR elements.
+    template<typename rotation_order, typename rotation_type = IntrinsicRotation>
+    std::size_t euler_rates(span_t<const double>, span_t<const double>, span_t<const double>,
+                            const VectorArray&, VectorArray&, span_t<std::uint8_t>,
+                            double tolerance = DEFAULT_GIMBAL_TOLERANCE);
+
+    namespace _kinematics_exec {
+
+        // The rotation and the row-major angular velocity matrix, whose
+        // column n is R^T times the reference frame axis of angle n.
+        template<typename rotation_order, typename rotation_type>
+        inline void _angular_velocity_matrix(const double* cosines, const double* sines, double* rotation,
+                                             double* matrix) noexcept
+        {
+            double axes[9];
+            _EulerAngleDelegate<rotation_order, rotation_type>::derive_matrix(cosines, sines, rotation);
+            _partials_exec::_world_axes<rotation_order, rotation_type>(cosines, sines, rotation, axes);
+            for (std::size_t n = 0; n < 3; n++) {
+                const double* axis = axes + 3 * n;
+                for (std::size_t r = 0; r < 3; r++) {
+                    matrix[r * 3 + n] = rotation[r] * axis[0] + rotation[3 + r] * axis[1] + rotation[6 + r] * axis[2];
+                }
+            }
+        }
+
+        // The determinant of the angular velocity matrix and its inverse,
+        // whose rows are the cross products of its columns, b2 x b3, b3 x b1
+        // and b1 x b2, over the determinant. The inverse is left unscaled
+        // and the determinant returned for the caller to check.
+        inline double _cross_inverse(const double* matrix, double* inverse) noexcept {
+            const double columns[3][3] = {
+                { matrix[0], matrix[3], matrix[6] },
+                { matrix[1], matrix[4], matrix[7] },
+                { matrix[2], matrix[5], matrix[8] },
+            };
+            for (std::size_t n = 0; n < 3; n++) {
+                _partials_exec::_cross(columns[(n + 1) % 3], columns[(n + 2) % 3], inverse + 3 * n);
+            }
+
+            return columns[0][0] * inverse[0] + columns[0][1] * inverse[1] + columns[0][2] * inverse[2];
+        }
+
+        inline bool _is_singular(double determinant, double tolerance) noexcept {
+            return !(std::fabs(determinant) > tolerance) || !std::isfinite(determinant);
+        }
+
+        // The euler rate matrix of the angle set, false and left unscaled if
+        // the angle set is within tolerance of gimbal lock.
+        template<typename rotation_order, typename rotation_type>
+        inline bool _euler_rate_matrix(const double* cosines, const double* sines, double tolerance,
+                                       double* rotation, double* inverse) noexcept
+        {
+            double matrix[9];
+            _angular_velocity_matrix<rotation_order, rotation_type>(cosines, sines, rotation, matrix);
+            const double determinant = _cross_inverse(matrix, inverse);
+            if (_is_singular(determinant, tolerance)) {
+                return false;
+            }
+
+            const double scale = 1.0 / determinant;
+            for (std::size_t k = 0; k < 9; k++) {
+                inverse[k] *= scale;
+            }
+            return true;
+        }
+
+        inline void _check_status(std::size_t status, std::size_t count) {
+            if (status != count) {
+                throw std::out_of_range("status must be the same size as the angle spans");
+            }
+        }
+
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    double kinematic_determinant(const EulerAngles& angles) {
+        double cosines[3], sines[3], rotation[9], matrix[9], inverse[9];
+        _rotation_exec::_euler_angle_trig(angles, cosines, sines);
+        _kinematics_exec::_angular_velocity_matrix<rotation_order, rotation_type>(cosines, sines, rotation, matrix);
+
+        return _kinematics_exec::_cross_inverse(matrix, inverse);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    Matrix angular_velocity_matrix(const EulerAngles& angles) {
+        double cosines[3], sines[3], rotation[9], matrix[9];
+        _rotation_exec::_euler_angle_trig(angles, cosines, sines);
+        _kinematics_exec::_angular_velocity_matrix<rotation_order, rotation_type>(cosines, sines, rotation, matrix);
+
+        return Matrix(matrix);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    Matrix euler_rate_matrix(const EulerAngles& angles, double tolerance) {
+        double cosines[3], sines[3], rotation[9], inverse[9];
+        _rotation_exec::_euler_angle_trig(angles, cosines, sines);
+        if (!_kinematics_exec::_euler_rate_matrix<rotation_order, rotation_type>(cosines, sines, tolerance,
+                                                                                 rotation, inverse)) {
+            throw std::runtime_error("Euler angle rates are undefined at gimbal lock");
+        }
+
+        return Matrix(inverse);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    Vector angular_velocity(const EulerAngles& angles, const Vector& rates) {
+        double cosines[3], sines[3], rotation[9], matrix[9];
+        _rotation_exec::_euler_angle_trig(angles, cosines, sines);
+        _kinematics_exec::_angular_velocity_matrix<rotation_order, rotation_type>(cosines, sines, rotation, matrix);
+
+        const double* r = rates.data().data();
+        return Vector(matrix[0] * r[0] + matrix[1] * r[1] + matrix[2] * r[2],
+                      matrix[3] * r[0] + matrix[4] * r[1] + matrix[5] * r[2],
+                      matrix[6] * r[0] + matrix[7] * r[1] + matrix[8] * r[2]);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    Vector euler_rates(const EulerAngles& angles, const Vector& omega, double tolerance) {
+        double cosines[3], sines[3], rotation[9], inverse[9];
+        _rotation_exec::_euler_angle_trig(angles, cosines, sines);
+        if (!_kinematics_exec::_euler_rate_matrix<rotation_order, rotation_type>(cosines, sines, tolerance,
+                                                                                 rotation, inverse)) {
+            throw std::runtime_error("Euler angle rates are undefined at gimbal lock");
+        }
+
+        const double* w = omega.data().data();
+        return Vector(inverse[0] * w[0] + inverse[1] * w[1] + inverse[2] * w[2],
+                      inverse[3] * w[0] + inverse[4] * w[1] + inverse[5] * w[2],
+                      inverse[6] * w[0] + inverse[7] * w[1] + inverse[8] * w[2]);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    void angular_velocity_matrix(span_t<const double> alphas, span_t<const double> betas,
+                                 span_t<const double> gammas, MatrixArray& rotations, MatrixArray& matrices)
+    {
+        _partials_exec::_check_sizes(alphas.size(), betas.size(), gammas.size());
+        const std::size_t count = alphas.size();
+        rotations.resize(count);
+        matrices.resize(count);
+        double* planes[18];
+        for (std::size_t component = 0; component < 9; component++) {
+            planes[component] = rotations.plane(component / 3, component % 3);
+            planes[9 + component] = matrices.plane(component / 3, component % 3);
+        }
+
+        _partials_exec::_for_each_angle_set(alphas, betas, gammas,
+            [&](const double* c, const double* s, std::size_t index) {
+                double values[18];
+                _kinematics_exec::_angular_velocity_matrix<rotation_order, rotation_type>(c, s, values, values + 9);
+                for (std::size_t k = 0; k < 18; k++) {
+                    planes[k][index] = values[k];
+                }
+            });
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    std::size_t euler_rate_matrix(span_t<const double> alphas, span_t<const double> betas,
+                                  span_t<const double> gammas, MatrixArray& rotations, MatrixArray& matrices,
+                                  span_t<std::uint8_t> status, double tolerance)
+    {
+        _partials_exec::_check_sizes(alphas.size(), betas.size(), gammas.size());
+        const std::size_t count = alphas.size();
+        _kinematics_exec::_check_status(status.size(), count);
+        rotations.resize(count);
+        matrices.resize(count);
+        double* planes[18];
+        for (std::size_t component = 0; component < 9; component++) {
+            planes[component] = rotations.plane(component / 3, component % 3);
+            planes[9 + component] = matrices.plane(component / 3, component % 3);
+        }
+        std::uint8_t* flags = status.data();
+
+        _partials_exec::_for_each_angle_set(alphas, betas, gammas,
+            [&](const double* c, const double* s, std::size_t index) {
+                double values[18];
+                const bool valid = _kinematics_exec::_euler_rate_matrix<rotation_order, rotation_type>(
+                    c, s, tolerance, values, values + 9);
+                for (std::size_t k = 0; k < 9; k++) {
+                    planes[k][index] = values[k];
+                    planes[9 + k][index] = valid ? values[9 + k] : 0.0;
+                }
+                flags[index] = valid ? MATRIX_OK : MATRIX_SINGULAR;
+            });
+
+        return _matrix_solve_exec::_count_flagged(flags, count);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    std::size_t euler_rates(span_t<const double> alphas, span_t<const double> betas, span_t<const double> gammas,
+                            const VectorArray& omegas, VectorArray& rates, span_t<std::uint8_t> status,
+                            double tolerance)
+    {
+        _partials_exec::_check_sizes(alphas.size(), betas.size(), gammas.size());
+        const std::size_t count = alphas.size();
+        if (omegas.size() != count) {
+            throw std::out_of_range("angular velocities must be the same size as the angle spans");
+        }
+        _kinematics_exec::_check_status(status.size(), count);
+
+        rates.resize(count);
+        const double* input[3] = { omegas.x(), omegas.y(), omegas.z() };
+        double* output[3] = { rates.x(), rates.y(), rates.z() };
+        std::uint8_t* flags = status.data();
+
+        _partials_exec::_for_each_angle_set(alphas, betas, gammas,
+            [&](const double* c, const double* s, std::size_t index) {
+                double rotation[9], inverse[9];
+                const bool valid = _kinematics_exec::_euler_rate_matrix<rotation_order, rotation_type>(
+                    c, s, tolerance, rotation, inverse);
+                const double omega[3] = { input[0][index], input[1][index], input[2][index] };
+                for (std::size_t r = 0; r < 3; r++) {
+                    output[r][index] = valid ? inverse[r * 3] * omega[0] + inverse[r * 3 + 1] * omega[1]
+                                               + inverse[r * 3 + 2] * omega[2]
+                                             : 0.0;
+                }
+                flags[index] = valid ? MATRIX_OK : MATRIX_SINGULAR;
+            });
+
+        return _matrix_solve_exec::_count_flagged(flags, count);
+    }
+
+}   // namespace evspace
+
+#endif // _EVSPACE_EULER_KINEMATICS_H_
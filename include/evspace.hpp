@@ -6,6 +6,32 @@
 #include <angles.hpp>
 #include <vector.hpp>
 #include <matrix.hpp>
+#include <vector_array.hpp>
+#include <matrix_array.hpp>
+#include <matrix_array_solve.hpp>
+#include <sincos.hpp>
 #include <rotation.hpp>
+#include <single_axis_rotation.hpp>
+#include <quaternion.hpp>
+#include <quaternion_array.hpp>
+#include <compact_reference_frame.hpp>
+#include <reference_frame_array.hpp>
+#include <dynamic_reference_frame.hpp>
+#include <symmetric_matrix.hpp>
+#include <symmetric_matrix_array.hpp>
+#include <symmetric_eigen.hpp>
+#include <matrix_decomposition.hpp>
+#include <attitude_determination.hpp>
+#include <dual.hpp>
+#include <rotation_partials.hpp>
+#include <euler_kinematics.hpp>
+#include <attitude_integrator.hpp>
+#include <rotation_exponential.hpp>
+#include <random_rotation.hpp>
+#include <dispersion.hpp>
+#include <angle_sweep.hpp>
+#include <rotation_cache.hpp>
+#include <orientation_table.hpp>
+#include <small_angle.hpp>
 
 #endif // _EVSPACE_H_
\ No newline at end of file
@@ -24,6 +24,19 @@ using span_t = gsl::span<T>;
 
 #define _EVSPACE_DEFAULT_ULP_MAXIMUM 10
 
+// Batch kernels split their chunk loops across threads with OpenMP when
+// the compiler has it enabled, see the ENABLE_OPENMP cmake option. The
+// condition keeps small batches on the calling thread.
+#define _EVSPACE_PRAGMA(x) _Pragma(#x)
+#if defined(_OPENMP)
+#define _EVSPACE_PARALLEL_FOR_IF(condition) _EVSPACE_PRAGMA(omp parallel for schedule(static) if(condition))
+#else
+#define _EVSPACE_PARALLEL_FOR_IF(condition)
+#endif
+
+// Batches with fewer items than this run on the calling thread.
+#define _EVSPACE_PARALLEL_MINIMUM 8192
+
 }
 
 #endif // _EVSPACE_COMMON_H_
\ No newline at end of file
@@ -10,6 +10,12 @@
 #include <iterator>     // std::data
 #include <ostream>      // std::ostream
 #include <type_traits>
+#include <cmath>        // std::fma
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define EVSPACE_MATRIX_AVX2
+#endif
 
 #define MATRIX_ARRAY_LENGTH     9
 #define MATRIX_ROW_LENGTH       3
@@ -25,6 +31,109 @@ std::ostream& operator<<(std::ostream&, const evspace::Matrix&);
 
 namespace evspace {
 
+    /**
+     * Single 3x3 product kernels on raw row-major buffers. Every output
+     * component is the fused chain fma(a2, b2, fma(a1, b1, a0 * b0)), so
+     * the AVX2/FMA and scalar versions give bit identical results. The
+     * AVX2 versions are used when the compiler targets AVX2 and FMA, see
+     * the ENABLE_AVX2 cmake option.
+     */
+    namespace _matrix_exec {
+
+        // out = a * b with the scalar fallback. out may alias a but not b.
+        inline void _multiply_scalar(const double* a, const double* b, double* out) noexcept {
+            for (int i = 0; i < 3; i++) {
+                // read the whole row of a before any of out's row is written
+                const double a0 = a[i * 3], a1 = a[i * 3 + 1], a2 = a[i * 3 + 2];
+                double row[3];
+                for (int j = 0; j < 3; j++) {
+                    row[j] = std::fma(a2, b[6 + j], std::fma(a1, b[3 + j], a0 * b[j]));
+                }
+                out[i * 3] = row[0];
+                out[i * 3 + 1] = row[1];
+                out[i * 3 + 2] = row[2];
+            }
+        }
+
+        // out = m * v, out may alias v. There is no AVX2 version, the
+        // columns of m would have to be gathered into registers first, which
+        // measured slower than the three scalar dot products.
+        inline void _multiply_vector(const double* m, const double* v, double* out) noexcept {
+            const double v0 = v[0], v1 = v[1], v2 = v[2];
+            for (int i = 0; i < 3; i++) {
+                out[i] = std::fma(m[i * 3 + 2], v2, std::fma(m[i * 3 + 1], v1, m[i * 3] * v0));
+            }
+        }
+
+        // out = v * m, the transpose product, with the scalar fallback. out
+        // may alias v.
+        inline void _vector_multiply_scalar(const double* v, const double* m, double* out) noexcept {
+            const double v0 = v[0], v1 = v[1], v2 = v[2];
+            for (int j = 0; j < 3; j++) {
+                out[j] = std::fma(v2, m[6 + j], std::fma(v1, m[3 + j], v0 * m[j]));
+            }
+        }
+
+#if defined(EVSPACE_MATRIX_AVX2)
+
+        // Lanes 0 through 2 of a 256 bit register hold one row. Rows are
+        // moved as a 128 bit pair and a scalar so nothing past the end of a
+        // buffer is touched; masked loads and stores would do the same but
+        // defeat store forwarding when a product feeds the next one.
+        inline __m256d _load_row(const double* row) noexcept {
+            return _mm256_insertf128_pd(_mm256_castpd128_pd256(_mm_loadu_pd(row)), _mm_load_sd(row + 2), 1);
+        }
+
+        inline void _store_row(double* row, __m256d value) noexcept {
+            _mm_storeu_pd(row, _mm256_castpd256_pd128(value));
+            _mm_store_sd(row + 2, _mm256_extractf128_pd(value, 1));
+        }
+
+        // Broadcast row formulation, row i of out is the sum of row k of b
+        // scaled by a[i][k]. The three rows of b stay in registers for all
+        // three output rows.
+        inline void _multiply_avx2(const double* a, const double* b, double* out) noexcept {
+            const __m256d b0 = _load_row(b);
+            const __m256d b1 = _load_row(b + 3);
+            const __m256d b2 = _load_row(b + 6);
+
+            for (int i = 0; i < 3; i++) {
+                __m256d row = _mm256_mul_pd(_mm256_broadcast_sd(a + i * 3), b0);
+                row = _mm256_fmadd_pd(_mm256_broadcast_sd(a + i * 3 + 1), b1, row);
+                row = _mm256_fmadd_pd(_mm256_broadcast_sd(a + i * 3 + 2), b2, row);
+                _store_row(out + i * 3, row);
+            }
+        }
+
+        // Broadcast row formulation of v * m.
+        inline void _vector_multiply_avx2(const double* v, const double* m, double* out) noexcept {
+            __m256d result = _mm256_mul_pd(_mm256_broadcast_sd(v), _load_row(m));
+            result = _mm256_fmadd_pd(_mm256_broadcast_sd(v + 1), _load_row(m + 3), result);
+            result = _mm256_fmadd_pd(_mm256_broadcast_sd(v + 2), _load_row(m + 6), result);
+            _store_row(out, result);
+        }
+
+#endif
+
+        // Dispatch to the AVX2/FMA kernels when the compiler targets them.
+        inline void _multiply(const double* a, const double* b, double* out) noexcept {
+#if defined(EVSPACE_MATRIX_AVX2)
+            _multiply_avx2(a, b, out);
+#else
+            _multiply_scalar(a, b, out);
+#endif
+        }
+
+        inline void _vector_multiply(const double* v, const double* m, double* out) noexcept {
+#if defined(EVSPACE_MATRIX_AVX2)
+            _vector_multiply_avx2(v, m, out);
+#else
+            _vector_multiply_scalar(v, m, out);
+#endif
+        }
+
+    }
+
     class Vector;
 
     class Matrix {
@@ -434,52 +543,28 @@ namespace evspace {
 
     inline Vector Matrix::operator*(const Vector& vec) const {
         Vector result;
-
-        for (int i = 0; i < MATRIX_ROW_LENGTH; i++) {
-            double sum = 0;
-            for (int j = 0; j < MATRIX_ROW_LENGTH; j++) {
-                sum = std::fma(MATRIX_ITEM_THIS(i, j), vec.m_data[j], sum);
-            }
-            result.m_data[i] = sum;
-        }
+        _matrix_exec::_multiply_vector(this->m_data, vec.m_data, result.m_data);
 
         return result;
     }
 
     inline Matrix Matrix::operator*(const Matrix& rhs) const {
         Matrix result;
-
-        for (int i = 0; i < MATRIX_ROW_LENGTH; i++) {
-            for (int j = 0; j < MATRIX_ROW_LENGTH; j++) {
-                double sum = 0;
-                for (int k = 0; k < MATRIX_ROW_LENGTH; k++) {
-                    sum = std::fma(MATRIX_ITEM_THIS(i, k), MATRIX_ITEM(rhs, k, j), sum);
-                }
-                MATRIX_ITEM(result, i, j) = sum;
-            }
-        }
+        _matrix_exec::_multiply(this->m_data, rhs.m_data, result.m_data);
 
         return result;
     }
 
     inline Matrix& Matrix::operator*=(const Matrix& rhs) noexcept {
+        // the kernels may write over the left operand, only a product with
+        // itself needs a copy of the right operand
         if (&rhs == this) {
-            Matrix tmp(rhs);
-            return (*this *= tmp);
+            double tmp[9];
+            std::memcpy(tmp, rhs.m_data, MATRIX_BYTE_SIZE);
+            _matrix_exec::_multiply(this->m_data, tmp, this->m_data);
         }
-        
-        double tmp[9];
-        std::memcpy(tmp, this->m_data, MATRIX_BYTE_SIZE);
-
-        for (int i = 0; i < MATRIX_ROW_LENGTH; i++) {
-            for (int j = 0; j < MATRIX_ROW_LENGTH; j++) {
-                double sum = 0;
-                for (int k = 0; k < MATRIX_ROW_LENGTH; k++) {
-                    sum = std::fma(tmp[i * MATRIX_ROW_LENGTH + k],
-                                   MATRIX_ITEM(rhs, k, j), sum);
-                }
-                MATRIX_ITEM_THIS(i, j) = sum;
-            }
+        else {
+            _matrix_exec::_multiply(this->m_data, rhs.m_data, this->m_data);
         }
 
         return *this;
@@ -590,7 +675,7 @@ namespace evspace {
         result.m_data[1] = -(MATRIX_ITEM_THIS(1, 0) * MATRIX_ITEM_THIS(2, 2) -
                              MATRIX_ITEM_THIS(1, 2) * MATRIX_ITEM_THIS(2, 0)) / det;
         result.m_data[2] = (MATRIX_ITEM_THIS(1, 0) * MATRIX_ITEM_THIS(2, 1) -
-                            MATRIX_ITEM_THIS(1, 2) * MATRIX_ITEM_THIS(2, 0)) / det;
+                            MATRIX_ITEM_THIS(1, 1) * MATRIX_ITEM_THIS(2, 0)) / det;
         result.m_data[3] = -(MATRIX_ITEM_THIS(0, 1) * MATRIX_ITEM_THIS(2, 2) -
                              MATRIX_ITEM_THIS(0, 2) * MATRIX_ITEM_THIS(2, 1)) / det;
         result.m_data[4] = (MATRIX_ITEM_THIS(0, 0) * MATRIX_ITEM_THIS(2, 2) -
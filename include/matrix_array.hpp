@@ -0,0 +1,244 @@
+#ifndef _EVSPACE_MATRIX_ARRAY_H_
+#define _EVSPACE_MATRIX_ARRAY_H_
+
+#include <cmath>        // std::fma
+#include <cstddef>      // std::size_t
+#include <stdexcept>    // std::out_of_range
+#include <vector>       // std::vector
+#include <evspace_common.hpp>
+#include <matrix.hpp>
+
+namespace evspace {
+
+    // Collection of 3x3 matrices stored as a structure of arrays. Each of
+    // the nine components lives in its own contiguous plane, in row-major
+    // component order, so batch kernels can process the same component of
+    // many matrices with vector instructions and no per-matrix heap
+    // allocation is made.
+    class MatrixArray {
+    private:
+        std::size_t m_size;
+        std::size_t m_capacity;
+        // nine planes of m_capacity components, plane (r * 3 + c) holds
+        // component (r, c) of every matrix
+        std::vector<double> m_data;
+
+    public:
+        MatrixArray() noexcept;
+        explicit MatrixArray(std::size_t);
+        MatrixArray(span_t<const Matrix>);
+
+        std::size_t size() const noexcept;
+        std::size_t capacity() const noexcept;
+        // Grows the planes to hold at least capacity matrices without
+        // changing the size, so later growth up to it doesn't reallocate.
+        void reserve(std::size_t);
+        // Resizes the array, preserving the existing matrices which fit
+        // in the new size. New matrices are initialized to zero.
+        void resize(std::size_t);
+
+        // Pointer to the plane holding component (row, col) of every matrix.
+        double* plane(std::size_t, std::size_t);
+        const double* plane(std::size_t, std::size_t) const;
+
+        // Copies the matrix at index into a new Matrix.
+        Matrix get(std::size_t) const;
+        void set(std::size_t, const Matrix&);
+    };
+
+    // Elementwise product, output[i] = lhs[i] * rhs[i]. The output is
+    // resized to the operands' size and may be either operand.
+    void multiply(const MatrixArray&, const MatrixArray&, MatrixArray&);
+    // Elementwise product with the left operand transposed,
+    // output[i] = transpose(lhs[i]) * rhs[i]. For rotation matrices this
+    // composes with the inverse of lhs[i], the rotate_to convention.
+    void transpose_multiply(const MatrixArray&, const MatrixArray&, MatrixArray&);
+
+    namespace _matrix_array_exec {
+
+        // a0 * b0 + a1 * b1 + a2 * b2. Targets with FMA use the fused chain
+        // of the single product kernels so batch and Matrix products agree
+        // bit for bit, others use separate multiplies and adds, which
+        // vectorize where a software fma would not.
+        inline double _dot(double a0, double b0, double a1, double b1, double a2, double b2) noexcept {
+#if defined(__FMA__)
+            return std::fma(a2, b2, std::fma(a1, b1, a0 * b0));
+#else
+            return a0 * b0 + a1 * b1 + a2 * b2;
+#endif
+        }
+
+        // Elementwise product of count matrices stored as component planes,
+        // lhs[i] is transposed when transpose_lhs is set. Works in chunks
+        // whose results are gathered in a local buffer before being copied
+        // out, so the output planes may alias the inputs and the inner
+        // loops vectorize without runtime alias checks. Chunks are split
+        // across threads for large batches.
+        template<bool transpose_lhs>
+        void _multiply_planes(const double* const* lhs, const double* const* rhs,
+                              std::size_t count, double* const* output)
+        {
+            constexpr std::size_t chunk_size = 256;
+            const std::size_t chunk_count = (count + chunk_size - 1) / chunk_size;
+
+            _EVSPACE_PARALLEL_FOR_IF(count >= _EVSPACE_PARALLEL_MINIMUM)
+            for (std::size_t chunk_index = 0; chunk_index < chunk_count; chunk_index++) {
+                const std::size_t start = chunk_index * chunk_size;
+                const std::size_t chunk = count - start < chunk_size ? count - start : chunk_size;
+                double result[9][chunk_size];
+                const double* a[9];
+                const double* b[9];
+                for (std::size_t component = 0; component < 9; component++) {
+                    // entry (r, k) of lhs[i], or entry (k, r) when transposed
+                    const std::size_t r = component / 3, k = component % 3;
+                    a[component] = lhs[transpose_lhs ? k * 3 + r : component] + start;
+                    b[component] = rhs[component] + start;
+                }
+
+                for (std::size_t i = 0; i < chunk; i++) {
+                    for (std::size_t r = 0; r < 3; r++) {
+                        for (std::size_t c = 0; c < 3; c++) {
+                            result[r * 3 + c][i] = _dot(a[r * 3][i], b[c][i], a[r * 3 + 1][i], b[3 + c][i],
+                                                        a[r * 3 + 2][i], b[6 + c][i]);
+                        }
+                    }
+                }
+
+                for (std::size_t component = 0; component < 9; component++) {
+                    double* out = output[component] + start;
+                    for (std::size_t i = 0; i < chunk; i++) {
+                        out[i] = result[component][i];
+                    }
+                }
+            }
+        }
+
+        template<bool transpose_lhs>
+        void _multiply(const MatrixArray& lhs, const MatrixArray& rhs, MatrixArray& output) {
+            if (lhs.size() != rhs.size()) {
+                throw std::out_of_range("MatrixArray operands must be the same size");
+            }
+
+            output.resize(lhs.size());
+            const double* lhs_planes[9];
+            const double* rhs_planes[9];
+            double* output_planes[9];
+            for (std::size_t component = 0; component < 9; component++) {
+                lhs_planes[component] = lhs.plane(component / 3, component % 3);
+                rhs_planes[component] = rhs.plane(component / 3, component % 3);
+                output_planes[component] = output.plane(component / 3, component % 3);
+            }
+
+            _multiply_planes<transpose_lhs>(lhs_planes, rhs_planes, lhs.size(), output_planes);
+        }
+
+    }
+
+    inline MatrixArray::MatrixArray() noexcept : m_size(0), m_capacity(0), m_data() { }
+
+    inline MatrixArray::MatrixArray(std::size_t size)
+        : m_size(size), m_capacity(size), m_data(9 * size, 0.0) { }
+
+    inline MatrixArray::MatrixArray(span_t<const Matrix> matrices)
+        : m_size(matrices.size()), m_capacity(matrices.size()), m_data(9 * matrices.size())
+    {
+        for (std::size_t i = 0; i < this->m_size; i++) {
+            const double* data = matrices[i].data().data();
+            for (std::size_t component = 0; component < 9; component++) {
+                this->m_data[component * this->m_size + i] = data[component];
+            }
+        }
+    }
+
+    inline std::size_t MatrixArray::size() const noexcept {
+        return this->m_size;
+    }
+
+    inline std::size_t MatrixArray::capacity() const noexcept {
+        return this->m_capacity;
+    }
+
+    inline void MatrixArray::reserve(std::size_t capacity) {
+        if (capacity <= this->m_capacity) {
+            return;
+        }
+
+        std::vector<double> data(9 * capacity, 0.0);
+        for (std::size_t plane = 0; plane < 9; plane++) {
+            for (std::size_t i = 0; i < this->m_size; i++) {
+                data[plane * capacity + i] = this->m_data[plane * this->m_capacity + i];
+            }
+        }
+
+        this->m_data = std::move(data);
+        this->m_capacity = capacity;
+    }
+
+    inline void MatrixArray::resize(std::size_t size) {
+        if (size > this->m_capacity) {
+            // geometric growth, so growing one element at a time is
+            // amortized constant
+            this->reserve(size > 2 * this->m_capacity ? size : 2 * this->m_capacity);
+        }
+
+        // slots past the old size may hold values from before a shrink
+        for (std::size_t plane = 0; plane < 9; plane++) {
+            for (std::size_t i = this->m_size; i < size; i++) {
+                this->m_data[plane * this->m_capacity + i] = 0.0;
+            }
+        }
+        this->m_size = size;
+    }
+
+    inline double* MatrixArray::plane(std::size_t row, std::size_t col) {
+        if (row > 2 || col > 2) {
+            throw std::out_of_range("MatrixArray plane index out of range");
+        }
+
+        return this->m_data.data() + (row * 3 + col) * this->m_capacity;
+    }
+
+    inline const double* MatrixArray::plane(std::size_t row, std::size_t col) const {
+        if (row > 2 || col > 2) {
+            throw std::out_of_range("MatrixArray plane index out of range");
+        }
+
+        return this->m_data.data() + (row * 3 + col) * this->m_capacity;
+    }
+
+    inline Matrix MatrixArray::get(std::size_t index) const {
+        if (index >= this->m_size) {
+            throw std::out_of_range("MatrixArray index out of range");
+        }
+
+        Matrix result;
+        double* data = result.data().data();
+        for (std::size_t component = 0; component < 9; component++) {
+            data[component] = this->m_data[component * this->m_capacity + index];
+        }
+
+        return result;
+    }
+
+    inline void MatrixArray::set(std::size_t index, const Matrix& matrix) {
+        if (index >= this->m_size) {
+            throw std::out_of_range("MatrixArray index out of range");
+        }
+
+        const double* data = matrix.data().data();
+        for (std::size_t component = 0; component < 9; component++) {
+            this->m_data[component * this->m_capacity + index] = data[component];
+        }
+    }
+
+    inline void multiply(const MatrixArray& lhs, const MatrixArray& rhs, MatrixArray& output) {
+        _matrix_array_exec::_multiply<false>(lhs, rhs, output);
+    }
+
+    inline void transpose_multiply(const MatrixArray& lhs, const MatrixArray& rhs, MatrixArray& output) {
+        _matrix_array_exec::_multiply<true>(lhs, rhs, output);
+    }
+
+}   // namespace evspace
+
+#endif // _EVSPACE_MATRIX_ARRAY_H_
@@ -0,0 +1,241 @@
+#ifndef _EVSPACE_MATRIX_ARRAY_SOLVE_H_
+#define _EVSPACE_MATRIX_ARRAY_SOLVE_H_
+
+#include <evspace_common.hpp>
+#include <matrix_array.hpp>
+#include <vector_array.hpp>
+#include <cmath>        // std::fabs, HUGE_VAL
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint8_t
+#include <stdexcept>    // std::out_of_range
+
+namespace evspace {
+
+    // Status of each matrix written by the batch inverse and solve. The
+    // batch never throws for a bad element, it flags it and carries on.
+    enum MatrixStatus : std::uint8_t {
+        MATRIX_OK = 0,
+        // The reciprocal condition estimate is below the requested minimum,
+        // the result was computed but may have lost most of its digits.
+        MATRIX_ILL_CONDITIONED = 1,
+        // The determinant is zero or not finite, the result is set to zero.
+        MATRIX_SINGULAR = 2
+    };
+
+    // Default minimum reciprocal condition estimate of the batch inverse
+    // and solve, below which a matrix is flagged as ill-conditioned.
+    constexpr double DEFAULT_MIN_RCOND = 1e-12;
+
+    // Computes the determinant of every matrix as r0 . (r1 x r2) of its
+    // rows. determinants must be the same size as matrices.
+    void determinate(const MatrixArray&, span_t<double>);
+    // Inverts every matrix, writing a MatrixStatus for each to status and
+    // returning the number of matrices which are not MATRIX_OK. The output
+    // is resized to match and may be the input array.
+    std::size_t inverse(const MatrixArray&, MatrixArray&, span_t<std::uint8_t>,
+                        double min_rcond = DEFAULT_MIN_RCOND);
+    // Solves matrices[i] * x[i] = rhs[i] directly, without forming the
+    // inverse as a MatrixArray. Statuses and the return value are as for
+    // inverse(). The solution is resized to match and may be rhs.
+    std::size_t solve(const MatrixArray&, const VectorArray&, VectorArray&, span_t<std::uint8_t>,
+                      double min_rcond = DEFAULT_MIN_RCOND);
+
+    namespace _matrix_solve_exec {
+
+        constexpr std::size_t _chunk_size = 256;
+
+        // Cofactors of the matrix with rows r0, r1 and r2, which are the
+        // columns r1 x r2, r2 x r0 and r0 x r1 of the adjugate, with the
+        // determinant r0 . (r1 x r2). Writes the adjugate row-major.
+        inline double _adjugate(const double* m, double* adj) noexcept {
+            // column 0: r1 x r2
+            adj[0] = m[4] * m[8] - m[5] * m[7];
+            adj[3] = m[5] * m[6] - m[3] * m[8];
+            adj[6] = m[3] * m[7] - m[4] * m[6];
+            // column 1: r2 x r0
+            adj[1] = m[7] * m[2] - m[8] * m[1];
+            adj[4] = m[8] * m[0] - m[6] * m[2];
+            adj[7] = m[6] * m[1] - m[7] * m[0];
+            // column 2: r0 x r1
+            adj[2] = m[1] * m[5] - m[2] * m[4];
+            adj[5] = m[2] * m[3] - m[0] * m[5];
+            adj[8] = m[0] * m[4] - m[1] * m[3];
+
+            return m[0] * adj[0] + m[1] * adj[3] + m[2] * adj[6];
+        }
+
+        // Status of a matrix from its adjugate and determinant. The
+        // reciprocal condition estimate is 1 / (|m|_F |m^-1|_F), which is
+        // |det| / (|m|_F |adj|_F), 1/3 for a rotation and falling to zero as
+        // the matrix becomes singular. It is compared squared so there is
+        // no square root, and the bitwise operators keep the function
+        // branch free so the calling loops vectorize.
+        inline std::uint8_t _status(const double* m, const double* adj, double det, double min_rcond) noexcept {
+            double norm_m = 0.0, norm_adj = 0.0;
+            for (int k = 0; k < 9; k++) {
+                norm_m += m[k] * m[k];
+                norm_adj += adj[k] * adj[k];
+            }
+
+            const double abs_det = std::fabs(det);
+            const double rcond_squared = (det / norm_m) * (det / norm_adj);
+            // a zero, infinite or NaN determinant fails one of the comparisons
+            const bool singular = !(abs_det > 0.0) | !(abs_det < HUGE_VAL);
+            const bool ill = !(rcond_squared >= min_rcond * min_rcond);
+
+            return static_cast<std::uint8_t>((singular << 1) | (ill & !singular));
+        }
+
+        inline std::size_t _count_flagged(const std::uint8_t* status, std::size_t count) noexcept {
+            std::size_t flagged = 0;
+            for (std::size_t i = 0; i < count; i++) {
+                flagged += status[i] != MATRIX_OK;
+            }
+
+            return flagged;
+        }
+
+    }
+
+    inline void determinate(const MatrixArray& matrices, span_t<double> determinants) {
+        if (determinants.size() != matrices.size()) {
+            throw std::out_of_range("determinants must be the same size as the MatrixArray");
+        }
+
+        const double* planes[9];
+        for (std::size_t component = 0; component < 9; component++) {
+            planes[component] = matrices.plane(component / 3, component % 3);
+        }
+
+        const std::size_t count = matrices.size();
+        double* out = determinants.data();
+        _EVSPACE_PARALLEL_FOR_IF(count >= _EVSPACE_PARALLEL_MINIMUM)
+        for (std::size_t i = 0; i < count; i++) {
+            // r0 . (r1 x r2)
+            out[i] = planes[0][i] * (planes[4][i] * planes[8][i] - planes[5][i] * planes[7][i])
+                   + planes[1][i] * (planes[5][i] * planes[6][i] - planes[3][i] * planes[8][i])
+                   + planes[2][i] * (planes[3][i] * planes[7][i] - planes[4][i] * planes[6][i]);
+        }
+    }
+
+    inline std::size_t inverse(const MatrixArray& matrices, MatrixArray& output, span_t<std::uint8_t> status,
+                               double min_rcond)
+    {
+        if (status.size() != matrices.size()) {
+            throw std::out_of_range("status must be the same size as the MatrixArray");
+        }
+
+        output.resize(matrices.size());
+        const double* planes[9];
+        double* output_planes[9];
+        for (std::size_t component = 0; component < 9; component++) {
+            planes[component] = matrices.plane(component / 3, component % 3);
+            output_planes[component] = output.plane(component / 3, component % 3);
+        }
+
+        using _matrix_solve_exec::_chunk_size;
+        const std::size_t count = matrices.size();
+        const std::size_t chunk_count = (count + _chunk_size - 1) / _chunk_size;
+        std::uint8_t* flags = status.data();
+
+        // results and statuses go through local buffers, as in multiply(),
+        // so the output may alias the input and the status bytes, which may
+        // alias anything, don't block vectorization. The division is done
+        // unconditionally and singular results are zeroed on the way out,
+        // a division under a condition would not vectorize.
+        _EVSPACE_PARALLEL_FOR_IF(count >= _EVSPACE_PARALLEL_MINIMUM)
+        for (std::size_t chunk_index = 0; chunk_index < chunk_count; chunk_index++) {
+            const std::size_t start = chunk_index * _chunk_size;
+            const std::size_t chunk = count - start < _chunk_size ? count - start : _chunk_size;
+            double result[9][_chunk_size];
+            std::uint8_t chunk_status[_chunk_size];
+
+            for (std::size_t i = 0; i < chunk; i++) {
+                double m[9], adj[9];
+                for (std::size_t component = 0; component < 9; component++) {
+                    m[component] = planes[component][start + i];
+                }
+
+                const double det = _matrix_solve_exec::_adjugate(m, adj);
+                chunk_status[i] = _matrix_solve_exec::_status(m, adj, det, min_rcond);
+                const double inverse_det = 1.0 / det;
+                for (std::size_t component = 0; component < 9; component++) {
+                    result[component][i] = adj[component] * inverse_det;
+                }
+            }
+
+            for (std::size_t component = 0; component < 9; component++) {
+                for (std::size_t i = 0; i < chunk; i++) {
+                    output_planes[component][start + i] = chunk_status[i] == MATRIX_SINGULAR ? 0.0 : result[component][i];
+                }
+            }
+            for (std::size_t i = 0; i < chunk; i++) {
+                flags[start + i] = chunk_status[i];
+            }
+        }
+
+        return _matrix_solve_exec::_count_flagged(flags, count);
+    }
+
+    inline std::size_t solve(const MatrixArray& matrices, const VectorArray& rhs, VectorArray& solution,
+                             span_t<std::uint8_t> status, double min_rcond)
+    {
+        if (rhs.size() != matrices.size()) {
+            throw std::out_of_range("rhs must be the same size as the MatrixArray");
+        }
+        else if (status.size() != matrices.size()) {
+            throw std::out_of_range("status must be the same size as the MatrixArray");
+        }
+
+        solution.resize(matrices.size());
+        const double* planes[9];
+        for (std::size_t component = 0; component < 9; component++) {
+            planes[component] = matrices.plane(component / 3, component % 3);
+        }
+        const double* b[3] = { rhs.x(), rhs.y(), rhs.z() };
+        double* x[3] = { solution.x(), solution.y(), solution.z() };
+
+        using _matrix_solve_exec::_chunk_size;
+        const std::size_t count = matrices.size();
+        const std::size_t chunk_count = (count + _chunk_size - 1) / _chunk_size;
+        std::uint8_t* flags = status.data();
+
+        _EVSPACE_PARALLEL_FOR_IF(count >= _EVSPACE_PARALLEL_MINIMUM)
+        for (std::size_t chunk_index = 0; chunk_index < chunk_count; chunk_index++) {
+            const std::size_t start = chunk_index * _chunk_size;
+            const std::size_t chunk = count - start < _chunk_size ? count - start : _chunk_size;
+            double result[3][_chunk_size];
+            std::uint8_t chunk_status[_chunk_size];
+
+            for (std::size_t i = 0; i < chunk; i++) {
+                double m[9], adj[9];
+                for (std::size_t component = 0; component < 9; component++) {
+                    m[component] = planes[component][start + i];
+                }
+
+                // x = adj(m) * b / det, Cramer's rule
+                const double det = _matrix_solve_exec::_adjugate(m, adj);
+                chunk_status[i] = _matrix_solve_exec::_status(m, adj, det, min_rcond);
+                const double inverse_det = 1.0 / det;
+                const double b0 = b[0][start + i], b1 = b[1][start + i], b2 = b[2][start + i];
+                for (std::size_t row = 0; row < 3; row++) {
+                    result[row][i] = (adj[row * 3] * b0 + adj[row * 3 + 1] * b1 + adj[row * 3 + 2] * b2) * inverse_det;
+                }
+            }
+
+            for (std::size_t row = 0; row < 3; row++) {
+                for (std::size_t i = 0; i < chunk; i++) {
+                    x[row][start + i] = chunk_status[i] == MATRIX_SINGULAR ? 0.0 : result[row][i];
+                }
+            }
+            for (std::size_t i = 0; i < chunk; i++) {
+                flags[start + i] = chunk_status[i];
+            }
+        }
+
+        return _matrix_solve_exec::_count_flagged(flags, count);
+    }
+
+}   // namespace evspace
+
+#endif // _EVSPACE_MATRIX_ARRAY_SOLVE_H_
@@ -0,0 +1,485 @@
+#ifndef _EVSPACE_MATRIX_DECOMPOSITION_H_
+#define _EVSPACE_MATRIX_DECOMPOSITION_H_
+
+#include <evspace_common.hpp>
+#include <matrix.hpp>
+#include <vector.hpp>
+#include <matrix_array.hpp>
+#include <vector_array.hpp>
+#include <symmetric_matrix.hpp>
+#include <symmetric_matrix_array.hpp>
+#include <symmetric_eigen.hpp>
+#include <matrix_array_solve.hpp>
+#include <cfloat>       // DBL_MIN
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint8_t
+#include <stdexcept>    // std::out_of_range, std::runtime_error
+
+namespace evspace {
+
+    // Singular value decomposition, matrix = u * diag(sigma) * v^T, with
+    // the singular values in descending order and non-negative. v is a
+    // proper rotation and u is one too unless matrix has a negative
+    // determinant, when its last column is negated to keep sigma
+    // non-negative. Rank deficient matrices are handled, the columns of u
+    // for zero singular values complete an orthonormal basis.
+    void svd(const Matrix&, Matrix&, Vector&, Matrix&);
+    // Batch singular value decomposition of every matrix, as above,
+    // resizing the outputs to match. u and v must be different arrays.
+    void svd(const MatrixArray&, MatrixArray&, VectorArray&, MatrixArray&);
+
+    // Polar decomposition, matrix = rotation * stretch, with rotation the
+    // proper rotation matrix nearest to matrix in the Frobenius norm and
+    // stretch symmetric. stretch is positive semi-definite unless matrix
+    // has a negative determinant, when its smallest eigenvalue is negative
+    // so that rotation stays proper.
+    void polar_decomposition(const Matrix&, Matrix&, SymmetricMatrix&);
+    // Batch polar decomposition of every matrix, as above, resizing the
+    // outputs to match.
+    void polar_decomposition(const MatrixArray&, MatrixArray&, SymmetricMatrixArray&);
+
+    // The proper rotation matrix nearest to matrix in the Frobenius norm,
+    // which projects a rotation matrix that has drifted from orthonormal
+    // back onto the rotations.
+    Matrix nearest_rotation(const Matrix&);
+    // Batch nearest rotation of every matrix, resizing the output to
+    // match. The output may be the input, to re-orthonormalize in place.
+    void nearest_rotation(const MatrixArray&, MatrixArray&);
+
+    // Cholesky factor of a positive semi-definite matrix, the lower
+    // triangular l with matrix = l * l^T and a non-negative diagonal, so
+    // l * z of a standard normal z has matrix as its covariance. A pivot
+    // which is zero to round-off, from a direction with no variance, leaves
+    // its column of l zero. Throws std::runtime_error if matrix is not
+    // positive semi-definite.
+    Matrix cholesky(const SymmetricMatrix&);
+    // Batch Cholesky factors of every matrix, as above, writing a
+    // MatrixStatus for each to status and returning the number which are
+    // MATRIX_SINGULAR. A matrix which is not positive semi-definite, or not
+    // finite, is MATRIX_SINGULAR and has a zero factor. The output is
+    // resized to match.
+    std::size_t cholesky(const SymmetricMatrixArray&, MatrixArray&, span_t<std::uint8_t>);
+
+    namespace _decomposition_exec {
+
+        // The lane helpers are found by argument dependent lookup for the
+        // vector lanes, but not for double.
+        using _symmetric_exec::_load;
+        using _symmetric_exec::_store;
+        using _symmetric_exec::_broadcast;
+        using _symmetric_exec::_sqrt;
+        using _symmetric_exec::_abs;
+        using _symmetric_exec::_max;
+        using _symmetric_exec::_select_less;
+
+        // Givens rotation of rows i and j of the row-major b zeroing entry
+        // (j, i) against the pivot (i, i), which is left non-negative. The
+        // transpose is accumulated into the columns of u, so that u * b is
+        // unchanged. A pair with negligible length, relative to the largest
+        // entry of one, is left alone.
+        template<std::size_t i, std::size_t j, typename T>
+        inline void _givens(T* b, T* u) noexcept {
+            const T x = b[i * 3 + i], y = b[j * 3 + i];
+            const T length_squared = x * x + y * y;
+            const T length = _sqrt(length_squared);
+            const T inverse_length = _broadcast(1.0, T()) / (length + _broadcast(DBL_MIN, T()));
+            const T negligible = _broadcast(_symmetric_exec::_jacobi_negligible * _symmetric_exec::_jacobi_negligible, T());
+            const T c = _select_less(length_squared, negligible, _broadcast(1.0, T()), x * inverse_length);
+            const T s = _select_less(length_squared, negligible, _broadcast(0.0, T()), y * inverse_length);
+
+            for (std::size_t k = 0; k < 3; k++) {
+                const T bi = b[i * 3 + k], bj = b[j * 3 + k];
+                b[i * 3 + k] = c * bi + s * bj;
+                b[j * 3 + k] = c * bj - s * bi;
+            }
+            for (std::size_t k = 0; k < 3; k++) {
+                const T ui = u[k * 3 + i], uj = u[k * 3 + j];
+                u[k * 3 + i] = c * ui + s * uj;
+                u[k * 3 + j] = c * uj - s * ui;
+            }
+        }
+
+        // One-sided Jacobi rotation of columns p and q of b, making them
+        // orthogonal. It is the two-sided rotation of b^T * b for the pair,
+        // applied to b itself so b^T * b is never formed and squared
+        // condition numbers don't cost accuracy. Accumulated into v.
+        template<std::size_t p, std::size_t q, typename T>
+        inline void _orthogonalize(T* b, T* v) noexcept {
+            const T app = b[p] * b[p] + b[3 + p] * b[3 + p] + b[6 + p] * b[6 + p];
+            const T aqq = b[q] * b[q] + b[3 + q] * b[3 + q] + b[6 + q] * b[6 + q];
+            const T apq = b[p] * b[q] + b[3 + p] * b[3 + q] + b[6 + p] * b[6 + q];
+
+            T t, c, s;
+            _symmetric_exec::_jacobi_angle(app, aqq, apq, t, c, s);
+            _symmetric_exec::_rotate_columns<p, q>(b, c, s);
+            _symmetric_exec::_rotate_columns<p, q>(v, c, s);
+        }
+
+        // Orders columns i < j of b by descending length, swapping them in
+        // b and v and negating one of each so v stays a proper rotation.
+        template<std::size_t i, std::size_t j, typename T>
+        inline void _sort_columns(T* b, T* v) noexcept {
+            const T length_i = b[i] * b[i] + b[3 + i] * b[3 + i] + b[6 + i] * b[6 + i];
+            const T length_j = b[j] * b[j] + b[3 + j] * b[3 + j] + b[6 + j] * b[6 + j];
+            for (std::size_t k = 0; k < 3; k++) {
+                const T bi = b[k * 3 + i], bj = b[k * 3 + j];
+                const T vi = v[k * 3 + i], vj = v[k * 3 + j];
+                b[k * 3 + i] = _select_less(length_i, length_j, bj, bi);
+                b[k * 3 + j] = _select_less(length_i, length_j, _broadcast(0.0, T()) - bi, bj);
+                v[k * 3 + i] = _select_less(length_i, length_j, vj, vi);
+                v[k * 3 + j] = _select_less(length_i, length_j, _broadcast(0.0, T()) - vi, vj);
+            }
+        }
+
+        // Signed singular value decomposition of the row-major matrix,
+        // matrix = u * diag(sigma) * v^T with u and v both proper rotations,
+        // sigma descending in magnitude and only sigma[2] possibly negative,
+        // with the sign of the determinant.
+        //
+        // One-sided Jacobi sweeps rotate the columns of b = matrix * v until
+        // they are orthogonal, their lengths the singular values, and they
+        // are sorted longest first. The Givens QR decomposition b = u * r
+        // then leaves r diagonal. The QR step gives u orthonormal columns
+        // even where b has columns of zero, which is what makes rank
+        // deficient matrices safe.
+        template<typename T>
+        inline void _svd(const T* matrix, T* u, T* sigma, T* v) noexcept {
+            // scaled by the largest entry, so the column products can't
+            // overflow
+            T scale = _abs(matrix[0]);
+            for (std::size_t k = 1; k < 9; k++) {
+                scale = _max(scale, _abs(matrix[k]));
+            }
+            scale = _max(scale, _broadcast(DBL_MIN, T()));
+            const T inverse_scale = _broadcast(1.0, T()) / scale;
+            T b[9];
+            for (std::size_t k = 0; k < 9; k++) {
+                b[k] = matrix[k] * inverse_scale;
+                v[k] = _broadcast(k % 4 == 0 ? 1.0 : 0.0, T());
+                u[k] = v[k];
+            }
+
+            for (int sweep = 0; sweep < _symmetric_exec::_jacobi_sweeps; sweep++) {
+                _orthogonalize<0, 1>(b, v);
+                _orthogonalize<0, 2>(b, v);
+                _orthogonalize<1, 2>(b, v);
+            }
+            _sort_columns<0, 1>(b, v);
+            _sort_columns<1, 2>(b, v);
+            _sort_columns<0, 1>(b, v);
+
+            _givens<0, 1>(b, u);
+            _givens<0, 2>(b, u);
+            _givens<1, 2>(b, u);
+
+            sigma[0] = b[0] * scale;
+            sigma[1] = b[4] * scale;
+            sigma[2] = b[8] * scale;
+        }
+
+        // The unsigned decomposition from the signed one, negating the last
+        // singular value and column of u when the singular value is negative.
+        template<typename T>
+        inline void _unsign(T* u, T* sigma) noexcept {
+            const T sign = _select_less(sigma[2], _broadcast(0.0, T()), _broadcast(-1.0, T()), _broadcast(1.0, T()));
+            sigma[2] = sigma[2] * sign;
+            for (std::size_t k = 0; k < 3; k++) {
+                u[k * 3 + 2] = u[k * 3 + 2] * sign;
+            }
+        }
+
+        // rotation = u * v^T from the signed decomposition.
+        template<typename T>
+        inline void _rotation(const T* u, const T* v, T* rotation) noexcept {
+            for (std::size_t row = 0; row < 3; row++) {
+                for (std::size_t col = 0; col < 3; col++) {
+                    rotation[row * 3 + col] = u[row * 3] * v[col * 3] + u[row * 3 + 1] * v[col * 3 + 1]
+                                            + u[row * 3 + 2] * v[col * 3 + 2];
+                }
+            }
+        }
+
+        // stretch = v * diag(sigma) * v^T from the signed decomposition,
+        // stored as in SymmetricMatrix.
+        template<typename T>
+        inline void _stretch(const T* sigma, const T* v, T* stretch) noexcept {
+            for (std::size_t row = 0, entry = 0; row < 3; row++) {
+                for (std::size_t col = row; col < 3; col++, entry++) {
+                    stretch[entry] = v[row * 3] * sigma[0] * v[col * 3] + v[row * 3 + 1] * sigma[1] * v[col * 3 + 1]
+                                   + v[row * 3 + 2] * sigma[2] * v[col * 3 + 2];
+                }
+            }
+        }
+
+        template<typename T>
+        inline void _load_matrix(const double* const* planes, std::size_t index, T* matrix) noexcept {
+            for (std::size_t component = 0; component < 9; component++) {
+                matrix[component] = _load(planes[component] + index, T());
+            }
+        }
+
+        template<typename T>
+        inline void _store_planes(double* const* planes, std::size_t count, std::size_t index, const T* values) noexcept {
+            for (std::size_t k = 0; k < count; k++) {
+                _store(planes[k] + index, values[k]);
+            }
+        }
+
+        inline void _matrix_planes(const MatrixArray& matrices, const double** planes) {
+            for (std::size_t component = 0; component < 9; component++) {
+                planes[component] = matrices.plane(component / 3, component % 3);
+            }
+        }
+
+        inline void _matrix_planes(MatrixArray& matrices, double** planes) {
+            for (std::size_t component = 0; component < 9; component++) {
+                planes[component] = matrices.plane(component / 3, component % 3);
+            }
+        }
+
+        // Pivots within this of zero, relative to the largest diagonal
+        // entry, are taken as zero by the Cholesky factorization.
+        constexpr double _cholesky_negligible = 1e-12;
+
+        // Lower Cholesky factor of the symmetric p, in SymmetricMatrix
+        // storage order, written row-major to l. Returns one where p is
+        // positive semi-definite and finite, zero otherwise. A dropped pivot
+        // is only consistent with a semi-definite p if what is left of its
+        // column is negligible too, a_ij^2 <= a_ii a_jj, which catches
+        // matrices such as [[0, 1], [1, 0]] with a zero pivot and no factor.
+        // Dropped pivots take the square root and reciprocal of one, which
+        // are then thrown away, so the lanes stay in step.
+        template<typename T>
+        inline T _cholesky(const T* p, T* l) noexcept {
+            const T zero = _broadcast(0.0, T()), one = _broadcast(1.0, T());
+            const T scale = _max(_max(_abs(p[0]), _abs(p[3])), _abs(p[5]));
+            const T negligible = _broadcast(_cholesky_negligible, T()) * scale;
+
+            const T d0 = p[0];
+            const T root0 = _sqrt(_select_less(negligible, d0, d0, one));
+            const T inverse0 = _select_less(negligible, d0, one / root0, zero);
+            const T l10 = p[1] * inverse0, l20 = p[2] * inverse0;
+            const T residual0 = _select_less(negligible, d0, zero, p[1] * p[1] + p[2] * p[2]);
+
+            const T d1 = p[3] - l10 * l10;
+            const T root1 = _sqrt(_select_less(negligible, d1, d1, one));
+            const T inverse1 = _select_less(negligible, d1, one / root1, zero);
+            const T off1 = p[4] - l20 * l10;
+            const T l21 = off1 * inverse1;
+            const T residual1 = _select_less(negligible, d1, zero, off1 * off1);
+
+            const T d2 = p[5] - l20 * l20 - l21 * l21;
+            const T root2 = _sqrt(_select_less(negligible, d2, d2, one));
+
+            l[0] = _select_less(negligible, d0, root0, zero);
+            l[1] = zero;
+            l[2] = zero;
+            l[3] = l10;
+            l[4] = _select_less(negligible, d1, root1, zero);
+            l[5] = zero;
+            l[6] = l20;
+            l[7] = l21;
+            l[8] = _select_less(negligible, d2, root2, zero);
+
+            // an entry less itself is NaN only if the entry is infinite or
+            // NaN, and NaN fails the comparison. The entries are checked one
+            // at a time, their sum could overflow for large finite entries.
+            T valid = one;
+            for (std::size_t entry = 0; entry < 6; entry++) {
+                valid = _select_less(p[entry] - p[entry], one, valid, zero);
+            }
+            const T minus_negligible = zero - negligible;
+            const T limit = negligible * scale;
+            valid = _select_less(d0, minus_negligible, zero, valid);
+            valid = _select_less(d1, minus_negligible, zero, valid);
+            valid = _select_less(d2, minus_negligible, zero, valid);
+            valid = _select_less(limit, residual0, zero, valid);
+            valid = _select_less(limit, residual1, zero, valid);
+
+            return valid;
+        }
+
+    }
+
+    inline void svd(const Matrix& matrix, Matrix& u, Vector& sigma, Matrix& v) {
+        // locals rather than the heap storage of the outputs, which the
+        // compiler would have to assume alias each other
+        double a[9], u_local[9], sigma_local[3], v_local[9];
+        const double* data = matrix.data().data();
+        for (std::size_t k = 0; k < 9; k++) {
+            a[k] = data[k];
+        }
+
+        _decomposition_exec::_svd(a, u_local, sigma_local, v_local);
+        _decomposition_exec::_unsign(u_local, sigma_local);
+        double* u_data = u.data().data();
+        double* v_data = v.data().data();
+        for (std::size_t k = 0; k < 9; k++) {
+            u_data[k] = u_local[k];
+            v_data[k] = v_local[k];
+        }
+        for (std::size_t k = 0; k < 3; k++) {
+            sigma[k] = sigma_local[k];
+        }
+    }
+
+    inline void svd(const MatrixArray& matrices, MatrixArray& u, VectorArray& sigma, MatrixArray& v) {
+        const std::size_t count = matrices.size();
+        u.resize(count);
+        sigma.resize(count);
+        v.resize(count);
+
+        const double* planes[9];
+        double* u_planes[9];
+        double* sigma_planes[3] = { sigma.x(), sigma.y(), sigma.z() };
+        double* v_planes[9];
+        _decomposition_exec::_matrix_planes(matrices, planes);
+        _decomposition_exec::_matrix_planes(u, u_planes);
+        _decomposition_exec::_matrix_planes(v, v_planes);
+
+        _symmetric_exec::_for_each_lane(count, [&](auto lane, std::size_t index) {
+            using T = decltype(lane);
+            T a[9], u_lane[9], sigma_lane[3], v_lane[9];
+            _decomposition_exec::_load_matrix(planes, index, a);
+            _decomposition_exec::_svd(a, u_lane, sigma_lane, v_lane);
+            _decomposition_exec::_unsign(u_lane, sigma_lane);
+            _decomposition_exec::_store_planes(u_planes, 9, index, u_lane);
+            _decomposition_exec::_store_planes(sigma_planes, 3, index, sigma_lane);
+            _decomposition_exec::_store_planes(v_planes, 9, index, v_lane);
+        });
+    }
+
+    inline void polar_decomposition(const Matrix& matrix, Matrix& rotation, SymmetricMatrix& stretch) {
+        double a[9], u[9], sigma[3], v[9], rotation_local[9];
+        const double* data = matrix.data().data();
+        for (std::size_t k = 0; k < 9; k++) {
+            a[k] = data[k];
+        }
+
+        _decomposition_exec::_svd(a, u, sigma, v);
+        _decomposition_exec::_rotation(u, v, rotation_local);
+        _decomposition_exec::_stretch(sigma, v, stretch.data().data());
+        double* rotation_data = rotation.data().data();
+        for (std::size_t k = 0; k < 9; k++) {
+            rotation_data[k] = rotation_local[k];
+        }
+    }
+
+    inline void polar_decomposition(const MatrixArray& matrices, MatrixArray& rotations, SymmetricMatrixArray& stretches) {
+        const std::size_t count = matrices.size();
+        rotations.resize(count);
+        stretches.resize(count);
+
+        const double* planes[9];
+        double* rotation_planes[9];
+        double* stretch_planes[6];
+        _decomposition_exec::_matrix_planes(matrices, planes);
+        _decomposition_exec::_matrix_planes(rotations, rotation_planes);
+        for (std::size_t row = 0, entry = 0; row < 3; row++) {
+            for (std::size_t col = row; col < 3; col++, entry++) {
+                stretch_planes[entry] = stretches.plane(row, col);
+            }
+        }
+
+        _symmetric_exec::_for_each_lane(count, [&](auto lane, std::size_t index) {
+            using T = decltype(lane);
+            T a[9], u[9], sigma[3], v[9], rotation[9], stretch[6];
+            _decomposition_exec::_load_matrix(planes, index, a);
+            _decomposition_exec::_svd(a, u, sigma, v);
+            _decomposition_exec::_rotation(u, v, rotation);
+            _decomposition_exec::_stretch(sigma, v, stretch);
+            _decomposition_exec::_store_planes(rotation_planes, 9, index, rotation);
+            _decomposition_exec::_store_planes(stretch_planes, 6, index, stretch);
+        });
+    }
+
+    inline Matrix nearest_rotation(const Matrix& matrix) {
+        double a[9], u[9], sigma[3], v[9];
+        const double* data = matrix.data().data();
+        for (std::size_t k = 0; k < 9; k++) {
+            a[k] = data[k];
+        }
+
+        Matrix result;
+        _decomposition_exec::_svd(a, u, sigma, v);
+        _decomposition_exec::_rotation(u, v, result.data().data());
+        return result;
+    }
+
+    inline void nearest_rotation(const MatrixArray& matrices, MatrixArray& rotations) {
+        const std::size_t count = matrices.size();
+        rotations.resize(count);
+
+        const double* planes[9];
+        double* rotation_planes[9];
+        _decomposition_exec::_matrix_planes(matrices, planes);
+        _decomposition_exec::_matrix_planes(rotations, rotation_planes);
+
+        // each lane is loaded before any of it is stored, so rotations may
+        // be matrices
+        _symmetric_exec::_for_each_lane(count, [&](auto lane, std::size_t index) {
+            using T = decltype(lane);
+            T a[9], u[9], sigma[3], v[9], rotation[9];
+            _decomposition_exec::_load_matrix(planes, index, a);
+            _decomposition_exec::_svd(a, u, sigma, v);
+            _decomposition_exec::_rotation(u, v, rotation);
+            _decomposition_exec::_store_planes(rotation_planes, 9, index, rotation);
+        });
+    }
+
+    inline Matrix cholesky(const SymmetricMatrix& matrix) {
+        Matrix result;
+        if (_decomposition_exec::_cholesky(matrix.data().data(), result.data().data()) == 0.0) {
+            throw std::runtime_error("Cholesky factorization of a matrix that is not positive semi-definite");
+        }
+
+        return result;
+    }
+
+    inline std::size_t cholesky(const SymmetricMatrixArray& matrices, MatrixArray& factors, span_t<std::uint8_t> status) {
+        if (status.size() != matrices.size()) {
+            throw std::out_of_range("status must be the same size as the SymmetricMatrixArray");
+        }
+
+        const std::size_t count = matrices.size();
+        factors.resize(count);
+        const double* planes[6];
+        double* factor_planes[9];
+        for (std::size_t row = 0, entry = 0; row < 3; row++) {
+            for (std::size_t col = row; col < 3; col++, entry++) {
+                planes[entry] = matrices.plane(row, col);
+            }
+        }
+        _decomposition_exec::_matrix_planes(factors, factor_planes);
+        std::uint8_t* flags = status.data();
+
+        _symmetric_exec::_for_each_lane(count, [&](auto lane, std::size_t index) {
+            using T = decltype(lane);
+            constexpr std::size_t width = sizeof(T) / sizeof(double);
+            T p[6], l[9];
+            for (std::size_t entry = 0; entry < 6; entry++) {
+                p[entry] = _decomposition_exec::_load(planes[entry] + index, T());
+            }
+
+            // the factors of bad matrices are zeroed
+            const T valid = _decomposition_exec::_cholesky(p, l);
+            const T zero = _decomposition_exec::_broadcast(0.0, T());
+            const T one = _decomposition_exec::_broadcast(1.0, T());
+            for (std::size_t component = 0; component < 9; component++) {
+                l[component] = _decomposition_exec::_select_less(valid, one, zero, l[component]);
+            }
+            _decomposition_exec::_store_planes(factor_planes, 9, index, l);
+
+            double valid_values[width];
+            _decomposition_exec::_store(valid_values, valid);
+            for (std::size_t k = 0; k < width; k++) {
+                flags[index + k] = valid_values[k] == 0.0 ? MATRIX_SINGULAR : MATRIX_OK;
+            }
+        });
+
+        return _matrix_solve_exec::_count_flagged(flags, count);
+    }
+
+}   // namespace evspace
+
+#endif // _EVSPACE_MATRIX_DECOMPOSITION_H_
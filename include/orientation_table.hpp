@@ -0,0 +1,448 @@
+#ifndef _EVSPACE_ORIENTATION_TABLE_H_
+#define _EVSPACE_ORIENTATION_TABLE_H_
+
+#include <angles.hpp>
+#include <matrix.hpp>
+#include <matrix_array.hpp>
+#include <rotation.hpp>
+#include <quaternion.hpp>
+#include <dynamic_reference_frame.hpp>
+#include <evspace_common.hpp>
+#include <cmath>        // std::cos, std::sin, std::sqrt
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint32_t, std::uint64_t
+#include <cstring>      // std::memcmp
+#include <ios>          // std::ios, std::streamoff, std::streamsize
+#include <istream>      // std::istream
+#include <limits>       // std::numeric_limits
+#include <ostream>      // std::ostream
+#include <stdexcept>    // std::invalid_argument, std::out_of_range, std::runtime_error
+#include <type_traits>  // std::is_same_v
+#include <vector>       // std::vector
+
+namespace evspace {
+
+    // Approximate rotation matrices from a precomputed table of unit
+    // quaternions sampled on a uniform grid of Euler angles. A lookup fetches
+    // the eight quaternions at the corners of the grid cell containing the
+    // angles, blends them with trilinear weights, normalizes the result
+    // (NLERP) and converts it to a matrix, with no trigonometric calls.
+    //
+    // Along one axis NLERP between quaternions a quaternion angle phi apart
+    // lags or leads the true great circle by at most phi^3 / (36 sqrt(3)).
+    // Each quaternion of the table turns at half the rate of each angle, so
+    // with grid spacings h = (h1, h2, h3) the rotation angle between the
+    // returned matrix and compute_rotation_matrix is bounded by
+    //
+    //      |h|^3 / (144 sqrt(3))
+    //
+    // radians, see error_bound(). The bound is exact for a cell stretched
+    // along one axis; sampled errors of cubic cells are about half of it.
+    // An error of 1e-6 rad needs spacings of about 0.036 rad, which over the
+    // full [-pi, pi] x [-pi/2, pi/2] x [-pi, pi] range is 2.8 million nodes
+    // (88 MB), so smaller ranges should be used where possible.
+    //
+    // Tables can be saved to and loaded from a binary stream in the native
+    // byte order, so large grids can be generated once ahead of time.
+    template<typename _rotation_order, typename _rotation_type=IntrinsicRotation>
+    class OrientationTable {
+    private:
+        double m_lower[3];
+        double m_step[3];
+        double m_inverse_step[3];
+        std::size_t m_counts[3];
+        // [ w, x, y, z ] of every node, the last angle varying fastest
+        std::vector<double> m_nodes;
+
+        OrientationTable() noexcept;
+
+        void generate();
+        // Computes the interpolated unit quaternion of the angles.
+        void interpolate(double, double, double, double*) const noexcept;
+        bool contains(double, double, double) const noexcept;
+
+    public:
+        // Samples the grid of counts[i] angles evenly spaced from lower[i] to
+        // upper[i] inclusive, for each of the three angles. Every count must
+        // be at least two and every upper angle greater than the lower.
+        OrientationTable(const EulerAngles&, const EulerAngles&, std::size_t, std::size_t, std::size_t);
+
+        EulerAngles lower() const;
+        EulerAngles upper() const;
+        std::size_t count(std::size_t) const;
+        // Number of quaternions stored in the table.
+        std::size_t size() const noexcept;
+        // Upper bound of the rotation angle error of a lookup in radians.
+        double error_bound() const noexcept;
+
+        // Angles outside of the grid throw std::out_of_range.
+        Matrix lookup(const EulerAngles&) const;
+        Quaternion lookup_quaternion(const EulerAngles&) const;
+        // Looks up the rotation of every (alpha[i], beta[i], gamma[i]) and
+        // writes it to output[i], resizing output to the size of the spans.
+        // The angles are all checked against the grid before any output is
+        // written.
+        void lookup(span_t<const double>, span_t<const double>, span_t<const double>, MatrixArray&) const;
+
+        void save(std::ostream&) const;
+        // Reads a table written by save(), throwing std::runtime_error if
+        // the stream is not a table of this rotation order and type, or if
+        // its grid is invalid, too large or truncated.
+        static OrientationTable load(std::istream&);
+
+        typedef _rotation_order  RotationOrder;
+        typedef _rotation_type   RotationType;
+    };
+
+    namespace _orientation_table_exec {
+
+        constexpr char _MAGIC[8] = { 'E', 'V', 'S', 'O', 'T', 'B', 'L', '1' };
+
+        // Doubles read at a time from a stream which can't report its length.
+        constexpr std::size_t _LOAD_CHUNK = 1 << 16;
+
+        // Bytes left in stream past the read position, or -1 if the stream
+        // can't seek.
+        inline std::streamoff _remaining(std::istream& stream) {
+            const std::istream::pos_type position = stream.tellg();
+            if (position == std::istream::pos_type(-1)) {
+                return -1;
+            }
+
+            stream.seekg(0, std::ios::end);
+            const std::istream::pos_type end = stream.tellg();
+            if (!stream || end == std::istream::pos_type(-1)) {
+                stream.clear();
+                stream.seekg(position);
+                return -1;
+            }
+
+            stream.seekg(position);
+            return end - position;
+        }
+
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    OrientationTable<rotation_order, rotation_type>::OrientationTable() noexcept
+        : m_lower(), m_step(), m_inverse_step(), m_counts(), m_nodes() { }
+
+    template<typename rotation_order, typename rotation_type>
+    OrientationTable<rotation_order, rotation_type>::OrientationTable(const EulerAngles& lower,
+        const EulerAngles& upper, std::size_t count1, std::size_t count2, std::size_t count3)
+        : m_lower{ lower[0], lower[1], lower[2] }, m_step(), m_inverse_step(),
+          m_counts{ count1, count2, count3 }, m_nodes()
+    {
+        for (std::size_t i = 0; i < 3; i++) {
+            if (this->m_counts[i] < 2) {
+                throw std::invalid_argument("OrientationTable needs at least two samples per angle");
+            }
+            if (!(upper[i] > lower[i])) {
+                throw std::invalid_argument("OrientationTable upper angles must be greater than lower angles");
+            }
+            this->m_step[i] = (upper[i] - lower[i]) / static_cast<double>(this->m_counts[i] - 1);
+            this->m_inverse_step[i] = 1.0 / this->m_step[i];
+        }
+
+        this->generate();
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    void OrientationTable<rotation_order, rotation_type>::generate() {
+        constexpr std::size_t axes[3] = {
+            static_cast<std::size_t>(rotation_order::Axis_1::direction),
+            static_cast<std::size_t>(rotation_order::Axis_2::direction),
+            static_cast<std::size_t>(rotation_order::Axis_3::direction)
+        };
+
+        // elementary quaternions of every sample of each angle
+        std::vector<double> elementary[3];
+        for (std::size_t i = 0; i < 3; i++) {
+            elementary[i].assign(4 * this->m_counts[i], 0.0);
+            for (std::size_t n = 0; n < this->m_counts[i]; n++) {
+                const double half = 0.5 * (this->m_lower[i] + static_cast<double>(n) * this->m_step[i]);
+                elementary[i][4 * n] = std::cos(half);
+                elementary[i][4 * n + 1 + axes[i]] = std::sin(half);
+            }
+        }
+
+        this->m_nodes.assign(4 * this->size(), 0.0);
+        double* node = this->m_nodes.data();
+        for (std::size_t a = 0; a < this->m_counts[0]; a++) {
+            for (std::size_t b = 0; b < this->m_counts[1]; b++) {
+                double partial[4];
+                if constexpr (std::is_same_v<rotation_type, ExtrinsicRotation>) {
+                    _quaternion_exec::_multiply(&elementary[1][4 * b], &elementary[0][4 * a], partial);
+                }
+                else {
+                    _quaternion_exec::_multiply(&elementary[0][4 * a], &elementary[1][4 * b], partial);
+                }
+                for (std::size_t c = 0; c < this->m_counts[2]; c++, node += 4) {
+                    if constexpr (std::is_same_v<rotation_type, ExtrinsicRotation>) {
+                        _quaternion_exec::_multiply(&elementary[2][4 * c], partial, node);
+                    }
+                    else {
+                        _quaternion_exec::_multiply(partial, &elementary[2][4 * c], node);
+                    }
+                }
+            }
+        }
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    bool OrientationTable<rotation_order, rotation_type>::contains(double alpha, double beta, double gamma) const noexcept {
+        const double angles[3] = { alpha, beta, gamma };
+        for (std::size_t i = 0; i < 3; i++) {
+            const double u = (angles[i] - this->m_lower[i]) * this->m_inverse_step[i];
+            // also rejects NaN
+            if (!(u >= 0.0 && u <= static_cast<double>(this->m_counts[i] - 1))) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    void OrientationTable<rotation_order, rotation_type>::interpolate(
+        double alpha, double beta, double gamma, double* q) const noexcept
+    {
+        const double angles[3] = { alpha, beta, gamma };
+        std::size_t cell[3];
+        double t[3];
+        for (std::size_t i = 0; i < 3; i++) {
+            const double u = (angles[i] - this->m_lower[i]) * this->m_inverse_step[i];
+            std::size_t index = static_cast<std::size_t>(u);
+            // the upper edge belongs to the last cell
+            if (index > this->m_counts[i] - 2) {
+                index = this->m_counts[i] - 2;
+            }
+            cell[i] = index;
+            t[i] = u - static_cast<double>(index);
+        }
+
+        const std::size_t stride_b = 4 * this->m_counts[2];
+        const std::size_t stride_a = stride_b * this->m_counts[1];
+        const double* base = this->m_nodes.data() + cell[0] * stride_a + cell[1] * stride_b + 4 * cell[2];
+
+        const double weights[8] = {
+            (1.0 - t[0]) * (1.0 - t[1]) * (1.0 - t[2]), (1.0 - t[0]) * (1.0 - t[1]) * t[2],
+            (1.0 - t[0]) * t[1] * (1.0 - t[2]),         (1.0 - t[0]) * t[1] * t[2],
+            t[0] * (1.0 - t[1]) * (1.0 - t[2]),         t[0] * (1.0 - t[1]) * t[2],
+            t[0] * t[1] * (1.0 - t[2]),                 t[0] * t[1] * t[2]
+        };
+        const std::size_t offsets[8] = {
+            0, 4, stride_b, stride_b + 4,
+            stride_a, stride_a + 4, stride_a + stride_b, stride_a + stride_b + 4
+        };
+
+        double sum[4] = { 0.0, 0.0, 0.0, 0.0 };
+        for (std::size_t corner = 0; corner < 8; corner++) {
+            const double* node = base + offsets[corner];
+            for (std::size_t component = 0; component < 4; component++) {
+                sum[component] += weights[corner] * node[component];
+            }
+        }
+
+        const double scale = 1.0 / std::sqrt(sum[0] * sum[0] + sum[1] * sum[1] + sum[2] * sum[2] + sum[3] * sum[3]);
+        for (std::size_t component = 0; component < 4; component++) {
+            q[component] = sum[component] * scale;
+        }
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    EulerAngles OrientationTable<rotation_order, rotation_type>::lower() const {
+        return EulerAngles(this->m_lower[0], this->m_lower[1], this->m_lower[2]);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    EulerAngles OrientationTable<rotation_order, rotation_type>::upper() const {
+        double angles[3];
+        for (std::size_t i = 0; i < 3; i++) {
+            angles[i] = this->m_lower[i] + static_cast<double>(this->m_counts[i] - 1) * this->m_step[i];
+        }
+
+        return EulerAngles(angles[0], angles[1], angles[2]);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    std::size_t OrientationTable<rotation_order, rotation_type>::count(std::size_t index) const {
+        if (index > 2) {
+            throw std::out_of_range("Angle index out of range");
+        }
+
+        return this->m_counts[index];
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    std::size_t OrientationTable<rotation_order, rotation_type>::size() const noexcept {
+        return this->m_counts[0] * this->m_counts[1] * this->m_counts[2];
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    double OrientationTable<rotation_order, rotation_type>::error_bound() const noexcept {
+        const double norm = std::sqrt(this->m_step[0] * this->m_step[0] + this->m_step[1] * this->m_step[1]
+            + this->m_step[2] * this->m_step[2]);
+        // 144 * sqrt(3)
+        return norm * norm * norm / 249.41531628991834;
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    Quaternion OrientationTable<rotation_order, rotation_type>::lookup_quaternion(const EulerAngles& angles) const {
+        if (!this->contains(angles[0], angles[1], angles[2])) {
+            throw std::out_of_range("Angles outside of the OrientationTable grid");
+        }
+
+        Quaternion result;
+        this->interpolate(angles[0], angles[1], angles[2], result.data().data());
+        return result;
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    Matrix OrientationTable<rotation_order, rotation_type>::lookup(const EulerAngles& angles) const {
+        if (!this->contains(angles[0], angles[1], angles[2])) {
+            throw std::out_of_range("Angles outside of the OrientationTable grid");
+        }
+
+        double q[4];
+        this->interpolate(angles[0], angles[1], angles[2], q);
+        Matrix result;
+        _quaternion_exec::_to_matrix(q, result.data().data());
+        return result;
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    void OrientationTable<rotation_order, rotation_type>::lookup(span_t<const double> alphas,
+        span_t<const double> betas, span_t<const double> gammas, MatrixArray& output) const
+    {
+        const std::size_t size = alphas.size();
+        if (betas.size() != size || gammas.size() != size) {
+            throw std::out_of_range("OrientationTable lookup spans must be the same size");
+        }
+        for (std::size_t i = 0; i < size; i++) {
+            if (!this->contains(alphas[i], betas[i], gammas[i])) {
+                throw std::out_of_range("Angles outside of the OrientationTable grid");
+            }
+        }
+
+        output.resize(size);
+        double* planes[9];
+        for (std::size_t component = 0; component < 9; component++) {
+            planes[component] = output.plane(component / 3, component % 3);
+        }
+
+        const double* a = alphas.data();
+        const double* b = betas.data();
+        const double* g = gammas.data();
+        for (std::size_t i = 0; i < size; i++) {
+            double q[4], m[9];
+            this->interpolate(a[i], b[i], g[i], q);
+            _quaternion_exec::_to_matrix(q, m);
+            for (std::size_t component = 0; component < 9; component++) {
+                planes[component][i] = m[component];
+            }
+        }
+    }
+
+    /**
+     * Binary table format, in native byte order:
+     *
+     *      8 bytes     magic "EVSOTBL1"
+     *      4 bytes     rotation order id (RotationOrderId)
+     *      4 bytes     rotation type id (RotationTypeId)
+     *      3 x 8       sample counts
+     *      3 x 8       lower angles
+     *      3 x 8       grid spacings
+     *      size x 32   node quaternions [ w, x, y, z ]
+     */
+
+    template<typename rotation_order, typename rotation_type>
+    void OrientationTable<rotation_order, rotation_type>::save(std::ostream& stream) const {
+        const std::uint32_t ids[2] = {
+            static_cast<std::uint32_t>(_dynamic_frame_exec::_order_id<rotation_order>()),
+            static_cast<std::uint32_t>(_dynamic_frame_exec::_type_id<rotation_type>())
+        };
+        const std::uint64_t counts[3] = { this->m_counts[0], this->m_counts[1], this->m_counts[2] };
+
+        stream.write(_orientation_table_exec::_MAGIC, sizeof(_orientation_table_exec::_MAGIC));
+        stream.write(reinterpret_cast<const char*>(ids), sizeof(ids));
+        stream.write(reinterpret_cast<const char*>(counts), sizeof(counts));
+        stream.write(reinterpret_cast<const char*>(this->m_lower), sizeof(this->m_lower));
+        stream.write(reinterpret_cast<const char*>(this->m_step), sizeof(this->m_step));
+        stream.write(reinterpret_cast<const char*>(this->m_nodes.data()),
+                     static_cast<std::streamsize>(this->m_nodes.size() * sizeof(double)));
+
+        if (!stream) {
+            throw std::runtime_error("Failed to write OrientationTable");
+        }
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    OrientationTable<rotation_order, rotation_type>
+    OrientationTable<rotation_order, rotation_type>::load(std::istream& stream) {
+        char magic[sizeof(_orientation_table_exec::_MAGIC)];
+        std::uint32_t ids[2];
+        std::uint64_t counts[3];
+        OrientationTable result;
+
+        stream.read(magic, sizeof(magic));
+        stream.read(reinterpret_cast<char*>(ids), sizeof(ids));
+        stream.read(reinterpret_cast<char*>(counts), sizeof(counts));
+        stream.read(reinterpret_cast<char*>(result.m_lower), sizeof(result.m_lower));
+        stream.read(reinterpret_cast<char*>(result.m_step), sizeof(result.m_step));
+        if (!stream || std::memcmp(magic, _orientation_table_exec::_MAGIC, sizeof(magic)) != 0) {
+            throw std::runtime_error("Stream does not hold an OrientationTable");
+        }
+        if (ids[0] != static_cast<std::uint32_t>(_dynamic_frame_exec::_order_id<rotation_order>())
+            || ids[1] != static_cast<std::uint32_t>(_dynamic_frame_exec::_type_id<rotation_type>()))
+        {
+            throw std::runtime_error("OrientationTable rotation order or type mismatch");
+        }
+
+        // the counts come from the stream, so their product is checked
+        // against what can be addressed and read before anything is
+        // allocated
+        constexpr std::uint64_t node_bytes = 4 * sizeof(double);
+        constexpr std::uint64_t max_bytes = static_cast<std::uint64_t>(std::numeric_limits<std::streamsize>::max())
+            < static_cast<std::uint64_t>(std::numeric_limits<std::size_t>::max())
+            ? static_cast<std::uint64_t>(std::numeric_limits<std::streamsize>::max())
+            : static_cast<std::uint64_t>(std::numeric_limits<std::size_t>::max());
+        std::uint64_t nodes = 1;
+        for (std::size_t i = 0; i < 3; i++) {
+            if (counts[i] < 2 || !(result.m_step[i] > 0.0)) {
+                throw std::runtime_error("Invalid OrientationTable grid");
+            }
+            if (counts[i] > max_bytes / node_bytes / nodes) {
+                throw std::runtime_error("OrientationTable grid is too large");
+            }
+            nodes *= counts[i];
+            result.m_counts[i] = static_cast<std::size_t>(counts[i]);
+            result.m_inverse_step[i] = 1.0 / result.m_step[i];
+        }
+
+        const std::streamoff remaining = _orientation_table_exec::_remaining(stream);
+        if (remaining >= 0 && static_cast<std::uint64_t>(remaining) < nodes * node_bytes) {
+            throw std::runtime_error("Truncated OrientationTable");
+        }
+
+        // a stream which can't report its length is read in chunks, so a
+        // header claiming more nodes than the stream holds fails before
+        // they are all allocated
+        const std::size_t total = static_cast<std::size_t>(4 * nodes);
+        const std::size_t chunk = remaining >= 0 ? total : _orientation_table_exec::_LOAD_CHUNK;
+        for (std::size_t offset = 0; offset < total; offset += chunk) {
+            const std::size_t count = total - offset < chunk ? total - offset : chunk;
+            result.m_nodes.resize(offset + count);
+            stream.read(reinterpret_cast<char*>(result.m_nodes.data() + offset),
+                        static_cast<std::streamsize>(count * sizeof(double)));
+            if (!stream) {
+                throw std::runtime_error("Truncated OrientationTable");
+            }
+        }
+
+        return result;
+    }
+
+}   // namespace evspace
+
+#endif // _EVSPACE_ORIENTATION_TABLE_H_
@@ -0,0 +1,308 @@
+#ifndef _EVSPACE_QUATERNION_H_
+#define _EVSPACE_QUATERNION_H_
+
+#include <angles.hpp>
+#include <matrix.hpp>
+#include <vector.hpp>
+#include <rotation.hpp>
+#include <cmath>        // std::sqrt, std::sin, std::cos
+#include <cstddef>      // std::size_t
+#include <stdexcept>    // std::out_of_range
+#include <type_traits>  // std::is_same_v
+
+namespace evspace {
+
+    // Rotation represented by a unit quaternion. The components are stored
+    // inline with the scalar part first, [ w, x, y, z ]. A quaternion q
+    // represents the same rotation as the rotation matrix m when (m * v)
+    // is equal to (q * v * conjugate(q)), so quaternions can be used in
+    // place of a Matrix in any rotate_to or rotate_from call.
+    class Quaternion {
+    private:
+        double m_data[4];
+
+    public:
+        // Constructs the identity rotation.
+        constexpr Quaternion() noexcept;
+        constexpr Quaternion(double, double, double, double) noexcept;
+        // Constructs the quaternion of a pure rotation matrix.
+        explicit Quaternion(const Matrix&);
+
+        double& operator[](std::size_t);
+        const double& operator[](std::size_t) const;
+
+        span_t<double> data() noexcept;
+        span_t<const double> data() const noexcept;
+
+        // Hamilton product, the rotation (*this) followed by the rotation
+        // rhs when used in the rotate_from sense, matching Matrix products.
+        Quaternion operator*(const Quaternion&) const noexcept;
+        Quaternion& operator*=(const Quaternion&) noexcept;
+
+        bool operator==(const Quaternion&) const;
+        bool operator!=(const Quaternion&) const;
+
+        Quaternion conjugate() const noexcept;
+        double norm() const noexcept;
+        // Scales the quaternion to unit length. Floating point drift of
+        // repeated products should be removed with this periodically.
+        Quaternion& normalize() noexcept;
+
+        Matrix to_matrix() const;
+    };
+
+    inline std::ostream& operator<<(std::ostream& out, const Quaternion& quaternion) {
+        out << "[ " << quaternion[0] << ", " << quaternion[1] << ", "
+            << quaternion[2] << ", " << quaternion[3] << " ]";
+        return out;
+    }
+
+    namespace _quaternion_exec {
+
+        // Hamilton product of two raw [ w, x, y, z ] buffers.
+        inline void _multiply(const double* a, const double* b, double* out) noexcept {
+            double w = a[0] * b[0] - a[1] * b[1] - a[2] * b[2] - a[3] * b[3];
+            double x = a[0] * b[1] + a[1] * b[0] + a[2] * b[3] - a[3] * b[2];
+            double y = a[0] * b[2] - a[1] * b[3] + a[2] * b[0] + a[3] * b[1];
+            double z = a[0] * b[3] + a[1] * b[2] - a[2] * b[1] + a[3] * b[0];
+            out[0] = w;
+            out[1] = x;
+            out[2] = y;
+            out[3] = z;
+        }
+
+        // Writes the row-major rotation matrix of the unit quaternion q.
+        inline void _to_matrix(const double* q, double* m) noexcept {
+            const double w = q[0], x = q[1], y = q[2], z = q[3];
+            const double xx = x * x, yy = y * y, zz = z * z;
+            const double xy = x * y, xz = x * z, yz = y * z;
+            const double wx = w * x, wy = w * y, wz = w * z;
+
+            m[0] = 1.0 - 2.0 * (yy + zz);
+            m[1] = 2.0 * (xy - wz);
+            m[2] = 2.0 * (xz + wy);
+            m[3] = 2.0 * (xy + wz);
+            m[4] = 1.0 - 2.0 * (xx + zz);
+            m[5] = 2.0 * (yz - wx);
+            m[6] = 2.0 * (xz - wy);
+            m[7] = 2.0 * (yz + wx);
+            m[8] = 1.0 - 2.0 * (xx + yy);
+        }
+
+        // Computes the unit quaternion of a row-major rotation matrix using
+        // Shepperd's method, which branches on the largest diagonal term to
+        // avoid dividing by a small number.
+        inline void _from_matrix(const double* m, double* q) noexcept {
+            const double trace = m[0] + m[4] + m[8];
+
+            if (trace >= m[0] && trace >= m[4] && trace >= m[8]) {
+                double t = std::sqrt(1.0 + trace) * 2.0;
+                q[0] = 0.25 * t;
+                q[1] = (m[7] - m[5]) / t;
+                q[2] = (m[2] - m[6]) / t;
+                q[3] = (m[3] - m[1]) / t;
+            }
+            else if (m[0] >= m[4] && m[0] >= m[8]) {
+                double t = std::sqrt(1.0 + m[0] - m[4] - m[8]) * 2.0;
+                q[0] = (m[7] - m[5]) / t;
+                q[1] = 0.25 * t;
+                q[2] = (m[1] + m[3]) / t;
+                q[3] = (m[2] + m[6]) / t;
+            }
+            else if (m[4] >= m[8]) {
+                double t = std::sqrt(1.0 + m[4] - m[0] - m[8]) * 2.0;
+                q[0] = (m[2] - m[6]) / t;
+                q[1] = (m[1] + m[3]) / t;
+                q[2] = 0.25 * t;
+                q[3] = (m[5] + m[7]) / t;
+            }
+            else {
+                double t = std::sqrt(1.0 + m[8] - m[0] - m[4]) * 2.0;
+                q[0] = (m[3] - m[1]) / t;
+                q[1] = (m[2] + m[6]) / t;
+                q[2] = (m[5] + m[7]) / t;
+                q[3] = 0.25 * t;
+            }
+
+            // keep a canonical sign so equal rotations compare equal
+            if (q[0] < 0.0) {
+                q[0] = -q[0];
+                q[1] = -q[1];
+                q[2] = -q[2];
+                q[3] = -q[3];
+            }
+        }
+
+        // Computes (q * v * conjugate(q)), equivalent to (m * v). Uses the
+        // form v + w * t + u x t where t = 2 * (u x v) and u is the vector
+        // part of q.
+        inline void _rotate_from(const double* q, const double* v, double* out) noexcept {
+            const double w = q[0], x = q[1], y = q[2], z = q[3];
+            const double tx = 2.0 * (y * v[2] - z * v[1]);
+            const double ty = 2.0 * (z * v[0] - x * v[2]);
+            const double tz = 2.0 * (x * v[1] - y * v[0]);
+
+            out[0] = v[0] + w * tx + (y * tz - z * ty);
+            out[1] = v[1] + w * ty + (z * tx - x * tz);
+            out[2] = v[2] + w * tz + (x * ty - y * tx);
+        }
+
+        // Computes (conjugate(q) * v * q), equivalent to (v * m).
+        inline void _rotate_to(const double* q, const double* v, double* out) noexcept {
+            const double conjugate[4] = { q[0], -q[1], -q[2], -q[3] };
+            _rotate_from(conjugate, v, out);
+        }
+
+    }
+
+    inline constexpr Quaternion::Quaternion() noexcept : m_data{ 1.0, 0.0, 0.0, 0.0 } { }
+
+    inline constexpr Quaternion::Quaternion(double w, double x, double y, double z) noexcept
+        : m_data{ w, x, y, z } { }
+
+    inline Quaternion::Quaternion(const Matrix& matrix) {
+        _quaternion_exec::_from_matrix(matrix.data().data(), this->m_data);
+    }
+
+    inline double& Quaternion::operator[](std::size_t index) {
+        if (index > 3) {
+            throw std::out_of_range("Quaternion index out of range");
+        }
+
+        return this->m_data[index];
+    }
+
+    inline const double& Quaternion::operator[](std::size_t index) const {
+        if (index > 3) {
+            throw std::out_of_range("Quaternion index out of range");
+        }
+
+        return this->m_data[index];
+    }
+
+    inline span_t<double> Quaternion::data() noexcept {
+        return span_t<double>(this->m_data, 4);
+    }
+
+    inline span_t<const double> Quaternion::data() const noexcept {
+        return span_t<const double>(this->m_data, 4);
+    }
+
+    inline Quaternion Quaternion::operator*(const Quaternion& rhs) const noexcept {
+        Quaternion result;
+        _quaternion_exec::_multiply(this->m_data, rhs.m_data, result.m_data);
+        return result;
+    }
+
+    inline Quaternion& Quaternion::operator*=(const Quaternion& rhs) noexcept {
+        _quaternion_exec::_multiply(this->m_data, rhs.m_data, this->m_data);
+        return *this;
+    }
+
+    // Quaternions q and -q represent the same rotation and compare equal.
+    inline bool Quaternion::operator==(const Quaternion& rhs) const {
+        double sign = (this->m_data[0] * rhs.m_data[0] + this->m_data[1] * rhs.m_data[1]
+            + this->m_data[2] * rhs.m_data[2] + this->m_data[3] * rhs.m_data[3]) < 0.0 ? -1.0 : 1.0;
+
+        for (int i = 0; i < 4; i++) {
+            if (!_double_almost_equal(this->m_data[i], sign * rhs.m_data[i], DEFAULT_REL_TOL, DEFAULT_ABS_TOL)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    inline bool Quaternion::operator!=(const Quaternion& rhs) const {
+        return !(*this == rhs);
+    }
+
+    inline Quaternion Quaternion::conjugate() const noexcept {
+        return Quaternion(this->m_data[0], -this->m_data[1], -this->m_data[2], -this->m_data[3]);
+    }
+
+    inline double Quaternion::norm() const noexcept {
+        return std::sqrt(this->m_data[0] * this->m_data[0] + this->m_data[1] * this->m_data[1]
+            + this->m_data[2] * this->m_data[2] + this->m_data[3] * this->m_data[3]);
+    }
+
+    inline Quaternion& Quaternion::normalize() noexcept {
+        double norm = this->norm();
+        for (int i = 0; i < 4; i++) {
+            this->m_data[i] /= norm;
+        }
+
+        return *this;
+    }
+
+    inline Matrix Quaternion::to_matrix() const {
+        Matrix result;
+        _quaternion_exec::_to_matrix(this->m_data, result.data().data());
+        return result;
+    }
+
+    /**
+     * Quaternion computation functions mirroring compute_rotation_matrix.
+     */
+
+    template<typename axis>
+    Quaternion compute_rotation_quaternion(double angle) {
+        double half_sin = std::sin(angle / 2.0);
+        double components[3]{ 0.0, 0.0, 0.0 };
+        components[static_cast<std::size_t>(axis::direction)] = half_sin;
+
+        return Quaternion(std::cos(angle / 2.0), components[0], components[1], components[2]);
+    }
+
+    // Computes the quaternion for a rotation of angle around the vector
+    // rotation_vector.
+    inline Quaternion
+    compute_rotation_quaternion(double angle, const Vector& rotation_vector) {
+        Vector axis = rotation_vector.norm();
+        double half_sin = std::sin(angle / 2.0);
+
+        return Quaternion(std::cos(angle / 2.0), axis[0] * half_sin, axis[1] * half_sin, axis[2] * half_sin);
+    }
+
+    template<typename rotation_order, typename rotation_type = IntrinsicRotation>
+    Quaternion compute_rotation_quaternion(const EulerAngles& angles) {
+        Quaternion q1 = compute_rotation_quaternion<typename rotation_order::Axis_1>(angles[0]);
+        Quaternion q2 = compute_rotation_quaternion<typename rotation_order::Axis_2>(angles[1]);
+        Quaternion q3 = compute_rotation_quaternion<typename rotation_order::Axis_3>(angles[2]);
+
+        if constexpr (std::is_same_v<rotation_type, ExtrinsicRotation>) {
+            return q3 * q2 * q1;
+        }
+        else {
+            return q1 * q2 * q3;
+        }
+    }
+
+    /**
+     * Quaternion rotation overloads. These follow the same conventions as
+     * the Matrix overloads in rotation.hpp.
+     */
+
+    inline Vector rotate_from(const Quaternion& rotation, const Vector& vector) {
+        Vector result;
+        _quaternion_exec::_rotate_from(rotation.data().data(), vector.data().data(), result.data().data());
+        return result;
+    }
+
+    inline Vector rotate_from(const Quaternion& rotation, const Vector& vector, const Vector& offset) {
+        return rotate_from(rotation, vector) + offset;
+    }
+
+    inline Vector rotate_to(const Quaternion& rotation, const Vector& vector) {
+        Vector result;
+        _quaternion_exec::_rotate_to(rotation.data().data(), vector.data().data(), result.data().data());
+        return result;
+    }
+
+    inline Vector rotate_to(const Quaternion& rotation, const Vector& vector, const Vector& offset) {
+        return rotate_to(rotation, vector - offset);
+    }
+
+}   // namespace evspace
+
+#endif // _EVSPACE_QUATERNION_H_
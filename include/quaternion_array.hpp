@@ -0,0 +1,238 @@
+#ifndef _EVSPACE_QUATERNION_ARRAY_H_
+#define _EVSPACE_QUATERNION_ARRAY_H_
+
+#include <cmath>        // std::sqrt
+#include <cstddef>      // std::size_t
+#include <stdexcept>    // std::out_of_range
+#include <vector>       // std::vector
+#include <evspace_common.hpp>
+#include <quaternion.hpp>
+#include <matrix_array.hpp>
+
+namespace evspace {
+
+    // Collection of unit quaternions stored as a structure of arrays, one
+    // contiguous plane for each of the w, x, y and z components, so batch
+    // kernels such as the attitude integrators can update many rotations
+    // with vector instructions.
+    class QuaternionArray {
+    private:
+        std::size_t m_size;
+        std::size_t m_capacity;
+        // w plane, followed by the x, y and z planes, each m_capacity long
+        std::vector<double> m_data;
+
+    public:
+        QuaternionArray() noexcept;
+        // Constructs size identity rotations.
+        explicit QuaternionArray(std::size_t);
+        QuaternionArray(span_t<const Quaternion>);
+
+        std::size_t size() const noexcept;
+        std::size_t capacity() const noexcept;
+        // Grows the planes to hold at least capacity quaternions without
+        // changing the size, so later growth up to it doesn't reallocate.
+        void reserve(std::size_t);
+        // Resizes the array, preserving the existing quaternions which fit
+        // in the new size. New quaternions are initialized to the identity.
+        void resize(std::size_t);
+
+        double* w() noexcept;
+        double* x() noexcept;
+        double* y() noexcept;
+        double* z() noexcept;
+        const double* w() const noexcept;
+        const double* x() const noexcept;
+        const double* y() const noexcept;
+        const double* z() const noexcept;
+
+        // Copies the quaternion at index into a new Quaternion.
+        Quaternion get(std::size_t) const;
+        void set(std::size_t, const Quaternion&);
+
+        // Scales every quaternion to unit length.
+        void normalize() noexcept;
+        // Writes the rotation matrix of every quaternion, as
+        // Quaternion::to_matrix, resizing the output to match.
+        void to_matrices(MatrixArray&) const;
+    };
+
+    namespace _quaternion_array_exec {
+
+        constexpr std::size_t _chunk_size = 256;
+
+        // Scales the count quaternions of the four planes to unit length.
+        inline void _normalize(double* const* planes, std::size_t count) noexcept {
+            double* w = planes[0];
+            double* x = planes[1];
+            double* y = planes[2];
+            double* z = planes[3];
+            for (std::size_t i = 0; i < count; i++) {
+                const double scale = 1.0 / std::sqrt(w[i] * w[i] + x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+                w[i] *= scale;
+                x[i] *= scale;
+                y[i] *= scale;
+                z[i] *= scale;
+            }
+        }
+
+    }
+
+    inline QuaternionArray::QuaternionArray() noexcept : m_size(0), m_capacity(0), m_data() { }
+
+    inline QuaternionArray::QuaternionArray(std::size_t size)
+        : m_size(size), m_capacity(size), m_data(4 * size, 0.0)
+    {
+        for (std::size_t i = 0; i < size; i++) {
+            this->m_data[i] = 1.0;
+        }
+    }
+
+    inline QuaternionArray::QuaternionArray(span_t<const Quaternion> quaternions)
+        : m_size(quaternions.size()), m_capacity(quaternions.size()), m_data(4 * quaternions.size())
+    {
+        for (std::size_t i = 0; i < this->m_size; i++) {
+            const double* data = quaternions[i].data().data();
+            for (std::size_t plane = 0; plane < 4; plane++) {
+                this->m_data[plane * this->m_size + i] = data[plane];
+            }
+        }
+    }
+
+    inline std::size_t QuaternionArray::size() const noexcept {
+        return this->m_size;
+    }
+
+    inline std::size_t QuaternionArray::capacity() const noexcept {
+        return this->m_capacity;
+    }
+
+    inline void QuaternionArray::reserve(std::size_t capacity) {
+        if (capacity <= this->m_capacity) {
+            return;
+        }
+
+        std::vector<double> data(4 * capacity, 0.0);
+        for (std::size_t plane = 0; plane < 4; plane++) {
+            for (std::size_t i = 0; i < this->m_size; i++) {
+                data[plane * capacity + i] = this->m_data[plane * this->m_capacity + i];
+            }
+        }
+
+        this->m_data = std::move(data);
+        this->m_capacity = capacity;
+    }
+
+    inline void QuaternionArray::resize(std::size_t size) {
+        if (size > this->m_capacity) {
+            // geometric growth, so growing one element at a time is
+            // amortized constant
+            this->reserve(size > 2 * this->m_capacity ? size : 2 * this->m_capacity);
+        }
+
+        // slots past the old size may hold values from before a shrink
+        for (std::size_t i = this->m_size; i < size; i++) {
+            this->m_data[i] = 1.0;
+        }
+        for (std::size_t plane = 1; plane < 4; plane++) {
+            for (std::size_t i = this->m_size; i < size; i++) {
+                this->m_data[plane * this->m_capacity + i] = 0.0;
+            }
+        }
+        this->m_size = size;
+    }
+
+    inline double* QuaternionArray::w() noexcept {
+        return this->m_data.data();
+    }
+
+    inline double* QuaternionArray::x() noexcept {
+        return this->m_data.data() + this->m_capacity;
+    }
+
+    inline double* QuaternionArray::y() noexcept {
+        return this->m_data.data() + 2 * this->m_capacity;
+    }
+
+    inline double* QuaternionArray::z() noexcept {
+        return this->m_data.data() + 3 * this->m_capacity;
+    }
+
+    inline const double* QuaternionArray::w() const noexcept {
+        return this->m_data.data();
+    }
+
+    inline const double* QuaternionArray::x() const noexcept {
+        return this->m_data.data() + this->m_capacity;
+    }
+
+    inline const double* QuaternionArray::y() const noexcept {
+        return this->m_data.data() + 2 * this->m_capacity;
+    }
+
+    inline const double* QuaternionArray::z() const noexcept {
+        return this->m_data.data() + 3 * this->m_capacity;
+    }
+
+    inline Quaternion QuaternionArray::get(std::size_t index) const {
+        if (index >= this->m_size) {
+            throw std::out_of_range("QuaternionArray index out of range");
+        }
+
+        return Quaternion(this->w()[index], this->x()[index], this->y()[index], this->z()[index]);
+    }
+
+    inline void QuaternionArray::set(std::size_t index, const Quaternion& quaternion) {
+        if (index >= this->m_size) {
+            throw std::out_of_range("QuaternionArray index out of range");
+        }
+
+        const double* data = quaternion.data().data();
+        this->w()[index] = data[0];
+        this->x()[index] = data[1];
+        this->y()[index] = data[2];
+        this->z()[index] = data[3];
+    }
+
+    inline void QuaternionArray::normalize() noexcept {
+        const std::size_t count = this->m_size;
+        const std::size_t chunk_size = _quaternion_array_exec::_chunk_size;
+        const std::size_t chunk_count = (count + chunk_size - 1) / chunk_size;
+        double* const planes[4] = { this->w(), this->x(), this->y(), this->z() };
+
+        _EVSPACE_PARALLEL_FOR_IF(count >= _EVSPACE_PARALLEL_MINIMUM)
+        for (std::size_t chunk_index = 0; chunk_index < chunk_count; chunk_index++) {
+            const std::size_t start = chunk_index * chunk_size;
+            const std::size_t chunk = count - start < chunk_size ? count - start : chunk_size;
+            double* const chunk_planes[4] = { planes[0] + start, planes[1] + start, planes[2] + start,
+                                              planes[3] + start };
+            _quaternion_array_exec::_normalize(chunk_planes, chunk);
+        }
+    }
+
+    inline void QuaternionArray::to_matrices(MatrixArray& matrices) const {
+        const std::size_t count = this->m_size;
+        matrices.resize(count);
+        double* planes[9];
+        for (std::size_t component = 0; component < 9; component++) {
+            planes[component] = matrices.plane(component / 3, component % 3);
+        }
+        const double* w = this->w();
+        const double* x = this->x();
+        const double* y = this->y();
+        const double* z = this->z();
+
+        _EVSPACE_PARALLEL_FOR_IF(count >= _EVSPACE_PARALLEL_MINIMUM)
+        for (std::size_t i = 0; i < count; i++) {
+            const double quaternion[4] = { w[i], x[i], y[i], z[i] };
+            double matrix[9];
+            _quaternion_exec::_to_matrix(quaternion, matrix);
+            for (std::size_t component = 0; component < 9; component++) {
+                planes[component][i] = matrix[component];
+            }
+        }
+    }
+
+}   // namespace evspace
+
+#endif // _EVSPACE_QUATERNION_ARRAY_H_
@@ -0,0 +1,362 @@
+#ifndef _EVSPACE_RANDOM_ROTATION_H_
+#define _EVSPACE_RANDOM_ROTATION_H_
+
+#include <evspace_common.hpp>
+#include <matrix.hpp>
+#include <vector.hpp>
+#include <matrix_array.hpp>
+#include <vector_array.hpp>
+#include <quaternion.hpp>
+#include <quaternion_array.hpp>
+#include <rotation_exponential.hpp>
+#include <sincos.hpp>
+#include <array>        // std::array
+#include <cmath>        // std::sqrt, std::log
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::int32_t, std::uint32_t, std::uint64_t
+
+namespace evspace {
+
+    /**
+     * Random rotations and directions for Monte Carlo work, drawn from the
+     * counter based Philox4x32-10 generator of Salmon et al. Its output is
+     * a pure function of a key and a 128 bit counter, so every element of
+     * a batch is generated from its own counter: the batches split across
+     * threads without locks and give the same values whatever the thread
+     * count, and separate streams of one seed never overlap.
+     *
+     * Each draw is four uniform doubles with 53 random bits, made from two
+     * Philox blocks, and element i of a batch uses draw position() + i.
+     */
+
+    // Philox4x32-10 keyed by a seed, with a stream number and a position
+    // in the stream. Streams with different numbers are independent, and
+    // the position advances by the number of draws each batch uses.
+    class Philox {
+    private:
+        std::uint32_t m_key[2];
+        std::uint64_t m_stream;
+        std::uint64_t m_position;
+
+    public:
+        explicit Philox(std::uint64_t seed, std::uint64_t stream = 0) noexcept;
+
+        std::uint64_t seed() const noexcept;
+        std::uint64_t stream() const noexcept;
+        std::uint64_t position() const noexcept;
+        // Moves the stream to a draw, for example to replay a batch or to
+        // skip over the draws of other workers.
+        void seek(std::uint64_t) noexcept;
+
+        // The Philox4x32-10 block of a counter, four random 32 bit words.
+        std::array<std::uint32_t, 4> block(const std::array<std::uint32_t, 4>&) const noexcept;
+        // The four uniform doubles in [0, 1) of the draw at the position,
+        // advancing the position by one.
+        std::array<double, 4> uniform() noexcept;
+    };
+
+    // Uniformly distributed random rotations, resizing the output to count.
+    // The quaternions are uniform on the unit sphere in four dimensions by
+    // Shoemake's method, which makes the rotations uniform over SO(3).
+    void random_rotations(Philox&, std::size_t, QuaternionArray&);
+    // As above, writing rotation matrices.
+    void random_rotations(Philox&, std::size_t, MatrixArray&);
+    // Uniformly distributed unit vectors, resizing the output to count.
+    void random_unit_vectors(Philox&, std::size_t, VectorArray&);
+    // Vectors of independent standard normal components, resizing the
+    // output to count.
+    void random_normal_vectors(Philox&, std::size_t, VectorArray&);
+    // Random rotations about mean, mean * exp([theta]x) with each rotation
+    // vector theta normal in the body frame with the standard deviations of
+    // sigmas about its axes, resizing the output to count.
+    void random_perturbations(Philox&, const Matrix&, const Vector&, std::size_t, MatrixArray&);
+
+    namespace _random_exec {
+
+        constexpr std::size_t _chunk_size = 256;
+        constexpr double _TWO_PI = 6.28318530717958647693;
+
+        // mulhilo of the Philox round, the high and low words of a * b.
+        inline void _multiply(std::uint32_t a, std::uint32_t b, std::uint32_t& high, std::uint32_t& low) noexcept {
+            const std::uint64_t product = static_cast<std::uint64_t>(a) * b;
+            high = static_cast<std::uint32_t>(product >> 32);
+            low = static_cast<std::uint32_t>(product);
+        }
+
+        // Ten rounds of Philox4x32 on the counter words with the two word
+        // key, in place.
+        inline void _rounds(std::uint32_t& c0, std::uint32_t& c1, std::uint32_t& c2, std::uint32_t& c3,
+                            std::uint32_t k0, std::uint32_t k1) noexcept
+        {
+            for (int round = 0; round < 10; round++) {
+                std::uint32_t high0, low0, high1, low1;
+                _multiply(0xD2511F53u, c0, high0, low0);
+                _multiply(0xCD9E8D57u, c2, high1, low1);
+                c0 = high1 ^ c1 ^ k0;
+                c1 = low1;
+                c2 = high0 ^ c3 ^ k1;
+                c3 = low0;
+                k0 += 0x9E3779B9u;
+                k1 += 0xBB67AE85u;
+            }
+        }
+
+        inline void _philox(const std::uint32_t* key, const std::uint32_t* counter, std::uint32_t* output) noexcept {
+            std::uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+            _rounds(c0, c1, c2, c3, key[0], key[1]);
+            output[0] = c0;
+            output[1] = c1;
+            output[2] = c2;
+            output[3] = c3;
+        }
+
+        // 53 random bits of two words as a double in [0, 1), all of high
+        // and the top 21 bits of low. Both parts convert through signed
+        // 32 bit integers, which unlike 64 bit conversions have vector
+        // instructions on AVX2.
+        inline double _to_uniform(std::uint32_t high, std::uint32_t low) noexcept {
+            const double top = static_cast<double>(static_cast<std::int32_t>(high ^ 0x80000000u)) + 2147483648.0;
+            const double bottom = static_cast<double>(static_cast<std::int32_t>(low >> 11));
+            return top * (1.0 / 4294967296.0) + bottom * (1.0 / 9007199254740992.0);
+        }
+
+        // The four uniform doubles of a draw of the generator's stream.
+        inline void _draw(const Philox& generator, std::uint64_t draw, double* uniforms) noexcept {
+            const std::uint64_t stream = generator.stream();
+            for (std::uint64_t half = 0; half < 2; half++) {
+                const std::uint64_t index = 2 * draw + half;
+                const std::array<std::uint32_t, 4> words = generator.block({
+                    static_cast<std::uint32_t>(index), static_cast<std::uint32_t>(index >> 32),
+                    static_cast<std::uint32_t>(stream), static_cast<std::uint32_t>(stream >> 32) });
+                uniforms[2 * half] = _to_uniform(words[0], words[1]);
+                uniforms[2 * half + 1] = _to_uniform(words[2], words[3]);
+            }
+        }
+
+        // Box-Muller radius of a uniform in [0, 1), sqrt(-2 ln(1 - u)).
+        inline double _normal_radius(double uniform) noexcept {
+            return std::sqrt(-2.0 * std::log(1.0 - uniform));
+        }
+
+        // The uniforms of chunk consecutive draws from first, uniform[k][i]
+        // uniform k of draw first + i, as _draw gives them. The rounds are
+        // run on every block of the chunk in turn so they vectorize.
+        inline void _draw_chunk(const Philox& generator, std::uint64_t first, std::size_t chunk,
+                                double (*uniform)[_chunk_size]) noexcept
+        {
+            const std::uint64_t seed = generator.seed(), stream = generator.stream();
+            for (std::uint64_t half = 0; half < 2; half++) {
+                double* even = uniform[2 * half];
+                double* odd = uniform[2 * half + 1];
+                for (std::size_t i = 0; i < chunk; i++) {
+                    const std::uint64_t index = 2 * (first + i) + half;
+                    std::uint32_t c0 = static_cast<std::uint32_t>(index), c1 = static_cast<std::uint32_t>(index >> 32);
+                    std::uint32_t c2 = static_cast<std::uint32_t>(stream), c3 = static_cast<std::uint32_t>(stream >> 32);
+                    _rounds(c0, c1, c2, c3, static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32));
+                    even[i] = _to_uniform(c0, c1);
+                    odd[i] = _to_uniform(c2, c3);
+                }
+            }
+        }
+
+        // A chunk of draws, uniform[k][i] the uniform k of draw i, with the
+        // sines and cosines of the angles 2 pi uniform[1] and 2 pi uniform[3],
+        // which every generator below uses as its angles.
+        struct _Draws {
+            double uniform[4][_chunk_size];
+            double sine[2][_chunk_size];
+            double cosine[2][_chunk_size];
+        };
+
+        // Fills draws with chunk consecutive draws of the generator from
+        // first, with their sines and cosines.
+        inline void _fill_draws(const Philox& generator, std::uint64_t first, std::size_t chunk, _Draws& draws) {
+            _draw_chunk(generator, first, chunk, draws.uniform);
+
+            double angles[_chunk_size];
+            for (std::size_t a = 0; a < 2; a++) {
+                for (std::size_t i = 0; i < chunk; i++) {
+                    angles[i] = _TWO_PI * draws.uniform[2 * a + 1][i];
+                }
+                sincos(span_t<const double>(angles, chunk), span_t<double>(draws.sine[a], chunk),
+                       span_t<double>(draws.cosine[a], chunk));
+            }
+        }
+
+        // Runs kernel(draws, start, chunk) over count draws of the generator
+        // a chunk at a time, splitting the chunks across threads for large
+        // batches, then advances the generator's position by count.
+        template<typename Kernel>
+        void _for_each_draw(Philox& generator, std::size_t count, Kernel&& kernel) {
+            const std::uint64_t first = generator.position();
+            const Philox& source = generator;
+            const std::size_t chunk_count = (count + _chunk_size - 1) / _chunk_size;
+
+            _EVSPACE_PARALLEL_FOR_IF(count >= _EVSPACE_PARALLEL_MINIMUM)
+            for (std::size_t chunk_index = 0; chunk_index < chunk_count; chunk_index++) {
+                const std::size_t start = chunk_index * _chunk_size;
+                const std::size_t chunk = count - start < _chunk_size ? count - start : _chunk_size;
+                _Draws draws;
+                _fill_draws(source, first + start, chunk, draws);
+                kernel(draws, start, chunk);
+            }
+
+            generator.seek(first + count);
+        }
+
+        // Uniform quaternion i of the draws by Shoemake's method.
+        inline void _uniform_quaternion(const _Draws& draws, std::size_t i, double* quaternion) noexcept {
+            const double lower = std::sqrt(1.0 - draws.uniform[0][i]);
+            const double upper = std::sqrt(draws.uniform[0][i]);
+            quaternion[0] = upper * draws.cosine[1][i];
+            quaternion[1] = lower * draws.sine[0][i];
+            quaternion[2] = lower * draws.cosine[0][i];
+            quaternion[3] = upper * draws.sine[1][i];
+        }
+
+        // Three independent standard normals of draw i by Box-Muller.
+        inline void _normal_vector(const _Draws& draws, std::size_t i, double* vector) noexcept {
+            const double first = _normal_radius(draws.uniform[0][i]);
+            vector[0] = first * draws.cosine[0][i];
+            vector[1] = first * draws.sine[0][i];
+            vector[2] = _normal_radius(draws.uniform[2][i]) * draws.cosine[1][i];
+        }
+
+    }
+
+    inline Philox::Philox(std::uint64_t seed, std::uint64_t stream) noexcept
+        : m_key{ static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32) },
+          m_stream(stream), m_position(0) { }
+
+    inline std::uint64_t Philox::seed() const noexcept {
+        return static_cast<std::uint64_t>(this->m_key[1]) << 32 | this->m_key[0];
+    }
+
+    inline std::uint64_t Philox::stream() const noexcept {
+        return this->m_stream;
+    }
+
+    inline std::uint64_t Philox::position() const noexcept {
+        return this->m_position;
+    }
+
+    inline void Philox::seek(std::uint64_t position) noexcept {
+        this->m_position = position;
+    }
+
+    inline std::array<std::uint32_t, 4> Philox::block(const std::array<std::uint32_t, 4>& counter) const noexcept {
+        std::array<std::uint32_t, 4> output;
+        _random_exec::_philox(this->m_key, counter.data(), output.data());
+        return output;
+    }
+
+    inline std::array<double, 4> Philox::uniform() noexcept {
+        std::array<double, 4> uniforms;
+        _random_exec::_draw(*this, this->m_position, uniforms.data());
+        this->m_position++;
+        return uniforms;
+    }
+
+    inline void random_rotations(Philox& generator, std::size_t count, QuaternionArray& rotations) {
+        rotations.resize(count);
+        double* const planes[4] = { rotations.w(), rotations.x(), rotations.y(), rotations.z() };
+
+        _random_exec::_for_each_draw(generator, count,
+            [&](const _random_exec::_Draws& draws, std::size_t start, std::size_t chunk) {
+                for (std::size_t i = 0; i < chunk; i++) {
+                    double quaternion[4];
+                    _random_exec::_uniform_quaternion(draws, i, quaternion);
+                    for (std::size_t k = 0; k < 4; k++) {
+                        planes[k][start + i] = quaternion[k];
+                    }
+                }
+            });
+    }
+
+    inline void random_rotations(Philox& generator, std::size_t count, MatrixArray& rotations) {
+        rotations.resize(count);
+        double* planes[9];
+        for (std::size_t component = 0; component < 9; component++) {
+            planes[component] = rotations.plane(component / 3, component % 3);
+        }
+
+        _random_exec::_for_each_draw(generator, count,
+            [&](const _random_exec::_Draws& draws, std::size_t start, std::size_t chunk) {
+                for (std::size_t i = 0; i < chunk; i++) {
+                    double quaternion[4], matrix[9];
+                    _random_exec::_uniform_quaternion(draws, i, quaternion);
+                    _quaternion_exec::_to_matrix(quaternion, matrix);
+                    for (std::size_t component = 0; component < 9; component++) {
+                        planes[component][start + i] = matrix[component];
+                    }
+                }
+            });
+    }
+
+    inline void random_unit_vectors(Philox& generator, std::size_t count, VectorArray& vectors) {
+        vectors.resize(count);
+        double* const planes[3] = { vectors.x(), vectors.y(), vectors.z() };
+
+        // z uniform in [-1, 1] and the longitude uniform, by Archimedes'
+        // hat-box theorem
+        _random_exec::_for_each_draw(generator, count,
+            [&](const _random_exec::_Draws& draws, std::size_t start, std::size_t chunk) {
+                for (std::size_t i = 0; i < chunk; i++) {
+                    const double z = 1.0 - 2.0 * draws.uniform[0][i];
+                    const double radius = std::sqrt(1.0 - z * z);
+                    planes[0][start + i] = radius * draws.cosine[0][i];
+                    planes[1][start + i] = radius * draws.sine[0][i];
+                    planes[2][start + i] = z;
+                }
+            });
+    }
+
+    inline void random_normal_vectors(Philox& generator, std::size_t count, VectorArray& vectors) {
+        vectors.resize(count);
+        double* const planes[3] = { vectors.x(), vectors.y(), vectors.z() };
+
+        _random_exec::_for_each_draw(generator, count,
+            [&](const _random_exec::_Draws& draws, std::size_t start, std::size_t chunk) {
+                for (std::size_t i = 0; i < chunk; i++) {
+                    double vector[3];
+                    _random_exec::_normal_vector(draws, i, vector);
+                    for (std::size_t k = 0; k < 3; k++) {
+                        planes[k][start + i] = vector[k];
+                    }
+                }
+            });
+    }
+
+    inline void random_perturbations(Philox& generator, const Matrix& mean, const Vector& sigmas, std::size_t count,
+                                     MatrixArray& rotations)
+    {
+        rotations.resize(count);
+        double* planes[9];
+        for (std::size_t component = 0; component < 9; component++) {
+            planes[component] = rotations.plane(component / 3, component % 3);
+        }
+        const double* m = mean.data().data();
+        const double* sigma = sigmas.data().data();
+
+        _random_exec::_for_each_draw(generator, count,
+            [&](const _random_exec::_Draws& draws, std::size_t start, std::size_t chunk) {
+                for (std::size_t i = 0; i < chunk; i++) {
+                    double theta[3], axis[3], half_sine, half_cosine, exponential[9];
+                    _random_exec::_normal_vector(draws, i, theta);
+                    const double angle = _exponential_exec::_axis(sigma[0] * theta[0], sigma[1] * theta[1],
+                                                                   sigma[2] * theta[2], axis);
+                    sincos(0.5 * angle, half_sine, half_cosine);
+                    _exponential_exec::_exponential(axis, half_sine, half_cosine, exponential);
+                    for (std::size_t r = 0; r < 3; r++) {
+                        for (std::size_t c = 0; c < 3; c++) {
+                            planes[r * 3 + c][start + i] = m[r * 3] * exponential[c] + m[r * 3 + 1] * exponential[3 + c]
+                                + m[r * 3 + 2] * exponential[6 + c];
+                        }
+                    }
+                }
+            });
+    }
+
+}   // namespace evspace
+
+#endif // _EVSPACE_RANDOM_ROTATION_H_
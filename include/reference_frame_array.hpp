@@ -0,0 +1,470 @@
+#ifndef _EVSPACE_REFERENCE_FRAME_ARRAY_H_
+#define _EVSPACE_REFERENCE_FRAME_ARRAY_H_
+
+#include <angles.hpp>
+#include <matrix.hpp>
+#include <vector.hpp>
+#include <vector_array.hpp>
+#include <matrix_array.hpp>
+#include <rotation.hpp>
+#include <sincos.hpp>
+#include <cstddef>      // std::size_t
+#include <iterator>     // std::forward_iterator_tag
+#include <stdexcept>    // std::out_of_range
+#include <vector>       // std::vector
+
+namespace evspace {
+
+    namespace _rotation_exec {
+
+        // Computes the rotation matrix of count sets of angles stored as
+        // three angle planes, writing component (r, c) of each matrix to
+        // planes[r * 3 + c]. Works in chunks so the sines and cosines stay
+        // in cache between the sincos pass and the matrix pass.
+        template<typename rotation_order, typename rotation_type>
+        void _derive_matrix_planes(const double* alpha, const double* beta, const double* gamma,
+                                   std::size_t count, double* const* planes)
+        {
+            constexpr std::size_t chunk_size = 256;
+            double cosines[3][chunk_size], sines[3][chunk_size];
+            const double* angles[3] = { alpha, beta, gamma };
+
+            for (std::size_t start = 0; start < count; start += chunk_size) {
+                const std::size_t chunk = count - start < chunk_size ? count - start : chunk_size;
+
+                for (std::size_t a = 0; a < 3; a++) {
+                    sincos(span_t<const double>(angles[a] + start, chunk),
+                           span_t<double>(sines[a], chunk), span_t<double>(cosines[a], chunk));
+                }
+
+                for (std::size_t i = 0; i < chunk; i++) {
+                    const double c[3] = { cosines[0][i], cosines[1][i], cosines[2][i] };
+                    const double s[3] = { sines[0][i], sines[1][i], sines[2][i] };
+                    double matrix[9];
+                    _EulerAngleDelegate<rotation_order, rotation_type>::derive_matrix(c, s, matrix);
+
+                    for (std::size_t component = 0; component < 9; component++) {
+                        planes[component][start + i] = matrix[component];
+                    }
+                }
+            }
+        }
+
+    }
+
+    // Collection of reference frames sharing a rotation order and type,
+    // stored as a structure of arrays: three angle planes, an offset
+    // VectorArray and a MatrixArray of the derived rotation matrices.
+    //
+    // Setting angles through a Frame proxy updates that frame's matrix
+    // immediately, like ReferenceFrame::set_angles. To update many frames
+    // at once, write the angle planes directly and call update_all(), which
+    // computes every matrix in one vectorized pass.
+    template<typename _rotation_order, typename _rotation_type=IntrinsicRotation>
+    class ReferenceFrameArray {
+    private:
+        std::size_t m_size;
+        std::size_t m_capacity;
+        // alpha plane, followed by the beta plane, followed by the gamma
+        // plane, each m_capacity long
+        std::vector<double> m_angles;
+        VectorArray m_offsets;
+        MatrixArray m_matrices;
+
+        void update_matrix(std::size_t);
+
+    public:
+
+        // Read only view of a single frame in the array.
+        class ConstFrame {
+        protected:
+            const ReferenceFrameArray* m_array;
+            std::size_t m_index;
+
+        public:
+            ConstFrame(const ReferenceFrameArray&, std::size_t) noexcept;
+
+            std::size_t index() const noexcept;
+            EulerAngles get_angles() const;
+            Vector get_offset() const;
+            Matrix get_matrix() const;
+
+            Vector rotate_to(const Vector&) const;
+            Vector rotate_from(const Vector&) const;
+        };
+
+        // Mutable view of a single frame in the array.
+        class Frame : public ConstFrame {
+        public:
+            Frame(ReferenceFrameArray&, std::size_t) noexcept;
+
+            void set_angles(std::size_t, double);
+            void set_angles(const EulerAngles&);
+            void set_offset(const Vector&);
+        };
+
+        // Forward iterator yielding frame proxies by value.
+        template<typename _proxy, typename _array>
+        class _FrameIterator {
+        private:
+            _array* m_array;
+            std::size_t m_index;
+
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef _proxy value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef void pointer;
+            typedef _proxy reference;
+
+            _FrameIterator(_array& array, std::size_t index) noexcept
+                : m_array(&array), m_index(index) { }
+
+            _proxy operator*() const noexcept {
+                return _proxy(*this->m_array, this->m_index);
+            }
+
+            _FrameIterator& operator++() noexcept {
+                this->m_index++;
+                return *this;
+            }
+
+            _FrameIterator operator++(int) noexcept {
+                _FrameIterator tmp = *this;
+                this->m_index++;
+                return tmp;
+            }
+
+            bool operator==(const _FrameIterator& rhs) const noexcept {
+                return this->m_array == rhs.m_array && this->m_index == rhs.m_index;
+            }
+
+            bool operator!=(const _FrameIterator& rhs) const noexcept {
+                return !(*this == rhs);
+            }
+        };
+
+        typedef _FrameIterator<Frame, ReferenceFrameArray> iterator;
+        typedef _FrameIterator<ConstFrame, const ReferenceFrameArray> const_iterator;
+
+        ReferenceFrameArray() noexcept;
+        // Constructs size frames with zero angles and offsets.
+        explicit ReferenceFrameArray(std::size_t);
+
+        std::size_t size() const noexcept;
+        std::size_t capacity() const noexcept;
+        // Grows the planes to hold at least capacity frames without
+        // changing the size, so later growth up to it doesn't reallocate.
+        void reserve(std::size_t);
+        // Resizes the array, preserving the existing frames which fit in
+        // the new size. New frames have zero angles and offsets.
+        void resize(std::size_t);
+        // Appends a frame, deriving only its matrix. The planes grow
+        // geometrically, so filling an array this way is amortized linear.
+        void push_back(const EulerAngles&, const Vector & = _zero_vector);
+
+        // Angle planes. Writing these does not update the matrices until
+        // update_all() is called.
+        double* alpha() noexcept;
+        double* beta() noexcept;
+        double* gamma() noexcept;
+        const double* alpha() const noexcept;
+        const double* beta() const noexcept;
+        const double* gamma() const noexcept;
+
+        VectorArray& offsets() noexcept;
+        const VectorArray& offsets() const noexcept;
+        const MatrixArray& matrices() const noexcept;
+
+        // Recomputes the rotation matrix of every frame from the angle planes.
+        void update_all();
+
+        Frame operator[](std::size_t);
+        ConstFrame operator[](std::size_t) const;
+
+        iterator begin() noexcept;
+        iterator end() noexcept;
+        const_iterator begin() const noexcept;
+        const_iterator end() const noexcept;
+
+        typedef _rotation_order  RotationOrder;
+        typedef _rotation_type   RotationType;
+    };
+
+    /**
+     * ReferenceFrameArray implementations.
+     */
+
+    template<typename rotation_order, typename rotation_type>
+    ReferenceFrameArray<rotation_order, rotation_type>::ReferenceFrameArray() noexcept
+        : m_size(0), m_capacity(0), m_angles(), m_offsets(), m_matrices() { }
+
+    template<typename rotation_order, typename rotation_type>
+    ReferenceFrameArray<rotation_order, rotation_type>::ReferenceFrameArray(std::size_t size)
+        : m_size(size), m_capacity(size), m_angles(3 * size, 0.0), m_offsets(size), m_matrices(size)
+    {
+        this->update_all();
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    std::size_t ReferenceFrameArray<rotation_order, rotation_type>::size() const noexcept {
+        return this->m_size;
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    std::size_t ReferenceFrameArray<rotation_order, rotation_type>::capacity() const noexcept {
+        return this->m_capacity;
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    void ReferenceFrameArray<rotation_order, rotation_type>::reserve(std::size_t capacity) {
+        if (capacity <= this->m_capacity) {
+            return;
+        }
+
+        std::vector<double> angles(3 * capacity, 0.0);
+        for (std::size_t plane = 0; plane < 3; plane++) {
+            for (std::size_t i = 0; i < this->m_size; i++) {
+                angles[plane * capacity + i] = this->m_angles[plane * this->m_capacity + i];
+            }
+        }
+
+        this->m_offsets.reserve(capacity);
+        this->m_matrices.reserve(capacity);
+        this->m_angles = std::move(angles);
+        this->m_capacity = capacity;
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    void ReferenceFrameArray<rotation_order, rotation_type>::resize(std::size_t size) {
+        const std::size_t old_size = this->m_size;
+        if (size > this->m_capacity) {
+            this->reserve(size > 2 * this->m_capacity ? size : 2 * this->m_capacity);
+        }
+
+        this->m_offsets.resize(size);
+        this->m_matrices.resize(size);
+        this->m_size = size;
+
+        // zero angles, whose matrix is the identity for every order
+        for (std::size_t plane = 0; plane < 3; plane++) {
+            for (std::size_t i = old_size; i < size; i++) {
+                this->m_angles[plane * this->m_capacity + i] = 0.0;
+            }
+        }
+        for (std::size_t diagonal = 0; diagonal < 3; diagonal++) {
+            double* plane = this->m_matrices.plane(diagonal, diagonal);
+            for (std::size_t i = old_size; i < size; i++) {
+                plane[i] = 1.0;
+            }
+        }
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    void ReferenceFrameArray<rotation_order, rotation_type>::push_back(const EulerAngles& angles, const Vector& offset) {
+        const std::size_t index = this->m_size;
+        if (index == this->m_capacity) {
+            this->reserve(index > 0 ? 2 * index : 1);
+        }
+
+        this->m_offsets.resize(index + 1);
+        this->m_matrices.resize(index + 1);
+        this->m_size = index + 1;
+        this->alpha()[index] = angles[0];
+        this->beta()[index] = angles[1];
+        this->gamma()[index] = angles[2];
+        this->m_offsets.set(index, offset);
+        this->update_matrix(index);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    double* ReferenceFrameArray<rotation_order, rotation_type>::alpha() noexcept {
+        return this->m_angles.data();
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    double* ReferenceFrameArray<rotation_order, rotation_type>::beta() noexcept {
+        return this->m_angles.data() + this->m_capacity;
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    double* ReferenceFrameArray<rotation_order, rotation_type>::gamma() noexcept {
+        return this->m_angles.data() + 2 * this->m_capacity;
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    const double* ReferenceFrameArray<rotation_order, rotation_type>::alpha() const noexcept {
+        return this->m_angles.data();
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    const double* ReferenceFrameArray<rotation_order, rotation_type>::beta() const noexcept {
+        return this->m_angles.data() + this->m_capacity;
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    const double* ReferenceFrameArray<rotation_order, rotation_type>::gamma() const noexcept {
+        return this->m_angles.data() + 2 * this->m_capacity;
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    VectorArray& ReferenceFrameArray<rotation_order, rotation_type>::offsets() noexcept {
+        return this->m_offsets;
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    const VectorArray& ReferenceFrameArray<rotation_order, rotation_type>::offsets() const noexcept {
+        return this->m_offsets;
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    const MatrixArray& ReferenceFrameArray<rotation_order, rotation_type>::matrices() const noexcept {
+        return this->m_matrices;
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    void ReferenceFrameArray<rotation_order, rotation_type>::update_matrix(std::size_t index) {
+        double cosines[3], sines[3], matrix[9];
+        sincos(this->alpha()[index], sines[0], cosines[0]);
+        sincos(this->beta()[index], sines[1], cosines[1]);
+        sincos(this->gamma()[index], sines[2], cosines[2]);
+        _EulerAngleDelegate<rotation_order, rotation_type>::derive_matrix(cosines, sines, matrix);
+
+        for (std::size_t component = 0; component < 9; component++) {
+            this->m_matrices.plane(component / 3, component % 3)[index] = matrix[component];
+        }
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    void ReferenceFrameArray<rotation_order, rotation_type>::update_all() {
+        double* planes[9];
+        for (std::size_t component = 0; component < 9; component++) {
+            planes[component] = this->m_matrices.plane(component / 3, component % 3);
+        }
+
+        _rotation_exec::_derive_matrix_planes<rotation_order, rotation_type>(
+            this->alpha(), this->beta(), this->gamma(), this->m_size, planes);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    typename ReferenceFrameArray<rotation_order, rotation_type>::Frame
+    ReferenceFrameArray<rotation_order, rotation_type>::operator[](std::size_t index) {
+        if (index >= this->m_size) {
+            throw std::out_of_range("ReferenceFrameArray index out of range");
+        }
+
+        return Frame(*this, index);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    typename ReferenceFrameArray<rotation_order, rotation_type>::ConstFrame
+    ReferenceFrameArray<rotation_order, rotation_type>::operator[](std::size_t index) const {
+        if (index >= this->m_size) {
+            throw std::out_of_range("ReferenceFrameArray index out of range");
+        }
+
+        return ConstFrame(*this, index);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    typename ReferenceFrameArray<rotation_order, rotation_type>::iterator
+    ReferenceFrameArray<rotation_order, rotation_type>::begin() noexcept {
+        return iterator(*this, 0);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    typename ReferenceFrameArray<rotation_order, rotation_type>::iterator
+    ReferenceFrameArray<rotation_order, rotation_type>::end() noexcept {
+        return iterator(*this, this->m_size);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    typename ReferenceFrameArray<rotation_order, rotation_type>::const_iterator
+    ReferenceFrameArray<rotation_order, rotation_type>::begin() const noexcept {
+        return const_iterator(*this, 0);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    typename ReferenceFrameArray<rotation_order, rotation_type>::const_iterator
+    ReferenceFrameArray<rotation_order, rotation_type>::end() const noexcept {
+        return const_iterator(*this, this->m_size);
+    }
+
+    /**
+     * Frame proxy implementations.
+     */
+
+    template<typename rotation_order, typename rotation_type>
+    ReferenceFrameArray<rotation_order, rotation_type>::ConstFrame::ConstFrame(
+        const ReferenceFrameArray& array, std::size_t index) noexcept
+        : m_array(&array), m_index(index) { }
+
+    template<typename rotation_order, typename rotation_type>
+    std::size_t ReferenceFrameArray<rotation_order, rotation_type>::ConstFrame::index() const noexcept {
+        return this->m_index;
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    EulerAngles ReferenceFrameArray<rotation_order, rotation_type>::ConstFrame::get_angles() const {
+        return EulerAngles(
+            this->m_array->alpha()[this->m_index],
+            this->m_array->beta()[this->m_index],
+            this->m_array->gamma()[this->m_index]
+        );
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    Vector ReferenceFrameArray<rotation_order, rotation_type>::ConstFrame::get_offset() const {
+        return this->m_array->m_offsets.get(this->m_index);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    Matrix ReferenceFrameArray<rotation_order, rotation_type>::ConstFrame::get_matrix() const {
+        return this->m_array->m_matrices.get(this->m_index);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    Vector ReferenceFrameArray<rotation_order, rotation_type>::ConstFrame::rotate_to(const Vector& vector) const {
+        return _rotation_exec::_rotate_to_exec(this->get_matrix(), vector, this->get_offset());
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    Vector ReferenceFrameArray<rotation_order, rotation_type>::ConstFrame::rotate_from(const Vector& vector) const {
+        return _rotation_exec::_rotate_from_exec(this->get_matrix(), vector, this->get_offset());
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    ReferenceFrameArray<rotation_order, rotation_type>::Frame::Frame(
+        ReferenceFrameArray& array, std::size_t index) noexcept
+        : ConstFrame(array, index) { }
+
+    template<typename rotation_order, typename rotation_type>
+    void ReferenceFrameArray<rotation_order, rotation_type>::Frame::set_angles(std::size_t index, double value) {
+        if (index > 2) {
+            throw std::out_of_range("Angle index out of range");
+        }
+
+        // the proxy was constructed from a mutable array
+        ReferenceFrameArray* array = const_cast<ReferenceFrameArray*>(this->m_array);
+        array->m_angles[index * array->m_capacity + this->m_index] = value;
+        array->update_matrix(this->m_index);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    void ReferenceFrameArray<rotation_order, rotation_type>::Frame::set_angles(const EulerAngles& angles) {
+        ReferenceFrameArray* array = const_cast<ReferenceFrameArray*>(this->m_array);
+        array->alpha()[this->m_index] = angles[0];
+        array->beta()[this->m_index] = angles[1];
+        array->gamma()[this->m_index] = angles[2];
+        array->update_matrix(this->m_index);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    void ReferenceFrameArray<rotation_order, rotation_type>::Frame::set_offset(const Vector& offset) {
+        ReferenceFrameArray* array = const_cast<ReferenceFrameArray*>(this->m_array);
+        array->m_offsets.set(this->m_index, offset);
+    }
+
+}   // namespace evspace
+
+#endif // _EVSPACE_REFERENCE_FRAME_ARRAY_H_
@@ -4,9 +4,11 @@
 #include <angles.hpp>
 #include <matrix.hpp>
 #include <vector.hpp>
+#include <vector_array.hpp>
 #include <cstddef>      // std::size_t
 #include <stdexcept>    // std::out_of_range
-#include <cmath>        // std::cos, std::sin
+#include <cmath>        // std::cos, std::sin, std::fabs, std::nearbyint, std::fma
+#include <type_traits>  // std::is_same_v
 
 namespace evspace {
 
@@ -30,41 +32,123 @@ namespace evspace {
     struct IntrinsicRotation : RotationType { };
     struct ExtrinsicRotation : RotationType { };
 
+    /**
+     * Offset types to distinguish frames offset from the inertial frame
+     * vs frames which are pure rotations.
+     */
+    struct OffsetType { };
+    struct WithOffset : OffsetType { };
+    struct WithoutOffset : OffsetType { };
+
+    // Defined in rotation_cache.hpp.
+    class RotationMatrixCache;
+
     // Internal variable for fuction default
     inline const Vector _zero_vector = Vector(0.0, 0.0, 0.0);
 
-    template<typename _rotation_order, typename _rotation_type=IntrinsicRotation>
-    class ReferenceFrame {
+    // Offset storage for ReferenceFrame. Rotation only frames derive from
+    // the empty specialization so they carry no offset vector.
+    template<typename _offset_type>
+    struct _FrameOffsetStorage {
+        Vector m_offset;
+
+        _FrameOffsetStorage() : m_offset(0.0, 0.0, 0.0) { }
+        _FrameOffsetStorage(const Vector& offset) : m_offset(offset) { }
+    };
+
+    template<>
+    struct _FrameOffsetStorage<WithoutOffset> {
+        _FrameOffsetStorage() noexcept { }
+        _FrameOffsetStorage(const Vector&) noexcept { }
+    };
+
+    // A reference frame rotated (and optionally offset) from an inertial
+    // frame. Frames with an offset_type of WithoutOffset are pure
+    // rotations: they store no offset, cannot be given one, and rotate
+    // vectors with the non-offset kernels.
+    template<typename _rotation_order, typename _rotation_type=IntrinsicRotation, typename _offset_type=WithOffset>
+    class ReferenceFrame : private _FrameOffsetStorage<_offset_type> {
     private:
         EulerAngles m_angles;
-        Vector m_offset;
         Matrix m_matrix;
 
         void update_matrix();
 
+        static constexpr bool has_offset = !std::is_same_v<_offset_type, WithoutOffset>;
+
     public:
         ReferenceFrame() = delete;
-        ReferenceFrame(const EulerAngles&, const Vector & = _zero_vector);
+        ReferenceFrame(const EulerAngles&);
+        // Only valid for frames WithOffset.
+        ReferenceFrame(const EulerAngles&, const Vector&);
 
         //double& operator[](std::size_t);
         const double& operator[](std::size_t) const;
 
         const EulerAngles& get_angles() const;
+        // Rotation only frames return the zero vector.
         const Vector& get_offset() const;
         const Matrix& get_matrix() const;
         void set_angles(std::size_t, double);
         void set_angles(const EulerAngles&);
+        // Looks the new matrix up in cache rather than deriving it. Defined
+        // in rotation_cache.hpp.
+        void set_angles(std::size_t, double, RotationMatrixCache&);
+        void set_angles(const EulerAngles&, RotationMatrixCache&);
+        // Only valid for frames WithOffset.
         void set_offset(const Vector&);
 
         Vector rotate_to(const Vector&) const;
-        template<typename param_order, typename param_type>
-        Vector rotate_to(const ReferenceFrame<param_order, param_type>&, const Vector&) const;
+        template<typename param_order, typename param_type, typename param_offset>
+        Vector rotate_to(const ReferenceFrame<param_order, param_type, param_offset>&, const Vector&) const;
         Vector rotate_from(const Vector&) const;
-        template<typename param_order, typename param_type>
-        Vector rotate_from(const ReferenceFrame<param_order, param_type>&, const Vector&) const;
+        template<typename param_order, typename param_type, typename param_offset>
+        Vector rotate_from(const ReferenceFrame<param_order, param_type, param_offset>&, const Vector&) const;
 
         typedef _rotation_order  RotationOrder;
         typedef _rotation_type   RotationType;
+        typedef _offset_type     OffsetType;
+    };
+
+    // Position and velocity of a point, the six element state that is
+    // transformed between rotating reference frames.
+    struct State {
+        Vector position;
+        Vector velocity;
+    };
+
+    // A ReferenceFrame whose orientation is changing with a constant angular
+    // velocity. The angular velocity is expressed in the basis of the frame
+    // being rotated from (the inertial frame), the same basis as the offset
+    // vector. Transforming velocities between a rotating frame and the
+    // inertial frame includes the transport term (angular_velocity x r).
+    template<typename _rotation_order, typename _rotation_type=IntrinsicRotation>
+    class RotatingReferenceFrame : public ReferenceFrame<_rotation_order, _rotation_type> {
+    private:
+        Vector m_angular_velocity;
+
+    public:
+        RotatingReferenceFrame() = delete;
+        RotatingReferenceFrame(const EulerAngles&, const Vector&, const Vector & = _zero_vector);
+
+        const Vector& get_angular_velocity() const;
+        void set_angular_velocity(const Vector&);
+
+        using ReferenceFrame<_rotation_order, _rotation_type>::rotate_to;
+        using ReferenceFrame<_rotation_order, _rotation_type>::rotate_from;
+
+        State rotate_to(const State&) const;
+        State rotate_from(const State&) const;
+        template<typename param_order, typename param_type>
+        State rotate_to(const RotatingReferenceFrame<param_order, param_type>&, const State&) const;
+        template<typename param_order, typename param_type>
+        State rotate_from(const RotatingReferenceFrame<param_order, param_type>&, const State&) const;
+
+        // Batch state transforms. Positions and velocities are transformed
+        // together in a single pass, and the output arrays are resized to
+        // match the input. The output arrays may be the input arrays.
+        void rotate_to(const VectorArray&, const VectorArray&, VectorArray&, VectorArray&) const;
+        void rotate_from(const VectorArray&, const VectorArray&, VectorArray&, VectorArray&) const;
     };
 
     /**
@@ -97,6 +181,14 @@ namespace evspace {
     template<typename rotation_from, typename rotation_to, typename from_type = IntrinsicRotation, typename to_type = IntrinsicRotation>
     Matrix compute_rotation_matrix(const EulerAngles& angles_from, const EulerAngles& angles_to);
 
+    // Computes a set of Euler angles that produce rotation_matrix with the
+    // given rotation order and type. The middle angle is in [-pi/2, pi/2]
+    // for improper rotations and [0, pi] for proper rotations. At a gimbal
+    // lock only the sum (or difference) of the outer angles is defined, in
+    // which case the last angle is set to zero.
+    template<typename rotation_order, typename rotation_type = IntrinsicRotation>
+    EulerAngles compute_euler_angles(const Matrix&);
+
     /**
      * Rotation function declarations.
      */
@@ -157,9 +249,118 @@ namespace evspace {
             return (vector - offset) * matrix;
         }
 
-    }
+        /**
+         *  State rotations for rotating reference frames.
+         *
+         *  If w is the angular velocity of the rotated frame relative to the
+         *  inertial frame (in the inertial basis), rotating a state from the
+         *  rotated frame computes r' = (m * r) + o and v' = (m * v) + w x (m * r).
+         *  Rotating a state to the rotated frame computes d = r - o,
+         *  r' = d * m and v' = (v - w x d) * m. The kernels below work on raw
+         *  buffers so the single State and batch interfaces share them.
+         */
+
+        inline void _rotate_state_from_exec(const double* m, const double* w, const double* o,
+                                            const double* r, const double* v,
+                                            double* r_out, double* v_out) noexcept
+        {
+            double mr[3], mv[3];
+            for (int i = 0; i < 3; i++) {
+                mr[i] = std::fma(m[i * 3], r[0], std::fma(m[i * 3 + 1], r[1], m[i * 3 + 2] * r[2]));
+                mv[i] = std::fma(m[i * 3], v[0], std::fma(m[i * 3 + 1], v[1], m[i * 3 + 2] * v[2]));
+            }
+
+            r_out[0] = mr[0] + o[0];
+            r_out[1] = mr[1] + o[1];
+            r_out[2] = mr[2] + o[2];
+            v_out[0] = mv[0] + (w[1] * mr[2] - w[2] * mr[1]);
+            v_out[1] = mv[1] + (w[2] * mr[0] - w[0] * mr[2]);
+            v_out[2] = mv[2] + (w[0] * mr[1] - w[1] * mr[0]);
+        }
+
+        inline void _rotate_state_to_exec(const double* m, const double* w, const double* o,
+                                          const double* r, const double* v,
+                                          double* r_out, double* v_out) noexcept
+        {
+            double d[3] = { r[0] - o[0], r[1] - o[1], r[2] - o[2] };
+            double u[3] = {
+                v[0] - (w[1] * d[2] - w[2] * d[1]),
+                v[1] - (w[2] * d[0] - w[0] * d[2]),
+                v[2] - (w[0] * d[1] - w[1] * d[0])
+            };
+
+            for (int i = 0; i < 3; i++) {
+                r_out[i] = std::fma(d[0], m[i], std::fma(d[1], m[3 + i], d[2] * m[6 + i]));
+                v_out[i] = std::fma(u[0], m[i], std::fma(u[1], m[3 + i], u[2] * m[6 + i]));
+            }
+        }
+
+        template<void (*_kernel)(const double*, const double*, const double*, const double*,
+                                 const double*, double*, double*) noexcept>
+        inline void _rotate_state_batch_exec(const Matrix& matrix, const Vector& angular_velocity,
+                                             const Vector& offset, const VectorArray& positions,
+                                             const VectorArray& velocities, VectorArray& out_positions,
+                                             VectorArray& out_velocities)
+        {
+            const std::size_t size = positions.size();
+            if (velocities.size() != size) {
+                throw std::out_of_range("Position and velocity arrays must be the same size");
+            }
+            out_positions.resize(size);
+            out_velocities.resize(size);
+
+            const double* m = matrix.data().data();
+            const double* w = angular_velocity.data().data();
+            const double* o = offset.data().data();
+            const double *rx = positions.x(), *ry = positions.y(), *rz = positions.z();
+            const double *vx = velocities.x(), *vy = velocities.y(), *vz = velocities.z();
+            double *rx_out = out_positions.x(), *ry_out = out_positions.y(), *rz_out = out_positions.z();
+            double *vx_out = out_velocities.x(), *vy_out = out_velocities.y(), *vz_out = out_velocities.z();
+
+            for (std::size_t i = 0; i < size; i++) {
+                const double r[3] = { rx[i], ry[i], rz[i] };
+                const double v[3] = { vx[i], vy[i], vz[i] };
+                double r_out[3], v_out[3];
+                _kernel(m, w, o, r, v, r_out, v_out);
+                rx_out[i] = r_out[0];
+                ry_out[i] = r_out[1];
+                rz_out[i] = r_out[2];
+                vx_out[i] = v_out[0];
+                vy_out[i] = v_out[1];
+                vz_out[i] = v_out[2];
+            }
+        }
+
+        // Applies a row-major matrix to every vector of input, in the
+        // rotate_from sense if from is true, otherwise the rotate_to sense.
+        inline void _rotate_batch_exec(const double* m, const double* offset, bool from,
+                                       const VectorArray& input, VectorArray& output)
+        {
+            const std::size_t size = input.size();
+            output.resize(size);
+
+            const double *x = input.x(), *y = input.y(), *z = input.z();
+            double *x_out = output.x(), *y_out = output.y(), *z_out = output.z();
+
+            if (from) {
+                for (std::size_t i = 0; i < size; i++) {
+                    const double vx = x[i], vy = y[i], vz = z[i];
+                    x_out[i] = m[0] * vx + m[1] * vy + m[2] * vz + offset[0];
+                    y_out[i] = m[3] * vx + m[4] * vy + m[5] * vz + offset[1];
+                    z_out[i] = m[6] * vx + m[7] * vy + m[8] * vz + offset[2];
+                }
+            }
+            else {
+                for (std::size_t i = 0; i < size; i++) {
+                    const double vx = x[i] - offset[0], vy = y[i] - offset[1], vz = z[i] - offset[2];
+                    x_out[i] = vx * m[0] + vy * m[3] + vz * m[6];
+                    y_out[i] = vx * m[1] + vy * m[4] + vz * m[7];
+                    z_out[i] = vx * m[2] + vy * m[5] + vz * m[8];
+                }
+            }
+        }
 
-    // fixme: should these handle rotating reference frames?
+    }
 
     // Rotates vector to an inertial reference frame from a reference frame
     // defined by rotation_matrix. The inertial reference frame here assumes
@@ -223,16 +424,223 @@ namespace evspace {
     template<typename rotation_from, typename rotation_to, typename from_type = IntrinsicRotation, typename to_type = IntrinsicRotation>
     Vector rotate_between(const EulerAngles&, const EulerAngles&, const Vector&, const Vector & = _zero_vector, const Vector & = _zero_vector);
 
+    /**
+     * Closed form composition of elementary rotations. An elementary rotation
+     * about an axis only mixes the two components in the plane perpendicular
+     * to that axis, so composing one onto a matrix only updates two columns.
+     * These kernels work on raw row-major buffers with all indices resolved
+     * at compile time, so loops over many matrices vectorize.
+     */
+
+    // Indices of the plane an elementary rotation about _axis acts in. A
+    // rotation by angle takes (v[i], v[j]) to (c * v[i] - s * v[j],
+    // s * v[i] + c * v[j]) and leaves v[k] unchanged.
+    template<typename _axis>
+    struct _AxisPlane {
+        static constexpr std::size_t k = static_cast<std::size_t>(_axis::direction);
+        static constexpr std::size_t i = (k + 1) % 3;
+        static constexpr std::size_t j = (k + 2) % 3;
+    };
+
+    namespace _rotation_exec {
+
+        constexpr double _HALF_PI = 1.57079632679489661923;
+
+        // Returns true if angle is exactly n * (pi / 2) in double precision,
+        // setting quarter_turns to n modulo 4 in [0, 3]. Angles such as
+        // pi / 2, -pi and 3 * pi / 2 written with a double pi constant match.
+        inline bool _quarter_turns(double angle, int& quarter_turns) noexcept {
+            const double turns = std::nearbyint(angle / _HALF_PI);
+            if (std::fabs(turns) > 1048576.0 || turns * _HALF_PI != angle) {
+                return false;
+            }
+
+            quarter_turns = static_cast<int>(static_cast<long>(turns) & 3);
+            return true;
+        }
+
+        // Cosine and sine of angle. Multiples of pi / 2 give exact zeros and
+        // ones instead of the ~1e-16 noise of std::cos and std::sin.
+        inline void _axis_trig(double angle, double& c, double& s) noexcept {
+            int quarter_turns;
+            if (_quarter_turns(angle, quarter_turns)) {
+                constexpr double cosines[4] = { 1.0, 0.0, -1.0, 0.0 };
+                constexpr double sines[4] = { 0.0, 1.0, 0.0, -1.0 };
+                c = cosines[quarter_turns];
+                s = sines[quarter_turns];
+            }
+            else {
+                c = std::cos(angle);
+                s = std::sin(angle);
+            }
+        }
+
+        // The elementary rotation kernels are templated on the scalar so
+        // that the Dual numbers of dual.hpp differentiate through the same
+        // code, they are only ever instantiated for double otherwise.
+        //
+        // Writes the elementary rotation matrix about axis to m.
+        template<typename axis, typename T>
+        inline void _elementary_matrix(T c, T s, T* m) noexcept {
+            constexpr std::size_t i = _AxisPlane<axis>::i;
+            constexpr std::size_t j = _AxisPlane<axis>::j;
+            constexpr std::size_t k = _AxisPlane<axis>::k;
+
+            m[k * 3 + k] = T(1.0);
+            m[k * 3 + i] = T(0.0);
+            m[k * 3 + j] = T(0.0);
+            m[i * 3 + k] = T(0.0);
+            m[j * 3 + k] = T(0.0);
+            m[i * 3 + i] = c;
+            m[i * 3 + j] = -s;
+            m[j * 3 + i] = s;
+            m[j * 3 + j] = c;
+        }
+
+        // Right multiplies m by the elementary rotation about axis in place.
+        template<typename axis, typename T>
+        inline void _post_multiply_elementary(T c, T s, T* m) noexcept {
+            constexpr std::size_t i = _AxisPlane<axis>::i;
+            constexpr std::size_t j = _AxisPlane<axis>::j;
+
+            for (std::size_t r = 0; r < 3; r++) {
+                const T a = m[r * 3 + i];
+                const T b = m[r * 3 + j];
+                m[r * 3 + i] = c * a + s * b;
+                m[r * 3 + j] = c * b - s * a;
+            }
+        }
+
+        // Left multiplies m by the elementary rotation about axis in place.
+        template<typename axis, typename T>
+        inline void _pre_multiply_elementary(T c, T s, T* m) noexcept {
+            constexpr std::size_t i = _AxisPlane<axis>::i;
+            constexpr std::size_t j = _AxisPlane<axis>::j;
+
+            for (std::size_t col = 0; col < 3; col++) {
+                const T a = m[i * 3 + col];
+                const T b = m[j * 3 + col];
+                m[i * 3 + col] = c * a - s * b;
+                m[j * 3 + col] = s * a + c * b;
+            }
+        }
+
+        // Computes R1 * R2 * R3 for elementary rotations about axis1, axis2
+        // and axis3 from their cosines and sines.
+        template<typename axis1, typename axis2, typename axis3, typename T>
+        inline void _compose_elementary(T c1, T s1, T c2, T s2, T c3, T s3, T* m) noexcept {
+            _elementary_matrix<axis1>(c1, s1, m);
+            _post_multiply_elementary<axis2>(c2, s2, m);
+            _post_multiply_elementary<axis3>(c3, s3, m);
+        }
+
+        // Applies the elementary rotation about axis to v in place, (m * v)
+        // where m is the elementary rotation matrix.
+        template<typename axis, typename T>
+        inline void _rotate_elementary_from(T c, T s, T* v) noexcept {
+            constexpr std::size_t i = _AxisPlane<axis>::i;
+            constexpr std::size_t j = _AxisPlane<axis>::j;
+
+            const T a = v[i];
+            const T b = v[j];
+            v[i] = c * a - s * b;
+            v[j] = s * a + c * b;
+        }
+
+        // Applies the inverse elementary rotation about axis to v in place,
+        // (v * m) where m is the elementary rotation matrix.
+        template<typename axis, typename T>
+        inline void _rotate_elementary_to(T c, T s, T* v) noexcept {
+            constexpr std::size_t i = _AxisPlane<axis>::i;
+            constexpr std::size_t j = _AxisPlane<axis>::j;
+
+            const T a = v[i];
+            const T b = v[j];
+            v[i] = c * a + s * b;
+            v[j] = c * b - s * a;
+        }
+
+        // Applies n quarter turns about axis to v in place in the rotate_from
+        // sense. Quarter turns only permute and negate components, so the
+        // result is exact.
+        template<typename axis>
+        inline void _rotate_quarter_turns_from(int quarter_turns, double* v) noexcept {
+            constexpr std::size_t i = _AxisPlane<axis>::i;
+            constexpr std::size_t j = _AxisPlane<axis>::j;
+
+            const double a = v[i];
+            const double b = v[j];
+            switch (quarter_turns & 3) {
+            case 1:
+                v[i] = -b;
+                v[j] = a;
+                break;
+            case 2:
+                v[i] = -a;
+                v[j] = -b;
+                break;
+            case 3:
+                v[i] = b;
+                v[j] = -a;
+                break;
+            default:
+                break;
+            }
+        }
+
+        // Applies n quarter turns about axis to v in place in the rotate_to
+        // sense, the inverse of _rotate_quarter_turns_from.
+        template<typename axis>
+        inline void _rotate_quarter_turns_to(int quarter_turns, double* v) noexcept {
+            _rotate_quarter_turns_from<axis>(4 - (quarter_turns & 3), v);
+        }
+
+        // Cosines and sines of a set of Euler angles, exact for multiples
+        // of pi / 2.
+        inline void _euler_angle_trig(const EulerAngles& angles, double* cosines, double* sines) {
+            for (std::size_t i = 0; i < 3; i++) {
+                _axis_trig(angles[i], cosines[i], sines[i]);
+            }
+        }
+
+        // Sparse single axis rotation kernels shared by the _SingleAxisDelegate
+        // specializations. Only the two components in the plane of rotation
+        // are touched, and quarter turns take an exact permutation path.
+        template<typename axis>
+        struct _SingleAxisKernels {
+            static inline void rotate_from(double angle, double* vector) noexcept {
+                int quarter_turns;
+                if (_quarter_turns(angle, quarter_turns)) {
+                    _rotate_quarter_turns_from<axis>(quarter_turns, vector);
+                }
+                else {
+                    _rotate_elementary_from<axis>(std::cos(angle), std::sin(angle), vector);
+                }
+            }
+
+            static inline void rotate_to(double angle, double* vector) noexcept {
+                int quarter_turns;
+                if (_quarter_turns(angle, quarter_turns)) {
+                    _rotate_quarter_turns_to<axis>(quarter_turns, vector);
+                }
+                else {
+                    _rotate_elementary_to<axis>(std::cos(angle), std::sin(angle), vector);
+                }
+            }
+        };
+
+    }
+
     /**
      * Template specialization of single axis rotation delegate classes.
      * These are the bread and butter of the rotation part of the library.
      */
 
     template<>
-    struct _SingleAxisDelegate<XAxis> {
+    struct _SingleAxisDelegate<XAxis> : _rotation_exec::_SingleAxisKernels<XAxis> {
         static inline Matrix derive_matrix(double angle) {
-            double cos_angle = std::cos(angle);
-            double sin_angle = std::sin(angle);
+            double cos_angle, sin_angle;
+            _rotation_exec::_axis_trig(angle, cos_angle, sin_angle);
 
             return Matrix(
                 {
@@ -245,10 +653,10 @@ namespace evspace {
     };
 
     template<>
-    struct _SingleAxisDelegate<YAxis> {
+    struct _SingleAxisDelegate<YAxis> : _rotation_exec::_SingleAxisKernels<YAxis> {
         static inline Matrix derive_matrix(double angle) {
-            double cos_angle = std::cos(angle);
-            double sin_angle = std::sin(angle);
+            double cos_angle, sin_angle;
+            _rotation_exec::_axis_trig(angle, cos_angle, sin_angle);
 
             return Matrix(
                 {
@@ -261,11 +669,11 @@ namespace evspace {
     };
 
     template<>
-    struct _SingleAxisDelegate<ZAxis> {
+    struct _SingleAxisDelegate<ZAxis> : _rotation_exec::_SingleAxisKernels<ZAxis> {
 
         static inline Matrix derive_matrix(double angle) {
-            double cos_angle = std::cos(angle);
-            double sin_angle = std::sin(angle);
+            double cos_angle, sin_angle;
+            _rotation_exec::_axis_trig(angle, cos_angle, sin_angle);
 
             return Matrix(
                 {
@@ -291,6 +699,32 @@ namespace evspace {
                 * _SingleAxisDelegate<axis3>::derive_matrix(gamma);
         }
 
+        // Closed form of derive_matrix from the cosines and sines of the
+        // angles, written to a row-major buffer.
+        template<typename T>
+        static inline void derive_matrix(const T* cosines, const T* sines, T* matrix) noexcept {
+            _rotation_exec::_compose_elementary<axis1, axis2, axis3>(
+                cosines[0], sines[0], cosines[1], sines[1], cosines[2], sines[2], matrix);
+        }
+
+        // Rotates vector in place in the rotate_from sense without forming
+        // the matrix, applying the elementary rotations right to left.
+        template<typename T>
+        static inline void rotate_from(const T* cosines, const T* sines, T* vector) noexcept {
+            _rotation_exec::_rotate_elementary_from<axis3>(cosines[2], sines[2], vector);
+            _rotation_exec::_rotate_elementary_from<axis2>(cosines[1], sines[1], vector);
+            _rotation_exec::_rotate_elementary_from<axis1>(cosines[0], sines[0], vector);
+        }
+
+        // Rotates vector in place in the rotate_to sense without forming
+        // the matrix, applying the inverse elementary rotations left to right.
+        template<typename T>
+        static inline void rotate_to(const T* cosines, const T* sines, T* vector) noexcept {
+            _rotation_exec::_rotate_elementary_to<axis1>(cosines[0], sines[0], vector);
+            _rotation_exec::_rotate_elementary_to<axis2>(cosines[1], sines[1], vector);
+            _rotation_exec::_rotate_elementary_to<axis3>(cosines[2], sines[2], vector);
+        }
+
     };
 
     template<typename axis1, typename axis2, typename axis3>
@@ -302,54 +736,93 @@ namespace evspace {
                 * _SingleAxisDelegate<axis1>::derive_matrix(alpha);
         }
 
+        // Closed form of derive_matrix from the cosines and sines of the
+        // angles, written to a row-major buffer.
+        template<typename T>
+        static inline void derive_matrix(const T* cosines, const T* sines, T* matrix) noexcept {
+            _rotation_exec::_compose_elementary<axis3, axis2, axis1>(
+                cosines[2], sines[2], cosines[1], sines[1], cosines[0], sines[0], matrix);
+        }
+
+        // Rotates vector in place in the rotate_from sense without forming
+        // the matrix, applying the elementary rotations right to left.
+        template<typename T>
+        static inline void rotate_from(const T* cosines, const T* sines, T* vector) noexcept {
+            _rotation_exec::_rotate_elementary_from<axis1>(cosines[0], sines[0], vector);
+            _rotation_exec::_rotate_elementary_from<axis2>(cosines[1], sines[1], vector);
+            _rotation_exec::_rotate_elementary_from<axis3>(cosines[2], sines[2], vector);
+        }
+
+        // Rotates vector in place in the rotate_to sense without forming
+        // the matrix, applying the inverse elementary rotations left to right.
+        template<typename T>
+        static inline void rotate_to(const T* cosines, const T* sines, T* vector) noexcept {
+            _rotation_exec::_rotate_elementary_to<axis3>(cosines[2], sines[2], vector);
+            _rotation_exec::_rotate_elementary_to<axis2>(cosines[1], sines[1], vector);
+            _rotation_exec::_rotate_elementary_to<axis1>(cosines[0], sines[0], vector);
+        }
+
     };
 
     /**
      * ReferenceFrame implementations.
      */
 
-    template<typename rotation_order, typename rotation_type>
-    ReferenceFrame<rotation_order, rotation_type>::ReferenceFrame(const EulerAngles& angles, const Vector& offset)
-        : m_angles(angles), m_offset(offset)
+    template<typename rotation_order, typename rotation_type, typename offset_type>
+    ReferenceFrame<rotation_order, rotation_type, offset_type>::ReferenceFrame(const EulerAngles& angles)
+        : _FrameOffsetStorage<offset_type>(), m_angles(angles)
     {
         this->update_matrix();
     }
 
-    template<typename rotation_order, typename rotation_type>
-    const EulerAngles& ReferenceFrame<rotation_order, rotation_type>::get_angles() const {
+    template<typename rotation_order, typename rotation_type, typename offset_type>
+    ReferenceFrame<rotation_order, rotation_type, offset_type>::ReferenceFrame(const EulerAngles& angles, const Vector& offset)
+        : _FrameOffsetStorage<offset_type>(offset), m_angles(angles)
+    {
+        static_assert(has_offset, "Rotation only frames can not be constructed with an offset");
+        this->update_matrix();
+    }
+
+    template<typename rotation_order, typename rotation_type, typename offset_type>
+    const EulerAngles& ReferenceFrame<rotation_order, rotation_type, offset_type>::get_angles() const {
         return this->m_angles;
     }
 
-    template<typename rotation_order, typename rotation_type>
-    const Vector& ReferenceFrame<rotation_order, rotation_type>::get_offset() const {
-        return this->m_offset;
+    template<typename rotation_order, typename rotation_type, typename offset_type>
+    const Vector& ReferenceFrame<rotation_order, rotation_type, offset_type>::get_offset() const {
+        if constexpr (has_offset) {
+            return this->m_offset;
+        }
+        else {
+            return _zero_vector;
+        }
     }
 
-    template<typename rotation_order, typename rotation_type>
-    const Matrix& ReferenceFrame<rotation_order, rotation_type>::get_matrix() const {
+    template<typename rotation_order, typename rotation_type, typename offset_type>
+    const Matrix& ReferenceFrame<rotation_order, rotation_type, offset_type>::get_matrix() const {
         return this->m_matrix;
     }
 
-    template<typename rotation_order, typename rotation_type>
-    void ReferenceFrame<rotation_order, rotation_type>::set_angles(std::size_t index, double value) {
+    template<typename rotation_order, typename rotation_type, typename offset_type>
+    void ReferenceFrame<rotation_order, rotation_type, offset_type>::set_angles(std::size_t index, double value) {
         this->m_angles[index] = value;
         this->update_matrix();
     }
 
-    template<typename rotation_order, typename rotation_type>
-    void ReferenceFrame<rotation_order, rotation_type>::set_angles(const EulerAngles& angles) {
+    template<typename rotation_order, typename rotation_type, typename offset_type>
+    void ReferenceFrame<rotation_order, rotation_type, offset_type>::set_angles(const EulerAngles& angles) {
         this->m_angles = angles;
         this->update_matrix();
     }
 
-    template<typename rotation_order, typename rotation_type>
-    void ReferenceFrame<rotation_order, rotation_type>::set_offset(const Vector& offset) {
+    template<typename rotation_order, typename rotation_type, typename offset_type>
+    void ReferenceFrame<rotation_order, rotation_type, offset_type>::set_offset(const Vector& offset) {
+        static_assert(has_offset, "Rotation only frames can not be given an offset");
         this->m_offset = offset;
-        this->update_matrix();
     }
 
-    template<typename rotation_order, typename rotation_type>
-    void ReferenceFrame<rotation_order, rotation_type>::update_matrix() {
+    template<typename rotation_order, typename rotation_type, typename offset_type>
+    void ReferenceFrame<rotation_order, rotation_type, offset_type>::update_matrix() {
         this->m_matrix = _EulerAngleDelegate<rotation_order, rotation_type>::derive_matrix(
             this->m_angles[0],
             this->m_angles[1],
@@ -357,8 +830,8 @@ namespace evspace {
         );
     }
 
-    template<typename rotation_order, typename rotation_type>
-    const double& ReferenceFrame<rotation_order, rotation_type>::operator[](std::size_t index) const {
+    template<typename rotation_order, typename rotation_type, typename offset_type>
+    const double& ReferenceFrame<rotation_order, rotation_type, offset_type>::operator[](std::size_t index) const {
         if (index > 2) {
             throw std::out_of_range("Index out of bounds.");
         }
@@ -366,30 +839,115 @@ namespace evspace {
         return this->m_angles[index];
     }
 
+    template<typename rotation_order, typename rotation_type, typename offset_type>
+    Vector ReferenceFrame<rotation_order, rotation_type, offset_type>::rotate_from(const Vector& vector) const {
+        if constexpr (has_offset) {
+            return _rotation_exec::_rotate_from_exec(this->m_matrix, vector, this->m_offset);
+        }
+        else {
+            return _rotation_exec::_rotate_from_exec(this->m_matrix, vector);
+        }
+    }
+
+    template<typename rotation_order, typename rotation_type, typename offset_type>
+    Vector ReferenceFrame<rotation_order, rotation_type, offset_type>::rotate_to(const Vector& vector) const {
+        if constexpr (has_offset) {
+            return _rotation_exec::_rotate_to_exec(this->m_matrix, vector, this->m_offset);
+        }
+        else {
+            return _rotation_exec::_rotate_to_exec(this->m_matrix, vector);
+        }
+    }
+
+    template<typename rotation_order, typename rotation_type, typename offset_type>
+    template<typename _o, typename _t, typename _f>
+    Vector ReferenceFrame<rotation_order, rotation_type, offset_type>::rotate_to(const ReferenceFrame<_o, _t, _f>& frame, const Vector& vector) const {
+        Vector inert_vector = this->rotate_from(vector);
+
+        return frame.rotate_to(inert_vector);
+    }
+
+    template<typename rotation_order, typename rotation_type, typename offset_type>
+    template<typename _o, typename _t, typename _f>
+    Vector ReferenceFrame<rotation_order, rotation_type, offset_type>::rotate_from(const ReferenceFrame<_o, _t, _f>& frame, const Vector& vector) const {
+        Vector inert_vector = frame.rotate_from(vector);
+
+        return this->rotate_to(inert_vector);
+    }
+
+    /**
+     * RotatingReferenceFrame implementations.
+     */
+
     template<typename rotation_order, typename rotation_type>
-    Vector ReferenceFrame<rotation_order, rotation_type>::rotate_from(const Vector& vector) const {
-        return _rotation_exec::_rotate_from_exec(this->m_matrix, vector, this->m_offset);
+    RotatingReferenceFrame<rotation_order, rotation_type>::RotatingReferenceFrame(
+        const EulerAngles& angles, const Vector& angular_velocity, const Vector& offset)
+        : ReferenceFrame<rotation_order, rotation_type>(angles, offset), m_angular_velocity(angular_velocity) { }
+
+    template<typename rotation_order, typename rotation_type>
+    const Vector& RotatingReferenceFrame<rotation_order, rotation_type>::get_angular_velocity() const {
+        return this->m_angular_velocity;
     }
 
     template<typename rotation_order, typename rotation_type>
-    Vector ReferenceFrame<rotation_order, rotation_type>::rotate_to(const Vector& vector) const {
-        return _rotation_exec::_rotate_to_exec(this->m_matrix, vector, this->m_offset);
+    void RotatingReferenceFrame<rotation_order, rotation_type>::set_angular_velocity(const Vector& angular_velocity) {
+        this->m_angular_velocity = angular_velocity;
     }
 
     template<typename rotation_order, typename rotation_type>
-    template<typename _o, typename _t>
-    Vector ReferenceFrame<rotation_order, rotation_type>::rotate_to(const ReferenceFrame<_o, _t>& frame, const Vector& vector) const {
-        Vector inert_vector = _rotation_exec::_rotate_from_exec(this->m_matrix, vector, this->m_offset);
+    State RotatingReferenceFrame<rotation_order, rotation_type>::rotate_to(const State& state) const {
+        double r[3], v[3];
+        _rotation_exec::_rotate_state_to_exec(this->get_matrix().data().data(),
+            this->m_angular_velocity.data().data(), this->get_offset().data().data(),
+            state.position.data().data(), state.velocity.data().data(), r, v);
 
-        return _rotation_exec::_rotate_to_exec(frame.get_matrix(), inert_vector, frame.get_offset());
+        return State{ Vector(r[0], r[1], r[2]), Vector(v[0], v[1], v[2]) };
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    State RotatingReferenceFrame<rotation_order, rotation_type>::rotate_from(const State& state) const {
+        double r[3], v[3];
+        _rotation_exec::_rotate_state_from_exec(this->get_matrix().data().data(),
+            this->m_angular_velocity.data().data(), this->get_offset().data().data(),
+            state.position.data().data(), state.velocity.data().data(), r, v);
+
+        return State{ Vector(r[0], r[1], r[2]), Vector(v[0], v[1], v[2]) };
     }
 
     template<typename rotation_order, typename rotation_type>
     template<typename _o, typename _t>
-    Vector ReferenceFrame<rotation_order, rotation_type>::rotate_from(const ReferenceFrame<_o, _t>& frame, const Vector& vector) const {
-        Vector inert_vector = _rotation_exec::_rotate_from_exec(frame.get_matrix(), vector, frame.get_offset());
+    State RotatingReferenceFrame<rotation_order, rotation_type>::rotate_to(
+        const RotatingReferenceFrame<_o, _t>& frame, const State& state) const
+    {
+        return frame.rotate_to(this->rotate_from(state));
+    }
 
-        return _rotation_exec::_rotate_to_exec(this->m_matrix, inert_vector, this->m_offset);
+    template<typename rotation_order, typename rotation_type>
+    template<typename _o, typename _t>
+    State RotatingReferenceFrame<rotation_order, rotation_type>::rotate_from(
+        const RotatingReferenceFrame<_o, _t>& frame, const State& state) const
+    {
+        return this->rotate_to(frame.rotate_from(state));
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    void RotatingReferenceFrame<rotation_order, rotation_type>::rotate_to(
+        const VectorArray& positions, const VectorArray& velocities,
+        VectorArray& out_positions, VectorArray& out_velocities) const
+    {
+        _rotation_exec::_rotate_state_batch_exec<_rotation_exec::_rotate_state_to_exec>(
+            this->get_matrix(), this->m_angular_velocity, this->get_offset(),
+            positions, velocities, out_positions, out_velocities);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    void RotatingReferenceFrame<rotation_order, rotation_type>::rotate_from(
+        const VectorArray& positions, const VectorArray& velocities,
+        VectorArray& out_positions, VectorArray& out_velocities) const
+    {
+        _rotation_exec::_rotate_state_batch_exec<_rotation_exec::_rotate_state_from_exec>(
+            this->get_matrix(), this->m_angular_velocity, this->get_offset(),
+            positions, velocities, out_positions, out_velocities);
     }
 
     /**
@@ -410,6 +968,70 @@ namespace evspace {
         );
     }
 
+    /**
+     * Euler angle extraction. Extrinsic rotations about axes (i, j, k) are
+     * equal to intrinsic rotations about (k, j, i) with the angles reversed,
+     * so only the intrinsic case needs to be solved.
+     */
+
+    template<typename axis1, typename axis2, typename axis3>
+    EulerAngles _compute_intrinsic_euler_angles(const Matrix& matrix) {
+        constexpr std::size_t i = static_cast<std::size_t>(axis1::direction);
+        constexpr std::size_t j = static_cast<std::size_t>(axis2::direction);
+        constexpr std::size_t k = static_cast<std::size_t>(axis3::direction);
+        constexpr std::size_t m = 3 - i - j;
+        constexpr double s = (j == (i + 1) % 3) ? 1.0 : -1.0;
+        static_assert(i != j && j != k, "Consecutive rotation axes must differ");
+
+        const double* r = matrix.data().data();
+        auto at = [r](std::size_t row, std::size_t col) { return r[row * 3 + col]; };
+        double alpha, beta, gamma;
+
+        if constexpr (i != k) {
+            // improper rotation (Tait-Bryan angles)
+            double cos_beta = std::hypot(at(i, i), at(i, j));
+            beta = std::atan2(s * at(i, k), cos_beta);
+            if (cos_beta > 1e-12) {
+                alpha = std::atan2(-s * at(j, k), at(k, k));
+                gamma = std::atan2(-s * at(i, j), at(i, i));
+            }
+            else {
+                alpha = std::atan2(s * at(m, j), at(j, j));
+                gamma = 0.0;
+            }
+        }
+        else {
+            // proper rotation
+            double sin_beta = std::hypot(at(i, j), at(i, m));
+            beta = std::atan2(sin_beta, at(i, i));
+            if (sin_beta > 1e-12) {
+                alpha = std::atan2(at(j, i), -s * at(m, i));
+                gamma = std::atan2(at(i, j), s * at(i, m));
+            }
+            else {
+                alpha = std::atan2(s * at(m, j), at(j, j));
+                gamma = 0.0;
+            }
+        }
+
+        return EulerAngles(alpha, beta, gamma);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    EulerAngles compute_euler_angles(const Matrix& matrix) {
+        typedef typename rotation_order::Axis_1 axis1;
+        typedef typename rotation_order::Axis_2 axis2;
+        typedef typename rotation_order::Axis_3 axis3;
+
+        if constexpr (std::is_same_v<rotation_type, ExtrinsicRotation>) {
+            EulerAngles reversed = _compute_intrinsic_euler_angles<axis3, axis2, axis1>(matrix);
+            return EulerAngles(reversed[2], reversed[1], reversed[0]);
+        }
+        else {
+            return _compute_intrinsic_euler_angles<axis1, axis2, axis3>(matrix);
+        }
+    }
+
     /**
      * This resulting matrix should multiply a vector from the 'from' reference frame on the
      * left-hand side to rotate it to the 'to' frame.
@@ -430,58 +1052,71 @@ namespace evspace {
 
     template<typename axis>
     Vector rotate_from(double angle, const Vector& vector) {
-        Matrix rotation_matrix = compute_rotation_matrix<axis>(angle);
+        Vector result = vector;
+        _SingleAxisDelegate<axis>::rotate_from(angle, result.data().data());
 
-        return _rotation_exec::_rotate_from_exec(rotation_matrix, vector);
+        return result;
     }
 
     template<typename axis>
     Vector rotate_from(double angle, const Vector& vector, const Vector& offset) {
-        Matrix rotation_matrix = compute_rotation_matrix<axis>(angle);
+        Vector result = rotate_from<axis>(angle, vector);
+        result += offset;
 
-        return _rotation_exec::_rotate_from_exec(rotation_matrix, vector, offset);
+        return result;
     }
 
     template<typename axis>
     Vector rotate_to(double angle, const Vector& vector) {
-        Matrix rotation_matrix = compute_rotation_matrix<axis>(angle);
+        Vector result = vector;
+        _SingleAxisDelegate<axis>::rotate_to(angle, result.data().data());
 
-        return _rotation_exec::_rotate_to_exec(rotation_matrix, vector);
+        return result;
     }
 
     template<typename axis>
     Vector rotate_to(double angle, const Vector& vector, const Vector& offset) {
-        Matrix rotation_matrix = compute_rotation_matrix<axis>(angle);
-
-        return _rotation_exec::_rotate_to_exec(rotation_matrix, vector, offset);
+        return rotate_to<axis>(angle, vector - offset);
     }
 
+    /**
+     * Euler angle rotations apply the three elementary rotations directly to
+     * the vector instead of building the rotation matrix, which is cheaper
+     * for a single vector. To rotate several vectors by the same angles,
+     * compute the matrix once (or use a ReferenceFrame) instead.
+     */
+
     template<typename rotation_order, typename rotation_type>
     Vector rotate_from(const EulerAngles& angles, const Vector& vector) {
-        Matrix rotation_matrix = compute_rotation_matrix<rotation_order, rotation_type>(angles);
+        double cosines[3], sines[3];
+        _rotation_exec::_euler_angle_trig(angles, cosines, sines);
+        Vector result = vector;
+        _EulerAngleDelegate<rotation_order, rotation_type>::rotate_from(cosines, sines, result.data().data());
 
-        return _rotation_exec::_rotate_from_exec(rotation_matrix, vector);
+        return result;
     }
 
     template<typename rotation_order, typename rotation_type>
     Vector rotate_from(const EulerAngles& angles, const Vector& vector, const Vector& offset) {
-        Matrix rotation_matrix = compute_rotation_matrix<rotation_order, rotation_type>(angles);
+        Vector result = rotate_from<rotation_order, rotation_type>(angles, vector);
+        result += offset;
 
-        return _rotation_exec::_rotate_from_exec(rotation_matrix, vector, offset);
+        return result;
     }
 
     template<typename rotation_order, typename rotation_type>
     Vector rotate_to(const EulerAngles& angles, const Vector& vector) {
-        Matrix rotation_matrix = compute_rotation_matrix<rotation_order, rotation_type>(angles);
+        double cosines[3], sines[3];
+        _rotation_exec::_euler_angle_trig(angles, cosines, sines);
+        Vector result = vector;
+        _EulerAngleDelegate<rotation_order, rotation_type>::rotate_to(cosines, sines, result.data().data());
 
-        return _rotation_exec::_rotate_to_exec(rotation_matrix, vector);
+        return result;
     }
 
     template<typename rotation_order, typename rotation_type>
     Vector rotate_to(const EulerAngles& angles, const Vector& vector, const Vector& offset) {
-        Matrix rotation_matrix = compute_rotation_matrix<rotation_order, rotation_type>(angles);
-
-        return _rotation_exec::_rotate_to_exec(rotation_matrix, vector, offset);
+        return rotate_to<rotation_order, rotation_type>(angles, vector - offset);
     }
 
     template<typename rotation_from, typename rotation_to,
@@ -489,11 +1124,21 @@ namespace evspace {
     Vector rotate_between(const EulerAngles& angles_from, const EulerAngles& angles_to, const Vector& vector,
         const Vector& offset_from, const Vector& offset_to)
     {
-        Matrix matrix_from = compute_rotation_matrix<rotation_from, from_type>(angles_from);
-        Vector inert_vector = _rotation_exec::_rotate_from_exec(matrix_from, vector, offset_from);
-        Matrix matrix_to = compute_rotation_matrix<rotation_to, to_type>(angles_to);
+        double cosines[3], sines[3];
+        Vector result = vector;
+        double* v = result.data().data();
+        const double* o_from = offset_from.data().data();
+        const double* o_to = offset_to.data().data();
+
+        _rotation_exec::_euler_angle_trig(angles_from, cosines, sines);
+        _EulerAngleDelegate<rotation_from, from_type>::rotate_from(cosines, sines, v);
+        for (std::size_t i = 0; i < 3; i++) {
+            v[i] += o_from[i] - o_to[i];
+        }
+        _rotation_exec::_euler_angle_trig(angles_to, cosines, sines);
+        _EulerAngleDelegate<rotation_to, to_type>::rotate_to(cosines, sines, v);
 
-        return _rotation_exec::_rotate_to_exec(matrix_to, inert_vector, offset_to);
+        return result;
     }
 
 } // namespace evspace
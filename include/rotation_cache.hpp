@@ -0,0 +1,338 @@
+#ifndef _EVSPACE_ROTATION_CACHE_H_
+#define _EVSPACE_ROTATION_CACHE_H_
+
+#include <angles.hpp>
+#include <matrix.hpp>
+#include <vector.hpp>
+#include <rotation.hpp>
+#include <dynamic_reference_frame.hpp>
+#include <atomic>           // std::atomic
+#include <cstddef>          // std::size_t
+#include <cstdint>          // std::uint64_t
+#include <cstring>          // std::memcpy
+#include <memory>           // std::unique_ptr
+#include <mutex>            // std::mutex, std::lock_guard
+#include <stdexcept>        // std::invalid_argument
+#include <unordered_map>    // std::unordered_map
+#include <vector>           // std::vector
+
+namespace evspace {
+
+    namespace _rotation_cache_exec {
+
+        // Bit pattern of the three angles and the rotation order and type
+        // combination. Angles are compared bit for bit, so 0.0 and -0.0 are
+        // distinct keys and a hit always returns exactly the matrix that
+        // would have been derived.
+        struct _Key {
+            std::uint64_t bits[3];
+            std::size_t combination;
+
+            bool operator==(const _Key& other) const noexcept {
+                return this->bits[0] == other.bits[0] && this->bits[1] == other.bits[1]
+                    && this->bits[2] == other.bits[2] && this->combination == other.combination;
+            }
+        };
+
+        // splitmix64 finalizer.
+        inline std::uint64_t _mix(std::uint64_t x) noexcept {
+            x ^= x >> 30;
+            x *= 0xbf58476d1ce4e5b9ULL;
+            x ^= x >> 27;
+            x *= 0x94d049bb133111ebULL;
+            x ^= x >> 31;
+            return x;
+        }
+
+        struct _KeyHash {
+            std::size_t operator()(const _Key& key) const noexcept {
+                return static_cast<std::size_t>(
+                    _mix(key.bits[0] ^ _mix(key.bits[1] ^ _mix(key.bits[2] ^ key.combination))));
+            }
+        };
+
+        inline _Key _make_key(const EulerAngles& angles, std::size_t combination) noexcept {
+            _Key key;
+            for (std::size_t i = 0; i < 3; i++) {
+                std::memcpy(&key.bits[i], &angles[i], sizeof(double));
+            }
+            key.combination = combination;
+            return key;
+        }
+
+    }
+
+    // Bounded, thread safe cache of rotation matrices derived from Euler
+    // angles, keyed by the bit pattern of the angles together with the
+    // rotation order and type. Entries are spread over independently locked
+    // shards so concurrent lookups of different angles rarely contend, and
+    // each shard evicts with the CLOCK (second chance) approximation of least
+    // recently used. Matrices are derived outside of the shard lock.
+    //
+    // Deriving a matrix costs roughly six sin/cos evaluations, so the cache
+    // pays off when the same angles are looked up repeatedly, for example a
+    // small set of commanded attitudes reused across many frames.
+    class RotationMatrixCache {
+    private:
+        struct Entry {
+            _rotation_cache_exec::_Key key;
+            double matrix[9];
+            bool referenced;
+        };
+
+        struct alignas(64) Shard {
+            std::mutex mutex;
+            std::vector<Entry> entries;
+            std::unordered_map<_rotation_cache_exec::_Key, std::size_t, _rotation_cache_exec::_KeyHash> index;
+            std::size_t hand = 0;
+            std::atomic<std::uint64_t> hits{ 0 };
+            std::atomic<std::uint64_t> misses{ 0 };
+        };
+
+        std::unique_ptr<Shard[]> m_shards;
+        std::size_t m_shard_count;
+        std::size_t m_shard_capacity;
+
+        Shard& shard_for(std::size_t) const noexcept;
+        bool find(Shard&, const _rotation_cache_exec::_Key&, double*) const;
+        void insert(Shard&, const _rotation_cache_exec::_Key&, const double*) const;
+
+    public:
+        // Capacity is the total number of matrices held, divided evenly
+        // between shard_count shards (rounded up).
+        explicit RotationMatrixCache(std::size_t capacity = 4096, std::size_t shard_count = 16);
+
+        RotationMatrixCache(const RotationMatrixCache&) = delete;
+        RotationMatrixCache& operator=(const RotationMatrixCache&) = delete;
+
+        // Writes the row-major rotation matrix of angles into matrix,
+        // deriving and inserting it on a miss.
+        template<typename rotation_order, typename rotation_type = IntrinsicRotation>
+        void lookup(const EulerAngles&, double*);
+        template<typename rotation_order, typename rotation_type = IntrinsicRotation>
+        Matrix lookup(const EulerAngles&);
+
+        void clear();
+        void reset_counters() noexcept;
+
+        std::size_t capacity() const noexcept;
+        std::size_t size() const;
+        std::uint64_t hits() const noexcept;
+        std::uint64_t misses() const noexcept;
+    };
+
+    // Cached equivalents of the Euler angle compute_rotation_matrix and
+    // rotate_* functions in rotation.hpp. Rotations apply the cached matrix
+    // through the same kernels as the Matrix overloads and ReferenceFrame,
+    // so their results match those exactly whether the entry was cached or
+    // not.
+    template<typename rotation_order, typename rotation_type = IntrinsicRotation>
+    Matrix compute_rotation_matrix(const EulerAngles&, RotationMatrixCache&);
+
+    template<typename rotation_order, typename rotation_type = IntrinsicRotation>
+    Vector rotate_from(const EulerAngles&, const Vector&, RotationMatrixCache&);
+    template<typename rotation_order, typename rotation_type = IntrinsicRotation>
+    Vector rotate_from(const EulerAngles&, const Vector&, const Vector&, RotationMatrixCache&);
+    template<typename rotation_order, typename rotation_type = IntrinsicRotation>
+    Vector rotate_to(const EulerAngles&, const Vector&, RotationMatrixCache&);
+    template<typename rotation_order, typename rotation_type = IntrinsicRotation>
+    Vector rotate_to(const EulerAngles&, const Vector&, const Vector&, RotationMatrixCache&);
+
+    /**
+     * RotationMatrixCache implementations.
+     */
+
+    inline RotationMatrixCache::RotationMatrixCache(std::size_t capacity, std::size_t shard_count)
+        : m_shards(), m_shard_count(shard_count), m_shard_capacity()
+    {
+        if (capacity == 0 || shard_count == 0) {
+            throw std::invalid_argument("RotationMatrixCache capacity and shard count must be positive");
+        }
+
+        this->m_shard_capacity = (capacity + shard_count - 1) / shard_count;
+        this->m_shards.reset(new Shard[shard_count]);
+        for (std::size_t i = 0; i < shard_count; i++) {
+            this->m_shards[i].entries.reserve(this->m_shard_capacity);
+            this->m_shards[i].index.reserve(this->m_shard_capacity);
+        }
+    }
+
+    inline RotationMatrixCache::Shard& RotationMatrixCache::shard_for(std::size_t hash) const noexcept {
+        // the low bits select the map bucket, use the high bits for the shard
+        return this->m_shards[(static_cast<std::uint64_t>(hash) >> 32) % this->m_shard_count];
+    }
+
+    inline bool RotationMatrixCache::find(Shard& shard, const _rotation_cache_exec::_Key& key, double* matrix) const {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it == shard.index.end()) {
+            return false;
+        }
+
+        Entry& entry = shard.entries[it->second];
+        entry.referenced = true;
+        std::memcpy(matrix, entry.matrix, sizeof(entry.matrix));
+        return true;
+    }
+
+    inline void RotationMatrixCache::insert(Shard& shard, const _rotation_cache_exec::_Key& key, const double* matrix) const {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.index.find(key) != shard.index.end()) {
+            // another thread derived the same matrix first
+            return;
+        }
+
+        std::size_t slot;
+        if (shard.entries.size() < this->m_shard_capacity) {
+            slot = shard.entries.size();
+            shard.entries.push_back(Entry());
+        }
+        else {
+            // give every referenced entry a second chance, the hand stops
+            // at the first entry not used since it last passed
+            while (shard.entries[shard.hand].referenced) {
+                shard.entries[shard.hand].referenced = false;
+                shard.hand = (shard.hand + 1) % this->m_shard_capacity;
+            }
+            slot = shard.hand;
+            shard.hand = (shard.hand + 1) % this->m_shard_capacity;
+            shard.index.erase(shard.entries[slot].key);
+        }
+
+        Entry& entry = shard.entries[slot];
+        entry.key = key;
+        std::memcpy(entry.matrix, matrix, sizeof(entry.matrix));
+        entry.referenced = false;
+        shard.index.emplace(key, slot);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    void RotationMatrixCache::lookup(const EulerAngles& angles, double* matrix) {
+        const _rotation_cache_exec::_Key key = _rotation_cache_exec::_make_key(angles,
+            _dynamic_frame_exec::_combination_index(_dynamic_frame_exec::_order_id<rotation_order>(),
+                                                    _dynamic_frame_exec::_type_id<rotation_type>()));
+        Shard& shard = this->shard_for(_rotation_cache_exec::_KeyHash()(key));
+
+        if (this->find(shard, key, matrix)) {
+            shard.hits.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        shard.misses.fetch_add(1, std::memory_order_relaxed);
+        // derive exactly as compute_rotation_matrix and ReferenceFrame do, so
+        // cached and uncached results are identical
+        const Matrix derived = _EulerAngleDelegate<rotation_order, rotation_type>::derive_matrix(
+            angles[0], angles[1], angles[2]);
+        std::memcpy(matrix, derived.data().data(), 9 * sizeof(double));
+        this->insert(shard, key, matrix);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    Matrix RotationMatrixCache::lookup(const EulerAngles& angles) {
+        Matrix result;
+        this->lookup<rotation_order, rotation_type>(angles, result.data().data());
+        return result;
+    }
+
+    inline void RotationMatrixCache::clear() {
+        for (std::size_t i = 0; i < this->m_shard_count; i++) {
+            Shard& shard = this->m_shards[i];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.entries.clear();
+            shard.index.clear();
+            shard.hand = 0;
+        }
+    }
+
+    inline void RotationMatrixCache::reset_counters() noexcept {
+        for (std::size_t i = 0; i < this->m_shard_count; i++) {
+            this->m_shards[i].hits.store(0, std::memory_order_relaxed);
+            this->m_shards[i].misses.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    inline std::size_t RotationMatrixCache::capacity() const noexcept {
+        return this->m_shard_capacity * this->m_shard_count;
+    }
+
+    inline std::size_t RotationMatrixCache::size() const {
+        std::size_t result = 0;
+        for (std::size_t i = 0; i < this->m_shard_count; i++) {
+            Shard& shard = this->m_shards[i];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            result += shard.entries.size();
+        }
+
+        return result;
+    }
+
+    inline std::uint64_t RotationMatrixCache::hits() const noexcept {
+        std::uint64_t result = 0;
+        for (std::size_t i = 0; i < this->m_shard_count; i++) {
+            result += this->m_shards[i].hits.load(std::memory_order_relaxed);
+        }
+
+        return result;
+    }
+
+    inline std::uint64_t RotationMatrixCache::misses() const noexcept {
+        std::uint64_t result = 0;
+        for (std::size_t i = 0; i < this->m_shard_count; i++) {
+            result += this->m_shards[i].misses.load(std::memory_order_relaxed);
+        }
+
+        return result;
+    }
+
+    /**
+     * ReferenceFrame cached angle setters, declared in rotation.hpp.
+     */
+
+    template<typename rotation_order, typename rotation_type, typename offset_type>
+    void ReferenceFrame<rotation_order, rotation_type, offset_type>::set_angles(
+        std::size_t index, double value, RotationMatrixCache& cache)
+    {
+        this->m_angles[index] = value;
+        cache.lookup<rotation_order, rotation_type>(this->m_angles, this->m_matrix.data().data());
+    }
+
+    template<typename rotation_order, typename rotation_type, typename offset_type>
+    void ReferenceFrame<rotation_order, rotation_type, offset_type>::set_angles(
+        const EulerAngles& angles, RotationMatrixCache& cache)
+    {
+        this->m_angles = angles;
+        cache.lookup<rotation_order, rotation_type>(this->m_angles, this->m_matrix.data().data());
+    }
+
+    /**
+     * Cached rotation function implementations.
+     */
+
+    template<typename rotation_order, typename rotation_type>
+    Matrix compute_rotation_matrix(const EulerAngles& angles, RotationMatrixCache& cache) {
+        return cache.lookup<rotation_order, rotation_type>(angles);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    Vector rotate_from(const EulerAngles& angles, const Vector& vector, RotationMatrixCache& cache) {
+        return _rotation_exec::_rotate_from_exec(cache.lookup<rotation_order, rotation_type>(angles), vector);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    Vector rotate_from(const EulerAngles& angles, const Vector& vector, const Vector& offset, RotationMatrixCache& cache) {
+        return _rotation_exec::_rotate_from_exec(cache.lookup<rotation_order, rotation_type>(angles), vector, offset);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    Vector rotate_to(const EulerAngles& angles, const Vector& vector, RotationMatrixCache& cache) {
+        return _rotation_exec::_rotate_to_exec(cache.lookup<rotation_order, rotation_type>(angles), vector);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    Vector rotate_to(const EulerAngles& angles, const Vector& vector, const Vector& offset, RotationMatrixCache& cache) {
+        return _rotation_exec::_rotate_to_exec(cache.lookup<rotation_order, rotation_type>(angles), vector, offset);
+    }
+
+}   // namespace evspace
+
+#endif // _EVSPACE_ROTATION_CACHE_H_
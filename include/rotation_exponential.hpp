@@ -0,0 +1,228 @@
+#ifndef _EVSPACE_ROTATION_EXPONENTIAL_H_
+#define _EVSPACE_ROTATION_EXPONENTIAL_H_
+
+#include <evspace_common.hpp>
+#include <matrix.hpp>
+#include <vector.hpp>
+#include <matrix_array.hpp>
+#include <vector_array.hpp>
+#include <sincos.hpp>
+#include <cmath>        // std::sqrt
+#include <cstddef>      // std::size_t
+#include <stdexcept>    // std::out_of_range
+
+namespace evspace {
+
+    /**
+     * Matrix exponentials of constant angular velocities. With omega = w u
+     * for a unit axis u, exp(Omega t) is Rodrigues' rotation of w t about
+     * u, written here with the half angle h = w t / 2 as
+     *
+     *      exp(Omega t) = (1 - 2 sin^2 h) I + 2 sin h cos h [u]x
+     *                     + 2 sin^2 h u u^T,
+     *
+     * which avoids the cancellation of 1 - cos(w t) for small angles. The
+     * result matches compute_rotation_matrix(w * t, omega) and rotates in
+     * the rotate_from sense.
+     */
+
+    // exp(Omega t) of one angular velocity omega at many times t. The rate
+    // and axis terms are computed once on construction, leaving a sincos
+    // and a few multiplies for each time.
+    class RotationExponential {
+    private:
+        double m_rate;
+        double m_axis[3];
+        // u u^T, row-major
+        double m_outer[9];
+
+    public:
+        // Constructs the exponential of a zero angular velocity, the
+        // identity at every time.
+        RotationExponential() noexcept;
+        explicit RotationExponential(const Vector&);
+
+        // The magnitude of the angular velocity.
+        double rate() const noexcept;
+        // The unit axis of the angular velocity, zero for a zero rate.
+        Vector axis() const;
+
+        // exp(Omega t).
+        Matrix at(double) const;
+        // exp(Omega t) at every time, resizing the output to match.
+        void at(span_t<const double>, MatrixArray&) const;
+    };
+
+    // exp(Omega t), as RotationExponential(omega).at(t).
+    Matrix compute_rotation_exponential(const Vector&, double);
+    // Batch exp(Omega[i] t[i]) of each angular velocity at its time,
+    // resizing the output to match. The times must be the same size as
+    // the angular velocities.
+    void compute_rotation_exponential(const VectorArray&, span_t<const double>, MatrixArray&);
+
+    namespace _exponential_exec {
+
+        constexpr std::size_t _chunk_size = 256;
+
+        // The rate of omega and its unit axis, zero when the rate is zero.
+        inline double _axis(double x, double y, double z, double* axis) noexcept {
+            const double rate = std::sqrt(x * x + y * y + z * z);
+            const double inverse = rate > 0.0 ? 1.0 / rate : 0.0;
+            axis[0] = x * inverse;
+            axis[1] = y * inverse;
+            axis[2] = z * inverse;
+
+            return rate;
+        }
+
+        // Writes the row-major exponential of the unit axis from the sine
+        // and cosine of the half angle.
+        inline void _exponential(const double* axis, double half_sine, double half_cosine,
+                                 double* matrix) noexcept
+        {
+            const double sine = 2.0 * half_sine * half_cosine;
+            const double versine = 2.0 * half_sine * half_sine;
+            const double cosine = 1.0 - versine;
+            const double x = axis[0], y = axis[1], z = axis[2];
+
+            matrix[0] = cosine + versine * x * x;
+            matrix[1] = versine * x * y - sine * z;
+            matrix[2] = versine * x * z + sine * y;
+            matrix[3] = versine * x * y + sine * z;
+            matrix[4] = cosine + versine * y * y;
+            matrix[5] = versine * y * z - sine * x;
+            matrix[6] = versine * x * z - sine * y;
+            matrix[7] = versine * y * z + sine * x;
+            matrix[8] = cosine + versine * z * z;
+        }
+
+        // As above, with the outer product of the axis already formed.
+        inline void _exponential(const double* axis, const double* outer, double half_sine, double half_cosine,
+                                 double* matrix) noexcept
+        {
+            const double sine = 2.0 * half_sine * half_cosine;
+            const double versine = 2.0 * half_sine * half_sine;
+            const double cosine = 1.0 - versine;
+            const double skew[9] = { 0.0, -axis[2], axis[1], axis[2], 0.0, -axis[0], -axis[1], axis[0], 0.0 };
+
+            for (std::size_t k = 0; k < 9; k++) {
+                matrix[k] = versine * outer[k] + sine * skew[k] + (k % 4 == 0 ? cosine : 0.0);
+            }
+        }
+
+    }
+
+    inline RotationExponential::RotationExponential() noexcept
+        : m_rate(0.0), m_axis{ 0.0, 0.0, 0.0 }, m_outer{ 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 } { }
+
+    inline RotationExponential::RotationExponential(const Vector& omega) {
+        const double* data = omega.data().data();
+        this->m_rate = _exponential_exec::_axis(data[0], data[1], data[2], this->m_axis);
+        for (std::size_t r = 0; r < 3; r++) {
+            for (std::size_t c = 0; c < 3; c++) {
+                this->m_outer[r * 3 + c] = this->m_axis[r] * this->m_axis[c];
+            }
+        }
+    }
+
+    inline double RotationExponential::rate() const noexcept {
+        return this->m_rate;
+    }
+
+    inline Vector RotationExponential::axis() const {
+        return Vector(this->m_axis[0], this->m_axis[1], this->m_axis[2]);
+    }
+
+    inline Matrix RotationExponential::at(double time) const {
+        double half_sine, half_cosine, matrix[9];
+        sincos(0.5 * this->m_rate * time, half_sine, half_cosine);
+        _exponential_exec::_exponential(this->m_axis, this->m_outer, half_sine, half_cosine, matrix);
+
+        return Matrix(matrix);
+    }
+
+    inline void RotationExponential::at(span_t<const double> times, MatrixArray& matrices) const {
+        const std::size_t count = times.size();
+        const std::size_t chunk_size = _exponential_exec::_chunk_size;
+        const std::size_t chunk_count = (count + chunk_size - 1) / chunk_size;
+        matrices.resize(count);
+        double* planes[9];
+        for (std::size_t component = 0; component < 9; component++) {
+            planes[component] = matrices.plane(component / 3, component % 3);
+        }
+
+        _EVSPACE_PARALLEL_FOR_IF(count >= _EVSPACE_PARALLEL_MINIMUM)
+        for (std::size_t chunk_index = 0; chunk_index < chunk_count; chunk_index++) {
+            const std::size_t start = chunk_index * chunk_size;
+            const std::size_t chunk = count - start < chunk_size ? count - start : chunk_size;
+            double half_angles[_exponential_exec::_chunk_size];
+            double sines[_exponential_exec::_chunk_size], cosines[_exponential_exec::_chunk_size];
+            for (std::size_t i = 0; i < chunk; i++) {
+                half_angles[i] = 0.5 * this->m_rate * times[start + i];
+            }
+            sincos(span_t<const double>(half_angles, chunk), span_t<double>(sines, chunk),
+                   span_t<double>(cosines, chunk));
+
+            for (std::size_t i = 0; i < chunk; i++) {
+                double matrix[9];
+                _exponential_exec::_exponential(this->m_axis, this->m_outer, sines[i], cosines[i], matrix);
+                for (std::size_t component = 0; component < 9; component++) {
+                    planes[component][start + i] = matrix[component];
+                }
+            }
+        }
+    }
+
+    inline Matrix compute_rotation_exponential(const Vector& omega, double time) {
+        return RotationExponential(omega).at(time);
+    }
+
+    inline void compute_rotation_exponential(const VectorArray& omegas, span_t<const double> times,
+                                             MatrixArray& matrices)
+    {
+        const std::size_t count = omegas.size();
+        if (times.size() != count) {
+            throw std::out_of_range("times must be the same size as the angular velocities");
+        }
+
+        const std::size_t chunk_size = _exponential_exec::_chunk_size;
+        const std::size_t chunk_count = (count + chunk_size - 1) / chunk_size;
+        matrices.resize(count);
+        double* planes[9];
+        for (std::size_t component = 0; component < 9; component++) {
+            planes[component] = matrices.plane(component / 3, component % 3);
+        }
+        const double* input[3] = { omegas.x(), omegas.y(), omegas.z() };
+
+        _EVSPACE_PARALLEL_FOR_IF(count >= _EVSPACE_PARALLEL_MINIMUM)
+        for (std::size_t chunk_index = 0; chunk_index < chunk_count; chunk_index++) {
+            const std::size_t start = chunk_index * chunk_size;
+            const std::size_t chunk = count - start < chunk_size ? count - start : chunk_size;
+            double axes[3][_exponential_exec::_chunk_size], half_angles[_exponential_exec::_chunk_size];
+            double sines[_exponential_exec::_chunk_size], cosines[_exponential_exec::_chunk_size];
+            for (std::size_t i = 0; i < chunk; i++) {
+                double axis[3];
+                const double rate = _exponential_exec::_axis(input[0][start + i], input[1][start + i],
+                                                              input[2][start + i], axis);
+                axes[0][i] = axis[0];
+                axes[1][i] = axis[1];
+                axes[2][i] = axis[2];
+                half_angles[i] = 0.5 * rate * times[start + i];
+            }
+            sincos(span_t<const double>(half_angles, chunk), span_t<double>(sines, chunk),
+                   span_t<double>(cosines, chunk));
+
+            for (std::size_t i = 0; i < chunk; i++) {
+                const double axis[3] = { axes[0][i], axes[1][i], axes[2][i] };
+                double matrix[9];
+                _exponential_exec::_exponential(axis, sines[i], cosines[i], matrix);
+                for (std::size_t component = 0; component < 9; component++) {
+                    planes[component][start + i] = matrix[component];
+                }
+            }
+        }
+    }
+
+}   // namespace evspace
+
+#endif // _EVSPACE_ROTATION_EXPONENTIAL_H_
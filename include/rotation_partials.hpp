@@ -0,0 +1,327 @@
+#ifndef _EVSPACE_ROTATION_PARTIALS_H_
+#define _EVSPACE_ROTATION_PARTIALS_H_
+
+#include <evspace_common.hpp>
+#include <angles.hpp>
+#include <matrix.hpp>
+#include <vector.hpp>
+#include <matrix_array.hpp>
+#include <vector_array.hpp>
+#include <rotation.hpp>
+#include <sincos.hpp>
+#include <cstddef>      // std::size_t
+#include <stdexcept>    // std::out_of_range
+#include <type_traits>  // std::is_same_v
+
+namespace evspace {
+
+    /**
+     * Closed form partial derivatives of Euler angle rotations with respect
+     * to the angles. Changing one angle turns the frame about that angle's
+     * axis, so each partial is a cross product with the axis as seen in
+     * the reference frame,
+     *
+     *      dR / d(angle) = [axis]x * R,
+     *
+     * and the axes are columns of R and of its first elementary rotation.
+     * Given R, all three partials cost 27 multiplies each and no more trig.
+     */
+
+    // The rotation matrix of angles, as compute_rotation_matrix, along with
+    // its partial derivatives with respect to alpha, beta and gamma.
+    template<typename rotation_order, typename rotation_type = IntrinsicRotation>
+    void compute_rotation_partials(const EulerAngles&, Matrix&, Matrix&, Matrix&, Matrix&);
+    // Batch rotation matrices and partials of the angle sets in the alpha,
+    // beta and gamma spans, resizing the outputs to match. The spans must
+    // be the same size.
+    template<typename rotation_order, typename rotation_type = IntrinsicRotation>
+    void compute_rotation_partials(span_t<const double>, span_t<const double>, span_t<const double>,
+                                   MatrixArray&, MatrixArray&, MatrixArray&, MatrixArray&);
+
+    // rotate_from(angles, vector) along with its Jacobian with respect to
+    // the angles, column n the derivative with respect to angle n.
+    template<typename rotation_order, typename rotation_type = IntrinsicRotation>
+    Vector rotate_from_partials(const EulerAngles&, const Vector&, Matrix&);
+    // rotate_to(angles, vector) along with its Jacobian, as above.
+    template<typename rotation_order, typename rotation_type = IntrinsicRotation>
+    Vector rotate_to_partials(const EulerAngles&, const Vector&, Matrix&);
+    // Batch rotate_from of each vector by its angle set, writing the
+    // rotated vectors and their derivatives with respect to alpha, beta and
+    // gamma, resizing the outputs to match.
+    template<typename rotation_order, typename rotation_type = IntrinsicRotation>
+    void rotate_from_partials(span_t<const double>, span_t<const double>, span_t<const double>,
+                              const VectorArray&, VectorArray&, VectorArray&, VectorArray&, VectorArray&);
+    // Batch rotate_to with derivatives, as above.
+    template<typename rotation_order, typename rotation_type = IntrinsicRotation>
+    void rotate_to_partials(span_t<const double>, span_t<const double>, span_t<const double>,
+                            const VectorArray&, VectorArray&, VectorArray&, VectorArray&, VectorArray&);
+
+    namespace _partials_exec {
+
+        // Angle sets per chunk of the batch functions, small enough for the
+        // sines and cosines to stay in cache between the two passes.
+        constexpr std::size_t _chunk_size = 256;
+
+        // The reference frame axis of each angle of the row-major rotation,
+        // axis n at axes[3 * n]. Intrinsic rotations R1 * R2 * R3 turn about
+        // axis1, then axis2 carried by R1 and axis3 carried by all of R.
+        // Extrinsic rotations R3 * R2 * R1 are the mirror image.
+        template<typename rotation_order, typename rotation_type>
+        inline void _world_axes(const double* cosines, const double* sines, const double* rotation,
+                                double* axes) noexcept
+        {
+            typedef typename rotation_order::Axis_1 axis1;
+            typedef typename rotation_order::Axis_2 axis2;
+            typedef typename rotation_order::Axis_3 axis3;
+            constexpr std::size_t k1 = _AxisPlane<axis1>::k;
+            constexpr std::size_t k2 = _AxisPlane<axis2>::k;
+            constexpr std::size_t k3 = _AxisPlane<axis3>::k;
+
+            double first[9];
+            if constexpr (std::is_same_v<rotation_type, ExtrinsicRotation>) {
+                _rotation_exec::_elementary_matrix<axis3>(cosines[2], sines[2], first);
+                for (std::size_t r = 0; r < 3; r++) {
+                    axes[r] = rotation[r * 3 + k1];
+                    axes[3 + r] = first[r * 3 + k2];
+                    axes[6 + r] = r == k3 ? 1.0 : 0.0;
+                }
+            }
+            else {
+                _rotation_exec::_elementary_matrix<axis1>(cosines[0], sines[0], first);
+                for (std::size_t r = 0; r < 3; r++) {
+                    axes[r] = r == k1 ? 1.0 : 0.0;
+                    axes[3 + r] = first[r * 3 + k2];
+                    axes[6 + r] = rotation[r * 3 + k3];
+                }
+            }
+        }
+
+        // result = axis x vector
+        inline void _cross(const double* axis, const double* vector, double* result) noexcept {
+            result[0] = axis[1] * vector[2] - axis[2] * vector[1];
+            result[1] = axis[2] * vector[0] - axis[0] * vector[2];
+            result[2] = axis[0] * vector[1] - axis[1] * vector[0];
+        }
+
+        // partial = [axis]x * rotation, crossing each column of rotation.
+        inline void _cross_columns(const double* axis, const double* rotation, double* partial) noexcept {
+            for (std::size_t c = 0; c < 3; c++) {
+                const double column[3] = { rotation[c], rotation[3 + c], rotation[6 + c] };
+                double crossed[3];
+                _cross(axis, column, crossed);
+                partial[c] = crossed[0];
+                partial[3 + c] = crossed[1];
+                partial[6 + c] = crossed[2];
+            }
+        }
+
+        // The rotation and its three partials, partials[9 * n] for angle n.
+        template<typename rotation_order, typename rotation_type>
+        inline void _rotation_partials(const double* cosines, const double* sines, double* rotation,
+                                       double* partials) noexcept
+        {
+            _EulerAngleDelegate<rotation_order, rotation_type>::derive_matrix(cosines, sines, rotation);
+            double axes[9];
+            _world_axes<rotation_order, rotation_type>(cosines, sines, rotation, axes);
+            for (std::size_t n = 0; n < 3; n++) {
+                _cross_columns(axes + 3 * n, rotation, partials + 9 * n);
+            }
+        }
+
+        // The rotated vector and its derivatives, derivatives[3 * n] for
+        // angle n. Rotating from, R * v turns with the frame, so each
+        // derivative is axis x (R * v). Rotating to, R^T * v turns against
+        // it, giving (R^T * v) x (R^T * axis).
+        template<typename rotation_order, typename rotation_type, bool to>
+        inline void _vector_partials(const double* cosines, const double* sines, const double* vector,
+                                     double* rotated, double* derivatives) noexcept
+        {
+            double rotation[9], axes[9];
+            _EulerAngleDelegate<rotation_order, rotation_type>::derive_matrix(cosines, sines, rotation);
+            _world_axes<rotation_order, rotation_type>(cosines, sines, rotation, axes);
+
+            for (std::size_t r = 0; r < 3; r++) {
+                rotated[r] = to ? rotation[r] * vector[0] + rotation[3 + r] * vector[1] + rotation[6 + r] * vector[2]
+                                : rotation[r * 3] * vector[0] + rotation[r * 3 + 1] * vector[1]
+                                  + rotation[r * 3 + 2] * vector[2];
+            }
+            for (std::size_t n = 0; n < 3; n++) {
+                const double* axis = axes + 3 * n;
+                if (to) {
+                    double body_axis[3];
+                    for (std::size_t r = 0; r < 3; r++) {
+                        body_axis[r] = rotation[r] * axis[0] + rotation[3 + r] * axis[1] + rotation[6 + r] * axis[2];
+                    }
+                    _cross(rotated, body_axis, derivatives + 3 * n);
+                }
+                else {
+                    _cross(axis, rotated, derivatives + 3 * n);
+                }
+            }
+        }
+
+        inline void _check_sizes(std::size_t alphas, std::size_t betas, std::size_t gammas) {
+            if (betas != alphas || gammas != alphas) {
+                throw std::out_of_range("angle spans must be the same size");
+            }
+        }
+
+        // Runs kernel(cosines, sines, index) on every angle set, the sines
+        // and cosines computed a chunk at a time by the vectorized sincos.
+        template<typename Kernel>
+        inline void _for_each_angle_set(span_t<const double> alphas, span_t<const double> betas,
+                                        span_t<const double> gammas, Kernel&& kernel)
+        {
+            const std::size_t count = alphas.size();
+            const std::size_t chunk_count = (count + _chunk_size - 1) / _chunk_size;
+            const double* angles[3] = { alphas.data(), betas.data(), gammas.data() };
+
+            _EVSPACE_PARALLEL_FOR_IF(count >= _EVSPACE_PARALLEL_MINIMUM)
+            for (std::size_t chunk_index = 0; chunk_index < chunk_count; chunk_index++) {
+                const std::size_t start = chunk_index * _chunk_size;
+                const std::size_t chunk = count - start < _chunk_size ? count - start : _chunk_size;
+                double cosines[3][_chunk_size], sines[3][_chunk_size];
+                for (std::size_t a = 0; a < 3; a++) {
+                    sincos(span_t<const double>(angles[a] + start, chunk),
+                           span_t<double>(sines[a], chunk), span_t<double>(cosines[a], chunk));
+                }
+
+                for (std::size_t i = 0; i < chunk; i++) {
+                    const double c[3] = { cosines[0][i], cosines[1][i], cosines[2][i] };
+                    const double s[3] = { sines[0][i], sines[1][i], sines[2][i] };
+                    kernel(c, s, start + i);
+                }
+            }
+        }
+
+        template<typename rotation_order, typename rotation_type, bool to>
+        void _batch_vector_partials(span_t<const double> alphas, span_t<const double> betas,
+                                    span_t<const double> gammas, const VectorArray& vectors, VectorArray& rotated,
+                                    VectorArray& d_alpha, VectorArray& d_beta, VectorArray& d_gamma)
+        {
+            _check_sizes(alphas.size(), betas.size(), gammas.size());
+            const std::size_t count = alphas.size();
+            if (vectors.size() != count) {
+                throw std::out_of_range("vectors must be the same size as the angle spans");
+            }
+
+            rotated.resize(count);
+            d_alpha.resize(count);
+            d_beta.resize(count);
+            d_gamma.resize(count);
+            const double* input[3] = { vectors.x(), vectors.y(), vectors.z() };
+            VectorArray* outputs[4] = { &rotated, &d_alpha, &d_beta, &d_gamma };
+            double* planes[12];
+            for (std::size_t n = 0; n < 4; n++) {
+                planes[3 * n] = outputs[n]->x();
+                planes[3 * n + 1] = outputs[n]->y();
+                planes[3 * n + 2] = outputs[n]->z();
+            }
+
+            _for_each_angle_set(alphas, betas, gammas, [&](const double* c, const double* s, std::size_t index) {
+                const double vector[3] = { input[0][index], input[1][index], input[2][index] };
+                double values[12];
+                _vector_partials<rotation_order, rotation_type, to>(c, s, vector, values, values + 3);
+                for (std::size_t k = 0; k < 12; k++) {
+                    planes[k][index] = values[k];
+                }
+            });
+        }
+
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    void compute_rotation_partials(const EulerAngles& angles, Matrix& rotation, Matrix& d_alpha, Matrix& d_beta,
+                                   Matrix& d_gamma)
+    {
+        double cosines[3], sines[3], values[9], partials[27];
+        _rotation_exec::_euler_angle_trig(angles, cosines, sines);
+        _partials_exec::_rotation_partials<rotation_order, rotation_type>(cosines, sines, values, partials);
+
+        double* outputs[4] = { rotation.data().data(), d_alpha.data().data(), d_beta.data().data(),
+                               d_gamma.data().data() };
+        for (std::size_t k = 0; k < 9; k++) {
+            outputs[0][k] = values[k];
+            for (std::size_t n = 0; n < 3; n++) {
+                outputs[n + 1][k] = partials[9 * n + k];
+            }
+        }
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    void compute_rotation_partials(span_t<const double> alphas, span_t<const double> betas,
+                                   span_t<const double> gammas, MatrixArray& rotations, MatrixArray& d_alpha,
+                                   MatrixArray& d_beta, MatrixArray& d_gamma)
+    {
+        _partials_exec::_check_sizes(alphas.size(), betas.size(), gammas.size());
+        const std::size_t count = alphas.size();
+        MatrixArray* outputs[4] = { &rotations, &d_alpha, &d_beta, &d_gamma };
+        double* planes[36];
+        for (std::size_t n = 0; n < 4; n++) {
+            outputs[n]->resize(count);
+            for (std::size_t component = 0; component < 9; component++) {
+                planes[9 * n + component] = outputs[n]->plane(component / 3, component % 3);
+            }
+        }
+
+        _partials_exec::_for_each_angle_set(alphas, betas, gammas,
+            [&](const double* c, const double* s, std::size_t index) {
+                double values[36];
+                _partials_exec::_rotation_partials<rotation_order, rotation_type>(c, s, values, values + 9);
+                for (std::size_t k = 0; k < 36; k++) {
+                    planes[k][index] = values[k];
+                }
+            });
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    Vector rotate_from_partials(const EulerAngles& angles, const Vector& vector, Matrix& jacobian) {
+        double cosines[3], sines[3], rotated[3], derivatives[9];
+        _rotation_exec::_euler_angle_trig(angles, cosines, sines);
+        _partials_exec::_vector_partials<rotation_order, rotation_type, false>(
+            cosines, sines, vector.data().data(), rotated, derivatives);
+
+        for (std::size_t r = 0; r < 3; r++) {
+            for (std::size_t n = 0; n < 3; n++) {
+                jacobian(r, n) = derivatives[3 * n + r];
+            }
+        }
+        return Vector(rotated[0], rotated[1], rotated[2]);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    Vector rotate_to_partials(const EulerAngles& angles, const Vector& vector, Matrix& jacobian) {
+        double cosines[3], sines[3], rotated[3], derivatives[9];
+        _rotation_exec::_euler_angle_trig(angles, cosines, sines);
+        _partials_exec::_vector_partials<rotation_order, rotation_type, true>(
+            cosines, sines, vector.data().data(), rotated, derivatives);
+
+        for (std::size_t r = 0; r < 3; r++) {
+            for (std::size_t n = 0; n < 3; n++) {
+                jacobian(r, n) = derivatives[3 * n + r];
+            }
+        }
+        return Vector(rotated[0], rotated[1], rotated[2]);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    void rotate_from_partials(span_t<const double> alphas, span_t<const double> betas, span_t<const double> gammas,
+                              const VectorArray& vectors, VectorArray& rotated, VectorArray& d_alpha,
+                              VectorArray& d_beta, VectorArray& d_gamma)
+    {
+        _partials_exec::_batch_vector_partials<rotation_order, rotation_type, false>(
+            alphas, betas, gammas, vectors, rotated, d_alpha, d_beta, d_gamma);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    void rotate_to_partials(span_t<const double> alphas, span_t<const double> betas, span_t<const double> gammas,
+                            const VectorArray& vectors, VectorArray& rotated, VectorArray& d_alpha,
+                            VectorArray& d_beta, VectorArray& d_gamma)
+    {
+        _partials_exec::_batch_vector_partials<rotation_order, rotation_type, true>(
+            alphas, betas, gammas, vectors, rotated, d_alpha, d_beta, d_gamma);
+    }
+
+}   // namespace evspace
+
+#endif // _EVSPACE_ROTATION_PARTIALS_H_
@@ -0,0 +1,109 @@
+#ifndef _EVSPACE_SINCOS_H_
+#define _EVSPACE_SINCOS_H_
+
+#include <cmath>        // std::sin, std::cos, std::fabs, std::nearbyint
+#include <cstddef>      // std::size_t
+#include <stdexcept>    // std::out_of_range
+#include <evspace_common.hpp>
+
+namespace evspace {
+
+    namespace _sincos_exec {
+
+        // Arguments up to this magnitude are reduced exactly by the three
+        // part Cody-Waite reduction below (n * _PIO2_1 is exact while n
+        // fits in 20 bits). Larger arguments fall back to std::sin/std::cos.
+        constexpr double _REDUCTION_LIMIT = 1.0e5;
+
+        constexpr double _TWO_OVER_PI = 6.36619772367581382433e-01;
+        constexpr double _PIO2_1 = 1.57079632673412561417e+00;
+        constexpr double _PIO2_2 = 6.07710050630396597660e-11;
+        constexpr double _PIO2_3 = 2.02226624871116645580e-21;
+
+        // Rounds to the nearest integer without a library call, so the
+        // enclosing loop can vectorize. The magic constant trick is not safe
+        // under -ffast-math, which is free to fold (x + c) - c into x.
+        inline double _round_nearest(double x) noexcept {
+#if defined(__FAST_MATH__)
+            return std::nearbyint(x);
+#else
+            constexpr double magic = 6755399441055744.0;  // 1.5 * 2^52
+            return (x + magic) - magic;
+#endif
+        }
+
+        // Computes sin and cos of x for |x| <= _REDUCTION_LIMIT with the
+        // fdlibm minimax polynomials on [-pi/4, pi/4]. Branch free so a loop
+        // calling it vectorizes. Results are within an ulp or two of std::sin
+        // and std::cos over the valid range.
+        inline void _sincos_reduced(double x, double& sine, double& cosine) noexcept {
+            const double n = _round_nearest(x * _TWO_OVER_PI);
+            const double r = ((x - n * _PIO2_1) - n * _PIO2_2) - n * _PIO2_3;
+            const int quadrant = static_cast<int>(n);
+
+            const double z = r * r;
+            const double s = r + r * z * (-1.66666666666666324348e-01 + z * (8.33333333332248946124e-03
+                + z * (-1.98412698298579493134e-04 + z * (2.75573137070700676789e-06
+                + z * (-2.50507602534068634195e-08 + z * 1.58969099521155010221e-10)))));
+            const double c = 1.0 - 0.5 * z + z * z * (4.16666666666666019037e-02 + z * (-1.38888888888741095749e-03
+                + z * (2.48015872894767294178e-05 + z * (-2.75573143513906633035e-07
+                + z * (2.08757232129817482790e-09 + z * -1.13596475577881948265e-11)))));
+
+            // quadrant 0: ( s,  c), 1: ( c, -s), 2: (-s, -c), 3: (-c,  s)
+            const bool swap = (quadrant & 1) != 0;
+            const double sin_base = swap ? c : s;
+            const double cos_base = swap ? s : c;
+            sine = ((quadrant + 0) & 2) != 0 ? -sin_base : sin_base;
+            cosine = ((quadrant + 1) & 2) != 0 ? -cos_base : cos_base;
+        }
+
+    }
+
+    // Computes the sine and cosine of angle together, sharing the argument
+    // reduction.
+    inline void sincos(double angle, double& sine, double& cosine) noexcept {
+        if (std::fabs(angle) <= _sincos_exec::_REDUCTION_LIMIT) {
+            _sincos_exec::_sincos_reduced(angle, sine, cosine);
+        }
+        else {
+            sine = std::sin(angle);
+            cosine = std::cos(angle);
+        }
+    }
+
+    // Computes the sine and cosine of every angle. The main loop is branch
+    // free and vectorizes; angles too large for the fast argument reduction
+    // are then fixed up with std::sin and std::cos. Every span
+    // must be the same size and the output spans must not alias angles.
+    inline void sincos(span_t<const double> angles, span_t<double> sines, span_t<double> cosines) {
+        const std::size_t size = angles.size();
+        if (sines.size() != size || cosines.size() != size) {
+            throw std::out_of_range("sincos spans must be the same size");
+        }
+
+        const double* a = angles.data();
+        double* s = sines.data();
+        double* c = cosines.data();
+
+        for (std::size_t i = 0; i < size; i++) {
+            // NaN, infinite and large angles are reduced as 0 here, since the
+            // quadrant cast is undefined for them, and fixed up below
+            const double angle = std::fabs(a[i]) <= _sincos_exec::_REDUCTION_LIMIT ? a[i] : 0.0;
+            double sine, cosine;
+            _sincos_exec::_sincos_reduced(angle, sine, cosine);
+            s[i] = sine;
+            c[i] = cosine;
+        }
+
+        for (std::size_t i = 0; i < size; i++) {
+            if (!(std::fabs(a[i]) <= _sincos_exec::_REDUCTION_LIMIT)) {
+                const double angle = a[i];
+                s[i] = std::sin(angle);
+                c[i] = std::cos(angle);
+            }
+        }
+    }
+
+}   // namespace evspace
+
+#endif // _EVSPACE_SINCOS_H_
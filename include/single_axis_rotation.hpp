@@ -0,0 +1,143 @@
+#ifndef _EVSPACE_SINGLE_AXIS_ROTATION_H_
+#define _EVSPACE_SINGLE_AXIS_ROTATION_H_
+
+#include <matrix.hpp>
+#include <vector.hpp>
+#include <rotation.hpp>
+
+namespace evspace {
+
+    // Rotation by an angle around a single coordinate axis, stored as the
+    // angle with its cosine and sine. The rotation matrix has five entries
+    // which are always zero or one, so products with a Matrix or Vector only
+    // update the two rows, columns or components in the plane of rotation
+    // rather than doing a dense 3x3 product. Multiples of pi / 2 are stored
+    // with exact cosines and sines, making common mounting rotations exact.
+    template<typename _axis>
+    class SingleAxisRotation {
+    private:
+        double m_angle;
+        double m_cos;
+        double m_sin;
+
+        SingleAxisRotation(double, double, double) noexcept;
+
+    public:
+        explicit SingleAxisRotation(double) noexcept;
+
+        double get_angle() const noexcept;
+        Matrix to_matrix() const;
+        // The rotation by the negated angle, equal to the transpose.
+        SingleAxisRotation inverse() const noexcept;
+
+        Vector rotate_from(const Vector&) const;
+        Vector rotate_to(const Vector&) const;
+
+        // Composes two rotations about the same axis, whose angles add.
+        SingleAxisRotation operator*(const SingleAxisRotation&) const noexcept;
+
+        typedef _axis Axis;
+
+        template<typename axis>
+        friend Matrix operator*(const Matrix&, const SingleAxisRotation<axis>&);
+        template<typename axis>
+        friend Matrix operator*(const SingleAxisRotation<axis>&, const Matrix&);
+        template<typename axis>
+        friend Matrix& operator*=(Matrix&, const SingleAxisRotation<axis>&);
+    };
+
+    // Product of a matrix and an elementary rotation, updating two columns.
+    template<typename axis>
+    Matrix operator*(const Matrix&, const SingleAxisRotation<axis>&);
+    // Product of an elementary rotation and a matrix, updating two rows.
+    template<typename axis>
+    Matrix operator*(const SingleAxisRotation<axis>&, const Matrix&);
+    template<typename axis>
+    Matrix& operator*=(Matrix&, const SingleAxisRotation<axis>&);
+    // Equivalent to rotation.rotate_from(vector).
+    template<typename axis>
+    Vector operator*(const SingleAxisRotation<axis>&, const Vector&);
+
+    /**
+     * SingleAxisRotation implementations.
+     */
+
+    template<typename axis>
+    SingleAxisRotation<axis>::SingleAxisRotation(double angle, double cos_angle, double sin_angle) noexcept
+        : m_angle(angle), m_cos(cos_angle), m_sin(sin_angle) { }
+
+    template<typename axis>
+    SingleAxisRotation<axis>::SingleAxisRotation(double angle) noexcept
+        : m_angle(angle), m_cos(), m_sin()
+    {
+        _rotation_exec::_axis_trig(angle, this->m_cos, this->m_sin);
+    }
+
+    template<typename axis>
+    double SingleAxisRotation<axis>::get_angle() const noexcept {
+        return this->m_angle;
+    }
+
+    template<typename axis>
+    Matrix SingleAxisRotation<axis>::to_matrix() const {
+        Matrix result;
+        _rotation_exec::_elementary_matrix<axis>(this->m_cos, this->m_sin, result.data().data());
+        return result;
+    }
+
+    template<typename axis>
+    SingleAxisRotation<axis> SingleAxisRotation<axis>::inverse() const noexcept {
+        return SingleAxisRotation(-this->m_angle, this->m_cos, -this->m_sin);
+    }
+
+    template<typename axis>
+    Vector SingleAxisRotation<axis>::rotate_from(const Vector& vector) const {
+        Vector result = vector;
+        _rotation_exec::_rotate_elementary_from<axis>(this->m_cos, this->m_sin, result.data().data());
+        return result;
+    }
+
+    template<typename axis>
+    Vector SingleAxisRotation<axis>::rotate_to(const Vector& vector) const {
+        Vector result = vector;
+        _rotation_exec::_rotate_elementary_to<axis>(this->m_cos, this->m_sin, result.data().data());
+        return result;
+    }
+
+    template<typename axis>
+    SingleAxisRotation<axis> SingleAxisRotation<axis>::operator*(const SingleAxisRotation& rhs) const noexcept {
+        return SingleAxisRotation(
+            this->m_angle + rhs.m_angle,
+            this->m_cos * rhs.m_cos - this->m_sin * rhs.m_sin,
+            this->m_sin * rhs.m_cos + this->m_cos * rhs.m_sin
+        );
+    }
+
+    template<typename axis>
+    Matrix operator*(const Matrix& matrix, const SingleAxisRotation<axis>& rotation) {
+        Matrix result = matrix;
+        _rotation_exec::_post_multiply_elementary<axis>(rotation.m_cos, rotation.m_sin, result.data().data());
+        return result;
+    }
+
+    template<typename axis>
+    Matrix operator*(const SingleAxisRotation<axis>& rotation, const Matrix& matrix) {
+        Matrix result = matrix;
+        _rotation_exec::_pre_multiply_elementary<axis>(rotation.m_cos, rotation.m_sin, result.data().data());
+        return result;
+    }
+
+    template<typename axis>
+    Matrix& operator*=(Matrix& matrix, const SingleAxisRotation<axis>& rotation) {
+        _rotation_exec::_post_multiply_elementary<axis>(rotation.m_cos, rotation.m_sin, matrix.data().data());
+        return matrix;
+    }
+
+    template<typename axis>
+    Vector operator*(const SingleAxisRotation<axis>& rotation, const Vector& vector) {
+        return rotation.rotate_from(vector);
+    }
+
+}   // namespace evspace
+
+#endif // _EVSPACE_SINGLE_AXIS_ROTATION_H_
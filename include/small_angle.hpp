@@ -0,0 +1,314 @@
+#ifndef _EVSPACE_SMALL_ANGLE_H_
+#define _EVSPACE_SMALL_ANGLE_H_
+
+#include <angles.hpp>
+#include <matrix.hpp>
+#include <vector.hpp>
+#include <matrix_array.hpp>
+#include <rotation.hpp>
+#include <evspace_common.hpp>
+#include <cmath>        // std::sin, std::cos, std::fabs
+#include <cstddef>      // std::size_t
+#include <stdexcept>    // std::out_of_range
+
+namespace evspace {
+
+    /**
+     * Small angle rotations. Corrections of an attitude estimate are often
+     * on the order of 1e-4 rad, where a couple of Taylor terms give sin and
+     * cos to full precision. These functions take an absolute tolerance,
+     * choose the fewest Taylor terms whose truncation error is within it,
+     * and fall back to std::sin and std::cos when no order up to
+     * _MAX_TERMS is enough or the angle is outside of |angle| <= 1.
+     *
+     * The series alternate with decreasing terms on that domain, so the
+     * truncation error is bounded by the first omitted term. Keeping n
+     * terms of each series the errors of sin and cos are at most
+     *
+     *      |x|^(2n + 1) / (2n + 1)!    and    |x|^(2n) / (2n)!
+     *
+     * respectively, and the cosine bound is the larger of the two. Computed
+     * values are within the tolerance plus a few ulp of rounding error.
+     */
+
+    namespace _small_angle_exec {
+
+        constexpr double _SMALL_ANGLE_LIMIT = 1.0;
+        constexpr std::size_t _MAX_TERMS = 6;
+
+        // Taylor coefficients of sin(x) / x and cos(x) in powers of x^2.
+        constexpr double _SIN_COEFFICIENTS[_MAX_TERMS] = {
+            1.0, -1.0 / 6.0, 1.0 / 120.0, -1.0 / 5040.0, 1.0 / 362880.0, -1.0 / 39916800.0
+        };
+        constexpr double _COS_COEFFICIENTS[_MAX_TERMS] = {
+            1.0, -1.0 / 2.0, 1.0 / 24.0, -1.0 / 720.0, 1.0 / 40320.0, -1.0 / 3628800.0
+        };
+
+        // Fewest terms that keep the truncation error of sin and cos of
+        // angle within tolerance, or zero if exact trig must be used.
+        inline std::size_t _terms(double angle, double tolerance) noexcept {
+            const double magnitude = std::fabs(angle);
+            // also rejects NaN
+            if (!(magnitude <= _SMALL_ANGLE_LIMIT)) {
+                return 0;
+            }
+
+            // bound = x^(2n) / (2n)!
+            const double square = magnitude * magnitude;
+            double bound = 1.0;
+            for (std::size_t n = 1; n <= _MAX_TERMS; n++) {
+                bound *= square / static_cast<double>((2 * n - 1) * (2 * n));
+                if (bound <= tolerance) {
+                    return n;
+                }
+            }
+
+            return 0;
+        }
+
+        // Evaluates terms of the sin and cos series with Horner's rule.
+        inline void _sincos_series(double angle, std::size_t terms, double& sine, double& cosine) noexcept {
+            const double square = angle * angle;
+            double s = _SIN_COEFFICIENTS[terms - 1];
+            double c = _COS_COEFFICIENTS[terms - 1];
+            for (std::size_t n = terms - 1; n > 0; n--) {
+                s = s * square + _SIN_COEFFICIENTS[n - 1];
+                c = c * square + _COS_COEFFICIENTS[n - 1];
+            }
+
+            sine = s * angle;
+            cosine = c;
+        }
+
+        // Same as above with the number of terms fixed at compile time, so
+        // loops calling it unroll and vectorize.
+        template<std::size_t _terms_count>
+        inline void _sincos_series(double angle, double& sine, double& cosine) noexcept {
+            const double square = angle * angle;
+            double s = _SIN_COEFFICIENTS[_terms_count - 1];
+            double c = _COS_COEFFICIENTS[_terms_count - 1];
+            for (std::size_t n = _terms_count - 1; n > 0; n--) {
+                s = s * square + _SIN_COEFFICIENTS[n - 1];
+                c = c * square + _COS_COEFFICIENTS[n - 1];
+            }
+
+            sine = s * angle;
+            cosine = c;
+        }
+
+        // 1 - cos(angle) from the series without the leading one, avoiding
+        // the cancellation of subtracting a cosine close to one. Has the
+        // same truncation error bound as the cosine, and always keeps the
+        // leading x^2 / 2 term so tiny angles keep their relative precision.
+        inline double _versine_series(double angle, std::size_t terms) noexcept {
+            const double square = angle * angle;
+            double v = 0.0;
+            for (std::size_t n = (terms > 1 ? terms : 2) - 1; n > 0; n--) {
+                v = v * square - _COS_COEFFICIENTS[n];
+            }
+
+            return v * square;
+        }
+
+        template<std::size_t _terms_count>
+        inline void _sincos_batch(const double* angles, std::size_t count, double* sines, double* cosines) noexcept {
+            for (std::size_t i = 0; i < count; i++) {
+                double s, c;
+                _sincos_series<_terms_count>(angles[i], s, c);
+                sines[i] = s;
+                cosines[i] = c;
+            }
+        }
+
+        // Computes the sines and cosines of count angles. When one order
+        // covers the largest angle every angle uses it in a branch free
+        // loop, otherwise each angle chooses its own order or exact trig.
+        inline void _sincos_batch(const double* angles, std::size_t count, double tolerance,
+                                  double* sines, double* cosines) noexcept
+        {
+            double largest = 0.0;
+            for (std::size_t i = 0; i < count; i++) {
+                const double magnitude = std::fabs(angles[i]);
+                largest = magnitude > largest ? magnitude : largest;
+            }
+            // NaN angles compare false above, check them with the per angle path
+            bool has_nan = false;
+            for (std::size_t i = 0; i < count; i++) {
+                has_nan |= angles[i] != angles[i];
+            }
+
+            switch (has_nan ? 0 : _terms(largest, tolerance)) {
+            case 1: _sincos_batch<1>(angles, count, sines, cosines); return;
+            case 2: _sincos_batch<2>(angles, count, sines, cosines); return;
+            case 3: _sincos_batch<3>(angles, count, sines, cosines); return;
+            case 4: _sincos_batch<4>(angles, count, sines, cosines); return;
+            case 5: _sincos_batch<5>(angles, count, sines, cosines); return;
+            case 6: _sincos_batch<6>(angles, count, sines, cosines); return;
+            default: break;
+            }
+
+            for (std::size_t i = 0; i < count; i++) {
+                const std::size_t terms = _terms(angles[i], tolerance);
+                if (terms != 0) {
+                    _sincos_series(angles[i], terms, sines[i], cosines[i]);
+                }
+                else {
+                    sines[i] = std::sin(angles[i]);
+                    cosines[i] = std::cos(angles[i]);
+                }
+            }
+        }
+
+    }
+
+    // Number of Taylor terms used for angle at tolerance, zero when the
+    // small angle functions fall back to exact trig.
+    inline std::size_t small_angle_terms(double angle, double tolerance) noexcept {
+        return _small_angle_exec::_terms(angle, tolerance);
+    }
+
+    // Sine and cosine of angle within tolerance.
+    inline void small_angle_sincos(double angle, double tolerance, double& sine, double& cosine) noexcept {
+        const std::size_t terms = _small_angle_exec::_terms(angle, tolerance);
+        if (terms != 0) {
+            _small_angle_exec::_sincos_series(angle, terms, sine, cosine);
+        }
+        else {
+            sine = std::sin(angle);
+            cosine = std::cos(angle);
+        }
+    }
+
+    // Sines and cosines of every angle within tolerance. Every span must be
+    // the same size.
+    inline void small_angle_sincos(span_t<const double> angles, double tolerance,
+                                   span_t<double> sines, span_t<double> cosines)
+    {
+        const std::size_t size = angles.size();
+        if (sines.size() != size || cosines.size() != size) {
+            throw std::out_of_range("small_angle_sincos spans must be the same size");
+        }
+
+        _small_angle_exec::_sincos_batch(angles.data(), size, tolerance, sines.data(), cosines.data());
+    }
+
+    // Rotation matrix about axis, each entry within tolerance of
+    // compute_rotation_matrix<axis>(angle).
+    template<typename axis>
+    Matrix compute_small_angle_matrix(double angle, double tolerance) {
+        double s, c;
+        small_angle_sincos(angle, tolerance, s, c);
+
+        Matrix result;
+        _rotation_exec::_elementary_matrix<axis>(c, s, result.data().data());
+        return result;
+    }
+
+    // Rotation matrix of angle about rotation_vector by the Rodrigues
+    // formula, each entry within twice tolerance of the exact matrix. The
+    // 1 - cos(angle) term comes from its own series rather than the
+    // cosine, so it keeps its relative precision for tiny angles.
+    inline Matrix compute_small_angle_matrix(double angle, const Vector& rotation_vector, double tolerance) {
+        const Vector unit = rotation_vector.norm();
+        const double x = unit[0], y = unit[1], z = unit[2];
+
+        double s, c, v;
+        const std::size_t terms = _small_angle_exec::_terms(angle, tolerance);
+        if (terms != 0) {
+            _small_angle_exec::_sincos_series(angle, terms, s, c);
+            v = _small_angle_exec::_versine_series(angle, terms);
+        }
+        else {
+            s = std::sin(angle);
+            c = std::cos(angle);
+            v = 1.0 - c;
+        }
+
+        return Matrix(
+            {
+                { c + v * x * x, v * x * y - s * z, v * x * z + s * y },
+                { v * x * y + s * z, c + v * y * y, v * y * z - s * x },
+                { v * x * z - s * y, v * y * z + s * x, c + v * z * z }
+            }
+        );
+    }
+
+    // Rotation matrix of a set of Euler angles, each entry within three
+    // times tolerance of compute_rotation_matrix.
+    template<typename rotation_order, typename rotation_type = IntrinsicRotation>
+    Matrix compute_small_angle_matrix(const EulerAngles& angles, double tolerance) {
+        double sines[3], cosines[3];
+        for (std::size_t i = 0; i < 3; i++) {
+            small_angle_sincos(angles[i], tolerance, sines[i], cosines[i]);
+        }
+
+        Matrix result;
+        _EulerAngleDelegate<rotation_order, rotation_type>::derive_matrix(cosines, sines, result.data().data());
+        return result;
+    }
+
+    // Rotation matrices of the Euler angles (alpha[i], beta[i], gamma[i])
+    // written to output[i], resizing output to the size of the spans.
+    template<typename rotation_order, typename rotation_type = IntrinsicRotation>
+    void compute_small_angle_matrices(span_t<const double>, span_t<const double>, span_t<const double>,
+                                      double, MatrixArray&);
+
+    template<typename axis>
+    Vector small_angle_rotate_from(double angle, const Vector& vector, double tolerance) {
+        double s, c;
+        small_angle_sincos(angle, tolerance, s, c);
+
+        Vector result = vector;
+        _rotation_exec::_rotate_elementary_from<axis>(c, s, result.data().data());
+        return result;
+    }
+
+    template<typename axis>
+    Vector small_angle_rotate_to(double angle, const Vector& vector, double tolerance) {
+        double s, c;
+        small_angle_sincos(angle, tolerance, s, c);
+
+        Vector result = vector;
+        _rotation_exec::_rotate_elementary_to<axis>(c, s, result.data().data());
+        return result;
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    void compute_small_angle_matrices(span_t<const double> alphas, span_t<const double> betas,
+                                      span_t<const double> gammas, double tolerance, MatrixArray& output)
+    {
+        const std::size_t size = alphas.size();
+        if (betas.size() != size || gammas.size() != size) {
+            throw std::out_of_range("compute_small_angle_matrices spans must be the same size");
+        }
+
+        output.resize(size);
+        double* planes[9];
+        for (std::size_t component = 0; component < 9; component++) {
+            planes[component] = output.plane(component / 3, component % 3);
+        }
+
+        constexpr std::size_t chunk_size = 256;
+        double sines[3][chunk_size], cosines[3][chunk_size];
+        const double* angles[3] = { alphas.data(), betas.data(), gammas.data() };
+        for (std::size_t start = 0; start < size; start += chunk_size) {
+            const std::size_t count = size - start < chunk_size ? size - start : chunk_size;
+            for (std::size_t a = 0; a < 3; a++) {
+                _small_angle_exec::_sincos_batch(angles[a] + start, count, tolerance, sines[a], cosines[a]);
+            }
+
+            for (std::size_t i = 0; i < count; i++) {
+                const double c[3] = { cosines[0][i], cosines[1][i], cosines[2][i] };
+                const double s[3] = { sines[0][i], sines[1][i], sines[2][i] };
+                double m[9];
+                _EulerAngleDelegate<rotation_order, rotation_type>::derive_matrix(c, s, m);
+                for (std::size_t component = 0; component < 9; component++) {
+                    planes[component][start + i] = m[component];
+                }
+            }
+        }
+    }
+
+}   // namespace evspace
+
+#endif // _EVSPACE_SMALL_ANGLE_H_
@@ -0,0 +1,319 @@
+#ifndef _EVSPACE_SYMMETRIC_EIGEN_H_
+#define _EVSPACE_SYMMETRIC_EIGEN_H_
+
+#include <evspace_common.hpp>
+#include <matrix.hpp>
+#include <vector.hpp>
+#include <matrix_array.hpp>
+#include <vector_array.hpp>
+#include <symmetric_matrix.hpp>
+#include <symmetric_matrix_array.hpp>
+#include <cfloat>       // DBL_MIN
+#include <cmath>        // std::sqrt, std::fabs, std::copysign
+#include <cstddef>      // std::size_t
+
+namespace evspace {
+
+    // Eigendecomposition of a symmetric matrix, tensor = V * diag(values) * V^T.
+    // The eigenvalues are written to values in ascending order and the
+    // matching unit eigenvectors to the columns of vectors, which is a
+    // proper rotation matrix (determinant +1). vectors therefore rotates
+    // from the principal axes frame, rotate_from(vectors, diag(values)) is
+    // tensor, and compute_euler_angles() of it gives the principal axes as
+    // a frame. Repeated eigenvalues are handled, their eigenvectors are an
+    // orthonormal basis of the shared eigenspace.
+    void eigen_decomposition(const SymmetricMatrix&, Vector&, Matrix&);
+    // Batch eigendecomposition of every tensor, as above, resizing values
+    // and vectors to match.
+    void eigen_decomposition(const SymmetricMatrixArray&, VectorArray&, MatrixArray&);
+
+    namespace _symmetric_exec {
+
+        /**
+         * Branch free cyclic Jacobi eigensolver, written once over a lane
+         * type T which is either a double or, when the compiler targets
+         * AVX2 and FMA, four or eight doubles of consecutive batch
+         * elements. The rotations need square roots, which compilers won't
+         * vectorize from a plain loop unless errno is disabled, so the
+         * batch kernel uses the lane types directly rather than relying on
+         * the auto-vectorizer.
+         */
+
+        // Fixed number of sweeps of the three off-diagonal entries. Jacobi
+        // converges quadratically, including for repeated eigenvalues, and
+        // four sweeps reached rounding error on random and near-degenerate
+        // tensors, the fifth is margin. A fixed count keeps the batch lanes
+        // in step.
+        constexpr int _jacobi_sweeps = 5;
+        // Off-diagonal entries below this, relative to the largest entry,
+        // are treated as zero.
+        constexpr double _jacobi_negligible = 1e-150;
+
+        inline double _load(const double* data, double) noexcept { return *data; }
+        inline void _store(double* data, double value) noexcept { *data = value; }
+        inline double _broadcast(double value, double) noexcept { return value; }
+        inline double _sqrt(double value) noexcept { return std::sqrt(value); }
+        inline double _abs(double value) noexcept { return std::fabs(value); }
+        inline double _copysign(double magnitude, double sign) noexcept { return std::copysign(magnitude, sign); }
+        inline double _max(double lhs, double rhs) noexcept { return lhs > rhs ? lhs : rhs; }
+        // lhs < rhs ? if_less : otherwise
+        inline double _select_less(double lhs, double rhs, double if_less, double otherwise) noexcept {
+            return lhs < rhs ? if_less : otherwise;
+        }
+
+#if defined(EVSPACE_MATRIX_AVX2)
+        struct _lane4 {
+            __m256d value;
+        };
+
+        inline _lane4 operator+(_lane4 lhs, _lane4 rhs) noexcept { return { _mm256_add_pd(lhs.value, rhs.value) }; }
+        inline _lane4 operator-(_lane4 lhs, _lane4 rhs) noexcept { return { _mm256_sub_pd(lhs.value, rhs.value) }; }
+        inline _lane4 operator*(_lane4 lhs, _lane4 rhs) noexcept { return { _mm256_mul_pd(lhs.value, rhs.value) }; }
+        inline _lane4 operator/(_lane4 lhs, _lane4 rhs) noexcept { return { _mm256_div_pd(lhs.value, rhs.value) }; }
+        inline _lane4& operator+=(_lane4& lhs, _lane4 rhs) noexcept { return lhs = lhs + rhs; }
+        inline _lane4& operator-=(_lane4& lhs, _lane4 rhs) noexcept { return lhs = lhs - rhs; }
+        inline _lane4& operator*=(_lane4& lhs, _lane4 rhs) noexcept { return lhs = lhs * rhs; }
+
+        inline _lane4 _load(const double* data, _lane4) noexcept { return { _mm256_loadu_pd(data) }; }
+        inline void _store(double* data, _lane4 value) noexcept { _mm256_storeu_pd(data, value.value); }
+        inline _lane4 _broadcast(double value, _lane4) noexcept { return { _mm256_set1_pd(value) }; }
+        inline _lane4 _sqrt(_lane4 value) noexcept { return { _mm256_sqrt_pd(value.value) }; }
+        inline _lane4 _abs(_lane4 value) noexcept { return { _mm256_andnot_pd(_mm256_set1_pd(-0.0), value.value) }; }
+        inline _lane4 _copysign(_lane4 magnitude, _lane4 sign) noexcept {
+            const __m256d sign_bit = _mm256_set1_pd(-0.0);
+            return { _mm256_or_pd(_mm256_andnot_pd(sign_bit, magnitude.value), _mm256_and_pd(sign_bit, sign.value)) };
+        }
+        inline _lane4 _max(_lane4 lhs, _lane4 rhs) noexcept { return { _mm256_max_pd(lhs.value, rhs.value) }; }
+        inline _lane4 _select_less(_lane4 lhs, _lane4 rhs, _lane4 if_less, _lane4 otherwise) noexcept {
+            return { _mm256_blendv_pd(otherwise.value, if_less.value, _mm256_cmp_pd(lhs.value, rhs.value, _CMP_LT_OQ)) };
+        }
+
+        // Two independent groups of four, so the out of order core has a
+        // second chain to work on while the first waits on a square root or
+        // division.
+        struct _lane8 {
+            _lane4 low, high;
+        };
+
+        inline _lane8 operator+(_lane8 lhs, _lane8 rhs) noexcept { return { lhs.low + rhs.low, lhs.high + rhs.high }; }
+        inline _lane8 operator-(_lane8 lhs, _lane8 rhs) noexcept { return { lhs.low - rhs.low, lhs.high - rhs.high }; }
+        inline _lane8 operator*(_lane8 lhs, _lane8 rhs) noexcept { return { lhs.low * rhs.low, lhs.high * rhs.high }; }
+        inline _lane8 operator/(_lane8 lhs, _lane8 rhs) noexcept { return { lhs.low / rhs.low, lhs.high / rhs.high }; }
+        inline _lane8& operator+=(_lane8& lhs, _lane8 rhs) noexcept { return lhs = lhs + rhs; }
+        inline _lane8& operator-=(_lane8& lhs, _lane8 rhs) noexcept { return lhs = lhs - rhs; }
+        inline _lane8& operator*=(_lane8& lhs, _lane8 rhs) noexcept { return lhs = lhs * rhs; }
+
+        inline _lane8 _load(const double* data, _lane8) noexcept { return { _load(data, _lane4()), _load(data + 4, _lane4()) }; }
+        inline void _store(double* data, _lane8 value) noexcept { _store(data, value.low); _store(data + 4, value.high); }
+        inline _lane8 _broadcast(double value, _lane8) noexcept { return { _broadcast(value, _lane4()), _broadcast(value, _lane4()) }; }
+        inline _lane8 _sqrt(_lane8 value) noexcept { return { _sqrt(value.low), _sqrt(value.high) }; }
+        inline _lane8 _abs(_lane8 value) noexcept { return { _abs(value.low), _abs(value.high) }; }
+        inline _lane8 _copysign(_lane8 magnitude, _lane8 sign) noexcept {
+            return { _copysign(magnitude.low, sign.low), _copysign(magnitude.high, sign.high) };
+        }
+        inline _lane8 _max(_lane8 lhs, _lane8 rhs) noexcept { return { _max(lhs.low, rhs.low), _max(lhs.high, rhs.high) }; }
+        inline _lane8 _select_less(_lane8 lhs, _lane8 rhs, _lane8 if_less, _lane8 otherwise) noexcept {
+            return { _select_less(lhs.low, rhs.low, if_less.low, otherwise.low),
+                     _select_less(lhs.high, rhs.high, if_less.high, otherwise.high) };
+        }
+#endif
+
+        // Jacobi rotation zeroing the off-diagonal apq of the symmetric 2x2
+        // with diagonal app and aqq. The tangent is the smaller root,
+        // t = sign(d) h / (|d| + sqrt(d^2 + h^2)) with d = aqq - app and
+        // h = 2 apq, written without dividing by apq so a zero entry gives
+        // t = 0 rather than a special case. The cosine 1 / sqrt(1 + t^2)
+        // simplifies to sqrt((|d| + r) / 2r) with r = sqrt(d^2 + h^2),
+        // which doesn't wait on the division for t, shortening the
+        // dependency chain through each rotation.
+        template<typename T>
+        inline void _jacobi_angle(T app, T aqq, T apq, T& t, T& c, T& s) noexcept {
+            const T tiny = _broadcast(DBL_MIN, T());
+            const T d = aqq - app;
+            // entries this far below the largest, which is one after
+            // scaling, are dropped so h^2 stays a normal number
+            const T h = _select_less(_abs(apq), _broadcast(_jacobi_negligible, T()), _broadcast(0.0, T()), apq + apq);
+            // h^2 is normal or zero, but d^2 may be subnormal, so radius is
+            // exactly |d| when h is zero, for c = 1
+            const T radius = _select_less(_abs(h), tiny, _abs(d), _sqrt(d * d + h * h));
+            const T denominator = _abs(d) + radius + tiny;
+            t = _copysign(_broadcast(1.0, T()), d) * h / denominator;
+            c = _sqrt(denominator / (radius + radius + tiny));
+            s = t * c;
+        }
+
+        // Rotation of columns p and q of the row-major m by the Jacobi
+        // rotation with cosine c and sine s, m = m * J.
+        template<std::size_t p, std::size_t q, typename T>
+        inline void _rotate_columns(T* m, T c, T s) noexcept {
+            for (std::size_t k = 0; k < 3; k++) {
+                const T mkp = m[k * 3 + p], mkq = m[k * 3 + q];
+                m[k * 3 + p] = c * mkp - s * mkq;
+                m[k * 3 + q] = s * mkp + c * mkq;
+            }
+        }
+
+        // Rotation in the (p, q) plane zeroing entry (p, q) of the symmetric
+        // a, stored as in SymmetricMatrix, with r the remaining index. The
+        // rotation is accumulated into the columns of the row-major v.
+        template<std::size_t p, std::size_t q, std::size_t r, typename T>
+        inline void _jacobi_rotate(T* a, T* v) noexcept {
+            constexpr std::size_t pp = _INDEX[p][p], qq = _INDEX[q][q], pq = _INDEX[p][q];
+            constexpr std::size_t rp = _INDEX[r][p], rq = _INDEX[r][q];
+
+            T t, c, s;
+            _jacobi_angle(a[pp], a[qq], a[pq], t, c, s);
+            a[pp] -= t * a[pq];
+            a[qq] += t * a[pq];
+            a[pq] = _broadcast(0.0, T());
+            const T arp = a[rp], arq = a[rq];
+            a[rp] = c * arp - s * arq;
+            a[rq] = s * arp + c * arq;
+
+            _rotate_columns<p, q>(v, c, s);
+        }
+
+        // Orders eigenvalues i < j, swapping the eigenvector columns and
+        // negating one of them so v stays a proper rotation.
+        template<std::size_t i, std::size_t j, typename T>
+        inline void _sort_pair(T* values, T* v) noexcept {
+            const T low = values[i], high = values[j];
+            values[i] = _select_less(high, low, high, low);
+            values[j] = _select_less(high, low, low, high);
+            for (std::size_t k = 0; k < 3; k++) {
+                const T vi = v[k * 3 + i], vj = v[k * 3 + j];
+                v[k * 3 + i] = _select_less(high, low, vj, vi);
+                v[k * 3 + j] = _select_less(high, low, _broadcast(0.0, T()) - vi, vj);
+            }
+        }
+
+        // Eigendecomposition of the symmetric a, which is overwritten.
+        // Writes the ascending eigenvalues to values and the eigenvectors to
+        // the columns of the row-major v. a is scaled by its largest entry
+        // first, so the squares in the rotations can't overflow for any
+        // finite input.
+        template<typename T>
+        inline void _eigen(T* a, T* values, T* v) noexcept {
+            T scale = _abs(a[0]);
+            for (std::size_t entry = 1; entry < 6; entry++) {
+                scale = _max(scale, _abs(a[entry]));
+            }
+            scale = _max(scale, _broadcast(DBL_MIN, T()));
+            const T inverse_scale = _broadcast(1.0, T()) / scale;
+            for (std::size_t entry = 0; entry < 6; entry++) {
+                a[entry] *= inverse_scale;
+            }
+
+            for (std::size_t k = 0; k < 9; k++) {
+                v[k] = _broadcast(k % 4 == 0 ? 1.0 : 0.0, T());
+            }
+            for (int sweep = 0; sweep < _jacobi_sweeps; sweep++) {
+                _jacobi_rotate<0, 1, 2>(a, v);
+                _jacobi_rotate<0, 2, 1>(a, v);
+                _jacobi_rotate<1, 2, 0>(a, v);
+            }
+
+            values[0] = a[0] * scale;
+            values[1] = a[3] * scale;
+            values[2] = a[5] * scale;
+            _sort_pair<0, 1>(values, v);
+            _sort_pair<1, 2>(values, v);
+            _sort_pair<0, 1>(values, v);
+        }
+
+        // Eigendecomposition of the tensors starting at index, one lane's
+        // worth of elements, read from and written to the planes.
+        template<typename T>
+        inline void _eigen_planes(const double* const* tensors, double* const* values, double* const* vectors,
+                                  std::size_t index) noexcept
+        {
+            T a[6], eigenvalues[3], v[9];
+            for (std::size_t entry = 0; entry < 6; entry++) {
+                a[entry] = _load(tensors[entry] + index, T());
+            }
+
+            _eigen(a, eigenvalues, v);
+            for (std::size_t k = 0; k < 3; k++) {
+                _store(values[k] + index, eigenvalues[k]);
+            }
+            for (std::size_t component = 0; component < 9; component++) {
+                _store(vectors[component] + index, v[component]);
+            }
+        }
+
+        // Calls kernel(T(), index) for batch elements index onwards, with
+        // T the widest lane type, over count elements. Whole lanes are split
+        // across threads, the remainder is done with a narrower lane and
+        // then one element at a time.
+        template<typename Kernel>
+        void _for_each_lane(std::size_t count, Kernel kernel) {
+#if defined(EVSPACE_MATRIX_AVX2)
+            using lane_type = _lane8;
+            constexpr std::size_t lane_width = 8;
+#else
+            using lane_type = double;
+            constexpr std::size_t lane_width = 1;
+#endif
+            const std::size_t lane_count = count / lane_width;
+            _EVSPACE_PARALLEL_FOR_IF(count >= _EVSPACE_PARALLEL_MINIMUM)
+            for (std::size_t lane = 0; lane < lane_count; lane++) {
+                kernel(lane_type(), lane * lane_width);
+            }
+
+            std::size_t i = lane_count * lane_width;
+#if defined(EVSPACE_MATRIX_AVX2)
+            for (; i + 4 <= count; i += 4) {
+                kernel(_lane4(), i);
+            }
+#endif
+            for (; i < count; i++) {
+                kernel(0.0, i);
+            }
+        }
+
+    }
+
+    inline void eigen_decomposition(const SymmetricMatrix& tensor, Vector& values, Matrix& vectors) {
+        // locals rather than the heap storage of values and vectors, which
+        // the compiler would have to assume alias each other
+        double a[6], eigenvalues[3], v[9];
+        const double* data = tensor.data().data();
+        for (std::size_t entry = 0; entry < 6; entry++) {
+            a[entry] = data[entry];
+        }
+
+        _symmetric_exec::_eigen(a, eigenvalues, v);
+        for (std::size_t k = 0; k < 3; k++) {
+            values[k] = eigenvalues[k];
+        }
+        double* vector_data = vectors.data().data();
+        for (std::size_t component = 0; component < 9; component++) {
+            vector_data[component] = v[component];
+        }
+    }
+
+    inline void eigen_decomposition(const SymmetricMatrixArray& tensors, VectorArray& values, MatrixArray& vectors) {
+        const std::size_t count = tensors.size();
+        values.resize(count);
+        vectors.resize(count);
+
+        const double* tensor_planes[6];
+        double* value_planes[3] = { values.x(), values.y(), values.z() };
+        double* vector_planes[9];
+        for (std::size_t row = 0, entry = 0; row < 3; row++) {
+            for (std::size_t col = row; col < 3; col++, entry++) {
+                tensor_planes[entry] = tensors.plane(row, col);
+            }
+        }
+        for (std::size_t component = 0; component < 9; component++) {
+            vector_planes[component] = vectors.plane(component / 3, component % 3);
+        }
+
+        _symmetric_exec::_for_each_lane(count, [&](auto lane, std::size_t index) {
+            _symmetric_exec::_eigen_planes<decltype(lane)>(tensor_planes, value_planes, vector_planes, index);
+        });
+    }
+
+}   // namespace evspace
+
+#endif // _EVSPACE_SYMMETRIC_EIGEN_H_
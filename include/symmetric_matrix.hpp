@@ -0,0 +1,261 @@
+#ifndef _EVSPACE_SYMMETRIC_MATRIX_H_
+#define _EVSPACE_SYMMETRIC_MATRIX_H_
+
+#include <evspace_common.hpp>
+#include <compare.hpp>
+#include <matrix.hpp>
+#include <rotation.hpp>
+#include <cstddef>      // std::size_t
+#include <stdexcept>    // std::out_of_range
+
+namespace evspace {
+
+    namespace _symmetric_exec {
+
+        // Storage slot of entry (row, col), the upper triangle row by row:
+        // xx, xy, xz, yy, yz, zz.
+        constexpr std::size_t _INDEX[3][3] = { { 0, 1, 2 }, { 1, 3, 4 }, { 2, 4, 5 } };
+
+        // Similarity transform of the symmetric p by the row-major r, either
+        // out = r * p * r^T or, when transpose is set, out = r^T * p * r.
+        // The half product t = r * p uses the symmetry of p, and only the
+        // upper triangle of t * r^T is formed, 45 multiply-adds against 54
+        // for two general products. out may alias p.
+        template<bool transpose>
+        inline void _similarity(const double* r, const double* p, double* out) noexcept {
+            // entry (i, k) of r, or of r^T when transposed
+            auto a = [r](std::size_t i, std::size_t k) { return transpose ? r[k * 3 + i] : r[i * 3 + k]; };
+
+            double t[9];
+            for (std::size_t i = 0; i < 3; i++) {
+                const double a0 = a(i, 0), a1 = a(i, 1), a2 = a(i, 2);
+                t[i * 3] = a0 * p[0] + a1 * p[1] + a2 * p[2];
+                t[i * 3 + 1] = a0 * p[1] + a1 * p[3] + a2 * p[4];
+                t[i * 3 + 2] = a0 * p[2] + a1 * p[4] + a2 * p[5];
+            }
+
+            // entry (i, j) of t * a^T, written out so batch loops calling
+            // this have no inner loops left and vectorize
+            auto upper = [&t, &a](std::size_t i, std::size_t j) {
+                return t[i * 3] * a(j, 0) + t[i * 3 + 1] * a(j, 1) + t[i * 3 + 2] * a(j, 2);
+            };
+            out[0] = upper(0, 0);
+            out[1] = upper(0, 1);
+            out[2] = upper(0, 2);
+            out[3] = upper(1, 1);
+            out[4] = upper(1, 2);
+            out[5] = upper(2, 2);
+        }
+
+    }
+
+    // Symmetric 3x3 matrix, such as a covariance or an inertia tensor,
+    // stored as the six entries of its upper triangle with no heap
+    // allocation. Entry (row, col) and (col, row) are the same storage.
+    class SymmetricMatrix {
+    private:
+        // xx, xy, xz, yy, yz, zz
+        double m_data[6];
+
+    public:
+        SymmetricMatrix() noexcept;
+        SymmetricMatrix(double xx, double xy, double xz, double yy, double yz, double zz) noexcept;
+        // The symmetric part (m + m^T) / 2 of matrix, which is matrix
+        // itself when it is already symmetric.
+        explicit SymmetricMatrix(const Matrix&) noexcept;
+
+        double& operator()(std::size_t, std::size_t);
+        double operator()(std::size_t, std::size_t) const;
+
+        // The six stored entries, xx, xy, xz, yy, yz, zz.
+        span_t<double> data() noexcept;
+        span_t<const double> data() const noexcept;
+
+        Matrix to_matrix() const;
+        double trace() const noexcept;
+
+        SymmetricMatrix operator+(const SymmetricMatrix&) const noexcept;
+        SymmetricMatrix& operator+=(const SymmetricMatrix&) noexcept;
+        SymmetricMatrix operator-(const SymmetricMatrix&) const noexcept;
+        SymmetricMatrix& operator-=(const SymmetricMatrix&) noexcept;
+        SymmetricMatrix operator*(double) const noexcept;
+        SymmetricMatrix& operator*=(double) noexcept;
+
+        // Tolerance based comparison of the stored entries, as for Matrix.
+        bool operator==(const SymmetricMatrix&) const noexcept;
+        bool operator!=(const SymmetricMatrix&) const noexcept;
+        bool compare_to(const SymmetricMatrix&, double rel_tol, double abs_tol) const noexcept;
+    };
+
+    // Rotates a tensor from a rotated frame to the inertial frame,
+    // m * p * m^T, the tensor counterpart of rotate_from(m, vector).
+    SymmetricMatrix rotate_from(const Matrix&, const SymmetricMatrix&);
+    // Rotates a tensor from the inertial frame to a rotated frame,
+    // m^T * p * m, the tensor counterpart of rotate_to(m, vector).
+    SymmetricMatrix rotate_to(const Matrix&, const SymmetricMatrix&);
+
+    // Frame versions of the tensor rotations. Offsets don't affect tensors
+    // and are ignored.
+    template<typename rotation_order, typename rotation_type, typename offset_type>
+    SymmetricMatrix rotate_from(const ReferenceFrame<rotation_order, rotation_type, offset_type>&,
+                                const SymmetricMatrix&);
+    template<typename rotation_order, typename rotation_type, typename offset_type>
+    SymmetricMatrix rotate_to(const ReferenceFrame<rotation_order, rotation_type, offset_type>&,
+                              const SymmetricMatrix&);
+
+    /**
+     * SymmetricMatrix implementations.
+     */
+
+    inline SymmetricMatrix::SymmetricMatrix() noexcept : m_data{ 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 } { }
+
+    inline SymmetricMatrix::SymmetricMatrix(double xx, double xy, double xz, double yy, double yz, double zz) noexcept
+        : m_data{ xx, xy, xz, yy, yz, zz } { }
+
+    inline SymmetricMatrix::SymmetricMatrix(const Matrix& matrix) noexcept : m_data() {
+        const double* data = matrix.data().data();
+        for (std::size_t row = 0; row < 3; row++) {
+            for (std::size_t col = row; col < 3; col++) {
+                this->m_data[_symmetric_exec::_INDEX[row][col]] = 0.5 * (data[row * 3 + col] + data[col * 3 + row]);
+            }
+        }
+    }
+
+    inline double& SymmetricMatrix::operator()(std::size_t row, std::size_t col) {
+        if (row > 2) {
+            throw std::out_of_range("SymmetricMatrix row index out of range");
+        }
+        if (col > 2) {
+            throw std::out_of_range("SymmetricMatrix column index out of range");
+        }
+
+        return this->m_data[_symmetric_exec::_INDEX[row][col]];
+    }
+
+    inline double SymmetricMatrix::operator()(std::size_t row, std::size_t col) const {
+        if (row > 2) {
+            throw std::out_of_range("SymmetricMatrix row index out of range");
+        }
+        if (col > 2) {
+            throw std::out_of_range("SymmetricMatrix column index out of range");
+        }
+
+        return this->m_data[_symmetric_exec::_INDEX[row][col]];
+    }
+
+    inline span_t<double> SymmetricMatrix::data() noexcept {
+        return span_t<double>(this->m_data, 6);
+    }
+
+    inline span_t<const double> SymmetricMatrix::data() const noexcept {
+        return span_t<const double>(this->m_data, 6);
+    }
+
+    inline Matrix SymmetricMatrix::to_matrix() const {
+        Matrix result;
+        double* data = result.data().data();
+        for (std::size_t row = 0; row < 3; row++) {
+            for (std::size_t col = 0; col < 3; col++) {
+                data[row * 3 + col] = this->m_data[_symmetric_exec::_INDEX[row][col]];
+            }
+        }
+
+        return result;
+    }
+
+    inline double SymmetricMatrix::trace() const noexcept {
+        return this->m_data[0] + this->m_data[3] + this->m_data[5];
+    }
+
+    inline SymmetricMatrix SymmetricMatrix::operator+(const SymmetricMatrix& rhs) const noexcept {
+        SymmetricMatrix result = *this;
+        return result += rhs;
+    }
+
+    inline SymmetricMatrix& SymmetricMatrix::operator+=(const SymmetricMatrix& rhs) noexcept {
+        for (std::size_t i = 0; i < 6; i++) {
+            this->m_data[i] += rhs.m_data[i];
+        }
+
+        return *this;
+    }
+
+    inline SymmetricMatrix SymmetricMatrix::operator-(const SymmetricMatrix& rhs) const noexcept {
+        SymmetricMatrix result = *this;
+        return result -= rhs;
+    }
+
+    inline SymmetricMatrix& SymmetricMatrix::operator-=(const SymmetricMatrix& rhs) noexcept {
+        for (std::size_t i = 0; i < 6; i++) {
+            this->m_data[i] -= rhs.m_data[i];
+        }
+
+        return *this;
+    }
+
+    inline SymmetricMatrix SymmetricMatrix::operator*(double scalar) const noexcept {
+        SymmetricMatrix result = *this;
+        return result *= scalar;
+    }
+
+    inline SymmetricMatrix& SymmetricMatrix::operator*=(double scalar) noexcept {
+        for (std::size_t i = 0; i < 6; i++) {
+            this->m_data[i] *= scalar;
+        }
+
+        return *this;
+    }
+
+    inline bool SymmetricMatrix::compare_to(const SymmetricMatrix& rhs, double rel_tol, double abs_tol) const noexcept {
+        for (std::size_t i = 0; i < 6; i++) {
+            if (!_double_almost_equal(this->m_data[i], rhs.m_data[i], rel_tol, abs_tol)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    inline bool SymmetricMatrix::operator==(const SymmetricMatrix& rhs) const noexcept {
+        return this->compare_to(rhs, DEFAULT_REL_TOL, DEFAULT_ABS_TOL);
+    }
+
+    inline bool SymmetricMatrix::operator!=(const SymmetricMatrix& rhs) const noexcept {
+        return !(*this == rhs);
+    }
+
+    /**
+     * Tensor rotations.
+     */
+
+    inline SymmetricMatrix rotate_from(const Matrix& rotation_matrix, const SymmetricMatrix& tensor) {
+        SymmetricMatrix result;
+        _symmetric_exec::_similarity<false>(rotation_matrix.data().data(), tensor.data().data(),
+                                            result.data().data());
+        return result;
+    }
+
+    inline SymmetricMatrix rotate_to(const Matrix& rotation_matrix, const SymmetricMatrix& tensor) {
+        SymmetricMatrix result;
+        _symmetric_exec::_similarity<true>(rotation_matrix.data().data(), tensor.data().data(),
+                                           result.data().data());
+        return result;
+    }
+
+    template<typename rotation_order, typename rotation_type, typename offset_type>
+    SymmetricMatrix rotate_from(const ReferenceFrame<rotation_order, rotation_type, offset_type>& frame,
+                                const SymmetricMatrix& tensor)
+    {
+        return rotate_from(frame.get_matrix(), tensor);
+    }
+
+    template<typename rotation_order, typename rotation_type, typename offset_type>
+    SymmetricMatrix rotate_to(const ReferenceFrame<rotation_order, rotation_type, offset_type>& frame,
+                              const SymmetricMatrix& tensor)
+    {
+        return rotate_to(frame.get_matrix(), tensor);
+    }
+
+}   // namespace evspace
+
+#endif // _EVSPACE_SYMMETRIC_MATRIX_H_
@@ -0,0 +1,324 @@
+#ifndef _EVSPACE_SYMMETRIC_MATRIX_ARRAY_H_
+#define _EVSPACE_SYMMETRIC_MATRIX_ARRAY_H_
+
+#include <evspace_common.hpp>
+#include <matrix.hpp>
+#include <matrix_array.hpp>
+#include <rotation.hpp>
+#include <reference_frame_array.hpp>
+#include <symmetric_matrix.hpp>
+#include <cstddef>      // std::size_t
+#include <stdexcept>    // std::out_of_range
+#include <vector>       // std::vector
+
+namespace evspace {
+
+    // Collection of symmetric 3x3 matrices stored as a structure of arrays,
+    // one contiguous plane per stored entry (xx, xy, xz, yy, yz, zz), so
+    // batches of covariances or inertia tensors can be rotated with vector
+    // instructions and no per-matrix heap allocation.
+    class SymmetricMatrixArray {
+    private:
+        std::size_t m_size;
+        std::size_t m_capacity;
+        // six planes of m_capacity entries, in SymmetricMatrix storage order
+        std::vector<double> m_data;
+
+    public:
+        SymmetricMatrixArray() noexcept;
+        explicit SymmetricMatrixArray(std::size_t);
+        SymmetricMatrixArray(span_t<const SymmetricMatrix>);
+
+        std::size_t size() const noexcept;
+        std::size_t capacity() const noexcept;
+        // Grows the planes to hold at least capacity matrices without
+        // changing the size, so later growth up to it doesn't reallocate.
+        void reserve(std::size_t);
+        // Resizes the array, preserving the existing matrices which fit
+        // in the new size. New matrices are initialized to zero.
+        void resize(std::size_t);
+
+        // Pointer to the plane holding entry (row, col) of every matrix,
+        // which is also the plane of entry (col, row).
+        double* plane(std::size_t, std::size_t);
+        const double* plane(std::size_t, std::size_t) const;
+
+        SymmetricMatrix get(std::size_t) const;
+        void set(std::size_t, const SymmetricMatrix&);
+    };
+
+    // Batch tensor rotations, output[i] = m * tensors[i] * m^T for
+    // rotate_from and m^T * tensors[i] * m for rotate_to. The rotation is
+    // either a single matrix or frame applied to every tensor, or one
+    // matrix per tensor from a MatrixArray or ReferenceFrameArray, which
+    // must then be the same size as tensors. The output is resized to
+    // match and may be the input.
+    void rotate_from(const Matrix&, const SymmetricMatrixArray&, SymmetricMatrixArray&);
+    void rotate_to(const Matrix&, const SymmetricMatrixArray&, SymmetricMatrixArray&);
+    void rotate_from(const MatrixArray&, const SymmetricMatrixArray&, SymmetricMatrixArray&);
+    void rotate_to(const MatrixArray&, const SymmetricMatrixArray&, SymmetricMatrixArray&);
+
+    template<typename rotation_order, typename rotation_type, typename offset_type>
+    void rotate_from(const ReferenceFrame<rotation_order, rotation_type, offset_type>&,
+                     const SymmetricMatrixArray&, SymmetricMatrixArray&);
+    template<typename rotation_order, typename rotation_type, typename offset_type>
+    void rotate_to(const ReferenceFrame<rotation_order, rotation_type, offset_type>&,
+                   const SymmetricMatrixArray&, SymmetricMatrixArray&);
+    template<typename rotation_order, typename rotation_type>
+    void rotate_from(const ReferenceFrameArray<rotation_order, rotation_type>&,
+                     const SymmetricMatrixArray&, SymmetricMatrixArray&);
+    template<typename rotation_order, typename rotation_type>
+    void rotate_to(const ReferenceFrameArray<rotation_order, rotation_type>&,
+                   const SymmetricMatrixArray&, SymmetricMatrixArray&);
+
+    namespace _symmetric_exec {
+
+        // Similarity transforms of count tensors stored as six planes. The
+        // rotation is nine planes, or nine single values applied to every
+        // tensor when broadcast is set. Results go through a chunk-local
+        // buffer, as in multiply(), so the output may alias the tensors and
+        // the loop vectorizes. Chunks are split across threads for large
+        // batches.
+        template<bool transpose, bool broadcast>
+        void _similarity_planes(const double* const* rotation, const double* const* tensors,
+                                std::size_t count, double* const* output)
+        {
+            constexpr std::size_t chunk_size = 256;
+            const std::size_t chunk_count = (count + chunk_size - 1) / chunk_size;
+
+            _EVSPACE_PARALLEL_FOR_IF(count >= _EVSPACE_PARALLEL_MINIMUM)
+            for (std::size_t chunk_index = 0; chunk_index < chunk_count; chunk_index++) {
+                const std::size_t start = chunk_index * chunk_size;
+                const std::size_t chunk = count - start < chunk_size ? count - start : chunk_size;
+                double result[6][chunk_size];
+
+                for (std::size_t i = 0; i < chunk; i++) {
+                    double r[9], p[6], out[6];
+                    for (std::size_t component = 0; component < 9; component++) {
+                        r[component] = rotation[component][broadcast ? 0 : start + i];
+                    }
+                    for (std::size_t entry = 0; entry < 6; entry++) {
+                        p[entry] = tensors[entry][start + i];
+                    }
+
+                    _similarity<transpose>(r, p, out);
+                    for (std::size_t entry = 0; entry < 6; entry++) {
+                        result[entry][i] = out[entry];
+                    }
+                }
+
+                for (std::size_t entry = 0; entry < 6; entry++) {
+                    for (std::size_t i = 0; i < chunk; i++) {
+                        output[entry][start + i] = result[entry][i];
+                    }
+                }
+            }
+        }
+
+        template<bool transpose>
+        void _rotate(const Matrix& rotation_matrix, const SymmetricMatrixArray& tensors, SymmetricMatrixArray& output) {
+            output.resize(tensors.size());
+            const double* data = rotation_matrix.data().data();
+            const double* rotation[9];
+            const double* tensor_planes[6];
+            double* output_planes[6];
+            for (std::size_t component = 0; component < 9; component++) {
+                rotation[component] = data + component;
+            }
+            for (std::size_t row = 0, entry = 0; row < 3; row++) {
+                for (std::size_t col = row; col < 3; col++, entry++) {
+                    tensor_planes[entry] = tensors.plane(row, col);
+                    output_planes[entry] = output.plane(row, col);
+                }
+            }
+
+            _similarity_planes<transpose, true>(rotation, tensor_planes, tensors.size(), output_planes);
+        }
+
+        template<bool transpose>
+        void _rotate(const MatrixArray& rotation_matrices, const SymmetricMatrixArray& tensors,
+                     SymmetricMatrixArray& output)
+        {
+            if (rotation_matrices.size() != tensors.size()) {
+                throw std::out_of_range("MatrixArray and SymmetricMatrixArray must be the same size");
+            }
+
+            output.resize(tensors.size());
+            const double* rotation[9];
+            const double* tensor_planes[6];
+            double* output_planes[6];
+            for (std::size_t component = 0; component < 9; component++) {
+                rotation[component] = rotation_matrices.plane(component / 3, component % 3);
+            }
+            for (std::size_t row = 0, entry = 0; row < 3; row++) {
+                for (std::size_t col = row; col < 3; col++, entry++) {
+                    tensor_planes[entry] = tensors.plane(row, col);
+                    output_planes[entry] = output.plane(row, col);
+                }
+            }
+
+            _similarity_planes<transpose, false>(rotation, tensor_planes, tensors.size(), output_planes);
+        }
+
+    }
+
+    /**
+     * SymmetricMatrixArray implementations.
+     */
+
+    inline SymmetricMatrixArray::SymmetricMatrixArray() noexcept : m_size(0), m_capacity(0), m_data() { }
+
+    inline SymmetricMatrixArray::SymmetricMatrixArray(std::size_t size)
+        : m_size(size), m_capacity(size), m_data(6 * size, 0.0) { }
+
+    inline SymmetricMatrixArray::SymmetricMatrixArray(span_t<const SymmetricMatrix> matrices)
+        : m_size(matrices.size()), m_capacity(matrices.size()), m_data(6 * matrices.size())
+    {
+        for (std::size_t i = 0; i < this->m_size; i++) {
+            const double* data = matrices[i].data().data();
+            for (std::size_t entry = 0; entry < 6; entry++) {
+                this->m_data[entry * this->m_size + i] = data[entry];
+            }
+        }
+    }
+
+    inline std::size_t SymmetricMatrixArray::size() const noexcept {
+        return this->m_size;
+    }
+
+    inline std::size_t SymmetricMatrixArray::capacity() const noexcept {
+        return this->m_capacity;
+    }
+
+    inline void SymmetricMatrixArray::reserve(std::size_t capacity) {
+        if (capacity <= this->m_capacity) {
+            return;
+        }
+
+        std::vector<double> data(6 * capacity, 0.0);
+        for (std::size_t entry = 0; entry < 6; entry++) {
+            for (std::size_t i = 0; i < this->m_size; i++) {
+                data[entry * capacity + i] = this->m_data[entry * this->m_capacity + i];
+            }
+        }
+
+        this->m_data = std::move(data);
+        this->m_capacity = capacity;
+    }
+
+    inline void SymmetricMatrixArray::resize(std::size_t size) {
+        if (size > this->m_capacity) {
+            // geometric growth, so growing one element at a time is
+            // amortized constant
+            this->reserve(size > 2 * this->m_capacity ? size : 2 * this->m_capacity);
+        }
+
+        // slots past the old size may hold values from before a shrink
+        for (std::size_t entry = 0; entry < 6; entry++) {
+            for (std::size_t i = this->m_size; i < size; i++) {
+                this->m_data[entry * this->m_capacity + i] = 0.0;
+            }
+        }
+        this->m_size = size;
+    }
+
+    inline double* SymmetricMatrixArray::plane(std::size_t row, std::size_t col) {
+        if (row > 2 || col > 2) {
+            throw std::out_of_range("SymmetricMatrixArray plane index out of range");
+        }
+
+        return this->m_data.data() + _symmetric_exec::_INDEX[row][col] * this->m_capacity;
+    }
+
+    inline const double* SymmetricMatrixArray::plane(std::size_t row, std::size_t col) const {
+        if (row > 2 || col > 2) {
+            throw std::out_of_range("SymmetricMatrixArray plane index out of range");
+        }
+
+        return this->m_data.data() + _symmetric_exec::_INDEX[row][col] * this->m_capacity;
+    }
+
+    inline SymmetricMatrix SymmetricMatrixArray::get(std::size_t index) const {
+        if (index >= this->m_size) {
+            throw std::out_of_range("SymmetricMatrixArray index out of range");
+        }
+
+        SymmetricMatrix result;
+        double* data = result.data().data();
+        for (std::size_t entry = 0; entry < 6; entry++) {
+            data[entry] = this->m_data[entry * this->m_capacity + index];
+        }
+
+        return result;
+    }
+
+    inline void SymmetricMatrixArray::set(std::size_t index, const SymmetricMatrix& matrix) {
+        if (index >= this->m_size) {
+            throw std::out_of_range("SymmetricMatrixArray index out of range");
+        }
+
+        const double* data = matrix.data().data();
+        for (std::size_t entry = 0; entry < 6; entry++) {
+            this->m_data[entry * this->m_capacity + index] = data[entry];
+        }
+    }
+
+    /**
+     * Batch tensor rotations.
+     */
+
+    inline void rotate_from(const Matrix& rotation_matrix, const SymmetricMatrixArray& tensors,
+                            SymmetricMatrixArray& output)
+    {
+        _symmetric_exec::_rotate<false>(rotation_matrix, tensors, output);
+    }
+
+    inline void rotate_to(const Matrix& rotation_matrix, const SymmetricMatrixArray& tensors,
+                          SymmetricMatrixArray& output)
+    {
+        _symmetric_exec::_rotate<true>(rotation_matrix, tensors, output);
+    }
+
+    inline void rotate_from(const MatrixArray& rotation_matrices, const SymmetricMatrixArray& tensors,
+                            SymmetricMatrixArray& output)
+    {
+        _symmetric_exec::_rotate<false>(rotation_matrices, tensors, output);
+    }
+
+    inline void rotate_to(const MatrixArray& rotation_matrices, const SymmetricMatrixArray& tensors,
+                          SymmetricMatrixArray& output)
+    {
+        _symmetric_exec::_rotate<true>(rotation_matrices, tensors, output);
+    }
+
+    template<typename rotation_order, typename rotation_type, typename offset_type>
+    void rotate_from(const ReferenceFrame<rotation_order, rotation_type, offset_type>& frame,
+                     const SymmetricMatrixArray& tensors, SymmetricMatrixArray& output)
+    {
+        _symmetric_exec::_rotate<false>(frame.get_matrix(), tensors, output);
+    }
+
+    template<typename rotation_order, typename rotation_type, typename offset_type>
+    void rotate_to(const ReferenceFrame<rotation_order, rotation_type, offset_type>& frame,
+                   const SymmetricMatrixArray& tensors, SymmetricMatrixArray& output)
+    {
+        _symmetric_exec::_rotate<true>(frame.get_matrix(), tensors, output);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    void rotate_from(const ReferenceFrameArray<rotation_order, rotation_type>& frames,
+                     const SymmetricMatrixArray& tensors, SymmetricMatrixArray& output)
+    {
+        _symmetric_exec::_rotate<false>(frames.matrices(), tensors, output);
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    void rotate_to(const ReferenceFrameArray<rotation_order, rotation_type>& frames,
+                   const SymmetricMatrixArray& tensors, SymmetricMatrixArray& output)
+    {
+        _symmetric_exec::_rotate<true>(frames.matrices(), tensors, output);
+    }
+
+}   // namespace evspace
+
+#endif // _EVSPACE_SYMMETRIC_MATRIX_ARRAY_H_
@@ -281,13 +281,8 @@ namespace evspace {
 
     inline Vector Vector::operator*(const Matrix& matrix) const {
         Vector result;
-        for (int i = 0; i < 3; i++) {
-            double sum = 0;
-            for(int j = 0; j < 3; j++) {
-                sum = std::fma(this->m_data[j], matrix.m_data[j * 3 + i], sum);
-            }
-            result[i] = sum;
-        }
+        _matrix_exec::_vector_multiply(this->m_data, matrix.m_data, result.m_data);
+
         return result;
     }
 
@@ -300,15 +295,7 @@ namespace evspace {
     }
 
     inline Vector& Vector::operator*=(const Matrix& matrix) {
-        double buffer[3]{this->m_data[0], this->m_data[1], this->m_data[2]};
-        
-        for (int i = 0; i < 3; i++) {
-            double sum = 0;
-            for (int j = 0; j < 3; j++) {
-                sum = std::fma(buffer[j], matrix.m_data[j * 3 + i], sum);
-            }
-            this->m_data[i] = sum;
-        }
+        _matrix_exec::_vector_multiply(this->m_data, matrix.m_data, this->m_data);
 
         return *this;
     }
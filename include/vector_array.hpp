@@ -0,0 +1,151 @@
+#ifndef _EVSPACE_VECTOR_ARRAY_H_
+#define _EVSPACE_VECTOR_ARRAY_H_
+
+#include <cstddef>      // std::size_t
+#include <stdexcept>    // std::out_of_range
+#include <vector>       // std::vector
+#include <evspace_common.hpp>
+#include <vector.hpp>
+
+namespace evspace {
+
+    // Collection of three dimensional vectors stored as a structure of
+    // arrays. Each component lives in its own contiguous plane so batch
+    // kernels can stream through the x, y and z values independently,
+    // and no per-vector heap allocation is made.
+    class VectorArray {
+    private:
+        std::size_t m_size;
+        std::size_t m_capacity;
+        // x plane, followed by the y plane, followed by the z plane, each
+        // m_capacity long
+        std::vector<double> m_data;
+
+    public:
+        VectorArray() noexcept;
+        explicit VectorArray(std::size_t);
+        VectorArray(span_t<const Vector>);
+
+        std::size_t size() const noexcept;
+        std::size_t capacity() const noexcept;
+        // Grows the planes to hold at least capacity vectors without
+        // changing the size, so later growth up to it doesn't reallocate.
+        void reserve(std::size_t);
+        // Resizes the array, preserving the existing vectors which fit
+        // in the new size. New vectors are initialized to zero.
+        void resize(std::size_t);
+
+        double* x() noexcept;
+        double* y() noexcept;
+        double* z() noexcept;
+        const double* x() const noexcept;
+        const double* y() const noexcept;
+        const double* z() const noexcept;
+
+        // Copies the vector at index into a new Vector.
+        Vector get(std::size_t) const;
+        void set(std::size_t, const Vector&);
+    };
+
+    inline VectorArray::VectorArray() noexcept : m_size(0), m_capacity(0), m_data() { }
+
+    inline VectorArray::VectorArray(std::size_t size)
+        : m_size(size), m_capacity(size), m_data(3 * size, 0.0) { }
+
+    inline VectorArray::VectorArray(span_t<const Vector> vectors)
+        : m_size(vectors.size()), m_capacity(vectors.size()), m_data(3 * vectors.size())
+    {
+        for (std::size_t i = 0; i < this->m_size; i++) {
+            const double* data = vectors[i].data().data();
+            this->m_data[i] = data[0];
+            this->m_data[this->m_size + i] = data[1];
+            this->m_data[2 * this->m_size + i] = data[2];
+        }
+    }
+
+    inline std::size_t VectorArray::size() const noexcept {
+        return this->m_size;
+    }
+
+    inline std::size_t VectorArray::capacity() const noexcept {
+        return this->m_capacity;
+    }
+
+    inline void VectorArray::reserve(std::size_t capacity) {
+        if (capacity <= this->m_capacity) {
+            return;
+        }
+
+        std::vector<double> data(3 * capacity, 0.0);
+        for (std::size_t plane = 0; plane < 3; plane++) {
+            for (std::size_t i = 0; i < this->m_size; i++) {
+                data[plane * capacity + i] = this->m_data[plane * this->m_capacity + i];
+            }
+        }
+
+        this->m_data = std::move(data);
+        this->m_capacity = capacity;
+    }
+
+    inline void VectorArray::resize(std::size_t size) {
+        if (size > this->m_capacity) {
+            // geometric growth, so growing one element at a time is
+            // amortized constant
+            this->reserve(size > 2 * this->m_capacity ? size : 2 * this->m_capacity);
+        }
+
+        // slots past the old size may hold values from before a shrink
+        for (std::size_t plane = 0; plane < 3; plane++) {
+            for (std::size_t i = this->m_size; i < size; i++) {
+                this->m_data[plane * this->m_capacity + i] = 0.0;
+            }
+        }
+        this->m_size = size;
+    }
+
+    inline double* VectorArray::x() noexcept {
+        return this->m_data.data();
+    }
+
+    inline double* VectorArray::y() noexcept {
+        return this->m_data.data() + this->m_capacity;
+    }
+
+    inline double* VectorArray::z() noexcept {
+        return this->m_data.data() + 2 * this->m_capacity;
+    }
+
+    inline const double* VectorArray::x() const noexcept {
+        return this->m_data.data();
+    }
+
+    inline const double* VectorArray::y() const noexcept {
+        return this->m_data.data() + this->m_capacity;
+    }
+
+    inline const double* VectorArray::z() const noexcept {
+        return this->m_data.data() + 2 * this->m_capacity;
+    }
+
+    inline Vector VectorArray::get(std::size_t index) const {
+        if (index >= this->m_size) {
+            throw std::out_of_range("VectorArray index out of range");
+        }
+
+        return Vector(this->x()[index], this->y()[index], this->z()[index]);
+    }
+
+    inline void VectorArray::set(std::size_t index, const Vector& vector) {
+        if (index >= this->m_size) {
+            throw std::out_of_range("VectorArray index out of range");
+        }
+
+        const double* data = vector.data().data();
+        this->x()[index] = data[0];
+        this->y()[index] = data[1];
+        this->z()[index] = data[2];
+    }
+
+}   // namespace evspace
+
+#endif // _EVSPACE_VECTOR_ARRAY_H_
@@ -0,0 +1,113 @@
+/**
+* Test files are built using cmake precompiled headers which are made
+* visible to this file when building tests and are not explicitly
+* included.
+*
+*/
+
+#include <angles.hpp>
+#include <vector.hpp>
+#include <matrix.hpp>
+#include <matrix_array.hpp>
+#include <rotation.hpp>
+#include <angle_sweep.hpp>
+#include <gtest/gtest.h>
+#include <helpers.hpp>
+
+namespace evs = evspace;
+
+TEST(AngleSweepUnitTest, TestSingleAxisSweep) {
+    const double start = -1.3, step = 0.0173;
+    const evs::Vector vector = evs::Vector(1, 2, 3);
+    evs::SingleAxisSweep<evs::YAxis> sweep(start, step);
+
+    for (std::size_t k = 0; k < 2000; k++, sweep.next()) {
+        const double angle = start + k * step;
+        ASSERT_EQ(sweep.index(), k) << "sweep index error";
+        EXPECT_DOUBLE_EQ(sweep.angle(), angle) << "sweep angle error";
+        EXPECT_NEAR(sweep.cosine(), std::cos(angle), 1e-14) << "sweep cosine error at " << k;
+        EXPECT_NEAR(sweep.sine(), std::sin(angle), 1e-14) << "sweep sine error at " << k;
+        if (k % 97 == 0) {
+            evs::Matrix answer = evs::compute_rotation_matrix<evs::YAxis>(angle);
+            EXPECT_TRUE(sweep.matrix().compare_to(answer, 0.0, 1e-14)) << "sweep matrix error at " << k;
+            _COMPARE_VECTOR_NEAR(sweep.rotate_from(vector), evs::rotate_from<evs::YAxis>(angle, vector),
+                "sweep rotate from error");
+            _COMPARE_VECTOR_NEAR(sweep.rotate_to(vector), evs::rotate_to<evs::YAxis>(angle, vector),
+                "sweep rotate to error");
+        }
+    }
+
+    sweep.seek(10);
+    EXPECT_EQ(sweep.index(), 10) << "sweep seek index error";
+    EXPECT_NEAR(sweep.sine(), std::sin(start + 10 * step), 1e-15) << "sweep seek error";
+}
+
+TEST(AngleSweepUnitTest, TestSweepWithoutResync) {
+    // renormalization alone keeps the pair on the unit circle over a long
+    // sweep, the phase error grows slowly with the number of steps
+    const double start = 0.25, step = 1e-3;
+    evs::SingleAxisSweep<evs::ZAxis> sweep(start, step, 0);
+    for (std::size_t k = 0; k < 100000; k++) {
+        sweep.next();
+    }
+
+    const double angle = start + 100000 * step;
+    EXPECT_NEAR(sweep.cosine() * sweep.cosine() + sweep.sine() * sweep.sine(), 1.0, 1e-15)
+        << "unresynced sweep left the unit circle";
+    EXPECT_NEAR(sweep.cosine(), std::cos(angle), 1e-10) << "unresynced sweep cosine error";
+    EXPECT_NEAR(sweep.sine(), std::sin(angle), 1e-10) << "unresynced sweep sine error";
+}
+
+template<typename order, typename type>
+void check_euler_sweep(std::size_t angle_index) {
+    const evs::EulerAngles start = evs::EulerAngles(0.4, -1.1, 2.7);
+    const double step = -0.011;
+    const evs::Vector vector = evs::Vector(1, -2, 3);
+    evs::EulerAngleSweep<order, type> sweep(start, angle_index, step, 50);
+
+    for (std::size_t k = 0; k < 500; k++, sweep.next()) {
+        evs::EulerAngles angles = start;
+        angles[angle_index] += k * step;
+        EXPECT_DOUBLE_EQ(sweep.angles()[angle_index], angles[angle_index]) << "euler sweep angles error";
+        if (k % 37 == 0) {
+            evs::Matrix answer = evs::compute_rotation_matrix<order, type>(angles);
+            EXPECT_TRUE(sweep.matrix().compare_to(answer, 0.0, 1e-14)) << "euler sweep matrix error at " << k;
+            _COMPARE_VECTOR_NEAR(sweep.rotate_from(vector), (evs::rotate_from<order, type>(angles, vector)),
+                "euler sweep rotate from error");
+            _COMPARE_VECTOR_NEAR(sweep.rotate_to(vector), (evs::rotate_to<order, type>(angles, vector)),
+                "euler sweep rotate to error");
+        }
+    }
+}
+
+TEST(AngleSweepUnitTest, TestEulerAngleSweep) {
+    for (std::size_t angle_index = 0; angle_index < 3; angle_index++) {
+        check_euler_sweep<evs::XYZ, evs::IntrinsicRotation>(angle_index);
+        check_euler_sweep<evs::ZXZ, evs::ExtrinsicRotation>(angle_index);
+    }
+
+    EXPECT_THROW((evs::EulerAngleSweep<evs::XYZ>(evs::EulerAngles(), 3, 0.1)), std::out_of_range)
+        << "euler sweep angle index out of range";
+}
+
+TEST(AngleSweepUnitTest, TestGenerate) {
+    const evs::EulerAngles start = evs::EulerAngles(0.1, 0.2, 0.3);
+    evs::EulerAngleSweep<evs::YXZ> sweep(start, 1, 0.05);
+    evs::MatrixArray matrices(100);
+    sweep.generate(matrices);
+    EXPECT_EQ(sweep.index(), 100) << "generate did not advance the sweep";
+
+    for (std::size_t k = 0; k < matrices.size(); k++) {
+        evs::Matrix answer = evs::compute_rotation_matrix<evs::YXZ>(evs::EulerAngles(0.1, 0.2 + k * 0.05, 0.3));
+        EXPECT_TRUE(matrices.get(k).compare_to(answer, 0.0, 1e-14)) << "generate matrix error at " << k;
+    }
+
+    evs::SingleAxisSweep<evs::XAxis> axis_sweep(0.0, EVSPACE_PI_4);
+    evs::MatrixArray axis_matrices(9);
+    axis_sweep.generate(axis_matrices);
+    COMPARE_MATRIX_NEAR(axis_matrices.get(2), create_array({ {1, 0, 0}, {0, 0, -1}, {0, 1, 0} }),
+        "generate quarter turn error", 1e-15);
+    // the start of the sweep is resynced from the exact angle
+    COMPARE_MATRIX(axis_matrices.get(0), create_array({ {1, 0, 0}, {0, 1, 0}, {0, 0, 1} }),
+        "generate start error");
+}
@@ -0,0 +1,261 @@
+/**
+* Test files are built using cmake precompiled headers which are made
+* visible to this file when building tests and are not explicitly
+* included.
+*
+*/
+
+#include <matrix.hpp>
+#include <vector.hpp>
+#include <matrix_array.hpp>
+#include <vector_array.hpp>
+#include <rotation.hpp>
+#include <attitude_determination.hpp>
+#include <cmath>        // std::sin, std::cos
+#include <cstdint>      // std::uint8_t
+#include <stdexcept>    // std::out_of_range, std::invalid_argument
+#include <string>       // std::string, std::to_string
+#include <vector>       // std::vector
+#include <gtest/gtest.h>
+#include <helpers.hpp>
+
+namespace evs = evspace;
+
+namespace {
+
+    const double pi = 3.14159265358979323846;
+
+    // Unit reference directions spread over the sphere.
+    std::vector<evs::Vector> create_references(std::size_t count, double seed) {
+        std::vector<evs::Vector> references;
+        for (std::size_t i = 0; i < count; i++) {
+            const double t = seed + 1.7 * static_cast<double>(i);
+            references.push_back(evs::Vector(std::cos(t) * std::cos(0.6 * t), std::sin(t) * std::cos(0.6 * t),
+                                             std::sin(0.6 * t)).norm());
+        }
+
+        return references;
+    }
+
+    // The observations of references from a body frame with the attitude,
+    // perturbed by noise.
+    std::vector<evs::Vector> create_observations(const evs::Matrix& attitude,
+                                                 const std::vector<evs::Vector>& references, double noise)
+    {
+        std::vector<evs::Vector> observations;
+        for (std::size_t i = 0; i < references.size(); i++) {
+            const double t = static_cast<double>(i);
+            const evs::Vector error(std::sin(3.1 * t), std::cos(2.3 * t), std::sin(1.3 * t + 0.5));
+            observations.push_back((evs::rotate_to(attitude, references[i]) + error * noise).norm());
+        }
+
+        return observations;
+    }
+
+    // Wahba's loss, sum(weight * |reference - attitude * observation|^2).
+    double wahba_loss(const evs::Matrix& attitude, const std::vector<evs::Vector>& observations,
+                      const std::vector<evs::Vector>& references, const std::vector<double>& weights)
+    {
+        double loss = 0.0;
+        for (std::size_t i = 0; i < observations.size(); i++) {
+            loss += weights[i] * (references[i] - evs::rotate_from(attitude, observations[i])).magnitude_squared();
+        }
+
+        return loss;
+    }
+
+    void check_rotation(const evs::Matrix& attitude, const std::string& msg) {
+        EXPECT_TRUE((attitude.transpose() * attitude).compare_to(evs::Matrix::IDENTITY, 0.0, 1e-14)) << msg;
+        EXPECT_NEAR(attitude.determinate(), 1.0, 1e-14) << msg;
+    }
+
+    std::vector<evs::Matrix> create_attitudes() {
+        std::vector<evs::Matrix> attitudes;
+        attitudes.push_back(evs::Matrix::IDENTITY);
+        attitudes.push_back(evs::compute_rotation_matrix<evs::ZYX>(evs::EulerAngles(0.4, -0.9, 2.1)));
+        attitudes.push_back(evs::compute_rotation_matrix<evs::XYZ>(evs::EulerAngles(-2.5, 0.3, 1.2)));
+        // half turns, where the classic QUEST Rodrigues parameters blow up
+        attitudes.push_back(evs::compute_rotation_matrix<evs::XYZ>(evs::EulerAngles(pi, 0.0, 0.0)));
+        attitudes.push_back(evs::compute_rotation_matrix<evs::ZXZ>(evs::EulerAngles(0.7, pi, -0.7)));
+
+        return attitudes;
+    }
+
+}
+
+TEST(AttitudeDeterminationUnitTest, TestAttitudeProfile) {
+    const std::vector<evs::Vector> references = create_references(4, 0.2);
+    const std::vector<evs::Vector> observations = create_references(4, 1.1);
+    const std::vector<double> weights = { 1.0, 0.5, 2.0, 0.25 };
+
+    evs::Matrix expected;
+    for (std::size_t i = 0; i < references.size(); i++) {
+        for (std::size_t row = 0; row < 3; row++) {
+            for (std::size_t col = 0; col < 3; col++) {
+                expected(row, col) += weights[i] * references[i][row] * observations[i][col];
+            }
+        }
+    }
+    EXPECT_TRUE(evs::attitude_profile(observations, references, weights).compare_to(expected, 0.0, 1e-15));
+
+    const std::vector<double> short_weights = { 1.0, 0.5 };
+    EXPECT_THROW(evs::attitude_profile(observations, references, short_weights), std::out_of_range);
+    EXPECT_THROW(evs::quest(observations, references, short_weights), std::out_of_range);
+}
+
+TEST(AttitudeDeterminationUnitTest, TestTriad) {
+    const std::vector<evs::Matrix> attitudes = create_attitudes();
+    const std::vector<evs::Vector> references = create_references(2, 0.5);
+    for (std::size_t n = 0; n < attitudes.size(); n++) {
+        const std::string msg = "attitude " + std::to_string(n);
+        const std::vector<evs::Vector> observations = create_observations(attitudes[n], references, 0.0);
+        const evs::Matrix attitude = evs::triad(observations[0], observations[1], references[0], references[1]);
+        check_rotation(attitude, msg);
+        EXPECT_TRUE(attitude.compare_to(attitudes[n], 0.0, 1e-14)) << msg;
+    }
+
+    // the first pair is matched exactly even with a noisy second one
+    const std::vector<evs::Vector> observations = create_observations(attitudes[1], references, 1e-3);
+    const evs::Matrix attitude = evs::triad(observations[0] * 3.0, observations[1], references[0], references[1]);
+    const evs::Vector observed = evs::rotate_to(attitude, references[0]);
+    const evs::Vector first = observations[0];
+    COMPARE_VECTOR_NEAR(observed, first, "primary pair", 1e-15);
+
+    const evs::EulerAngles angles = evs::triad<evs::ZYX>(observations[0], observations[1], references[0],
+                                                         references[1]);
+    const evs::EulerAngles expected = evs::compute_euler_angles<evs::ZYX>(attitude);
+    EXPECT_DOUBLE_EQ(angles[0], expected[0]);
+    EXPECT_DOUBLE_EQ(angles[1], expected[1]);
+    EXPECT_DOUBLE_EQ(angles[2], expected[2]);
+
+    EXPECT_THROW(evs::triad(observations[0], observations[0] * 2.0, references[0], references[1]),
+                 std::invalid_argument);
+    EXPECT_THROW(evs::triad(observations[0], observations[1], evs::Vector(), references[1]),
+                 std::invalid_argument);
+}
+
+TEST(AttitudeDeterminationUnitTest, TestQuestKabsch) {
+    const std::vector<evs::Matrix> attitudes = create_attitudes();
+    const std::vector<evs::Vector> references = create_references(7, 0.3);
+    const std::vector<double> weights = { 1.0, 2.0, 0.5, 1.5, 1.0, 0.1, 3.0 };
+    for (std::size_t n = 0; n < attitudes.size(); n++) {
+        // noise free observations give back the attitude exactly
+        std::string msg = "exact attitude " + std::to_string(n);
+        std::vector<evs::Vector> observations = create_observations(attitudes[n], references, 0.0);
+        evs::Matrix quest = evs::quest(observations, references, weights);
+        evs::Matrix kabsch = evs::kabsch(observations, references, weights);
+        check_rotation(quest, msg);
+        check_rotation(kabsch, msg);
+        EXPECT_TRUE(quest.compare_to(attitudes[n], 0.0, 1e-14)) << msg;
+        EXPECT_TRUE(kabsch.compare_to(attitudes[n], 0.0, 1e-14)) << msg;
+
+        // noisy ones agree on the optimum, which beats the true attitude
+        msg = "noisy attitude " + std::to_string(n);
+        observations = create_observations(attitudes[n], references, 1e-2);
+        quest = evs::quest(observations, references, weights);
+        kabsch = evs::kabsch(observations, references, weights);
+        check_rotation(quest, msg);
+        EXPECT_TRUE(quest.compare_to(kabsch, 0.0, 1e-13)) << msg;
+        EXPECT_TRUE(quest.compare_to(attitudes[n], 0.0, 1e-1)) << msg;
+        EXPECT_LE(wahba_loss(quest, observations, references, weights),
+                  wahba_loss(attitudes[n], observations, references, weights)) << msg;
+
+        const evs::Matrix profile = evs::attitude_profile(observations, references, weights);
+        EXPECT_TRUE(evs::quest(profile).compare_to(quest, 0.0, 0.0)) << msg;
+        EXPECT_TRUE(evs::kabsch(profile).compare_to(kabsch, 0.0, 0.0)) << msg;
+    }
+
+    // two pairs are enough, and match TRIAD when they are consistent
+    const std::vector<evs::Vector> pair_references(references.begin(), references.begin() + 2);
+    const std::vector<evs::Vector> pair_observations = create_observations(attitudes[2], pair_references, 0.0);
+    const std::vector<double> pair_weights = { 1.0, 1.0 };
+    EXPECT_TRUE(evs::quest(pair_observations, pair_references, pair_weights).compare_to(attitudes[2], 0.0, 1e-14));
+
+    // nothing observed falls back to the identity
+    EXPECT_TRUE(evs::quest(evs::Matrix()).compare_to(evs::Matrix::IDENTITY, 0.0, 0.0));
+
+    const std::vector<evs::Vector> observations = create_observations(attitudes[1], references, 1e-2);
+    const evs::EulerAngles angles = evs::quest<evs::XZX, evs::ExtrinsicRotation>(observations, references, weights);
+    const evs::EulerAngles expected = evs::compute_euler_angles<evs::XZX, evs::ExtrinsicRotation>(
+        evs::quest(observations, references, weights));
+    EXPECT_DOUBLE_EQ(angles[0], expected[0]);
+    EXPECT_DOUBLE_EQ(angles[1], expected[1]);
+    EXPECT_DOUBLE_EQ(angles[2], expected[2]);
+    const evs::EulerAngles kabsch_angles = evs::kabsch<evs::ZYX>(observations, references, weights);
+    EXPECT_NEAR(kabsch_angles[0], evs::compute_euler_angles<evs::ZYX>(attitudes[1])[0], 1e-1);
+}
+
+TEST(AttitudeDeterminationUnitTest, TestBatch) {
+    // problems of differing sizes, including an empty one
+    const std::size_t count = 37;
+    const std::vector<evs::Matrix> attitudes = create_attitudes();
+    std::vector<evs::Vector> observations, references;
+    std::vector<evs::Vector> first_observations, second_observations, first_references, second_references;
+    std::vector<double> weights;
+    std::vector<std::size_t> offsets = { 0 };
+    for (std::size_t i = 0; i < count; i++) {
+        const std::size_t pairs = i == 5 ? 0 : 2 + i % 4;
+        const std::vector<evs::Vector> problem_references = create_references(pairs, 0.1 * static_cast<double>(i));
+        const std::vector<evs::Vector> problem_observations = create_observations(
+            attitudes[i % attitudes.size()], problem_references, 1e-3);
+        for (std::size_t pair = 0; pair < pairs; pair++) {
+            observations.push_back(problem_observations[pair]);
+            references.push_back(problem_references[pair]);
+            weights.push_back(1.0 + 0.1 * static_cast<double>(pair));
+        }
+        offsets.push_back(observations.size());
+
+        first_observations.push_back(pairs > 0 ? problem_observations[0] : evs::Vector());
+        second_observations.push_back(pairs > 0 ? problem_observations[1] : evs::Vector());
+        first_references.push_back(pairs > 0 ? problem_references[0] : evs::Vector());
+        second_references.push_back(pairs > 0 ? problem_references[1] : evs::Vector());
+    }
+
+    evs::MatrixArray profiles, quest, kabsch, triad;
+    evs::attitude_profile(evs::VectorArray(observations), evs::VectorArray(references), weights, offsets, profiles);
+    evs::quest(profiles, quest);
+    evs::kabsch(profiles, kabsch);
+    std::vector<std::uint8_t> status(count);
+    const std::size_t flagged = evs::triad(evs::VectorArray(first_observations), evs::VectorArray(second_observations),
+                                           evs::VectorArray(first_references), evs::VectorArray(second_references),
+                                           triad, status);
+    ASSERT_EQ(profiles.size(), count);
+    ASSERT_EQ(quest.size(), count);
+    ASSERT_EQ(kabsch.size(), count);
+    ASSERT_EQ(triad.size(), count);
+    EXPECT_EQ(flagged, 1u);
+
+    for (std::size_t i = 0; i < count; i++) {
+        const std::string msg = "batch element " + std::to_string(i);
+        const std::vector<evs::Vector> problem_observations(observations.begin() + offsets[i],
+                                                            observations.begin() + offsets[i + 1]);
+        const std::vector<evs::Vector> problem_references(references.begin() + offsets[i],
+                                                          references.begin() + offsets[i + 1]);
+        const std::vector<double> problem_weights(weights.begin() + offsets[i], weights.begin() + offsets[i + 1]);
+
+        EXPECT_TRUE(profiles.get(i).compare_to(
+            evs::attitude_profile(problem_observations, problem_references, problem_weights), 0.0, 1e-15)) << msg;
+        EXPECT_TRUE(quest.get(i).compare_to(evs::quest(profiles.get(i)), 0.0, 1e-14)) << msg;
+        EXPECT_TRUE(kabsch.get(i).compare_to(evs::kabsch(profiles.get(i)), 0.0, 1e-14)) << msg;
+        if (i == 5) {
+            EXPECT_EQ(status[i], evs::MATRIX_SINGULAR) << msg;
+            EXPECT_TRUE(triad.get(i).compare_to(evs::Matrix(), 0.0, 0.0)) << msg;
+            EXPECT_TRUE(quest.get(i).compare_to(evs::Matrix::IDENTITY, 0.0, 0.0)) << msg;
+        }
+        else {
+            EXPECT_EQ(status[i], evs::MATRIX_OK) << msg;
+            EXPECT_TRUE(triad.get(i).compare_to(evs::triad(first_observations[i], second_observations[i],
+                                                           first_references[i], second_references[i]), 0.0, 1e-14))
+                << msg;
+            EXPECT_TRUE(quest.get(i).compare_to(attitudes[i % attitudes.size()], 0.0, 1e-2)) << msg;
+        }
+    }
+
+    offsets.back() = observations.size() + 1;
+    EXPECT_THROW(evs::attitude_profile(evs::VectorArray(observations), evs::VectorArray(references), weights,
+                                       offsets, profiles), std::out_of_range);
+    std::vector<std::uint8_t> short_status(count - 1);
+    EXPECT_THROW(evs::triad(evs::VectorArray(first_observations), evs::VectorArray(second_observations),
+                            evs::VectorArray(first_references), evs::VectorArray(second_references),
+                            triad, short_status), std::out_of_range);
+}
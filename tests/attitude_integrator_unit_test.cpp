@@ -0,0 +1,155 @@
+/**
+* Test files are built using cmake precompiled headers which are made
+* visible to this file when building tests and are not explicitly
+* included.
+*
+*/
+
+#include <angles.hpp>
+#include <matrix.hpp>
+#include <vector.hpp>
+#include <vector_array.hpp>
+#include <quaternion.hpp>
+#include <quaternion_array.hpp>
+#include <reference_frame_array.hpp>
+#include <rotation.hpp>
+#include <attitude_integrator.hpp>
+#include <cmath>        // std::sin, std::cos, std::fabs
+#include <stdexcept>    // std::out_of_range
+#include <string>       // std::string, std::to_string
+#include <vector>       // std::vector
+#include <gtest/gtest.h>
+#include <helpers.hpp>
+
+namespace evs = evspace;
+
+namespace {
+
+    // q and -q are the same rotation, compare with the sign of expected.
+    void expect_quaternion_near(const evs::Quaternion& actual, const evs::Quaternion& expected, double tolerance,
+                                const std::string& msg)
+    {
+        const double dot = actual[0] * expected[0] + actual[1] * expected[1] + actual[2] * expected[2]
+            + actual[3] * expected[3];
+        const double sign = dot < 0.0 ? -1.0 : 1.0;
+        for (std::size_t k = 0; k < 4; k++) {
+            EXPECT_NEAR(sign * actual[k], expected[k], tolerance) << msg << " component " << k;
+        }
+    }
+
+    // Attitudes and body rates of count bodies, a few with zero rate.
+    void make_bodies(std::size_t count, std::vector<evs::Quaternion>& attitudes, std::vector<evs::Vector>& rates) {
+        for (std::size_t i = 0; i < count; i++) {
+            const double t = static_cast<double>(i);
+            evs::Quaternion attitude(1.0, 0.3 * std::sin(t), -0.2, 0.4 * std::cos(0.3 * t));
+            attitudes.push_back(attitude.normalize());
+            rates.push_back(i % 40 == 3 ? evs::Vector() : evs::Vector(0.8 * std::sin(0.7 * t), -0.5 + 0.002 * t,
+                                                                       1.2 * std::cos(t)));
+        }
+    }
+
+}
+
+TEST(AttitudeIntegratorUnitTest, TestExponential) {
+    // more than one chunk, with a partial last chunk
+    const std::size_t count = 601;
+    std::vector<evs::Quaternion> attitudes;
+    std::vector<evs::Vector> rates;
+    make_bodies(count, attitudes, rates);
+    const evs::VectorArray rate_array(rates);
+
+    // constant rates turn each body about its rate axis, exactly for any
+    // step size
+    const double dt = 0.7;
+    evs::QuaternionArray array(attitudes);
+    evs::integrate_exponential(array, rate_array, dt);
+    for (std::size_t i = 0; i < count; i++) {
+        const double magnitude = rates[i].magnitude();
+        const evs::Quaternion expected = magnitude > 0.0
+            ? attitudes[i] * evs::compute_rotation_quaternion(magnitude * dt, rates[i])
+            : attitudes[i];
+        expect_quaternion_near(array.get(i), expected, 1e-15, "exponential " + std::to_string(i));
+    }
+
+    // so ten steps are one step of ten times the size
+    evs::QuaternionArray stepped(attitudes), single(attitudes);
+    for (int step = 0; step < 10; step++) {
+        evs::integrate_exponential(stepped, rate_array, dt / 10.0);
+    }
+    evs::integrate_exponential(single, rate_array, dt);
+    for (std::size_t i = 0; i < count; i++) {
+        expect_quaternion_near(stepped.get(i), single.get(i), 1e-14, "stepped " + std::to_string(i));
+    }
+
+    EXPECT_THROW(evs::integrate_exponential(array, evs::VectorArray(3), dt), std::out_of_range);
+}
+
+TEST(AttitudeIntegratorUnitTest, TestRK4) {
+    const std::size_t count = 601;
+    std::vector<evs::Quaternion> attitudes;
+    std::vector<evs::Vector> rates;
+    make_bodies(count, attitudes, rates);
+    const evs::VectorArray rate_array(rates);
+
+    // with constant rates RK4 matches the exact step to fourth order,
+    // halving the step cuts the error about sixteen times
+    const double dt = 0.1;
+    evs::QuaternionArray exact(attitudes), coarse(attitudes), fine(attitudes);
+    for (int step = 0; step < 20; step++) {
+        evs::integrate_exponential(exact, rate_array, dt / 2.0);
+        evs::integrate_rk4(fine, rate_array, rate_array, rate_array, dt / 2.0);
+    }
+    for (int step = 0; step < 10; step++) {
+        evs::integrate_rk4(coarse, rate_array, rate_array, rate_array, dt);
+    }
+    double coarse_error = 0.0, fine_error = 0.0;
+    for (std::size_t i = 0; i < count; i++) {
+        const evs::Quaternion expected = exact.get(i), lhs = coarse.get(i), rhs = fine.get(i);
+        EXPECT_NEAR(lhs.norm(), 1.0, 1e-15);
+        for (std::size_t k = 0; k < 4; k++) {
+            coarse_error = std::fmax(coarse_error, std::fabs(lhs[k] - expected[k]));
+            fine_error = std::fmax(fine_error, std::fabs(rhs[k] - expected[k]));
+        }
+    }
+    EXPECT_LT(coarse_error, 1e-6);
+    EXPECT_LT(fine_error * 10.0, coarse_error);
+
+    // rates changing over the step, a body spinning about z with
+    // omega = a * t, whose angle is a * t^2 / 2
+    const double a = 0.9;
+    evs::QuaternionArray spinning(2);
+    evs::VectorArray start(2), middle(2), end(2);
+    for (int step = 0; step < 10; step++) {
+        const double t = step * dt;
+        for (std::size_t i = 0; i < 2; i++) {
+            start.set(i, evs::Vector(0.0, 0.0, a * t));
+            middle.set(i, evs::Vector(0.0, 0.0, a * (t + dt / 2.0)));
+            end.set(i, evs::Vector(0.0, 0.0, a * (t + dt)));
+        }
+        evs::integrate_rk4(spinning, start, middle, end, dt);
+    }
+    const evs::Quaternion expected = evs::compute_rotation_quaternion<evs::ZAxis>(a * 0.5);
+    expect_quaternion_near(spinning.get(1), expected, 1e-8, "spinning");
+
+    EXPECT_THROW(evs::integrate_rk4(spinning, start, evs::VectorArray(3), end, dt), std::out_of_range);
+}
+
+TEST(AttitudeIntegratorUnitTest, TestFrames) {
+    const std::size_t count = 601;
+    std::vector<evs::Quaternion> attitudes;
+    std::vector<evs::Vector> rates;
+    make_bodies(count, attitudes, rates);
+    const evs::QuaternionArray array(attitudes);
+
+    evs::ReferenceFrameArray<evs::ZYX> frames(2);
+    frames.offsets().set(1, evs::Vector(1.0, 2.0, 3.0));
+    evs::to_frames(array, frames);
+    ASSERT_EQ(frames.size(), count);
+    const evs::Vector offset = frames.offsets().get(1);
+    const evs::Vector expected_offset(1.0, 2.0, 3.0);
+    COMPARE_VECTOR_NEAR(offset, expected_offset, "to_frames offset", 0.0);
+    for (std::size_t i = 0; i < count; i++) {
+        const evs::Matrix expected = attitudes[i].to_matrix();
+        EXPECT_TRUE(frames.matrices().get(i).compare_to(expected, 0.0, 1e-14)) << "to_frames " << i;
+    }
+}
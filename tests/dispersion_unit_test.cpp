@@ -0,0 +1,235 @@
+/**
+* Test files are built using cmake precompiled headers which are made
+* visible to this file when building tests and are not explicitly
+* included.
+*
+*/
+
+#include <angles.hpp>
+#include <matrix.hpp>
+#include <vector.hpp>
+#include <vector_array.hpp>
+#include <rotation.hpp>
+#include <symmetric_matrix.hpp>
+#include <random_rotation.hpp>
+#include <dispersion.hpp>
+#include <cmath>        // std::sqrt, std::fabs
+#include <cstddef>      // std::size_t
+#include <stdexcept>    // std::runtime_error
+#include <string>       // std::string, std::to_string
+#include <vector>       // std::vector
+#include <gtest/gtest.h>
+#include <helpers.hpp>
+
+namespace evs = evspace;
+
+namespace {
+
+    // J * p * J^T
+    evs::Matrix propagate(const evs::Matrix& jacobian, const evs::SymmetricMatrix& covariance) {
+        return jacobian * covariance.to_matrix() * jacobian.transpose();
+    }
+
+    // Entries of the sample covariance should be within a few standard
+    // errors of the expected, sqrt((p_ii p_jj + p_ij^2) / n) for Gaussian
+    // samples.
+    void check_covariance(const evs::SymmetricMatrix& sampled, const evs::Matrix& expected, std::size_t samples,
+                          const std::string& msg)
+    {
+        for (std::size_t row = 0; row < 3; row++) {
+            for (std::size_t col = 0; col < 3; col++) {
+                const double error = std::sqrt((expected(row, row) * expected(col, col)
+                                                + expected(row, col) * expected(row, col)) / samples);
+                EXPECT_NEAR(sampled(row, col), expected(row, col), 5.0 * error + 1e-18)
+                    << msg << " at index (" << row << ", " << col << ")";
+            }
+        }
+    }
+
+}
+
+TEST(DispersionUnitTest, TestStatistics) {
+    // a small spread about a large mean, past a chunk with a remainder
+    std::vector<evs::Vector> vectors;
+    for (std::size_t i = 0; i < 601; i++) {
+        const double t = static_cast<double>(i);
+        vectors.push_back(evs::Vector(1e8 + std::sin(t), -2e7 + 0.5 * std::cos(3.0 * t), 0.25 * std::sin(t) + 1e-3 * t));
+    }
+
+    // the reference is taken about the center, where the subtractions are
+    // exact
+    const double center[3] = { 1e8, -2e7, 0.0 };
+    double sum[3] = { 0.0, 0.0, 0.0 };
+    for (const evs::Vector& vector : vectors) {
+        for (std::size_t k = 0; k < 3; k++) {
+            sum[k] += vector[k] - center[k];
+        }
+    }
+    double mean[3];
+    for (std::size_t k = 0; k < 3; k++) {
+        mean[k] = sum[k] / vectors.size();
+    }
+    evs::Matrix expected;
+    for (const evs::Vector& vector : vectors) {
+        for (std::size_t row = 0; row < 3; row++) {
+            for (std::size_t col = 0; col < 3; col++) {
+                expected(row, col) += (vector[row] - center[row] - mean[row]) * (vector[col] - center[col] - mean[col])
+                    / (vectors.size() - 1);
+            }
+        }
+    }
+    for (std::size_t k = 0; k < 3; k++) {
+        mean[k] += center[k];
+    }
+    const evs::Vector expected_mean(mean[0], mean[1], mean[2]);
+
+    evs::DispersionStatistics single, batch, merged, second;
+    for (const evs::Vector& vector : vectors) {
+        single.add(vector);
+    }
+    batch.add(evs::VectorArray(vectors));
+    for (std::size_t i = 0; i < vectors.size(); i++) {
+        (i < 200 ? merged : second).add(vectors[i]);
+    }
+    merged.merge(second);
+
+    const evs::DispersionStatistics* results[3] = { &single, &batch, &merged };
+    const char* names[3] = { "single", "batch", "merged" };
+    for (std::size_t n = 0; n < 3; n++) {
+        EXPECT_EQ(results[n]->count(), vectors.size()) << names[n];
+        const evs::Vector result_mean = results[n]->mean();
+        COMPARE_VECTOR_NEAR(result_mean, expected_mean, names[n], 1e-7);
+        const evs::Matrix covariance = results[n]->covariance().to_matrix();
+        EXPECT_TRUE(covariance.compare_to(expected, 0.0, 1e-8)) << names[n];
+    }
+
+    evs::DispersionStatistics empty, one;
+    one.add(vectors[0]);
+    const evs::Matrix zero;
+    const evs::Matrix empty_covariance = empty.covariance().to_matrix();
+    const evs::Matrix one_covariance = one.covariance().to_matrix();
+    EXPECT_TRUE(empty_covariance.compare_to(zero, 0.0, 0.0)) << "empty";
+    EXPECT_TRUE(one_covariance.compare_to(zero, 0.0, 0.0)) << "one vector";
+    const evs::Vector one_mean = one.mean();
+    COMPARE_VECTOR(one_mean, vectors[0], "one vector");
+    one.merge(empty);
+    EXPECT_EQ(one.count(), 1u);
+}
+
+TEST(DispersionUnitTest, TestExact) {
+    evs::FrameUncertainty from, to;
+    from.angles = evs::EulerAngles(0.4, -1.1, 2.3);
+    from.offset = evs::Vector(1.0, -2.0, 0.5);
+    to.angles = evs::EulerAngles(-0.7, 0.3, 1.9);
+    to.offset = evs::Vector(-3.0, 0.25, 4.0);
+    const evs::Vector vector(2.0, 1.0, -1.5);
+
+    evs::Philox generator(3);
+    const evs::DispersionStatistics result =
+        evs::disperse_between<evs::ZXZ, evs::XYZ>(generator, 1000, from, to, vector);
+    EXPECT_EQ(result.count(), 1000u);
+    EXPECT_EQ(generator.position(), 5000u);
+
+    const evs::Vector mean = result.mean();
+    const evs::Vector expected = evs::rotate_between<evs::ZXZ, evs::XYZ>(from.angles, to.angles, vector, from.offset,
+                                                                         to.offset);
+    COMPARE_VECTOR_NEAR(mean, expected, "exact frames", 1e-13);
+    const evs::Matrix covariance = result.covariance().to_matrix();
+    const evs::Matrix zero;
+    EXPECT_TRUE(covariance.compare_to(zero, 0.0, 1e-24)) << "exact frames";
+
+    const evs::DispersionStatistics empty =
+        evs::disperse_between<evs::ZXZ, evs::XYZ>(generator, 0, from, to, vector);
+    EXPECT_EQ(empty.count(), 0u);
+    EXPECT_EQ(generator.position(), 5000u);
+
+    to.offset_covariance = evs::SymmetricMatrix(0.0, 1.0, 0.0, 0.0, 0.0, 1.0);
+    EXPECT_THROW((evs::disperse_between<evs::ZXZ, evs::XYZ>(generator, 10, from, to, vector)), std::runtime_error);
+}
+
+TEST(DispersionUnitTest, TestLinear) {
+    // offset and vector errors enter linearly, so the output covariance is
+    // exactly their propagated sum
+    evs::FrameUncertainty from, to;
+    from.angles = evs::EulerAngles(0.4, -1.1, 2.3);
+    from.offset = evs::Vector(1.0, -2.0, 0.5);
+    from.offset_covariance = evs::SymmetricMatrix(0.04, 0.01, 0.0, 0.09, -0.02, 0.01);
+    to.angles = evs::EulerAngles(-0.7, 0.3, 1.9);
+    to.offset_covariance = evs::SymmetricMatrix(0.01, 0.0, 0.005, 0.01, 0.0, 0.01);
+    const evs::Vector vector(2.0, 1.0, -1.5);
+    const evs::SymmetricMatrix vector_covariance(0.25, 0.1, 0.05, 0.16, 0.0, 0.04);
+
+    evs::Matrix between, to_rotation;
+    for (std::size_t k = 0; k < 3; k++) {
+        evs::Vector axis;
+        axis[k] = 1.0;
+        const evs::Vector column = evs::rotate_between<evs::ZYX, evs::YZY>(from.angles, to.angles, axis);
+        const evs::Vector to_column = evs::rotate_to<evs::YZY>(to.angles, axis);
+        for (std::size_t row = 0; row < 3; row++) {
+            between(row, k) = column[row];
+            to_rotation(row, k) = to_column[row];
+        }
+    }
+    const evs::Matrix expected = propagate(between, vector_covariance)
+        + propagate(to_rotation, from.offset_covariance) + propagate(to_rotation, to.offset_covariance);
+
+    const std::size_t samples = 40000;
+    evs::Philox generator(11, 2);
+    const evs::DispersionStatistics result =
+        evs::disperse_between<evs::ZYX, evs::YZY>(generator, samples, from, to, vector, vector_covariance);
+    const evs::Vector mean = result.mean();
+    const evs::Vector nominal = evs::rotate_between<evs::ZYX, evs::YZY>(from.angles, to.angles, vector, from.offset,
+                                                                        to.offset);
+    COMPARE_VECTOR_NEAR(mean, nominal, "linear mean", 0.02);
+    check_covariance(result.covariance(), expected, samples, "linear covariance");
+}
+
+TEST(DispersionUnitTest, TestAngles) {
+    // small angle errors propagate through the Jacobian of the rotation
+    // with respect to the angles
+    evs::FrameUncertainty from, to;
+    from.angles = evs::EulerAngles(0.4, 0.9, -0.6);
+    from.angle_covariance = evs::SymmetricMatrix(1e-6, 2e-7, 0.0, 4e-6, -1e-7, 1e-6);
+    to.angles = evs::EulerAngles(1.2, -0.5, 0.8);
+    to.angle_covariance = evs::SymmetricMatrix(2e-6, 0.0, 0.0, 1e-6, 0.0, 3e-6);
+    const evs::Vector vector(10.0, -4.0, 7.0);
+
+    auto rotate = [&](const evs::EulerAngles& angles_from, const evs::EulerAngles& angles_to) {
+        return evs::rotate_between<evs::XYZ, evs::ZXZ, evs::ExtrinsicRotation>(angles_from, angles_to, vector);
+    };
+    const double step = 1e-6;
+    evs::Matrix from_jacobian, to_jacobian;
+    for (std::size_t k = 0; k < 3; k++) {
+        evs::EulerAngles upper = from.angles, lower = from.angles;
+        upper[k] += step;
+        lower[k] -= step;
+        const evs::Vector from_column = (rotate(upper, to.angles) - rotate(lower, to.angles)) / (2.0 * step);
+        upper = to.angles;
+        lower = to.angles;
+        upper[k] += step;
+        lower[k] -= step;
+        const evs::Vector to_column = (rotate(from.angles, upper) - rotate(from.angles, lower)) / (2.0 * step);
+        for (std::size_t row = 0; row < 3; row++) {
+            from_jacobian(row, k) = from_column[row];
+            to_jacobian(row, k) = to_column[row];
+        }
+    }
+    const evs::Matrix expected = propagate(from_jacobian, from.angle_covariance)
+        + propagate(to_jacobian, to.angle_covariance);
+
+    const std::size_t samples = 40000;
+    evs::Philox generator(5);
+    const evs::DispersionStatistics result = evs::disperse_between<evs::XYZ, evs::ZXZ, evs::ExtrinsicRotation>(
+        generator, samples, from, to, vector);
+    check_covariance(result.covariance(), expected, samples, "angle covariance");
+
+    // the same seed reproduces the result exactly
+    evs::Philox replay(5);
+    const evs::DispersionStatistics repeated = evs::disperse_between<evs::XYZ, evs::ZXZ, evs::ExtrinsicRotation>(
+        replay, samples, from, to, vector);
+    const evs::Vector mean = result.mean(), repeated_mean = repeated.mean();
+    const evs::Matrix covariance = result.covariance().to_matrix();
+    const evs::Matrix repeated_covariance = repeated.covariance().to_matrix();
+    COMPARE_VECTOR(repeated_mean, mean, "replay");
+    EXPECT_TRUE(repeated_covariance.compare_to(covariance, 0.0, 0.0)) << "replay";
+}
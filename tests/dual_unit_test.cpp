@@ -0,0 +1,169 @@
+/**
+* Test files are built using cmake precompiled headers which are made
+* visible to this file when building tests and are not explicitly
+* included.
+*
+*/
+
+#include <angles.hpp>
+#include <matrix.hpp>
+#include <vector.hpp>
+#include <rotation.hpp>
+#include <dual.hpp>
+#include <array>        // std::array
+#include <cmath>        // std::sin, std::cos, std::sqrt
+#include <stdexcept>    // std::out_of_range
+#include <string>       // std::string
+#include <gtest/gtest.h>
+#include <helpers.hpp>
+
+namespace evs = evspace;
+
+namespace {
+
+    const double pi = 3.14159265358979323846;
+
+    // Central differences of rotate_to or rotate_from with respect to the
+    // angles and vector, to check the dual Jacobians against.
+    template<typename rotation_order, typename rotation_type, bool to>
+    void finite_difference(const evs::EulerAngles& angles, const evs::Vector& vector, evs::Matrix& angle_jacobian,
+                           evs::Matrix& vector_jacobian)
+    {
+        const double step = 1e-6;
+        auto rotate = [](const evs::EulerAngles& a, const evs::Vector& v) {
+            return to ? evs::rotate_to<rotation_order, rotation_type>(a, v)
+                      : evs::rotate_from<rotation_order, rotation_type>(a, v);
+        };
+
+        for (std::size_t col = 0; col < 3; col++) {
+            evs::EulerAngles plus = angles, minus = angles;
+            plus[col] += step;
+            minus[col] -= step;
+            const evs::Vector angle_slope = (rotate(plus, vector) - rotate(minus, vector)) / (2.0 * step);
+
+            evs::Vector vector_plus = vector, vector_minus = vector;
+            vector_plus[col] += step;
+            vector_minus[col] -= step;
+            const evs::Vector vector_slope = (rotate(angles, vector_plus) - rotate(angles, vector_minus)) / (2.0 * step);
+
+            for (std::size_t row = 0; row < 3; row++) {
+                angle_jacobian(row, col) = angle_slope[row];
+                vector_jacobian(row, col) = vector_slope[row];
+            }
+        }
+    }
+
+    template<typename rotation_order, typename rotation_type>
+    void check_jacobians(const evs::EulerAngles& angles, const evs::Vector& vector, const std::string& msg) {
+        evs::Matrix angle_jacobian, vector_jacobian, expected_angle, expected_vector;
+        const evs::Matrix matrix = evs::compute_rotation_matrix<rotation_order, rotation_type>(angles);
+
+        const evs::Vector to = evs::rotate_to_jacobian<rotation_order, rotation_type>(
+            angles, vector, angle_jacobian, vector_jacobian);
+        const evs::Vector expected_to = evs::rotate_to<rotation_order, rotation_type>(angles, vector);
+        COMPARE_VECTOR_NEAR(to, expected_to, msg + " rotate_to value", 1e-15);
+        finite_difference<rotation_order, rotation_type, true>(angles, vector, expected_angle, expected_vector);
+        EXPECT_TRUE(angle_jacobian.compare_to(expected_angle, 0.0, 1e-9)) << msg << " rotate_to angles";
+        // the result is linear in the vector, its Jacobian is the rotation
+        EXPECT_TRUE(vector_jacobian.compare_to(matrix.transpose(), 0.0, 1e-15)) << msg << " rotate_to vector";
+
+        const evs::Vector from = evs::rotate_from_jacobian<rotation_order, rotation_type>(
+            angles, vector, angle_jacobian, vector_jacobian);
+        const evs::Vector expected_from = evs::rotate_from<rotation_order, rotation_type>(angles, vector);
+        COMPARE_VECTOR_NEAR(from, expected_from, msg + " rotate_from value", 1e-15);
+        finite_difference<rotation_order, rotation_type, false>(angles, vector, expected_angle, expected_vector);
+        EXPECT_TRUE(angle_jacobian.compare_to(expected_angle, 0.0, 1e-9)) << msg << " rotate_from angles";
+        EXPECT_TRUE(vector_jacobian.compare_to(matrix, 0.0, 1e-15)) << msg << " rotate_from vector";
+    }
+
+}
+
+TEST(DualUnitTest, TestArithmetic) {
+    const evs::Dual<2> x(1.5, 0), y(-0.25, 1);
+    EXPECT_DOUBLE_EQ(x.value(), 1.5);
+    EXPECT_DOUBLE_EQ(x.derivative(0), 1.0);
+    EXPECT_DOUBLE_EQ(x.derivative(1), 0.0);
+    EXPECT_THROW(evs::Dual<2>(1.0, 2), std::out_of_range);
+    EXPECT_THROW(x.derivative(2), std::out_of_range);
+
+    // f = x * y + 3 * x - y / x
+    const evs::Dual<2> f = x * y + 3.0 * x - y / x;
+    EXPECT_DOUBLE_EQ(f.value(), 1.5 * -0.25 + 4.5 + 0.25 / 1.5);
+    EXPECT_DOUBLE_EQ(f.derivative(0), -0.25 + 3.0 + -0.25 / (1.5 * 1.5));
+    EXPECT_DOUBLE_EQ(f.derivative(1), 1.5 - 1.0 / 1.5);
+
+    // g = sin(x) * cos(y) + sqrt(x)
+    const evs::Dual<2> g = sin(x) * cos(y) + sqrt(x);
+    EXPECT_DOUBLE_EQ(g.value(), std::sin(1.5) * std::cos(-0.25) + std::sqrt(1.5));
+    EXPECT_DOUBLE_EQ(g.derivative(0), std::cos(1.5) * std::cos(-0.25) + 0.5 / std::sqrt(1.5));
+    EXPECT_DOUBLE_EQ(g.derivative(1), -std::sin(1.5) * std::sin(-0.25));
+
+    // constants carry no derivatives and mix in freely
+    evs::Dual<2> h = 2.0;
+    h *= x;
+    h -= evs::Dual<2>(1.0);
+    h /= 2.0;
+    EXPECT_DOUBLE_EQ(h.value(), 1.0);
+    EXPECT_DOUBLE_EQ(h.derivative(0), 1.0);
+    EXPECT_DOUBLE_EQ(h.derivative(1), 0.0);
+    EXPECT_DOUBLE_EQ((-h).derivative(0), -1.0);
+}
+
+TEST(DualUnitTest, TestRotationValues) {
+    const evs::EulerAngles angles(0.4, -1.1, 2.6);
+    const evs::Vector vector(1.0, -2.0, 0.5);
+    const std::array<evs::Dual<3>, 3> dual_angles = { evs::Dual<3>(0.4, 0), evs::Dual<3>(-1.1, 1),
+                                                      evs::Dual<3>(2.6, 2) };
+    const std::array<evs::Dual<3>, 3> dual_vector = { evs::Dual<3>(1.0), evs::Dual<3>(-2.0), evs::Dual<3>(0.5) };
+
+    const std::array<evs::Dual<3>, 9> matrix = evs::compute_rotation_matrix<evs::ZXZ, evs::ExtrinsicRotation>(dual_angles);
+    const evs::Matrix expected = evs::compute_rotation_matrix<evs::ZXZ, evs::ExtrinsicRotation>(angles);
+    for (std::size_t row = 0; row < 3; row++) {
+        for (std::size_t col = 0; col < 3; col++) {
+            EXPECT_NEAR(matrix[row * 3 + col].value(), expected(row, col), 1e-15);
+        }
+    }
+
+    const std::array<evs::Dual<3>, 3> to = evs::rotate_to<evs::YXZ>(dual_angles, dual_vector);
+    const std::array<evs::Dual<3>, 3> from = evs::rotate_from<evs::YXZ>(dual_angles, dual_vector);
+    const evs::Vector expected_to = evs::rotate_to<evs::YXZ>(angles, vector);
+    const evs::Vector expected_from = evs::rotate_from<evs::YXZ>(angles, vector);
+    for (std::size_t i = 0; i < 3; i++) {
+        EXPECT_NEAR(to[i].value(), expected_to[i], 1e-15);
+        EXPECT_NEAR(from[i].value(), expected_from[i], 1e-15);
+    }
+
+    // single axis rotations differentiate to the perpendicular component
+    const evs::Dual<1> angle(0.7, 0);
+    const std::array<evs::Dual<1>, 3> axis_vector = { evs::Dual<1>(1.0), evs::Dual<1>(2.0), evs::Dual<1>(3.0) };
+    const std::array<evs::Dual<1>, 3> rotated = evs::rotate_from<evs::ZAxis>(angle, axis_vector);
+    const evs::Vector expected_rotated = evs::rotate_from<evs::ZAxis>(0.7, evs::Vector(1.0, 2.0, 3.0));
+    for (std::size_t i = 0; i < 3; i++) {
+        EXPECT_NEAR(rotated[i].value(), expected_rotated[i], 1e-15);
+    }
+    EXPECT_NEAR(rotated[0].derivative(0), -expected_rotated[1], 1e-15);
+    EXPECT_NEAR(rotated[1].derivative(0), expected_rotated[0], 1e-15);
+    EXPECT_DOUBLE_EQ(rotated[2].derivative(0), 0.0);
+    const std::array<evs::Dual<1>, 3> unrotated = evs::rotate_to<evs::ZAxis>(angle, rotated);
+    for (std::size_t i = 0; i < 3; i++) {
+        EXPECT_NEAR(unrotated[i].value(), axis_vector[i].value(), 1e-15);
+        EXPECT_NEAR(unrotated[i].derivative(0), 0.0, 1e-15);
+    }
+
+    // quarter turns keep their exact values
+    const std::array<evs::Dual<1>, 9> quarter = evs::compute_rotation_matrix<evs::XAxis>(evs::Dual<1>(pi / 2.0, 0));
+    EXPECT_EQ(quarter[4].value(), 0.0);
+    EXPECT_EQ(quarter[7].value(), 1.0);
+    EXPECT_EQ(quarter[4].derivative(0), -1.0);
+}
+
+TEST(DualUnitTest, TestJacobians) {
+    const evs::EulerAngles angles(0.4, -1.1, 2.6);
+    const evs::Vector vector(1.0, -2.0, 0.5);
+    check_jacobians<evs::XYZ, evs::IntrinsicRotation>(angles, vector, "XYZ intrinsic");
+    check_jacobians<evs::XYZ, evs::ExtrinsicRotation>(angles, vector, "XYZ extrinsic");
+    check_jacobians<evs::ZXZ, evs::IntrinsicRotation>(angles, vector, "ZXZ intrinsic");
+    check_jacobians<evs::YZY, evs::ExtrinsicRotation>(angles, vector, "YZY extrinsic");
+    check_jacobians<evs::ZYX, evs::IntrinsicRotation>(evs::EulerAngles(pi / 2.0, pi, -pi / 2.0), vector,
+                                                      "ZYX quarter turns");
+}
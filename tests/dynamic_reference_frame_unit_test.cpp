@@ -0,0 +1,182 @@
+/**
+* Test files are built using cmake precompiled headers which are made
+* visible to this file when building tests and are not explicitly
+* included.
+*
+*/
+
+#include <angles.hpp>
+#include <vector.hpp>
+#include <matrix.hpp>
+#include <rotation.hpp>
+#include <dynamic_reference_frame.hpp>
+#include <resources/test_rotation_matrices.hpp>
+#include <resources/test_rotation_vectors.hpp>
+#include <gtest/gtest.h>
+#include <helpers.hpp>
+
+namespace evs = evspace;
+
+template<typename order>
+void check_dynamic_order(evs::RotationOrderId id, const char* name) {
+    const evs::EulerAngles angles = evs::EulerAngles(0.4, -1.1, 2.7);
+    const evs::Vector offset = evs::Vector(10, 20, 30);
+    const evs::Vector vector = evs::Vector(1, 2, 3);
+
+    evs::DynamicReferenceFrame intrinsic(id, evs::RotationTypeId::Intrinsic, angles, offset);
+    evs::DynamicReferenceFrame extrinsic(id, evs::RotationTypeId::Extrinsic, angles, offset);
+    evs::ReferenceFrame<order, evs::IntrinsicRotation> intrinsic_answer(angles, offset);
+    evs::ReferenceFrame<order, evs::ExtrinsicRotation> extrinsic_answer(angles, offset);
+
+    EXPECT_TRUE(intrinsic.get_matrix().compare_to(intrinsic_answer.get_matrix(), 0.0, ABS_ERROR))
+        << name << " intrinsic dynamic matrix error";
+    EXPECT_TRUE(extrinsic.get_matrix().compare_to(extrinsic_answer.get_matrix(), 0.0, ABS_ERROR))
+        << name << " extrinsic dynamic matrix error";
+    _COMPARE_VECTOR_NEAR(intrinsic.rotate_to(vector), intrinsic_answer.rotate_to(vector),
+        "intrinsic dynamic rotate to error");
+    _COMPARE_VECTOR_NEAR(extrinsic.rotate_from(vector), extrinsic_answer.rotate_from(vector),
+        "extrinsic dynamic rotate from error");
+
+    // single rotations go through the Matrix kernels, so they match the
+    // Matrix overloads exactly
+    const evs::Vector to = intrinsic.rotate_to(vector), from = extrinsic.rotate_from(vector);
+    const evs::Vector to_answer = evs::rotate_to(intrinsic.get_matrix(), vector, offset);
+    const evs::Vector from_answer = evs::rotate_from(extrinsic.get_matrix(), vector, offset);
+    for (std::size_t i = 0; i < 3; i++) {
+        EXPECT_EQ(to[i], to_answer[i]) << name << " dynamic rotate to not exact at index " << i;
+        EXPECT_EQ(from[i], from_answer[i]) << name << " dynamic rotate from not exact at index " << i;
+    }
+
+    evs::DynamicReferenceFrame converted(extrinsic_answer);
+    EXPECT_EQ(converted.get_order(), id) << name << " converted order error";
+    EXPECT_EQ(converted.get_type(), evs::RotationTypeId::Extrinsic) << name << " converted type error";
+}
+
+TEST(DynamicReferenceFrameUnitTest, TestAllCombinations) {
+    check_dynamic_order<evs::XYZ>(evs::RotationOrderId::XYZ, "XYZ");
+    check_dynamic_order<evs::XZY>(evs::RotationOrderId::XZY, "XZY");
+    check_dynamic_order<evs::YXZ>(evs::RotationOrderId::YXZ, "YXZ");
+    check_dynamic_order<evs::YZX>(evs::RotationOrderId::YZX, "YZX");
+    check_dynamic_order<evs::ZXY>(evs::RotationOrderId::ZXY, "ZXY");
+    check_dynamic_order<evs::ZYX>(evs::RotationOrderId::ZYX, "ZYX");
+    check_dynamic_order<evs::XYX>(evs::RotationOrderId::XYX, "XYX");
+    check_dynamic_order<evs::XZX>(evs::RotationOrderId::XZX, "XZX");
+    check_dynamic_order<evs::YXY>(evs::RotationOrderId::YXY, "YXY");
+    check_dynamic_order<evs::YZY>(evs::RotationOrderId::YZY, "YZY");
+    check_dynamic_order<evs::ZXZ>(evs::RotationOrderId::ZXZ, "ZXZ");
+    check_dynamic_order<evs::ZYZ>(evs::RotationOrderId::ZYZ, "ZYZ");
+}
+
+TEST(DynamicReferenceFrameUnitTest, TestFrame) {
+    const evs::EulerAngles angles = evs::EulerAngles(EVSPACE_PI / 6, EVSPACE_PI_4, EVSPACE_PI / 3);
+    const evs::Vector test_vector = evs::Vector(1, 2, 3);
+    const evs::Vector offset_vector = evs::Vector(10, 20, 30);
+
+    evs::DynamicReferenceFrame frame(evs::RotationOrderId::ZXZ, evs::RotationTypeId::Intrinsic, evs::EulerAngles());
+    frame.set_angles(angles);
+    _COMPARE_MATRIX_NEAR(frame.get_matrix(), create_array(ZXZ_ROTATION_MATRIX), "dynamic set angles error");
+    _COMPARE_VECTOR_NEAR(frame.rotate_to(test_vector), create_array(ZXZ_ROTATION_TO), "dynamic rotate to error");
+    frame.set_offset(offset_vector);
+    _COMPARE_VECTOR_NEAR(frame.rotate_from(test_vector), create_array(ZXZ_ROTATION_OFFSET_FROM),
+        "dynamic rotate from offset error");
+    EXPECT_THROW(frame.set_angles(3, 0.0), std::out_of_range) << "dynamic set angle index out of range";
+
+    // frame to frame rotations
+    evs::DynamicReferenceFrame other(evs::RotationOrderId::XYZ, evs::RotationTypeId::Extrinsic,
+        evs::EulerAngles(0.3, 0.2, 0.1), evs::Vector(-1, 5, 2));
+    evs::ReferenceFrame<evs::ZXZ> frame_answer(angles, offset_vector);
+    evs::ReferenceFrame<evs::XYZ, evs::ExtrinsicRotation> other_answer(evs::EulerAngles(0.3, 0.2, 0.1), evs::Vector(-1, 5, 2));
+    _COMPARE_VECTOR_NEAR(frame.rotate_to(other, test_vector), frame_answer.rotate_to(other_answer, test_vector),
+        "dynamic frame to frame rotate to error");
+    _COMPARE_VECTOR_NEAR(frame.rotate_from(other, test_vector), frame_answer.rotate_from(other_answer, test_vector),
+        "dynamic frame to frame rotate from error");
+
+    // batch rotations
+    evs::VectorArray vectors(2), output;
+    vectors.set(0, test_vector);
+    vectors.set(1, offset_vector);
+    frame.rotate_to(vectors, output);
+    _COMPARE_VECTOR_NEAR(output.get(1), frame.rotate_to(offset_vector), "dynamic batch rotate to error");
+    frame.rotate_from(vectors, output);
+    _COMPARE_VECTOR_NEAR(output.get(0), frame.rotate_from(test_vector), "dynamic batch rotate from error");
+}
+
+TEST(DynamicReferenceFrameUnitTest, TestFrameArray) {
+    const evs::EulerAngles angles = evs::EulerAngles(EVSPACE_PI / 6, EVSPACE_PI_4, EVSPACE_PI / 3);
+    const evs::Vector offset_vector = evs::Vector(10, 20, 30);
+    const evs::Vector test_vector = evs::Vector(1, 2, 3);
+
+    evs::DynamicReferenceFrameArray frames;
+    EXPECT_EQ(frames.size(), 0) << "default DynamicReferenceFrameArray size error";
+
+    // interleave combinations so the insertion index and group index differ
+    for (int i = 0; i < 10; i++) {
+        evs::RotationOrderId order = static_cast<evs::RotationOrderId>(i % 12);
+        evs::RotationTypeId type = i % 3 == 0 ? evs::RotationTypeId::Extrinsic : evs::RotationTypeId::Intrinsic;
+        EXPECT_EQ(frames.push_back(order, type, evs::EulerAngles(0.1 * i, 0.2, -0.3 * i)), i)
+            << "push_back index error";
+    }
+    std::size_t xyx = frames.push_back(evs::DynamicReferenceFrame(evs::RotationOrderId::XYX,
+        evs::RotationTypeId::Intrinsic, angles, offset_vector));
+    EXPECT_EQ(frames.size(), 11) << "DynamicReferenceFrameArray size error";
+    EXPECT_EQ(frames.group_size(evs::RotationOrderId::XYX, evs::RotationTypeId::Intrinsic), 1)
+        << "group size error";
+    EXPECT_EQ(frames.group_size(evs::RotationOrderId::XYZ, evs::RotationTypeId::Extrinsic), 1)
+        << "group size error";
+
+    _COMPARE_MATRIX_NEAR(frames.get_matrix(xyx), create_array(XYX_ROTATION_MATRIX), "array matrix error");
+    _COMPARE_VECTOR_NEAR(frames.rotate_to(xyx, test_vector), create_array(XYX_ROTATION_OFFSET_TO),
+        "array rotate to error");
+    _COMPARE_VECTOR_NEAR(frames.rotate_from(xyx, test_vector), create_array(XYX_ROTATION_OFFSET_FROM),
+        "array rotate from error");
+
+    // setting angles re-derives the frame's matrix, so every accessor agrees
+    // without update_all
+    for (std::size_t i = 0; i < frames.size(); i++) {
+        frames.set_angles(i, evs::EulerAngles(-0.5 * i, 0.25 * i, 1.0));
+    }
+    frames.set_offset(3, offset_vector);
+    for (std::size_t i = 0; i < frames.size(); i++) {
+        evs::DynamicReferenceFrame frame = frames.get(i);
+        EXPECT_EQ(frame.get_angles()[0], -0.5 * i) << "array get angles error";
+        EXPECT_TRUE(frames.get_matrix(i).compare_to(frame.get_matrix(), 0.0, 0.0)) << "set_angles matrix error at " << i;
+        const evs::Vector to = frames.rotate_to(i, test_vector), from = frames.rotate_from(i, test_vector);
+        const evs::Vector to_answer = frame.rotate_to(test_vector), from_answer = frame.rotate_from(test_vector);
+        for (std::size_t k = 0; k < 3; k++) {
+            EXPECT_EQ(to[k], to_answer[k]) << "set_angles rotate to error at " << i;
+            EXPECT_EQ(from[k], from_answer[k]) << "set_angles rotate from error at " << i;
+        }
+    }
+
+    frames.update_all();
+    for (std::size_t i = 0; i < frames.size(); i++) {
+        EXPECT_TRUE(frames.get_matrix(i).compare_to(frames.get(i).get_matrix(), 0.0, ABS_ERROR))
+            << "update_all error at " << i;
+    }
+    COMPARE_VECTOR(frames.get_offset(3), offset_vector, "array set offset error");
+    EXPECT_EQ(frames.get(9).get_order(), evs::RotationOrderId::YZY) << "array get order error";
+    EXPECT_EQ(frames.get(9).get_type(), evs::RotationTypeId::Extrinsic) << "array get type error";
+
+    EXPECT_THROW(frames.get(11), std::out_of_range) << "array get out of range";
+    EXPECT_THROW(frames.set_angles(11, angles), std::out_of_range) << "array set angles out of range";
+}
+
+TEST(DynamicReferenceFrameUnitTest, TestInvalidIds) {
+    // an out of range type must not alias the next order's intrinsic combination
+    const evs::RotationTypeId bad_type = static_cast<evs::RotationTypeId>(2);
+    const evs::RotationOrderId bad_order = static_cast<evs::RotationOrderId>(12);
+    EXPECT_THROW(evs::DynamicReferenceFrame(evs::RotationOrderId::XYZ, bad_type, evs::EulerAngles()),
+        std::out_of_range) << "invalid rotation type id";
+    EXPECT_THROW(evs::DynamicReferenceFrame(evs::RotationOrderId::ZYZ, bad_type, evs::EulerAngles()),
+        std::out_of_range) << "invalid rotation type id past the last order";
+    EXPECT_THROW(evs::DynamicReferenceFrame(bad_order, evs::RotationTypeId::Intrinsic, evs::EulerAngles()),
+        std::out_of_range) << "invalid rotation order id";
+
+    evs::DynamicReferenceFrameArray frames;
+    frames.push_back(evs::RotationOrderId::XZY, evs::RotationTypeId::Intrinsic, evs::EulerAngles(0.1, 0.2, 0.3));
+    EXPECT_THROW(frames.push_back(evs::RotationOrderId::XYZ, bad_type, evs::EulerAngles()), std::out_of_range)
+        << "array push_back invalid rotation type id";
+    EXPECT_EQ(frames.size(), 1) << "invalid push_back changed the size";
+    EXPECT_EQ(frames.group_size(evs::RotationOrderId::XYZ, bad_type), 0) << "invalid type group size error";
+    EXPECT_EQ(frames.group_size(bad_order, evs::RotationTypeId::Intrinsic), 0) << "invalid order group size error";
+}
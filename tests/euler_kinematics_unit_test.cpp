@@ -0,0 +1,163 @@
+/**
+* Test files are built using cmake precompiled headers which are made
+* visible to this file when building tests and are not explicitly
+* included.
+*
+*/
+
+#include <angles.hpp>
+#include <matrix.hpp>
+#include <vector.hpp>
+#include <matrix_array.hpp>
+#include <vector_array.hpp>
+#include <matrix_array_solve.hpp>
+#include <rotation.hpp>
+#include <rotation_partials.hpp>
+#include <euler_kinematics.hpp>
+#include <cmath>        // std::sin, std::cos, std::fabs
+#include <cstdint>      // std::uint8_t
+#include <stdexcept>    // std::out_of_range, std::runtime_error
+#include <string>       // std::string, std::to_string
+#include <vector>       // std::vector
+#include <gtest/gtest.h>
+#include <helpers.hpp>
+
+namespace evs = evspace;
+
+namespace {
+
+    const double pi = 3.14159265358979323846;
+
+    // Checks the kinematic matrices of one order and type against the
+    // rotation partials, R^T * dR/dt being the skew matrix of the body
+    // frame angular velocity.
+    template<typename rotation_order, typename rotation_type>
+    void check_kinematics(const evs::EulerAngles& angles, bool proper, const std::string& msg) {
+        const evs::Vector rates(0.7, -1.3, 0.4);
+        evs::Matrix rotation, partials[3];
+        evs::compute_rotation_partials<rotation_order, rotation_type>(angles, rotation, partials[0], partials[1],
+                                                                      partials[2]);
+        const evs::Matrix skew = rotation.transpose() * (partials[0] * rates[0] + partials[1] * rates[1]
+                                                         + partials[2] * rates[2]);
+        const evs::Vector expected(skew(2, 1), skew(0, 2), skew(1, 0));
+
+        const evs::Vector omega = evs::angular_velocity<rotation_order, rotation_type>(angles, rates);
+        COMPARE_VECTOR_NEAR(omega, expected, msg + " angular_velocity", 1e-14);
+        const evs::Matrix matrix = evs::angular_velocity_matrix<rotation_order, rotation_type>(angles);
+        const evs::Vector product = matrix * rates;
+        COMPARE_VECTOR_NEAR(product, expected, msg + " angular_velocity_matrix", 1e-14);
+
+        const evs::Matrix inverse = evs::euler_rate_matrix<rotation_order, rotation_type>(angles);
+        EXPECT_TRUE((inverse * matrix).compare_to(evs::Matrix::IDENTITY, 0.0, 1e-14)) << msg;
+        const evs::Vector recovered = evs::euler_rates<rotation_order, rotation_type>(angles, omega);
+        COMPARE_VECTOR_NEAR(recovered, rates, msg + " euler_rates", 1e-14);
+
+        const double determinant = evs::kinematic_determinant<rotation_order, rotation_type>(angles);
+        EXPECT_NEAR(std::fabs(determinant), std::fabs(proper ? std::sin(angles[1]) : std::cos(angles[1])), 1e-15)
+            << msg;
+
+        // the first and last axes line up at gimbal lock
+        const evs::EulerAngles locked(angles[0], proper ? 0.0 : pi / 2.0, angles[2]);
+        EXPECT_NEAR((evs::kinematic_determinant<rotation_order, rotation_type>(locked)), 0.0, 1e-15) << msg;
+        EXPECT_THROW((evs::euler_rate_matrix<rotation_order, rotation_type>(locked)), std::runtime_error) << msg;
+        EXPECT_THROW((evs::euler_rates<rotation_order, rotation_type>(locked, omega)), std::runtime_error) << msg;
+        EXPECT_NO_THROW((evs::angular_velocity_matrix<rotation_order, rotation_type>(locked))) << msg;
+    }
+
+    template<typename rotation_order>
+    void check_order(const std::string& name, bool proper) {
+        const evs::EulerAngles cases[] = {
+            evs::EulerAngles(0.4, -1.1, 2.6),
+            evs::EulerAngles(-2.9, 0.2, -0.7),
+            evs::EulerAngles(1.3, 2.8, 0.1),
+        };
+        for (std::size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+            check_kinematics<rotation_order, evs::IntrinsicRotation>(cases[i], proper,
+                                                                     name + " intrinsic " + std::to_string(i));
+            check_kinematics<rotation_order, evs::ExtrinsicRotation>(cases[i], proper,
+                                                                     name + " extrinsic " + std::to_string(i));
+        }
+    }
+
+}
+
+TEST(EulerKinematicsUnitTest, TestAllOrders) {
+    check_order<evs::XYZ>("XYZ", false);
+    check_order<evs::XZY>("XZY", false);
+    check_order<evs::YXZ>("YXZ", false);
+    check_order<evs::YZX>("YZX", false);
+    check_order<evs::ZXY>("ZXY", false);
+    check_order<evs::ZYX>("ZYX", false);
+    check_order<evs::XYX>("XYX", true);
+    check_order<evs::XZX>("XZX", true);
+    check_order<evs::YXY>("YXY", true);
+    check_order<evs::YZY>("YZY", true);
+    check_order<evs::ZXZ>("ZXZ", true);
+    check_order<evs::ZYZ>("ZYZ", true);
+}
+
+TEST(EulerKinematicsUnitTest, TestBatch) {
+    // more than one chunk, with a partial last chunk and some angle sets
+    // at gimbal lock
+    const std::size_t count = 601;
+    std::vector<double> alphas, betas, gammas;
+    std::vector<evs::Vector> omegas;
+    for (std::size_t i = 0; i < count; i++) {
+        const double t = static_cast<double>(i);
+        alphas.push_back(std::sin(0.1 * t) * 3.0);
+        betas.push_back(i % 50 == 7 ? 0.0 : 1.55 + std::cos(0.23 * t) * 1.25);
+        gammas.push_back(-2.0 + 0.01 * t);
+        omegas.push_back(evs::Vector(1.0 + std::sin(t), -0.5, std::cos(0.7 * t)));
+    }
+    const evs::VectorArray omega_array(omegas);
+
+    evs::MatrixArray rotations, matrices, rate_rotations, rate_matrices;
+    evs::VectorArray rates;
+    std::vector<std::uint8_t> matrix_status(count), rate_status(count);
+    evs::angular_velocity_matrix<evs::ZXZ, evs::ExtrinsicRotation>(alphas, betas, gammas, rotations, matrices);
+    const std::size_t matrix_flagged = evs::euler_rate_matrix<evs::ZXZ, evs::ExtrinsicRotation>(
+        alphas, betas, gammas, rate_rotations, rate_matrices, matrix_status);
+    const std::size_t rate_flagged = evs::euler_rates<evs::ZXZ, evs::ExtrinsicRotation>(
+        alphas, betas, gammas, omega_array, rates, rate_status);
+    ASSERT_EQ(matrices.size(), count);
+    ASSERT_EQ(rate_matrices.size(), count);
+    ASSERT_EQ(rates.size(), count);
+    EXPECT_EQ(matrix_flagged, 12u);
+    EXPECT_EQ(rate_flagged, 12u);
+
+    for (std::size_t i = 0; i < count; i++) {
+        const std::string msg = "batch element " + std::to_string(i);
+        const evs::EulerAngles angles(alphas[i], betas[i], gammas[i]);
+        const evs::Matrix rotation = evs::compute_rotation_matrix<evs::ZXZ, evs::ExtrinsicRotation>(angles);
+        EXPECT_TRUE(rotations.get(i).compare_to(rotation, 0.0, 1e-15)) << msg;
+        EXPECT_TRUE(rate_rotations.get(i).compare_to(rotation, 0.0, 1e-15)) << msg;
+        const evs::Matrix matrix = evs::angular_velocity_matrix<evs::ZXZ, evs::ExtrinsicRotation>(angles);
+        EXPECT_TRUE(matrices.get(i).compare_to(matrix, 0.0, 1e-15)) << msg;
+
+        if (i % 50 == 7) {
+            EXPECT_EQ(matrix_status[i], evs::MATRIX_SINGULAR) << msg;
+            EXPECT_EQ(rate_status[i], evs::MATRIX_SINGULAR) << msg;
+            EXPECT_TRUE(rate_matrices.get(i).compare_to(evs::Matrix(), 0.0, 0.0)) << msg;
+            const evs::Vector batch_rates = rates.get(i);
+            const evs::Vector zero;
+            COMPARE_VECTOR_NEAR(batch_rates, zero, msg, 0.0);
+            continue;
+        }
+        EXPECT_EQ(matrix_status[i], evs::MATRIX_OK) << msg;
+        EXPECT_EQ(rate_status[i], evs::MATRIX_OK) << msg;
+        const evs::Matrix inverse = evs::euler_rate_matrix<evs::ZXZ, evs::ExtrinsicRotation>(angles);
+        EXPECT_TRUE(rate_matrices.get(i).compare_to(inverse, 0.0, 1e-14)) << msg;
+        const evs::Vector expected = evs::euler_rates<evs::ZXZ, evs::ExtrinsicRotation>(angles, omegas[i]);
+        const evs::Vector batch_rates = rates.get(i);
+        COMPARE_VECTOR_NEAR(batch_rates, expected, msg, 1e-14);
+    }
+
+    std::vector<double> short_gammas(gammas.begin(), gammas.end() - 1);
+    EXPECT_THROW((evs::angular_velocity_matrix<evs::ZXZ>(alphas, betas, short_gammas, rotations, matrices)),
+                 std::out_of_range);
+    EXPECT_THROW((evs::euler_rate_matrix<evs::ZXZ>(alphas, betas, gammas, rotations, matrices,
+                                                   evs::span_t<std::uint8_t>(matrix_status.data(), 3))),
+                 std::out_of_range);
+    EXPECT_THROW((evs::euler_rates<evs::ZXZ>(alphas, betas, gammas, evs::VectorArray(3), rates, rate_status)),
+                 std::out_of_range);
+}
@@ -5,6 +5,7 @@
 #include <sstream>          // std::ostringstream
 #include <array>            // std::array
 #include <initializer_list> //std::initializer_list
+#include <cmath>            // std::nextafter
 
 #define EVSPACE_PI      3.14159265358979323846264338327950288
 #define EVSPACE_PI_2    (EVSPACE_PI / 2.0)
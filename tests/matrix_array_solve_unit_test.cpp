@@ -0,0 +1,165 @@
+/**
+* Test files are built using cmake precompiled headers which are made
+* visible to this file when building tests and are not explicitly
+* included.
+*
+*/
+
+#include <matrix.hpp>
+#include <vector.hpp>
+#include <matrix_array.hpp>
+#include <vector_array.hpp>
+#include <matrix_array_solve.hpp>
+#include <cstdint>      // std::uint8_t
+#include <limits>       // std::numeric_limits
+#include <vector>       // std::vector
+#include <gtest/gtest.h>
+#include <helpers.hpp>
+
+namespace evs = evspace;
+
+namespace {
+
+    // Well conditioned matrices spanning more than one chunk, with a
+    // partial last chunk.
+    std::vector<evs::Matrix> create_matrices(std::size_t count) {
+        std::vector<evs::Matrix> matrices;
+        for (std::size_t i = 0; i < count; i++) {
+            evs::Matrix matrix = evs::Matrix::IDENTITY * 2.0;
+            for (std::size_t component = 0; component < 9; component++) {
+                matrix.data()[component] += std::sin(0.61 * static_cast<double>(9 * i + component));
+            }
+            matrices.push_back(matrix);
+        }
+
+        return matrices;
+    }
+
+}
+
+TEST(MatrixArraySolveUnitTest, TestDeterminate) {
+    const std::vector<evs::Matrix> matrices = create_matrices(300);
+    const evs::MatrixArray array(matrices);
+    std::vector<double> determinants(matrices.size());
+    evs::determinate(array, determinants);
+
+    for (std::size_t i = 0; i < matrices.size(); i++) {
+        EXPECT_NEAR(determinants[i], matrices[i].determinate(), 1e-13) << "batch determinate error at " << i;
+    }
+
+    std::vector<double> short_determinants(matrices.size() - 1);
+    EXPECT_THROW(evs::determinate(array, short_determinants), std::out_of_range)
+        << "batch determinate size mismatch";
+}
+
+TEST(MatrixArraySolveUnitTest, TestInverse) {
+    const std::vector<evs::Matrix> matrices = create_matrices(300);
+    const evs::MatrixArray array(matrices);
+    evs::MatrixArray inverses;
+    std::vector<std::uint8_t> status(matrices.size(), 0xff);
+
+    EXPECT_EQ(evs::inverse(array, inverses, status), 0) << "batch inverse flagged count error";
+    ASSERT_EQ(inverses.size(), matrices.size()) << "batch inverse output size error";
+    for (std::size_t i = 0; i < matrices.size(); i++) {
+        EXPECT_EQ(status[i], evs::MATRIX_OK) << "batch inverse status error at " << i;
+        EXPECT_TRUE(inverses.get(i).compare_to(matrices[i].inverse(), 0.0, 1e-13))
+            << "batch inverse error at " << i;
+        EXPECT_TRUE((inverses.get(i) * matrices[i]).compare_to(evs::Matrix::IDENTITY, 0.0, 1e-13))
+            << "batch inverse product error at " << i;
+    }
+
+    // the output may be the input
+    evs::MatrixArray in_place = array;
+    evs::inverse(in_place, in_place, status);
+    for (std::size_t i = 0; i < matrices.size(); i++) {
+        EXPECT_TRUE(in_place.get(i) == inverses.get(i)) << "batch inverse in place error at " << i;
+    }
+
+    std::vector<std::uint8_t> short_status(matrices.size() - 1);
+    EXPECT_THROW(evs::inverse(array, inverses, short_status), std::out_of_range)
+        << "batch inverse size mismatch";
+}
+
+TEST(MatrixArraySolveUnitTest, TestInverseStatus) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const double inf = std::numeric_limits<double>::infinity();
+    std::vector<evs::Matrix> matrices{
+        evs::Matrix::IDENTITY,
+        // dependent rows
+        evs::Matrix(create_array({ {1, 2, 3}, {2, 4, 6}, {0, 1, 1} })),
+        // nearly singular, condition around 1e14
+        evs::Matrix(create_array({ {1, 0, 0}, {0, 1, 0}, {0, 0, 1e-14} })),
+        evs::Matrix(create_array({ {nan, 0, 0}, {0, 1, 0}, {0, 0, 1} })),
+        evs::Matrix(create_array({ {inf, 0, 0}, {0, 1, 0}, {0, 0, 1} })),
+        evs::Matrix(create_array(0.0))
+    };
+    const evs::MatrixArray array(matrices);
+    evs::MatrixArray inverses;
+    std::vector<std::uint8_t> status(matrices.size());
+
+    // bad elements are flagged without throwing and the rest still invert
+    EXPECT_EQ(evs::inverse(array, inverses, status), 5) << "batch inverse flagged count error";
+    EXPECT_EQ(status[0], evs::MATRIX_OK) << "identity status error";
+    EXPECT_EQ(status[1], evs::MATRIX_SINGULAR) << "dependent rows status error";
+    EXPECT_EQ(status[2], evs::MATRIX_ILL_CONDITIONED) << "nearly singular status error";
+    EXPECT_EQ(status[3], evs::MATRIX_SINGULAR) << "NaN status error";
+    EXPECT_EQ(status[4], evs::MATRIX_SINGULAR) << "infinite status error";
+    EXPECT_EQ(status[5], evs::MATRIX_SINGULAR) << "zero status error";
+
+    EXPECT_TRUE(inverses.get(0) == evs::Matrix::IDENTITY) << "identity inverse error";
+    EXPECT_DOUBLE_EQ(inverses.get(2)(2, 2), 1e14) << "ill-conditioned inverse is still computed";
+    for (std::size_t i : { 1, 3, 4, 5 }) {
+        for (std::size_t component = 0; component < 9; component++) {
+            EXPECT_EQ(inverses.get(i).data()[component], 0.0) << "singular inverse not zeroed at " << i;
+        }
+    }
+
+    // a looser minimum accepts the nearly singular matrix
+    EXPECT_EQ(evs::inverse(array, inverses, status, 1e-16), 4) << "batch inverse min_rcond error";
+    EXPECT_EQ(status[2], evs::MATRIX_OK) << "nearly singular status with loose min_rcond error";
+}
+
+TEST(MatrixArraySolveUnitTest, TestSolve) {
+    const std::vector<evs::Matrix> matrices = create_matrices(300);
+    const evs::MatrixArray array(matrices);
+    std::vector<evs::Vector> vectors;
+    for (std::size_t i = 0; i < matrices.size(); i++) {
+        const double t = static_cast<double>(i);
+        vectors.push_back(evs::Vector(std::cos(t), std::sin(0.3 * t), 1.0 + 0.01 * t));
+    }
+
+    const evs::VectorArray rhs(vectors);
+    evs::VectorArray solution;
+    std::vector<std::uint8_t> status(matrices.size(), 0xff);
+    EXPECT_EQ(evs::solve(array, rhs, solution, status), 0) << "batch solve flagged count error";
+    ASSERT_EQ(solution.size(), matrices.size()) << "batch solve output size error";
+
+    for (std::size_t i = 0; i < matrices.size(); i++) {
+        EXPECT_EQ(status[i], evs::MATRIX_OK) << "batch solve status error at " << i;
+        const evs::Vector x = solution.get(i);
+        const evs::Vector residual = matrices[i] * x - vectors[i];
+        EXPECT_LT(residual.magnitude(), 1e-13) << "batch solve residual error at " << i;
+    }
+
+    // the solution may be the right hand side
+    evs::VectorArray in_place = rhs;
+    evs::solve(array, in_place, in_place, status);
+    for (std::size_t i = 0; i < matrices.size(); i++) {
+        EXPECT_TRUE(in_place.get(i) == solution.get(i)) << "batch solve in place error at " << i;
+    }
+
+    // a singular element is flagged and zeroed, the others are unaffected
+    evs::MatrixArray with_singular = array;
+    with_singular.set(7, evs::Matrix(create_array({ {1, 2, 3}, {2, 4, 6}, {0, 1, 1} })));
+    EXPECT_EQ(evs::solve(with_singular, rhs, in_place, status), 1) << "batch solve flagged count error";
+    EXPECT_EQ(status[7], evs::MATRIX_SINGULAR) << "batch solve singular status error";
+    EXPECT_TRUE(in_place.get(7) == evs::Vector()) << "batch solve singular solution not zeroed";
+    EXPECT_TRUE(in_place.get(8) == solution.get(8)) << "batch solve neighbour of singular error";
+
+    evs::VectorArray short_rhs(matrices.size() - 1);
+    std::vector<std::uint8_t> short_status(matrices.size() - 1);
+    EXPECT_THROW(evs::solve(array, short_rhs, solution, status), std::out_of_range)
+        << "batch solve rhs size mismatch";
+    EXPECT_THROW(evs::solve(array, rhs, solution, short_status), std::out_of_range)
+        << "batch solve status size mismatch";
+}
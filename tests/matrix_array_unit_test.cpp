@@ -0,0 +1,131 @@
+/**
+* Test files are built using cmake precompiled headers which are made
+* visible to this file when building tests and are not explicitly
+* included.
+*
+*/
+
+#include <matrix.hpp>
+#include <matrix_array.hpp>
+#include <rotation.hpp>
+#include <vector>
+#include <gtest/gtest.h>
+#include <helpers.hpp>
+
+namespace evs = evspace;
+
+TEST(MatrixArrayUnitTest, TestCreation) {
+    evs::MatrixArray empty;
+    EXPECT_EQ(empty.size(), 0) << "Default MatrixArray size error";
+
+    evs::MatrixArray zeros(3);
+    EXPECT_EQ(zeros.size(), 3) << "Sized MatrixArray size error";
+    for (std::size_t i = 0; i < zeros.size(); i++) {
+        COMPARE_MATRIX(zeros.get(i), create_array(0.0), "Sized MatrixArray initial value error");
+    }
+}
+
+TEST(MatrixArrayUnitTest, TestAccess) {
+    const MatrixArray array_123 = create_array({ {1, 2, 3}, {4, 5, 6}, {7, 8, 9} });
+    evs::MatrixArray array(2);
+    array.set(1, evs::Matrix(array_123));
+    COMPARE_MATRIX(array.get(1), array_123, "MatrixArray set error");
+    COMPARE_MATRIX(array.get(0), create_array(0.0), "MatrixArray set changed other matrix");
+
+    // components are stored in planes
+    EXPECT_EQ(array.plane(0, 1)[1], 2) << "MatrixArray plane (0, 1) error";
+    EXPECT_EQ(array.plane(2, 0)[1], 7) << "MatrixArray plane (2, 0) error";
+    EXPECT_EQ(array.plane(2, 2)[0], 0) << "MatrixArray plane (2, 2) error";
+
+    EXPECT_THROW(array.get(2), std::out_of_range) << "MatrixArray get out of range";
+    EXPECT_THROW(array.set(2, evs::Matrix()), std::out_of_range) << "MatrixArray set out of range";
+    EXPECT_THROW(array.plane(3, 0), std::out_of_range) << "MatrixArray plane row out of range";
+    EXPECT_THROW(array.plane(0, 3), std::out_of_range) << "MatrixArray plane column out of range";
+}
+
+TEST(MatrixArrayUnitTest, TestResize) {
+    const MatrixArray array_123 = create_array({ {1, 2, 3}, {4, 5, 6}, {7, 8, 9} });
+    evs::MatrixArray array(1);
+    array.set(0, evs::Matrix(array_123));
+
+    array.resize(3);
+    EXPECT_EQ(array.size(), 3) << "MatrixArray grow size error";
+    COMPARE_MATRIX(array.get(0), array_123, "MatrixArray grow preserved value error");
+    COMPARE_MATRIX(array.get(2), create_array(0.0), "MatrixArray grow new value error");
+
+    array.resize(1);
+    EXPECT_EQ(array.size(), 1) << "MatrixArray shrink size error";
+    COMPARE_MATRIX(array.get(0), array_123, "MatrixArray shrink preserved value error");
+}
+
+TEST(MatrixArrayUnitTest, TestFromMatrices) {
+    std::vector<evs::Matrix> matrices{
+        evs::Matrix(create_array({ {1, 2, 3}, {4, 5, 6}, {7, 8, 9} })),
+        evs::Matrix(create_array({ {9, 8, 7}, {6, 5, 4}, {3, 2, 1} }))
+    };
+    evs::MatrixArray array(matrices);
+    EXPECT_EQ(array.size(), 2) << "MatrixArray from span size error";
+    COMPARE_MATRIX(array.get(0), create_array({ {1, 2, 3}, {4, 5, 6}, {7, 8, 9} }), "MatrixArray from span first matrix error");
+    COMPARE_MATRIX(array.get(1), create_array({ {9, 8, 7}, {6, 5, 4}, {3, 2, 1} }), "MatrixArray from span second matrix error");
+    EXPECT_EQ(array.plane(1, 2)[1], 4) << "MatrixArray from span plane error";
+}
+
+TEST(MatrixArrayUnitTest, TestMultiply) {
+    // more than one chunk, with a partial last chunk
+    const std::size_t count = 600;
+    std::vector<evs::Matrix> lhs_matrices, rhs_matrices;
+    for (std::size_t i = 0; i < count; i++) {
+        evs::Matrix lhs, rhs;
+        for (std::size_t component = 0; component < 9; component++) {
+            lhs.data()[component] = std::sin(0.37 * static_cast<double>(9 * i + component));
+            rhs.data()[component] = std::cos(0.53 * static_cast<double>(9 * i + component));
+        }
+        lhs_matrices.push_back(lhs);
+        rhs_matrices.push_back(rhs);
+    }
+
+    const evs::MatrixArray lhs(lhs_matrices), rhs(rhs_matrices);
+    evs::MatrixArray product, transpose_product;
+    evs::multiply(lhs, rhs, product);
+    evs::transpose_multiply(lhs, rhs, transpose_product);
+    ASSERT_EQ(product.size(), count) << "MatrixArray multiply output size error";
+    ASSERT_EQ(transpose_product.size(), count) << "MatrixArray transpose_multiply output size error";
+
+    for (std::size_t i = 0; i < count; i++) {
+        const evs::Matrix expected = lhs_matrices[i] * rhs_matrices[i];
+        const evs::Matrix expected_transpose = lhs_matrices[i].transpose() * rhs_matrices[i];
+        EXPECT_TRUE(product.get(i).compare_to(expected, 0.0, 1e-15))
+            << "MatrixArray multiply error at " << i;
+        EXPECT_TRUE(transpose_product.get(i).compare_to(expected_transpose, 0.0, 1e-15))
+            << "MatrixArray transpose_multiply error at " << i;
+    }
+
+    // the output may be one of the operands
+    evs::MatrixArray in_place = lhs;
+    evs::multiply(in_place, rhs, in_place);
+    evs::MatrixArray in_place_rhs = rhs;
+    evs::transpose_multiply(lhs, in_place_rhs, in_place_rhs);
+    for (std::size_t i = 0; i < count; i++) {
+        EXPECT_TRUE(in_place.get(i) == product.get(i))
+            << "MatrixArray in place multiply error at " << i;
+        EXPECT_TRUE(in_place_rhs.get(i) == transpose_product.get(i))
+            << "MatrixArray in place transpose_multiply error at " << i;
+    }
+
+    // transpose of a rotation composes with its inverse
+    evs::MatrixArray identity;
+    const evs::Matrix rotation = evs::compute_rotation_matrix<evs::ZXZ>(evs::EulerAngles(0.4, 1.1, -2.0));
+    std::vector<evs::Matrix> rotations(3, rotation);
+    const evs::MatrixArray rotation_array(rotations);
+    evs::transpose_multiply(rotation_array, rotation_array, identity);
+    for (std::size_t i = 0; i < identity.size(); i++) {
+        EXPECT_TRUE(identity.get(i).compare_to(evs::Matrix::IDENTITY, 0.0, 1e-15))
+            << "MatrixArray transpose_multiply inverse error at " << i;
+    }
+
+    evs::MatrixArray short_array(count - 1);
+    EXPECT_THROW(evs::multiply(lhs, short_array, product), std::out_of_range)
+        << "MatrixArray multiply size mismatch";
+    EXPECT_THROW(evs::transpose_multiply(short_array, rhs, product), std::out_of_range)
+        << "MatrixArray transpose_multiply size mismatch";
+}
@@ -0,0 +1,263 @@
+/**
+* Test files are built using cmake precompiled headers which are made
+* visible to this file when building tests and are not explicitly
+* included.
+*
+*/
+
+#include <matrix.hpp>
+#include <vector.hpp>
+#include <matrix_array.hpp>
+#include <vector_array.hpp>
+#include <rotation.hpp>
+#include <symmetric_matrix.hpp>
+#include <symmetric_matrix_array.hpp>
+#include <matrix_decomposition.hpp>
+#include <cmath>        // HUGE_VAL, NAN
+#include <cstdint>      // std::uint8_t
+#include <stdexcept>    // std::runtime_error, std::out_of_range
+#include <string>       // std::string, std::to_string
+#include <vector>       // std::vector
+#include <gtest/gtest.h>
+#include <helpers.hpp>
+
+namespace evs = evspace;
+
+namespace {
+
+    // Full rank, rank two, rank one, zero, negative determinant, drifted
+    // rotation and badly scaled matrices.
+    std::vector<evs::Matrix> create_matrices() {
+        std::vector<evs::Matrix> matrices;
+        matrices.push_back(evs::Matrix({ { 2.0, -1.0, 0.5 }, { 0.3, 4.0, 1.0 }, { -2.0, 0.7, 3.0 } }));
+        matrices.push_back(evs::Matrix({ { 1.0, 2.0, 3.0 }, { -1.0, 0.5, 2.0 }, { 0.0, 2.5, 5.0 } }));
+        matrices.push_back(evs::Matrix({ { 1.0, -2.0, 0.5 }, { -2.0, 4.0, -1.0 }, { 0.5, -1.0, 0.25 } }));
+        matrices.push_back(evs::Matrix());
+        matrices.push_back(evs::Matrix({ { 0.0, 1.0, 0.0 }, { 1.0, 0.0, 0.0 }, { 0.0, 0.0, 2.0 } }));
+
+        evs::Matrix drifted = evs::compute_rotation_matrix<evs::ZXZ>(evs::EulerAngles(0.4, 1.2, -2.0));
+        drifted(0, 1) += 1e-6;
+        drifted(2, 0) -= 2e-6;
+        drifted(1, 1) *= 1.0 + 3e-6;
+        matrices.push_back(drifted);
+        matrices.push_back(evs::Matrix({ { 1e-8, 0.0, 2e8 }, { 0.0, 3.0, 0.0 }, { 1e8, 0.0, 1e-8 } }));
+        matrices.push_back(matrices[0] * 1e-200);
+
+        return matrices;
+    }
+
+    double largest_entry(const evs::Matrix& matrix) {
+        double largest = 0.0;
+        for (std::size_t row = 0; row < 3; row++) {
+            for (std::size_t col = 0; col < 3; col++) {
+                largest = std::fabs(matrix(row, col)) > largest ? std::fabs(matrix(row, col)) : largest;
+            }
+        }
+
+        return largest;
+    }
+
+    void check_svd(const evs::Matrix& matrix, const evs::Matrix& u, const evs::Vector& sigma,
+                   const evs::Matrix& v, const std::string& msg)
+    {
+        const double scale = largest_entry(matrix) > 0.0 ? largest_entry(matrix) : 1.0;
+        EXPECT_GE(sigma[0], sigma[1]) << msg;
+        EXPECT_GE(sigma[1], sigma[2]) << msg;
+        EXPECT_GE(sigma[2], 0.0) << msg;
+        EXPECT_TRUE((u.transpose() * u).compare_to(evs::Matrix::IDENTITY, 0.0, 1e-14)) << msg;
+        EXPECT_TRUE((v.transpose() * v).compare_to(evs::Matrix::IDENTITY, 0.0, 1e-14)) << msg;
+        EXPECT_NEAR(v.determinate(), 1.0, 1e-14) << msg;
+
+        evs::Matrix diagonal;
+        for (std::size_t k = 0; k < 3; k++) {
+            diagonal(k, k) = sigma[k];
+        }
+        EXPECT_TRUE((u * diagonal * v.transpose() * (1.0 / scale)).compare_to(matrix * (1.0 / scale), 0.0, 1e-14))
+            << msg;
+    }
+
+    void check_polar(const evs::Matrix& matrix, const evs::Matrix& rotation, const evs::SymmetricMatrix& stretch,
+                     const std::string& msg)
+    {
+        const double scale = largest_entry(matrix) > 0.0 ? largest_entry(matrix) : 1.0;
+        EXPECT_TRUE((rotation.transpose() * rotation).compare_to(evs::Matrix::IDENTITY, 0.0, 1e-14)) << msg;
+        EXPECT_NEAR(rotation.determinate(), 1.0, 1e-14) << msg;
+        EXPECT_TRUE((rotation * stretch.to_matrix() * (1.0 / scale)).compare_to(matrix * (1.0 / scale), 0.0, 1e-14))
+            << msg;
+    }
+
+}
+
+TEST(MatrixDecompositionUnitTest, TestSvd) {
+    const std::vector<evs::Matrix> matrices = create_matrices();
+    for (std::size_t i = 0; i < matrices.size(); i++) {
+        evs::Matrix u, v;
+        evs::Vector sigma;
+        evs::svd(matrices[i], u, sigma, v);
+        check_svd(matrices[i], u, sigma, v, "matrix " + std::to_string(i));
+    }
+
+    evs::Matrix u, v;
+    evs::Vector sigma;
+    evs::svd(matrices[0], u, sigma, v);
+    // singular values are the square roots of the eigenvalues of m^T * m
+    const evs::Matrix normal = matrices[0].transpose() * matrices[0];
+    EXPECT_NEAR(sigma[0] * sigma[1] * sigma[2], std::fabs(matrices[0].determinate()), 1e-12);
+    EXPECT_NEAR(sigma[0] * sigma[0] + sigma[1] * sigma[1] + sigma[2] * sigma[2],
+                normal(0, 0) + normal(1, 1) + normal(2, 2), 1e-12);
+
+    // rank deficiency shows up as zero singular values
+    evs::svd(matrices[1], u, sigma, v);
+    EXPECT_NEAR(sigma[2], 0.0, 1e-14) << "rank two";
+    evs::svd(matrices[2], u, sigma, v);
+    EXPECT_NEAR(sigma[1], 0.0, 1e-14) << "rank one";
+    EXPECT_NEAR(sigma[2], 0.0, 1e-14) << "rank one";
+    evs::svd(matrices[4], u, sigma, v);
+    COMPARE_VECTOR_NEAR(sigma, create_array({ 2.0, 1.0, 1.0 }), "reflection", 1e-15);
+    EXPECT_NEAR(u.determinate(), -1.0, 1e-15) << "reflection";
+}
+
+TEST(MatrixDecompositionUnitTest, TestPolarDecomposition) {
+    const std::vector<evs::Matrix> matrices = create_matrices();
+    for (std::size_t i = 0; i < matrices.size(); i++) {
+        evs::Matrix rotation;
+        evs::SymmetricMatrix stretch;
+        evs::polar_decomposition(matrices[i], rotation, stretch);
+        check_polar(matrices[i], rotation, stretch, "matrix " + std::to_string(i));
+        EXPECT_TRUE(evs::nearest_rotation(matrices[i]).compare_to(rotation, 0.0, 1e-15)) << "matrix " << i;
+    }
+
+    // a rotation is its own nearest rotation with no stretch
+    const evs::Matrix exact = evs::compute_rotation_matrix<evs::XYZ>(evs::EulerAngles(-0.3, 0.8, 2.5));
+    evs::Matrix rotation;
+    evs::SymmetricMatrix stretch;
+    evs::polar_decomposition(exact, rotation, stretch);
+    EXPECT_TRUE(rotation.compare_to(exact, 0.0, 1e-15));
+    EXPECT_TRUE(stretch.compare_to(evs::SymmetricMatrix(1.0, 0.0, 0.0, 1.0, 0.0, 1.0), 0.0, 1e-15));
+
+    // the drifted rotation is projected back next to where it started
+    const evs::Matrix original = evs::compute_rotation_matrix<evs::ZXZ>(evs::EulerAngles(0.4, 1.2, -2.0));
+    EXPECT_TRUE(evs::nearest_rotation(matrices[5]).compare_to(original, 0.0, 1e-5));
+}
+
+TEST(MatrixDecompositionUnitTest, TestBatch) {
+    // repeated past every lane width with a partial remainder
+    std::vector<evs::Matrix> matrices;
+    const std::vector<evs::Matrix> cases = create_matrices();
+    for (std::size_t i = 0; i < 101; i++) {
+        matrices.push_back(cases[i % cases.size()] * (1.0 + 0.01 * static_cast<double>(i)));
+    }
+    const evs::MatrixArray array(matrices);
+
+    evs::MatrixArray u, v, rotations;
+    evs::VectorArray sigma;
+    evs::SymmetricMatrixArray stretches;
+    evs::svd(array, u, sigma, v);
+    evs::polar_decomposition(array, rotations, stretches);
+    ASSERT_EQ(u.size(), matrices.size());
+    ASSERT_EQ(sigma.size(), matrices.size());
+    ASSERT_EQ(stretches.size(), matrices.size());
+
+    for (std::size_t i = 0; i < matrices.size(); i++) {
+        const std::string msg = "batch element " + std::to_string(i);
+        check_svd(matrices[i], u.get(i), sigma.get(i), v.get(i), msg);
+        check_polar(matrices[i], rotations.get(i), stretches.get(i), msg);
+
+        evs::Matrix expected_u, expected_v;
+        evs::Vector expected_sigma;
+        evs::svd(matrices[i], expected_u, expected_sigma, expected_v);
+        const double scale = largest_entry(matrices[i]) > 0.0 ? largest_entry(matrices[i]) : 1.0;
+        const evs::Vector scaled_sigma = sigma.get(i) * (1.0 / scale);
+        const evs::Vector scaled_expected = expected_sigma * (1.0 / scale);
+        COMPARE_VECTOR_NEAR(scaled_sigma, scaled_expected, msg, 1e-14);
+    }
+
+    evs::MatrixArray in_place(matrices);
+    evs::nearest_rotation(in_place, in_place);
+    for (std::size_t i = 0; i < matrices.size(); i++) {
+        EXPECT_TRUE(in_place.get(i).compare_to(rotations.get(i), 0.0, 1e-15)) << "in place nearest rotation " << i;
+    }
+}
+
+TEST(MatrixDecompositionUnitTest, TestCholesky) {
+    // definite, rank two, rank one, zero, indefinite with a zero pivot,
+    // negative definite and not finite
+    std::vector<evs::SymmetricMatrix> matrices;
+    matrices.push_back(evs::SymmetricMatrix(4.0, 1.0, -0.5, 3.0, 0.25, 2.0));
+    matrices.push_back(evs::SymmetricMatrix(1.0, 1.0, 0.0, 1.0, 0.0, 2.0));
+    matrices.push_back(evs::SymmetricMatrix(1.0, -2.0, 0.5, 4.0, -1.0, 0.25));
+    matrices.push_back(evs::SymmetricMatrix());
+    matrices.push_back(evs::SymmetricMatrix(0.0, 1.0, 0.0, 0.0, 0.0, 1.0));
+    matrices.push_back(evs::SymmetricMatrix(-1.0, 0.0, 0.0, -2.0, 0.0, -3.0));
+    matrices.push_back(evs::SymmetricMatrix(1.0, 0.0, 0.0, 1.0, 0.0, HUGE_VAL));
+    const bool valid[] = { true, true, true, true, false, false, false };
+
+    for (std::size_t i = 0; i < matrices.size(); i++) {
+        const std::string msg = "matrix " + std::to_string(i);
+        if (!valid[i]) {
+            EXPECT_THROW(evs::cholesky(matrices[i]), std::runtime_error) << msg;
+            continue;
+        }
+
+        const evs::Matrix lower = evs::cholesky(matrices[i]);
+        const evs::Matrix product = lower * lower.transpose();
+        const evs::Matrix expected = matrices[i].to_matrix();
+        EXPECT_TRUE(product.compare_to(expected, 0.0, 1e-14)) << msg;
+        for (std::size_t row = 0; row < 3; row++) {
+            EXPECT_GE(lower(row, row), 0.0) << msg;
+            for (std::size_t col = row + 1; col < 3; col++) {
+                EXPECT_EQ(lower(row, col), 0.0) << msg;
+            }
+        }
+    }
+
+    // repeated past a chunk with a partial remainder
+    std::vector<evs::SymmetricMatrix> repeated;
+    for (std::size_t i = 0; i < 301; i++) {
+        repeated.push_back(matrices[i % matrices.size()] * (1.0 + 0.01 * static_cast<double>(i)));
+    }
+    const evs::SymmetricMatrixArray array(repeated);
+    evs::MatrixArray factors;
+    std::vector<std::uint8_t> status(repeated.size());
+    const std::size_t flagged = evs::cholesky(array, factors, status);
+    ASSERT_EQ(factors.size(), repeated.size());
+
+    std::size_t expected_flagged = 0;
+    for (std::size_t i = 0; i < repeated.size(); i++) {
+        const std::string msg = "batch element " + std::to_string(i);
+        if (!valid[i % matrices.size()]) {
+            expected_flagged++;
+            EXPECT_EQ(status[i], evs::MATRIX_SINGULAR) << msg;
+            const evs::Matrix factor = factors.get(i);
+            const evs::Matrix zero;
+            EXPECT_TRUE(factor.compare_to(zero, 0.0, 0.0)) << msg;
+            continue;
+        }
+
+        EXPECT_EQ(status[i], evs::MATRIX_OK) << msg;
+        const evs::Matrix factor = factors.get(i);
+        const evs::Matrix expected = evs::cholesky(repeated[i]);
+        EXPECT_TRUE(factor.compare_to(expected, 0.0, 0.0)) << msg;
+    }
+    EXPECT_EQ(flagged, expected_flagged);
+
+    std::vector<std::uint8_t> short_status(repeated.size() - 1);
+    EXPECT_THROW(evs::cholesky(array, factors, short_status), std::out_of_range);
+
+    // finite entries whose sum overflows are still a valid matrix, a NaN
+    // entry is not
+    const evs::SymmetricMatrix large(4e307, 2e307, 2e307, 4e307, 2e307, 4e307);
+    const evs::Matrix large_lower = evs::cholesky(large);
+    const evs::Matrix large_product = large_lower * large_lower.transpose();
+    EXPECT_TRUE(large_product.compare_to(large.to_matrix(), 1e-14, 0.0)) << "large finite matrix";
+    const evs::SymmetricMatrix not_a_number(1.0, NAN, 0.0, 1.0, 0.0, 1.0);
+    EXPECT_THROW(evs::cholesky(not_a_number), std::runtime_error) << "NaN matrix";
+
+    const std::vector<evs::SymmetricMatrix> edge{ large, not_a_number };
+    std::vector<std::uint8_t> edge_status(edge.size());
+    EXPECT_EQ(evs::cholesky(evs::SymmetricMatrixArray(edge), factors, edge_status), 1u);
+    EXPECT_EQ(edge_status[0], evs::MATRIX_OK) << "batch large finite matrix";
+    EXPECT_EQ(edge_status[1], evs::MATRIX_SINGULAR) << "batch NaN matrix";
+    const evs::Matrix large_factor = factors.get(0);
+    EXPECT_TRUE(large_factor.compare_to(large_lower, 0.0, 0.0)) << "batch large finite matrix";
+}
@@ -247,6 +247,13 @@ TEST_F(MatrixUnitTest, TestMathOperators) {
     answer = create_array({ {1, 0, 0}, {0, 1, 0}, {0, 0, 1} });
     _COMPARE_MATRIX_NEAR((result.inverse() * result), answer,
         "Matrix inverse check error");
+
+    // every cofactor contributes when no entries are zero
+    result << 2.0, 1.0, 3.0,
+              4.0, 5.0, 7.0,
+              6.0, 8.0, 11.0;
+    _COMPARE_MATRIX_NEAR((result.inverse() * result), answer,
+        "Matrix inverse full matrix check error");
 }
 
 TEST_F(MatrixUnitTest, TestMatrixComparison) {
@@ -349,3 +356,57 @@ TEST(MatrixUnitTestData, TestDataAccessors) {
     EXPECT_EQ(span.size(), 9) << "matrix const span size error";
     EXPECT_EQ(span.size_bytes(), 9 * sizeof(double)) << "matrix const span size_bytes error";
 }
+
+TEST(MatrixUnitTestKernels, TestProductKernels) {
+    // the dispatched kernels (AVX2/FMA when compiled for it) must match the
+    // scalar fallback bit for bit
+    double a[9], b[9], v[3];
+    for (int trial = 0; trial < 100; trial++) {
+        for (int i = 0; i < 9; i++) {
+            a[i] = std::sin(1.3 * trial + 0.7 * i) * 10.0;
+            b[i] = std::cos(0.9 * trial - 1.1 * i) / 3.0;
+        }
+        for (int i = 0; i < 3; i++) {
+            v[i] = std::sin(0.37 * trial * i + 2.0);
+        }
+
+        double expected[9], actual[9];
+        evs::_matrix_exec::_multiply_scalar(a, b, expected);
+        evs::_matrix_exec::_multiply(a, b, actual);
+        for (int i = 0; i < 9; i++) {
+            ASSERT_EQ(actual[i], expected[i]) << "matrix product kernel mismatch at " << i;
+        }
+
+        // writing over the left operand needs no copy
+        double in_place[9];
+        std::memcpy(in_place, a, sizeof(a));
+        evs::_matrix_exec::_multiply(in_place, b, in_place);
+        for (int i = 0; i < 9; i++) {
+            ASSERT_EQ(in_place[i], expected[i]) << "in place matrix product error at " << i;
+        }
+
+        double expected_vector[3], actual_vector[3];
+        evs::_matrix_exec::_multiply_vector(a, v, expected_vector);
+        for (int i = 0; i < 3; i++) {
+            ASSERT_NEAR(expected_vector[i], a[i * 3] * v[0] + a[i * 3 + 1] * v[1] + a[i * 3 + 2] * v[2], 1e-13)
+                << "matrix vector kernel error at " << i;
+        }
+
+        evs::_matrix_exec::_vector_multiply_scalar(v, a, expected_vector);
+        evs::_matrix_exec::_vector_multiply(v, a, actual_vector);
+        for (int i = 0; i < 3; i++) {
+            ASSERT_EQ(actual_vector[i], expected_vector[i]) << "vector matrix kernel mismatch at " << i;
+            ASSERT_NEAR(expected_vector[i], v[0] * a[i] + v[1] * a[3 + i] + v[2] * a[6 + i], 1e-13)
+                << "vector matrix kernel error at " << i;
+        }
+    }
+
+    // products with an aliased operand
+    evs::Matrix m({ {1, 2, 3}, {4, 5, 6}, {7, 8, 9} });
+    const evs::Matrix copy = m;
+    m *= m;
+    EXPECT_TRUE(m.compare_to(copy * copy, 0)) << "matrix self product error";
+    evs::Vector vector(1, -1, 2);
+    vector *= copy;
+    COMPARE_VECTOR(vector, evs::Vector(11, 13, 15), "vector matrix product in place error");
+}
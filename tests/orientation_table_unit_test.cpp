@@ -0,0 +1,180 @@
+/**
+* Test files are built using cmake precompiled headers which are made
+* visible to this file when building tests and are not explicitly
+* included.
+*
+*/
+
+#include <angles.hpp>
+#include <matrix.hpp>
+#include <matrix_array.hpp>
+#include <quaternion.hpp>
+#include <rotation.hpp>
+#include <orientation_table.hpp>
+#include <gtest/gtest.h>
+#include <helpers.hpp>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace evs = evspace;
+
+// Stream buffer over a string which can't seek, so the stream can't report
+// its length.
+class UnseekableBuffer : public std::streambuf {
+public:
+    explicit UnseekableBuffer(std::string& bytes) {
+        this->setg(&bytes[0], &bytes[0], &bytes[0] + bytes.size());
+    }
+};
+
+// Rotation angle between the rotations of two unit quaternions.
+static double rotation_error(const evs::Quaternion& lhs, const evs::Quaternion& rhs) {
+    evs::Quaternion difference = lhs.conjugate() * rhs;
+    double vector_norm = std::sqrt(difference[1] * difference[1] + difference[2] * difference[2]
+        + difference[3] * difference[3]);
+    return 2.0 * std::atan2(vector_norm, std::fabs(difference[0]));
+}
+
+template<typename order, typename type>
+static void check_error_bound(const std::string& name) {
+    SCOPED_TRACE(name);
+    const evs::EulerAngles lower(-0.6, -1.2, 0.3), upper(0.9, 0.4, 1.8);
+    evs::OrientationTable<order, type> table(lower, upper, 31, 41, 21);
+
+    // nodes are exact
+    for (double alpha : { -0.6, 0.05, 0.9 }) {
+        const evs::EulerAngles angles(alpha, -1.2 + 0.04 * 10, 0.3 + 0.075 * 20);
+        EXPECT_TRUE(table.lookup(angles).compare_to(evs::compute_rotation_matrix<order, type>(angles), 0.0, 1e-14))
+            << "grid node matrix error";
+    }
+
+    double max_error = 0.0;
+    for (int i = 0; i < 500; i++) {
+        const evs::EulerAngles angles(-0.6 + 1.5 * std::fmod(0.6180339887 * i, 1.0),
+                                      -1.2 + 1.6 * std::fmod(0.4142135624 * i, 1.0),
+                                      0.3 + 1.5 * std::fmod(0.7320508076 * i, 1.0));
+        const double error = rotation_error(table.lookup_quaternion(angles),
+                                            evs::compute_rotation_quaternion<order, type>(angles));
+        max_error = std::max(max_error, error);
+        EXPECT_TRUE(table.lookup(angles).compare_to(table.lookup_quaternion(angles).to_matrix(), 0.0, 1e-15))
+            << "matrix and quaternion lookup differ";
+    }
+
+    EXPECT_LE(max_error, table.error_bound()) << "interpolation error exceeds the documented bound";
+    // the bound is not wildly pessimistic
+    EXPECT_GE(max_error, table.error_bound() / 5.0) << "interpolation error bound is loose";
+}
+
+TEST(OrientationTableUnitTest, TestErrorBound) {
+    check_error_bound<evs::XYZ, evs::IntrinsicRotation>("intrinsic XYZ");
+    check_error_bound<evs::ZXZ, evs::IntrinsicRotation>("intrinsic ZXZ");
+    check_error_bound<evs::ZYX, evs::ExtrinsicRotation>("extrinsic ZYX");
+    check_error_bound<evs::YXY, evs::ExtrinsicRotation>("extrinsic YXY");
+
+    evs::OrientationTable<evs::XYZ> table(evs::EulerAngles(0, 0, 0), evs::EulerAngles(1, 1, 1), 101, 101, 101);
+    EXPECT_DOUBLE_EQ(table.error_bound(), std::pow(std::sqrt(3.0) * 0.01, 3) / (144 * std::sqrt(3.0))) << "error bound value error";
+    EXPECT_EQ(table.size(), 101 * 101 * 101) << "table size error";
+    EXPECT_EQ(table.count(1), 101) << "table count error";
+    EXPECT_THROW(table.count(3), std::out_of_range);
+}
+
+TEST(OrientationTableUnitTest, TestRangeAndArguments) {
+    const evs::EulerAngles lower(-1, -1, -1), upper(1, 1, 1);
+    evs::OrientationTable<evs::XZY> table(lower, upper, 5, 5, 5);
+
+    COMPARE_VECTOR(table.lower(), lower, "table lower angles error");
+    _COMPARE_VECTOR_NEAR(table.upper(), upper, "table upper angles error");
+    EXPECT_NO_THROW(table.lookup(upper));
+    EXPECT_NO_THROW(table.lookup(lower));
+    EXPECT_THROW(table.lookup(evs::EulerAngles(0, 1.01, 0)), std::out_of_range);
+    EXPECT_THROW(table.lookup(evs::EulerAngles(0, 0, std::nan(""))), std::out_of_range);
+    EXPECT_THROW(table.lookup_quaternion(evs::EulerAngles(-1.01, 0, 0)), std::out_of_range);
+
+    EXPECT_THROW((evs::OrientationTable<evs::XZY>(lower, upper, 1, 5, 5)), std::invalid_argument);
+    EXPECT_THROW((evs::OrientationTable<evs::XZY>(upper, lower, 5, 5, 5)), std::invalid_argument);
+}
+
+TEST(OrientationTableUnitTest, TestBatchLookup) {
+    evs::OrientationTable<evs::ZYX> table(evs::EulerAngles(0, 0, 0), evs::EulerAngles(1, 1, 1), 11, 11, 11);
+    std::vector<double> alphas{ 0.0, 0.33, 0.71, 1.0 }, betas{ 0.5, 0.12, 0.99, 1.0 }, gammas{ 0.25, 0.8, 0.05, 1.0 };
+    evs::MatrixArray output;
+
+    table.lookup(alphas, betas, gammas, output);
+    ASSERT_EQ(output.size(), alphas.size()) << "batch lookup output size error";
+    for (std::size_t i = 0; i < alphas.size(); i++) {
+        EXPECT_TRUE(output.get(i).compare_to(table.lookup(evs::EulerAngles(alphas[i], betas[i], gammas[i])), 0.0))
+            << "batch lookup differs from single lookup at " << i;
+    }
+
+    betas[2] = 1.5;
+    EXPECT_THROW(table.lookup(alphas, betas, gammas, output), std::out_of_range);
+    betas.pop_back();
+    EXPECT_THROW(table.lookup(alphas, betas, gammas, output), std::out_of_range);
+}
+
+TEST(OrientationTableUnitTest, TestSaveAndLoad) {
+    evs::OrientationTable<evs::XYX, evs::ExtrinsicRotation> table(
+        evs::EulerAngles(-0.5, 0.2, -3), evs::EulerAngles(0.5, 2.2, 3), 7, 9, 13);
+    std::stringstream stream;
+    table.save(stream);
+
+    const std::string bytes = stream.str();
+    std::istringstream input(bytes);
+    auto loaded = evs::OrientationTable<evs::XYX, evs::ExtrinsicRotation>::load(input);
+    EXPECT_EQ(loaded.size(), table.size()) << "loaded table size error";
+    COMPARE_VECTOR(loaded.upper(), table.upper(), "loaded table upper angles error");
+    EXPECT_DOUBLE_EQ(loaded.error_bound(), table.error_bound()) << "loaded table error bound error";
+    const evs::EulerAngles angles(0.123, 1.456, -2.789);
+    EXPECT_TRUE(loaded.lookup(angles).compare_to(table.lookup(angles), 0.0)) << "loaded table lookup error";
+
+    std::istringstream wrong_type(bytes);
+    EXPECT_THROW((evs::OrientationTable<evs::XYX>::load(wrong_type)), std::runtime_error);
+    std::istringstream truncated(bytes.substr(0, bytes.size() - 8));
+    EXPECT_THROW((evs::OrientationTable<evs::XYX, evs::ExtrinsicRotation>::load(truncated)), std::runtime_error);
+    std::istringstream garbage("not a table at all, not a table at all, not a table at all");
+    EXPECT_THROW((evs::OrientationTable<evs::XYX, evs::ExtrinsicRotation>::load(garbage)), std::runtime_error);
+}
+
+TEST(OrientationTableUnitTest, TestLoadCorruptCounts) {
+    typedef evs::OrientationTable<evs::ZYX> Table;
+    Table table(evs::EulerAngles(-1, -1, -1), evs::EulerAngles(1, 1, 1), 40, 41, 42);
+    std::stringstream stream;
+    table.save(stream);
+    const std::string bytes = stream.str();
+
+    // the counts follow the magic and the two ids
+    auto with_counts = [&bytes](std::uint64_t count1, std::uint64_t count2, std::uint64_t count3) {
+        const std::uint64_t counts[3] = { count1, count2, count3 };
+        std::string result = bytes;
+        std::memcpy(&result[16], counts, sizeof(counts));
+        return result;
+    };
+
+    // a product which overflows, and one which is too large to address
+    std::istringstream overflow(with_counts(1ull << 32, 1ull << 32, 1ull << 32));
+    EXPECT_THROW(Table::load(overflow), std::runtime_error) << "overflowing counts";
+    std::istringstream huge(with_counts(1ull << 20, 1ull << 20, 1ull << 20));
+    EXPECT_THROW(Table::load(huge), std::runtime_error) << "unaddressable counts";
+
+    // more nodes than the stream holds, seekable and not
+    std::istringstream claimed(with_counts(1000, 1000, 1000));
+    EXPECT_THROW(Table::load(claimed), std::runtime_error) << "counts past the end of the stream";
+    std::string claimed_bytes = with_counts(1000, 1000, 1000);
+    UnseekableBuffer claimed_buffer(claimed_bytes);
+    std::istream unseekable_claimed(&claimed_buffer);
+    EXPECT_THROW(Table::load(unseekable_claimed), std::runtime_error) << "unseekable counts past the end";
+
+    // a valid table still loads without seeking, across several chunks
+    std::string valid_bytes = bytes;
+    UnseekableBuffer valid_buffer(valid_bytes);
+    std::istream unseekable(&valid_buffer);
+    const Table loaded = Table::load(unseekable);
+    EXPECT_EQ(loaded.size(), table.size()) << "unseekable loaded table size error";
+    const evs::EulerAngles angles(0.3, -0.7, 0.9);
+    EXPECT_TRUE(loaded.lookup(angles).compare_to(table.lookup(angles), 0.0)) << "unseekable loaded lookup error";
+}
@@ -0,0 +1,120 @@
+/**
+* Test files are built using cmake precompiled headers which are made
+* visible to this file when building tests and are not explicitly
+* included.
+*
+*/
+
+#include <matrix.hpp>
+#include <vector.hpp>
+#include <matrix_array.hpp>
+#include <quaternion.hpp>
+#include <quaternion_array.hpp>
+#include <cmath>        // std::sqrt
+#include <stdexcept>    // std::out_of_range
+#include <vector>       // std::vector
+#include <gtest/gtest.h>
+#include <helpers.hpp>
+
+namespace evs = evspace;
+
+TEST(QuaternionArrayUnitTest, TestCreation) {
+    evs::QuaternionArray empty;
+    EXPECT_EQ(empty.size(), 0) << "Default QuaternionArray size error";
+
+    evs::QuaternionArray identities(3);
+    EXPECT_EQ(identities.size(), 3) << "Sized QuaternionArray size error";
+    for (std::size_t i = 0; i < identities.size(); i++) {
+        EXPECT_EQ(identities.get(i), evs::Quaternion()) << "Sized QuaternionArray initial value error";
+    }
+
+    std::vector<evs::Quaternion> quaternions{ evs::Quaternion(1, 2, 3, 4), evs::Quaternion(5, 6, 7, 8) };
+    evs::QuaternionArray array(quaternions);
+    EXPECT_EQ(array.size(), 2) << "QuaternionArray from span size error";
+    EXPECT_EQ(array.w()[0], 1) << "QuaternionArray w plane error";
+    EXPECT_EQ(array.x()[1], 6) << "QuaternionArray x plane error";
+    EXPECT_EQ(array.y()[0], 3) << "QuaternionArray y plane error";
+    EXPECT_EQ(array.z()[1], 8) << "QuaternionArray z plane error";
+}
+
+TEST(QuaternionArrayUnitTest, TestAccess) {
+    evs::QuaternionArray array(2);
+    array.set(1, evs::Quaternion(0.5, 0.5, -0.5, 0.5));
+    const evs::Quaternion value = array.get(1);
+    EXPECT_EQ(value[0], 0.5) << "QuaternionArray set error";
+    EXPECT_EQ(value[2], -0.5) << "QuaternionArray set error";
+
+    EXPECT_THROW(array.get(2), std::out_of_range) << "QuaternionArray get out of range";
+    EXPECT_THROW(array.set(2, evs::Quaternion()), std::out_of_range) << "QuaternionArray set out of range";
+}
+
+TEST(QuaternionArrayUnitTest, TestResize) {
+    std::vector<evs::Quaternion> quaternions{ evs::Quaternion(0, 1, 0, 0), evs::Quaternion(0, 0, 1, 0) };
+    evs::QuaternionArray array(quaternions);
+
+    array.resize(3);
+    EXPECT_EQ(array.size(), 3) << "QuaternionArray grow size error";
+    EXPECT_EQ(array.get(0), quaternions[0]) << "QuaternionArray grow preserved value error";
+    EXPECT_EQ(array.get(1), quaternions[1]) << "QuaternionArray grow preserved value error";
+    EXPECT_EQ(array.get(2), evs::Quaternion()) << "QuaternionArray grow new value error";
+
+    array.resize(1);
+    EXPECT_EQ(array.size(), 1) << "QuaternionArray shrink size error";
+    EXPECT_EQ(array.get(0), quaternions[0]) << "QuaternionArray shrink preserved value error";
+
+    // slots reused after a shrink start over as the identity
+    array.resize(2);
+    EXPECT_EQ(array.get(1), evs::Quaternion()) << "QuaternionArray regrown new value error";
+
+    // growing one quaternion at a time reallocates geometrically and
+    // carries every earlier quaternion over
+    evs::QuaternionArray grown;
+    std::size_t growths = 0;
+    for (std::size_t i = 0; i < 600; i++) {
+        const std::size_t capacity = grown.capacity();
+        grown.resize(i + 1);
+        grown.set(i, evs::Quaternion(1.0, 0.001 * i, -0.002 * i, 0.5));
+        if (grown.capacity() != capacity) {
+            growths++;
+            for (std::size_t j = 0; j <= i; j++) {
+                EXPECT_EQ(grown.get(j), evs::Quaternion(1.0, 0.001 * j, -0.002 * j, 0.5))
+                    << "QuaternionArray growth preserved value error at " << j;
+            }
+        }
+    }
+    EXPECT_LE(growths, 11u) << "QuaternionArray growth is not geometric";
+
+    evs::QuaternionArray reserved;
+    reserved.reserve(50);
+    EXPECT_EQ(reserved.size(), 0) << "QuaternionArray reserve size error";
+    EXPECT_EQ(reserved.capacity(), 50) << "QuaternionArray reserve capacity error";
+    reserved.resize(50);
+    EXPECT_EQ(reserved.capacity(), 50) << "QuaternionArray reserved resize reallocated";
+    EXPECT_EQ(reserved.get(49), evs::Quaternion()) << "QuaternionArray reserved resize new value error";
+}
+
+TEST(QuaternionArrayUnitTest, TestBatch) {
+    // more than one chunk, with a partial last chunk
+    const std::size_t count = 601;
+    std::vector<evs::Quaternion> quaternions;
+    for (std::size_t i = 0; i < count; i++) {
+        const double t = static_cast<double>(i);
+        quaternions.push_back(evs::Quaternion(1.0 + 0.01 * t, std::sin(t), -2.0, 0.5 * std::cos(t)));
+    }
+    evs::QuaternionArray array(quaternions);
+
+    array.normalize();
+    evs::MatrixArray matrices;
+    array.to_matrices(matrices);
+    ASSERT_EQ(matrices.size(), count);
+    for (std::size_t i = 0; i < count; i++) {
+        evs::Quaternion expected = quaternions[i];
+        expected.normalize();
+        const evs::Quaternion normalized = array.get(i);
+        for (std::size_t k = 0; k < 4; k++) {
+            EXPECT_NEAR(normalized[k], expected[k], 1e-15) << "QuaternionArray normalize error at " << i;
+        }
+        EXPECT_TRUE(matrices.get(i).compare_to(normalized.to_matrix(), 0.0, 1e-15))
+            << "QuaternionArray to_matrices error at " << i;
+    }
+}
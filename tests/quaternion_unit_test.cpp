@@ -0,0 +1,92 @@
+/**
+* Test files are built using cmake precompiled headers which are made
+* visible to this file when building tests and are not explicitly
+* included.
+*
+*/
+
+#include <angles.hpp>
+#include <vector.hpp>
+#include <matrix.hpp>
+#include <rotation.hpp>
+#include <quaternion.hpp>
+#include <resources/test_rotation_matrices.hpp>
+#include <resources/test_rotation_vectors.hpp>
+#include <gtest/gtest.h>
+#include <helpers.hpp>
+
+namespace evs = evspace;
+
+TEST(QuaternionUnitTest, TestCreation) {
+    evs::Quaternion identity;
+    EXPECT_EQ(identity[0], 1.0) << "Default quaternion scalar part error";
+    EXPECT_EQ(identity[1], 0.0) << "Default quaternion x part error";
+    EXPECT_EQ(identity[2], 0.0) << "Default quaternion y part error";
+    EXPECT_EQ(identity[3], 0.0) << "Default quaternion z part error";
+    COMPARE_MATRIX(identity.to_matrix(), create_array({ {1, 0, 0}, {0, 1, 0}, {0, 0, 1} }), "Identity quaternion matrix error");
+
+    evs::Quaternion q(1, 2, 3, 4);
+    EXPECT_EQ(q[3], 4.0) << "Quaternion component constructor error";
+    EXPECT_THROW(q[4], std::out_of_range) << "Quaternion index out of range";
+    EXPECT_DOUBLE_EQ(q.norm(), std::sqrt(30.0)) << "Quaternion norm error";
+    q.normalize();
+    EXPECT_DOUBLE_EQ(q.norm(), 1.0) << "Quaternion normalize error";
+
+    evs::Quaternion conjugate = q.conjugate();
+    EXPECT_EQ(conjugate[0], q[0]) << "Quaternion conjugate scalar error";
+    EXPECT_EQ(conjugate[1], -q[1]) << "Quaternion conjugate vector error";
+    evs::Quaternion product = q * conjugate;
+    EXPECT_EQ(product, evs::Quaternion()) << "Quaternion times conjugate is not identity";
+}
+
+TEST(QuaternionUnitTest, TestMatrixConversion) {
+    const evs::EulerAngles angles = evs::EulerAngles(EVSPACE_PI / 6, EVSPACE_PI_4, EVSPACE_PI / 3);
+    evs::Quaternion q = evs::compute_rotation_quaternion<evs::XYZ, evs::IntrinsicRotation>(angles);
+    _COMPARE_MATRIX_NEAR(q.to_matrix(), create_array(XYZ_ROTATION_MATRIX), "XYZ quaternion matrix error");
+    q = evs::compute_rotation_quaternion<evs::ZXZ, evs::IntrinsicRotation>(angles);
+    _COMPARE_MATRIX_NEAR(q.to_matrix(), create_array(ZXZ_ROTATION_MATRIX), "ZXZ quaternion matrix error");
+
+    const evs::EulerAngles reversed = evs::EulerAngles(EVSPACE_PI / 3, EVSPACE_PI_4, EVSPACE_PI / 6);
+    q = evs::compute_rotation_quaternion<evs::ZYX, evs::ExtrinsicRotation>(reversed);
+    _COMPARE_MATRIX_NEAR(q.to_matrix(), create_array(XYZ_ROTATION_MATRIX), "XYZ extrinsic quaternion matrix error");
+
+    q = evs::compute_rotation_quaternion<evs::YAxis>(EVSPACE_PI_4);
+    _COMPARE_MATRIX_NEAR(q.to_matrix(), create_array(Y_AXIS_ROTATION_MATRIX), "Y axis quaternion matrix error");
+    q = evs::compute_rotation_quaternion(EVSPACE_PI_4, evs::Vector(0, 0, 5));
+    _COMPARE_MATRIX_NEAR(q.to_matrix(), create_array(Z_AXIS_ROTATION_MATRIX), "Z axis vector quaternion matrix error");
+
+    // every branch of the matrix conversion
+    const evs::EulerAngles samples[] = {
+        evs::EulerAngles(0.1, 0.2, 0.3),
+        evs::EulerAngles(3.0, 0.1, 0.0),
+        evs::EulerAngles(0.0, 3.0, 0.1),
+        evs::EulerAngles(0.1, 0.0, 3.0),
+    };
+    for (const auto& sample : samples) {
+        evs::Matrix matrix = evs::compute_rotation_matrix<evs::XYZ>(sample);
+        evs::Quaternion from_matrix(matrix);
+        EXPECT_EQ(from_matrix, evs::compute_rotation_quaternion<evs::XYZ>(sample)) << "Quaternion from matrix error";
+        EXPECT_TRUE(from_matrix.to_matrix().compare_to(matrix, 1e-12, 1e-12)) << "Quaternion matrix round trip error";
+    }
+}
+
+TEST(QuaternionUnitTest, TestRotation) {
+    const evs::EulerAngles angles = evs::EulerAngles(EVSPACE_PI / 6, EVSPACE_PI_4, EVSPACE_PI / 3);
+    const evs::Vector test_vector = evs::Vector(1, 2, 3);
+    const evs::Vector offset_vector = evs::Vector(10, 20, 30);
+    evs::Quaternion q = evs::compute_rotation_quaternion<evs::XYZ>(angles);
+
+    _COMPARE_VECTOR_NEAR(evs::rotate_to(q, test_vector), create_array(XYZ_ROTATION_TO), "quaternion rotate to error");
+    _COMPARE_VECTOR_NEAR(evs::rotate_from(q, test_vector), create_array(XYZ_ROTATION_FROM), "quaternion rotate from error");
+    _COMPARE_VECTOR_NEAR(evs::rotate_to(q, test_vector, offset_vector), create_array(XYZ_ROTATION_OFFSET_TO),
+        "quaternion rotate to offset error");
+    _COMPARE_VECTOR_NEAR(evs::rotate_from(q, test_vector, offset_vector), create_array(XYZ_ROTATION_OFFSET_FROM),
+        "quaternion rotate from offset error");
+
+    // products compose like matrix products
+    evs::Quaternion q2 = evs::compute_rotation_quaternion<evs::XAxis>(0.3);
+    evs::Matrix answer = q.to_matrix() * q2.to_matrix();
+    EXPECT_TRUE((q * q2).to_matrix().compare_to(answer, 0.0, ABS_ERROR)) << "quaternion product error";
+    q *= q2;
+    EXPECT_TRUE(q.to_matrix().compare_to(answer, 0.0, ABS_ERROR)) << "quaternion inplace product error";
+}
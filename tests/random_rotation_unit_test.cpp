@@ -0,0 +1,181 @@
+/**
+* Test files are built using cmake precompiled headers which are made
+* visible to this file when building tests and are not explicitly
+* included.
+*
+*/
+
+#include <matrix.hpp>
+#include <vector.hpp>
+#include <matrix_array.hpp>
+#include <vector_array.hpp>
+#include <quaternion.hpp>
+#include <quaternion_array.hpp>
+#include <rotation.hpp>
+#include <random_rotation.hpp>
+#include <array>        // std::array
+#include <cmath>        // std::sqrt, std::fabs
+#include <cstdint>      // std::uint32_t
+#include <string>       // std::string
+#include <gtest/gtest.h>
+#include <helpers.hpp>
+
+namespace evs = evspace;
+
+namespace {
+
+    // Sample mean and mean square of a plane.
+    void moments(const double* values, std::size_t count, double& mean, double& mean_square) {
+        mean = 0.0;
+        mean_square = 0.0;
+        for (std::size_t i = 0; i < count; i++) {
+            mean += values[i];
+            mean_square += values[i] * values[i];
+        }
+        mean /= static_cast<double>(count);
+        mean_square /= static_cast<double>(count);
+    }
+
+}
+
+TEST(RandomRotationUnitTest, TestPhilox) {
+    // known answers of Philox4x32-10 from the Random123 distribution
+    const evs::Philox zero(0);
+    const std::array<std::uint32_t, 4> zero_block = zero.block({ 0, 0, 0, 0 });
+    const std::array<std::uint32_t, 4> zero_expected = { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 };
+    EXPECT_EQ(zero_block, zero_expected);
+
+    const evs::Philox ones(0xffffffffffffffffULL);
+    const std::array<std::uint32_t, 4> ones_block = ones.block({ 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff });
+    const std::array<std::uint32_t, 4> ones_expected = { 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd };
+    EXPECT_EQ(ones_block, ones_expected);
+
+    const evs::Philox pi(0x299f31d0a4093822ULL);
+    const std::array<std::uint32_t, 4> pi_block = pi.block({ 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 });
+    const std::array<std::uint32_t, 4> pi_expected = { 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 };
+    EXPECT_EQ(pi_block, pi_expected);
+
+    evs::Philox generator(42, 7);
+    EXPECT_EQ(generator.stream(), 7u);
+    EXPECT_EQ(generator.position(), 0u);
+    const std::array<double, 4> first = generator.uniform();
+    EXPECT_EQ(generator.position(), 1u);
+    for (double value : first) {
+        EXPECT_GE(value, 0.0);
+        EXPECT_LT(value, 1.0);
+    }
+    generator.seek(0);
+    EXPECT_EQ(generator.uniform(), first);
+    EXPECT_NE(evs::Philox(42, 8).uniform(), first);
+    EXPECT_NE(evs::Philox(43, 7).uniform(), first);
+}
+
+TEST(RandomRotationUnitTest, TestReproducible) {
+    // batches use consecutive draws, so one batch and two halves agree,
+    // whatever the chunking and threading
+    const std::size_t count = 20000;
+    evs::Philox whole(5, 1), halves(5, 1);
+    evs::VectorArray all, first, second;
+    evs::random_unit_vectors(whole, count, all);
+    EXPECT_EQ(whole.position(), count);
+    evs::random_unit_vectors(halves, 7001, first);
+    evs::random_unit_vectors(halves, count - 7001, second);
+    EXPECT_EQ(halves.position(), count);
+    for (std::size_t i = 0; i < count; i++) {
+        const evs::Vector expected = all.get(i);
+        const evs::Vector actual = i < 7001 ? first.get(i) : second.get(i - 7001);
+        COMPARE_VECTOR_NEAR(actual, expected, "batch split", 0.0);
+    }
+
+    // the quaternion and matrix outputs are the same rotations
+    evs::Philox quaternion_generator(9), matrix_generator(9);
+    evs::QuaternionArray quaternions;
+    evs::MatrixArray matrices;
+    evs::random_rotations(quaternion_generator, 601, quaternions);
+    evs::random_rotations(matrix_generator, 601, matrices);
+    for (std::size_t i = 0; i < 601; i++) {
+        EXPECT_TRUE(matrices.get(i).compare_to(quaternions.get(i).to_matrix(), 0.0, 0.0)) << i;
+    }
+}
+
+TEST(RandomRotationUnitTest, TestDistributions) {
+    const std::size_t count = 40000;
+    // about five standard errors of a mean of unit variance values
+    const double tolerance = 5.0 / std::sqrt(static_cast<double>(count));
+    evs::Philox generator(2024);
+
+    // uniform rotations average to zero, each component with variance 1/3
+    evs::QuaternionArray quaternions;
+    evs::MatrixArray rotations;
+    evs::random_rotations(generator, count, quaternions);
+    quaternions.to_matrices(rotations);
+    for (std::size_t i = 0; i < count; i += 97) {
+        EXPECT_NEAR(quaternions.get(i).norm(), 1.0, 1e-15);
+    }
+    for (std::size_t component = 0; component < 9; component++) {
+        double mean, mean_square;
+        moments(rotations.plane(component / 3, component % 3), count, mean, mean_square);
+        EXPECT_NEAR(mean, 0.0, tolerance) << "rotation component " << component;
+        EXPECT_NEAR(mean_square, 1.0 / 3.0, tolerance) << "rotation component " << component;
+    }
+
+    evs::VectorArray directions;
+    evs::random_unit_vectors(generator, count, directions);
+    const double* direction_planes[3] = { directions.x(), directions.y(), directions.z() };
+    for (std::size_t i = 0; i < count; i += 97) {
+        EXPECT_NEAR(directions.get(i).magnitude(), 1.0, 1e-15);
+    }
+    for (std::size_t k = 0; k < 3; k++) {
+        double mean, mean_square;
+        moments(direction_planes[k], count, mean, mean_square);
+        EXPECT_NEAR(mean, 0.0, tolerance) << "direction component " << k;
+        EXPECT_NEAR(mean_square, 1.0 / 3.0, tolerance) << "direction component " << k;
+    }
+
+    evs::VectorArray normals;
+    evs::random_normal_vectors(generator, count, normals);
+    const double* normal_planes[3] = { normals.x(), normals.y(), normals.z() };
+    for (std::size_t k = 0; k < 3; k++) {
+        double mean, mean_square;
+        moments(normal_planes[k], count, mean, mean_square);
+        EXPECT_NEAR(mean, 0.0, tolerance) << "normal component " << k;
+        EXPECT_NEAR(mean_square, 1.0, 2.0 * tolerance) << "normal component " << k;
+    }
+    EXPECT_EQ(generator.position(), 3 * count);
+}
+
+TEST(RandomRotationUnitTest, TestPerturbations) {
+    const std::size_t count = 40000;
+    const evs::Matrix mean = evs::compute_rotation_matrix<evs::ZYX>(evs::EulerAngles(0.4, -0.3, 1.2));
+    const evs::Vector sigmas(1e-3, 2e-3, 5e-4);
+    evs::Philox generator(77);
+    evs::MatrixArray rotations;
+    evs::random_perturbations(generator, mean, sigmas, count, rotations);
+    ASSERT_EQ(rotations.size(), count);
+
+    // mean^T * rotation is exp([theta]x), small enough to read theta from
+    // its skew part
+    double sums[3] = { 0.0, 0.0, 0.0 }, squares[3] = { 0.0, 0.0, 0.0 };
+    for (std::size_t i = 0; i < count; i++) {
+        const evs::Matrix rotation = rotations.get(i);
+        const evs::Matrix relative = mean.transpose() * rotation;
+        if (i % 97 == 0) {
+            EXPECT_TRUE((rotation.transpose() * rotation).compare_to(evs::Matrix::IDENTITY, 0.0, 1e-15)) << i;
+        }
+        const double theta[3] = { 0.5 * (relative(2, 1) - relative(1, 2)), 0.5 * (relative(0, 2) - relative(2, 0)),
+                                  0.5 * (relative(1, 0) - relative(0, 1)) };
+        for (std::size_t k = 0; k < 3; k++) {
+            sums[k] += theta[k];
+            squares[k] += theta[k] * theta[k];
+        }
+    }
+    const double tolerance = 5.0 / std::sqrt(static_cast<double>(count));
+    for (std::size_t k = 0; k < 3; k++) {
+        EXPECT_NEAR(sums[k] / count / sigmas[k], 0.0, tolerance) << "perturbation axis " << k;
+        EXPECT_NEAR(std::sqrt(squares[k] / count) / sigmas[k], 1.0, tolerance) << "perturbation axis " << k;
+    }
+
+    // zero deviations give the mean itself
+    evs::random_perturbations(generator, mean, evs::Vector(), 3, rotations);
+    EXPECT_TRUE(rotations.get(2).compare_to(mean, 0.0, 0.0));
+}
@@ -0,0 +1,174 @@
+/**
+* Test files are built using cmake precompiled headers which are made
+* visible to this file when building tests and are not explicitly
+* included.
+*
+*/
+
+#include <angles.hpp>
+#include <vector.hpp>
+#include <matrix.hpp>
+#include <rotation.hpp>
+#include <reference_frame_array.hpp>
+#include <resources/test_rotation_matrices.hpp>
+#include <resources/test_rotation_vectors.hpp>
+#include <gtest/gtest.h>
+#include <helpers.hpp>
+
+namespace evs = evspace;
+
+TEST(ReferenceFrameArrayUnitTest, TestCreation) {
+    evs::ReferenceFrameArray<evs::XYZ> empty;
+    EXPECT_EQ(empty.size(), 0) << "Default ReferenceFrameArray size error";
+    EXPECT_EQ(empty.begin(), empty.end()) << "Empty ReferenceFrameArray iterator error";
+
+    evs::ReferenceFrameArray<evs::XYZ> frames(2);
+    EXPECT_EQ(frames.size(), 2) << "Sized ReferenceFrameArray size error";
+    COMPARE_MATRIX(frames[1].get_matrix(), create_array({ {1, 0, 0}, {0, 1, 0}, {0, 0, 1} }),
+        "Sized ReferenceFrameArray identity matrix error");
+
+    const evs::EulerAngles angles = evs::EulerAngles(EVSPACE_PI / 6, EVSPACE_PI_4, EVSPACE_PI / 3);
+    const evs::Vector offset = evs::Vector(10, 20, 30);
+    frames.push_back(angles, offset);
+    EXPECT_EQ(frames.size(), 3) << "ReferenceFrameArray push_back size error";
+    _COMPARE_MATRIX_NEAR(frames[2].get_matrix(), create_array(XYZ_ROTATION_MATRIX), "push_back matrix error");
+    COMPARE_VECTOR(frames[2].get_offset(), offset, "push_back offset error");
+    EXPECT_EQ(frames[2].get_angles()[1], angles[1]) << "push_back angles error";
+    EXPECT_THROW(frames[3], std::out_of_range) << "ReferenceFrameArray index out of range";
+}
+
+TEST(ReferenceFrameArrayUnitTest, TestFrameProxy) {
+    const evs::EulerAngles angles = evs::EulerAngles(EVSPACE_PI / 6, EVSPACE_PI_4, EVSPACE_PI / 3);
+    const evs::Vector test_vector = evs::Vector(1, 2, 3);
+    const evs::Vector offset_vector = evs::Vector(10, 20, 30);
+    evs::ReferenceFrameArray<evs::XZY> frames(3);
+
+    auto frame = frames[1];
+    frame.set_angles(angles);
+    _COMPARE_MATRIX_NEAR(frame.get_matrix(), create_array(XZY_ROTATION_MATRIX), "proxy set angles matrix error");
+    _COMPARE_VECTOR_NEAR(frame.rotate_to(test_vector), create_array(XZY_ROTATION_TO), "proxy rotate to error");
+    _COMPARE_VECTOR_NEAR(frame.rotate_from(test_vector), create_array(XZY_ROTATION_FROM), "proxy rotate from error");
+
+    frame.set_offset(offset_vector);
+    _COMPARE_VECTOR_NEAR(frame.rotate_to(test_vector), create_array(XZY_ROTATION_OFFSET_TO),
+        "proxy rotate to offset error");
+    _COMPARE_VECTOR_NEAR(frame.rotate_from(test_vector), create_array(XZY_ROTATION_OFFSET_FROM),
+        "proxy rotate from offset error");
+
+    frame.set_angles(0, 0.0);
+    auto answer = evs::compute_rotation_matrix<evs::XZY>(evs::EulerAngles(0.0, angles[1], angles[2]));
+    EXPECT_TRUE(frame.get_matrix().compare_to(answer, 0.0, ABS_ERROR)) << "proxy set single angle error";
+    EXPECT_THROW(frame.set_angles(3, 0.0), std::out_of_range) << "proxy set angle index out of range";
+
+    // const access and iteration
+    const auto& const_frames = frames;
+    std::size_t count = 0;
+    for (auto const_frame : const_frames) {
+        EXPECT_EQ(const_frame.index(), count++) << "const iteration index error";
+    }
+    EXPECT_EQ(count, frames.size()) << "const iteration count error";
+    for (auto mutable_frame : frames) {
+        mutable_frame.set_offset(offset_vector);
+    }
+    COMPARE_VECTOR(const_frames[2].get_offset(), offset_vector, "mutable iteration set offset error");
+}
+
+template<typename order, typename type>
+void check_update_all(const char* name) {
+    const std::size_t size = 300;
+    evs::ReferenceFrameArray<order, type> frames(size);
+    for (std::size_t i = 0; i < size; i++) {
+        frames.alpha()[i] = -3.0 + 0.02 * i;
+        frames.beta()[i] = 1.5 - 0.01 * i;
+        frames.gamma()[i] = 0.5 + 0.05 * i;
+    }
+    frames.update_all();
+
+    for (const auto& frame : frames) {
+        evs::Matrix answer = evs::compute_rotation_matrix<order, type>(frame.get_angles());
+        EXPECT_TRUE(frame.get_matrix().compare_to(answer, 0.0, 1e-14)) << name << " update_all matrix error";
+    }
+}
+
+TEST(ReferenceFrameArrayUnitTest, TestUpdateAll) {
+    check_update_all<evs::XYZ, evs::IntrinsicRotation>("XYZ intrinsic");
+    check_update_all<evs::YXZ, evs::IntrinsicRotation>("YXZ intrinsic");
+    check_update_all<evs::ZYX, evs::ExtrinsicRotation>("ZYX extrinsic");
+    check_update_all<evs::XYX, evs::IntrinsicRotation>("XYX intrinsic");
+    check_update_all<evs::ZXZ, evs::ExtrinsicRotation>("ZXZ extrinsic");
+    check_update_all<evs::YZY, evs::ExtrinsicRotation>("YZY extrinsic");
+}
+
+TEST(ReferenceFrameArrayUnitTest, TestResize) {
+    evs::ReferenceFrameArray<evs::ZXZ> frames(1);
+    frames[0].set_angles(evs::EulerAngles(0.1, 0.2, 0.3));
+    frames.resize(4);
+    EXPECT_EQ(frames.size(), 4) << "ReferenceFrameArray grow size error";
+    EXPECT_EQ(frames[0].get_angles()[2], 0.3) << "ReferenceFrameArray grow preserved angle error";
+    COMPARE_MATRIX(frames[3].get_matrix(), create_array({ {1, 0, 0}, {0, 1, 0}, {0, 0, 1} }),
+        "ReferenceFrameArray grow new matrix error");
+
+    frames.resize(1);
+    EXPECT_EQ(frames.size(), 1) << "ReferenceFrameArray shrink size error";
+    EXPECT_EQ(frames[0].get_angles()[1], 0.2) << "ReferenceFrameArray shrink preserved angle error";
+}
+
+TEST(ReferenceFrameArrayUnitTest, TestPushBackGrowth) {
+    auto angles_at = [](std::size_t i) {
+        return evs::EulerAngles(-3.0 + 0.006 * i, 1.5 - 0.003 * i, 0.5 + 0.004 * i);
+    };
+    auto offset_at = [](std::size_t i) {
+        return evs::Vector(static_cast<double>(i), -2.0 * i, 0.5 * i);
+    };
+    auto check_frames = [&](const evs::ReferenceFrameArray<evs::XYZ>& frames, std::size_t count) {
+        for (std::size_t i = 0; i < count; i++) {
+            const evs::EulerAngles angles = angles_at(i);
+            for (std::size_t k = 0; k < 3; k++) {
+                EXPECT_EQ(frames[i].get_angles()[k], angles[k]) << "push_back preserved angle error at " << i;
+            }
+            COMPARE_VECTOR(frames[i].get_offset(), offset_at(i), "push_back preserved offset error");
+            const evs::Matrix answer = evs::compute_rotation_matrix<evs::XYZ>(angles);
+            EXPECT_TRUE(frames[i].get_matrix().compare_to(answer, 0.0, 1e-14))
+                << "push_back preserved matrix error at " << i;
+        }
+    };
+
+    // every reallocation has to carry the earlier frames over
+    evs::ReferenceFrameArray<evs::XYZ> frames;
+    std::size_t growths = 0;
+    for (std::size_t i = 0; i < 1000; i++) {
+        const std::size_t capacity = frames.capacity();
+        frames.push_back(angles_at(i), offset_at(i));
+        EXPECT_EQ(frames.size(), i + 1) << "push_back size error";
+        EXPECT_GE(frames.capacity(), frames.size()) << "push_back capacity error";
+        if (frames.capacity() != capacity) {
+            growths++;
+            check_frames(frames, i + 1);
+        }
+    }
+    EXPECT_GE(growths, 5u) << "push_back growth is not geometric";
+    EXPECT_LE(growths, 12u) << "push_back growth is not geometric";
+
+    // a reserved array doesn't reallocate while filling up to the capacity
+    evs::ReferenceFrameArray<evs::XYZ> reserved;
+    reserved.reserve(300);
+    EXPECT_EQ(reserved.size(), 0) << "reserve size error";
+    EXPECT_GE(reserved.capacity(), 300u) << "reserve capacity error";
+    const std::size_t capacity = reserved.capacity();
+    for (std::size_t i = 0; i < 300; i++) {
+        reserved.push_back(angles_at(i), offset_at(i));
+    }
+    EXPECT_EQ(reserved.capacity(), capacity) << "reserved push_back reallocated";
+    check_frames(reserved, 300);
+
+    // slots reused after a shrink start over as identity frames
+    reserved.resize(10);
+    reserved.resize(20);
+    check_frames(reserved, 10);
+    for (std::size_t i = 10; i < 20; i++) {
+        EXPECT_EQ(reserved[i].get_angles()[0], 0.0) << "regrown angle error at " << i;
+        COMPARE_VECTOR(reserved[i].get_offset(), evs::Vector(), "regrown offset error");
+        COMPARE_MATRIX(reserved[i].get_matrix(), create_array({ {1, 0, 0}, {0, 1, 0}, {0, 0, 1} }),
+            "regrown matrix error");
+    }
+}
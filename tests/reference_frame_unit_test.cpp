@@ -9,6 +9,8 @@
 #include <vector.hpp>
 #include <matrix.hpp>
 #include <rotation.hpp>
+#include <compact_reference_frame.hpp>
+#include <vector>       // std::vector
 #include <resources/test_rotation_matrices.hpp>
 #include <resources/test_rotation_vectors.hpp>
 #include <gtest/gtest.h>
@@ -475,3 +477,181 @@ TEST(ReferenceFrameUnitTest, TestBetweenFramesVectors) {
     result = frame_ZXZ_extrinsic.rotate_from(frame_YZY, result);
     _COMPARE_VECTOR_NEAR(result, test_vector, "rotate vector from offset YZY to offset extrinsic ZXZ error");
 }
+
+TEST(ReferenceFrameUnitTest, TestRotationOnlyFrame) {
+    evs::EulerAngles angles_from = evs::EulerAngles(EVSPACE_PI / 6, EVSPACE_PI_4, EVSPACE_PI / 3);
+    evs::EulerAngles angles_to = evs::EulerAngles(0, EVSPACE_PI_4, EVSPACE_PI / 2);
+    const evs::Vector offset_to = evs::Vector(100, 200, 300);
+    const evs::Vector test_vector = evs::Vector(1, 2, 3);
+    evs::Vector result;
+
+    auto frame = evs::ReferenceFrame<evs::XYZ, evs::IntrinsicRotation, evs::WithoutOffset>(angles_from);
+    _COMPARE_MATRIX_NEAR(frame.get_matrix(), create_array(XYZ_ROTATION_MATRIX), "rotation only matrix error");
+    COMPARE_VECTOR(frame.get_offset(), evs::Vector(0, 0, 0), "rotation only offset error");
+    _COMPARE_VECTOR_NEAR(frame.rotate_to(test_vector), create_array(XYZ_ROTATION_TO), "rotation only rotate to error");
+    _COMPARE_VECTOR_NEAR(frame.rotate_from(test_vector), create_array(XYZ_ROTATION_FROM),
+        "rotation only rotate from error");
+
+    // frame to frame rotations mixing rotation only and offset frames
+    auto frame_YXY = evs::ReferenceFrame<evs::YXY, evs::IntrinsicRotation, evs::WithoutOffset>(angles_to);
+    result = frame.rotate_to(frame_YXY, test_vector);
+    _COMPARE_VECTOR_NEAR(result, create_array(FROM_XYZ_TO_YXY_ROTATION), "rotation only XYZ to YXY error");
+    result = frame.rotate_from(frame_YXY, result);
+    _COMPARE_VECTOR_NEAR(result, test_vector, "rotation only YXY to XYZ error");
+
+    auto offset_YXY = evs::ReferenceFrame<evs::YXY>(angles_to, offset_to);
+    result = frame.rotate_to(offset_YXY, test_vector);
+    _COMPARE_VECTOR_NEAR(result, create_array(FROM_XYZ_TO_OFFSET_YXY_ROTATION), "rotation only XYZ to offset YXY error");
+    result = offset_YXY.rotate_to(frame, offset_YXY.rotate_from(frame, test_vector));
+    _COMPARE_VECTOR_NEAR(result, test_vector, "offset YXY to rotation only XYZ error");
+
+    frame.set_angles(angles_to);
+    EXPECT_TRUE(frame.get_matrix().compare_to(evs::compute_rotation_matrix<evs::XYZ>(angles_to), 0.0, ABS_ERROR))
+        << "rotation only set angles error";
+    EXPECT_LT(sizeof(frame), sizeof(offset_YXY)) << "rotation only frame stores an offset";
+}
+
+TEST(ReferenceFrameUnitTest, TestRotatingFrameState) {
+    // frame spinning about the inertial z-axis, currently aligned with the inertial frame
+    const evs::Vector spin = evs::Vector(0, 0, 1);
+    auto frame = evs::RotatingReferenceFrame<evs::ZYX>(evs::EulerAngles(0, 0, 0), spin);
+    COMPARE_VECTOR(frame.get_angular_velocity(), spin, "RotatingReferenceFrame angular velocity getter error");
+
+    // a point at rest in the inertial frame appears to move opposite the spin
+    evs::State inertial{ evs::Vector(1, 0, 0), evs::Vector(0, 0, 0) };
+    evs::State rotated = frame.rotate_to(inertial);
+    _COMPARE_VECTOR_NEAR(rotated.position, create_array({ 1, 0, 0 }), "rotate state to spinning frame position error");
+    _COMPARE_VECTOR_NEAR(rotated.velocity, create_array({ 0, -1, 0 }), "rotate state to spinning frame velocity error");
+
+    // a point at rest in the rotating frame moves with the spin
+    evs::State fixed{ evs::Vector(0, 2, 0), evs::Vector(0, 0, 0) };
+    evs::State moving = frame.rotate_from(fixed);
+    _COMPARE_VECTOR_NEAR(moving.velocity, create_array({ -2, 0, 0 }), "rotate state from spinning frame velocity error");
+
+    // general frame round trip
+    const evs::EulerAngles angles = evs::EulerAngles(EVSPACE_PI / 6, EVSPACE_PI_4, EVSPACE_PI / 3);
+    const evs::Vector offset = evs::Vector(10, 20, 30);
+    auto general = evs::RotatingReferenceFrame<evs::XYZ>(angles, evs::Vector(0.1, -0.2, 0.3), offset);
+    evs::State state{ evs::Vector(1, 2, 3), evs::Vector(-4, 5, -6) };
+    evs::State to = general.rotate_to(state);
+    evs::Vector answer = general.rotate_to(state.position);
+    _COMPARE_VECTOR_NEAR(to.position, answer, "rotate state to position differs from vector rotation");
+    evs::State back = general.rotate_from(to);
+    _COMPARE_VECTOR_NEAR(back.position, state.position, "rotating frame state round trip position error");
+    _COMPARE_VECTOR_NEAR(back.velocity, state.velocity, "rotating frame state round trip velocity error");
+
+    // transport term matches hand computation with vector_cross
+    evs::Vector relative = state.position - offset;
+    answer = (state.velocity - evs::vector_cross(general.get_angular_velocity(), relative)) * general.get_matrix();
+    _COMPARE_VECTOR_NEAR(to.velocity, answer, "rotate state to velocity transport term error");
+
+    // between two rotating frames
+    auto other = evs::RotatingReferenceFrame<evs::ZXZ, evs::ExtrinsicRotation>(
+        evs::EulerAngles(0, EVSPACE_PI_4, EVSPACE_PI_2), evs::Vector(0, 0.5, 0));
+    evs::State between = general.rotate_to(other, state);
+    evs::State expected = other.rotate_to(general.rotate_from(state));
+    _COMPARE_VECTOR_NEAR(between.position, expected.position, "rotate state between frames position error");
+    _COMPARE_VECTOR_NEAR(between.velocity, expected.velocity, "rotate state between frames velocity error");
+    evs::State returned = general.rotate_from(other, between);
+    _COMPARE_VECTOR_NEAR(returned.position, state.position, "rotate state between frames round trip position error");
+    _COMPARE_VECTOR_NEAR(returned.velocity, state.velocity, "rotate state between frames round trip velocity error");
+}
+
+TEST(ReferenceFrameUnitTest, TestRotatingFrameBatchState) {
+    const evs::EulerAngles angles = evs::EulerAngles(EVSPACE_PI / 6, EVSPACE_PI_4, EVSPACE_PI / 3);
+    auto frame = evs::RotatingReferenceFrame<evs::YZX>(angles, evs::Vector(0.1, -0.2, 0.3), evs::Vector(1, 2, 3));
+
+    std::vector<evs::Vector> positions{ evs::Vector(1, 2, 3), evs::Vector(-7, 0, 2), evs::Vector(0, 0, 0) };
+    std::vector<evs::Vector> velocities{ evs::Vector(0, 1, 0), evs::Vector(3, 3, 3), evs::Vector(-1, 0, 5) };
+    evs::VectorArray position_array(positions), velocity_array(velocities);
+    evs::VectorArray out_positions, out_velocities;
+
+    frame.rotate_to(position_array, velocity_array, out_positions, out_velocities);
+    ASSERT_EQ(out_positions.size(), positions.size()) << "batch rotate state to output size error";
+    for (std::size_t i = 0; i < positions.size(); i++) {
+        evs::State answer = frame.rotate_to(evs::State{ positions[i], velocities[i] });
+        _COMPARE_VECTOR_NEAR(out_positions.get(i), answer.position, "batch rotate state to position error");
+        _COMPARE_VECTOR_NEAR(out_velocities.get(i), answer.velocity, "batch rotate state to velocity error");
+    }
+
+    // in place round trip
+    frame.rotate_from(out_positions, out_velocities, out_positions, out_velocities);
+    for (std::size_t i = 0; i < positions.size(); i++) {
+        _COMPARE_VECTOR_NEAR(out_positions.get(i), positions[i], "batch rotate state round trip position error");
+        _COMPARE_VECTOR_NEAR(out_velocities.get(i), velocities[i], "batch rotate state round trip velocity error");
+    }
+
+    evs::VectorArray short_array(1);
+    EXPECT_THROW(frame.rotate_to(position_array, short_array, out_positions, out_velocities), std::out_of_range)
+        << "batch rotate state with mismatched sizes";
+}
+
+TEST(ReferenceFrameUnitTest, TestCompactFrame) {
+    const evs::EulerAngles angles = evs::EulerAngles(EVSPACE_PI / 6, EVSPACE_PI_4, EVSPACE_PI / 3);
+    const evs::Vector test_vector = evs::Vector(1, 2, 3);
+    const evs::Vector offset_vector = evs::Vector(10, 20, 30);
+
+    EXPECT_EQ(sizeof(evs::CompactReferenceFrame<evs::XYZ>), 56) << "CompactReferenceFrame is not compact";
+
+    auto frame = evs::CompactReferenceFrame<evs::XYZ>(angles);
+    _COMPARE_MATRIX_NEAR(frame.get_matrix(), create_array(XYZ_ROTATION_MATRIX), "compact frame matrix error");
+    evs::EulerAngles frame_angles = frame.get_angles();
+    EXPECT_NEAR(frame_angles[0], angles[0], ABS_ERROR) << "compact frame alpha angle error";
+    EXPECT_NEAR(frame_angles[1], angles[1], ABS_ERROR) << "compact frame beta angle error";
+    EXPECT_NEAR(frame_angles[2], angles[2], ABS_ERROR) << "compact frame gamma angle error";
+    _COMPARE_VECTOR_NEAR(frame.rotate_to(test_vector), create_array(XYZ_ROTATION_TO), "compact frame rotate to error");
+    _COMPARE_VECTOR_NEAR(frame.rotate_from(test_vector), create_array(XYZ_ROTATION_FROM), "compact frame rotate from error");
+
+    frame.set_offset(offset_vector);
+    COMPARE_VECTOR(frame.get_offset(), offset_vector, "compact frame set offset error");
+    _COMPARE_VECTOR_NEAR(frame.rotate_to(test_vector), create_array(XYZ_ROTATION_OFFSET_TO),
+        "compact frame rotate to offset error");
+    _COMPARE_VECTOR_NEAR(frame.rotate_from(test_vector), create_array(XYZ_ROTATION_OFFSET_FROM),
+        "compact frame rotate from offset error");
+
+    // matches the full frame it was built from
+    auto full = evs::ReferenceFrame<evs::ZXZ, evs::ExtrinsicRotation>(angles, offset_vector);
+    auto compact = evs::CompactReferenceFrame<evs::ZXZ, evs::ExtrinsicRotation>(full);
+    EXPECT_TRUE(compact.get_matrix().compare_to(full.get_matrix(), 0.0, ABS_ERROR))
+        << "compact frame from ReferenceFrame matrix error";
+    auto full_other = evs::ReferenceFrame<evs::YXY>(evs::EulerAngles(0, EVSPACE_PI_4, EVSPACE_PI_2));
+    auto compact_other = evs::CompactReferenceFrame<evs::YXY>(full_other);
+    _COMPARE_VECTOR_NEAR(compact.rotate_to(compact_other, test_vector), full.rotate_to(full_other, test_vector),
+        "compact frame rotate to frame error");
+    _COMPARE_VECTOR_NEAR(compact.rotate_from(compact_other, test_vector), full.rotate_from(full_other, test_vector),
+        "compact frame rotate from frame error");
+
+    frame.set_angles(evs::EulerAngles(0, 0, 0));
+    _COMPARE_MATRIX_NEAR(frame.get_matrix(), create_array({ {1, 0, 0}, {0, 1, 0}, {0, 0, 1} }),
+        "compact frame set angles error");
+}
+
+TEST(ReferenceFrameUnitTest, TestCompactFrameBatchAndCache) {
+    const evs::EulerAngles angles = evs::EulerAngles(EVSPACE_PI / 6, EVSPACE_PI_4, EVSPACE_PI / 3);
+    auto frame = evs::CompactReferenceFrame<evs::XZY>(angles, evs::Vector(1, 2, 3));
+    auto other = evs::CompactReferenceFrame<evs::XZY>(evs::EulerAngles(0.1, 0.2, 0.3));
+
+    std::vector<evs::Vector> vectors{ evs::Vector(1, 2, 3), evs::Vector(-4, 0, 9) };
+    evs::VectorArray input(vectors), output;
+    frame.rotate_to(input, output);
+    for (std::size_t i = 0; i < vectors.size(); i++) {
+        _COMPARE_VECTOR_NEAR(output.get(i), frame.rotate_to(vectors[i]), "compact frame batch rotate to error");
+    }
+    frame.rotate_from(output, output);
+    for (std::size_t i = 0; i < vectors.size(); i++) {
+        _COMPARE_VECTOR_NEAR(output.get(i), vectors[i], "compact frame batch round trip error");
+    }
+
+    evs::DerivedMatrixCache<1> cache;
+    evs::Matrix cached = frame.get_matrix(cache);
+    EXPECT_TRUE(cached.compare_to(frame.get_matrix(), 0)) << "cached matrix differs from derived matrix";
+    cached = frame.get_matrix(cache);
+    EXPECT_EQ(cache.hits(), 1) << "matrix cache hit count error";
+    EXPECT_EQ(cache.misses(), 1) << "matrix cache miss count error";
+
+    // capacity of one evicts the older entry
+    EXPECT_TRUE(other.get_matrix(cache).compare_to(other.get_matrix(), 0)) << "cached matrix after eviction error";
+    frame.get_matrix(cache);
+    EXPECT_EQ(cache.misses(), 3) << "matrix cache eviction error";
+    EXPECT_EQ(cache.size(), 1) << "matrix cache size error";
+}
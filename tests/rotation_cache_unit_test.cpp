@@ -0,0 +1,155 @@
+/**
+* Test files are built using cmake precompiled headers which are made
+* visible to this file when building tests and are not explicitly
+* included.
+*
+*/
+
+#include <angles.hpp>
+#include <vector.hpp>
+#include <matrix.hpp>
+#include <rotation.hpp>
+#include <rotation_cache.hpp>
+#include <gtest/gtest.h>
+#include <helpers.hpp>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace evs = evspace;
+
+TEST(RotationCacheUnitTest, TestLookup) {
+    evs::RotationMatrixCache cache(64, 4);
+    const evs::EulerAngles angles = evs::EulerAngles(0.3, -1.1, 2.4);
+
+    EXPECT_EQ(cache.capacity(), 64) << "cache capacity error";
+    evs::Matrix matrix = evs::compute_rotation_matrix<evs::ZYX>(angles, cache);
+    EXPECT_TRUE(matrix.compare_to(evs::compute_rotation_matrix<evs::ZYX>(angles), 0.0))
+        << "cached matrix differs from derived matrix";
+    EXPECT_EQ(cache.misses(), 1) << "cache miss count error";
+    EXPECT_EQ(cache.hits(), 0) << "cache hit count error";
+
+    matrix = evs::compute_rotation_matrix<evs::ZYX>(angles, cache);
+    EXPECT_TRUE(matrix.compare_to(evs::compute_rotation_matrix<evs::ZYX>(angles), 0.0))
+        << "cache hit matrix error";
+    EXPECT_EQ(cache.hits(), 1) << "cache hit count error";
+
+    // order, type and the sign of zero are all part of the key
+    matrix = evs::compute_rotation_matrix<evs::ZYX, evs::ExtrinsicRotation>(angles, cache);
+    EXPECT_TRUE(matrix.compare_to(evs::compute_rotation_matrix<evs::ZYX, evs::ExtrinsicRotation>(angles), 0.0))
+        << "cached extrinsic matrix error";
+    evs::compute_rotation_matrix<evs::XYZ>(angles, cache);
+    evs::compute_rotation_matrix<evs::XYZ>(evs::EulerAngles(0.0, 0.0, 0.0), cache);
+    evs::compute_rotation_matrix<evs::XYZ>(evs::EulerAngles(-0.0, 0.0, 0.0), cache);
+    EXPECT_EQ(cache.misses(), 5) << "cache key error";
+    EXPECT_EQ(cache.size(), 5) << "cache size error";
+
+    cache.clear();
+    cache.reset_counters();
+    EXPECT_EQ(cache.size(), 0) << "cache clear error";
+    EXPECT_EQ(cache.hits() + cache.misses(), 0) << "cache reset counters error";
+
+    EXPECT_THROW(evs::RotationMatrixCache(0), std::invalid_argument);
+    EXPECT_THROW(evs::RotationMatrixCache(8, 0), std::invalid_argument);
+}
+
+TEST(RotationCacheUnitTest, TestEviction) {
+    // a single shard makes the CLOCK order deterministic
+    evs::RotationMatrixCache cache(3, 1);
+    const evs::EulerAngles a(0.1, 0.2, 0.3), b(0.4, 0.5, 0.6), c(0.7, 0.8, 0.9), d(1.0, 1.1, 1.2);
+
+    cache.lookup<evs::XYZ>(a);
+    cache.lookup<evs::XYZ>(b);
+    cache.lookup<evs::XYZ>(c);
+    cache.lookup<evs::XYZ>(a);
+    EXPECT_EQ(cache.hits(), 1) << "cache hit before eviction error";
+
+    // a was referenced so it gets a second chance and b is evicted
+    cache.lookup<evs::XYZ>(d);
+    EXPECT_EQ(cache.size(), 3) << "cache exceeded its capacity";
+    cache.lookup<evs::XYZ>(a);
+    EXPECT_EQ(cache.hits(), 2) << "referenced entry was evicted";
+    cache.lookup<evs::XYZ>(b);
+    EXPECT_EQ(cache.misses(), 5) << "unreferenced entry was not evicted";
+
+    for (int i = 0; i < 100; i++) {
+        evs::EulerAngles angles(0.01 * i, 0.0, 0.0);
+        EXPECT_TRUE(cache.lookup<evs::XYZ>(angles).compare_to(evs::compute_rotation_matrix<evs::XYZ>(angles), 0.0))
+            << "matrix error after eviction";
+    }
+    EXPECT_EQ(cache.size(), 3) << "cache exceeded its capacity";
+}
+
+TEST(RotationCacheUnitTest, TestCachedRotations) {
+    evs::RotationMatrixCache cache;
+    const evs::EulerAngles angles = evs::EulerAngles(EVSPACE_PI / 6, EVSPACE_PI_4, EVSPACE_PI / 3);
+    const evs::Vector vector(1, 2, 3), offset(-4, 0.5, 9);
+
+    for (int repeat = 0; repeat < 2; repeat++) {
+        // the comparison macros evaluate their arguments once per component
+        const evs::Vector from = evs::rotate_from<evs::XYX>(angles, vector, cache);
+        const evs::Vector from_offset = evs::rotate_from<evs::XYX>(angles, vector, offset, cache);
+        const evs::Vector to = evs::rotate_to<evs::XYX>(angles, vector, cache);
+        const evs::Vector to_offset = evs::rotate_to<evs::XYX>(angles, vector, offset, cache);
+        _COMPARE_VECTOR_NEAR(from, (evs::rotate_from<evs::XYX>(angles, vector)), "cached rotate from error");
+        _COMPARE_VECTOR_NEAR(from_offset, (evs::rotate_from<evs::XYX>(angles, vector, offset)),
+            "cached rotate from offset error");
+        _COMPARE_VECTOR_NEAR(to, (evs::rotate_to<evs::XYX>(angles, vector)), "cached rotate to error");
+        _COMPARE_VECTOR_NEAR(to_offset, (evs::rotate_to<evs::XYX>(angles, vector, offset)),
+            "cached rotate to offset error");
+    }
+    EXPECT_EQ(cache.misses(), 1) << "cached rotations miss count error";
+    EXPECT_EQ(cache.hits(), 7) << "cached rotations hit count error";
+
+    // the cache is transparent, matching the uncached matrix path exactly
+    const evs::Matrix matrix = evs::compute_rotation_matrix<evs::XYX>(angles);
+    const evs::Vector results[4] = {
+        evs::rotate_from<evs::XYX>(angles, vector, cache), evs::rotate_from<evs::XYX>(angles, vector, offset, cache),
+        evs::rotate_to<evs::XYX>(angles, vector, cache), evs::rotate_to<evs::XYX>(angles, vector, offset, cache)
+    };
+    const evs::Vector answers[4] = {
+        evs::rotate_from(matrix, vector), evs::rotate_from(matrix, vector, offset),
+        evs::rotate_to(matrix, vector), evs::rotate_to(matrix, vector, offset)
+    };
+    for (std::size_t n = 0; n < 4; n++) {
+        for (std::size_t i = 0; i < 3; i++) {
+            EXPECT_EQ(results[n][i], answers[n][i]) << "cached rotation " << n << " not exact at index " << i;
+        }
+    }
+
+    evs::ReferenceFrame<evs::ZXZ, evs::ExtrinsicRotation> frame(evs::EulerAngles(0, 0, 0), offset);
+    frame.set_angles(angles, cache);
+    EXPECT_TRUE(frame.get_matrix().compare_to(
+        evs::compute_rotation_matrix<evs::ZXZ, evs::ExtrinsicRotation>(angles), 0.0)) << "cached set angles error";
+    frame.set_angles(1, 0.25, cache);
+    EXPECT_TRUE(frame.get_matrix().compare_to(evs::compute_rotation_matrix<evs::ZXZ, evs::ExtrinsicRotation>(
+        evs::EulerAngles(EVSPACE_PI / 6, 0.25, EVSPACE_PI / 3)), 0.0)) << "cached set angle error";
+}
+
+TEST(RotationCacheUnitTest, TestConcurrentLookup) {
+    evs::RotationMatrixCache cache(256, 8);
+    const std::size_t thread_count = 4, lookups = 2000, distinct = 64;
+
+    std::vector<std::thread> threads;
+    std::vector<int> errors(thread_count, 0);
+    for (std::size_t t = 0; t < thread_count; t++) {
+        threads.emplace_back([&cache, &errors, t, lookups, distinct]() {
+            for (std::size_t i = 0; i < lookups; i++) {
+                evs::EulerAngles angles(0.05 * ((i + t) % distinct), 0.3, -0.7);
+                evs::Matrix answer = evs::compute_rotation_matrix<evs::YXY>(angles);
+                if (!cache.lookup<evs::YXY>(angles).compare_to(answer, 0.0)) {
+                    errors[t]++;
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    for (std::size_t t = 0; t < thread_count; t++) {
+        EXPECT_EQ(errors[t], 0) << "concurrent lookup error in thread " << t;
+    }
+    EXPECT_EQ(cache.hits() + cache.misses(), thread_count * lookups) << "concurrent counter error";
+    EXPECT_LE(cache.size(), distinct) << "concurrent insert duplicated entries";
+}
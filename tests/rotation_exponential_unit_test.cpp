@@ -0,0 +1,84 @@
+/**
+* Test files are built using cmake precompiled headers which are made
+* visible to this file when building tests and are not explicitly
+* included.
+*
+*/
+
+#include <matrix.hpp>
+#include <vector.hpp>
+#include <matrix_array.hpp>
+#include <vector_array.hpp>
+#include <rotation.hpp>
+#include <rotation_exponential.hpp>
+#include <cmath>        // std::sin, std::cos
+#include <stdexcept>    // std::out_of_range
+#include <string>       // std::string, std::to_string
+#include <vector>       // std::vector
+#include <gtest/gtest.h>
+#include <helpers.hpp>
+
+namespace evs = evspace;
+
+TEST(RotationExponentialUnitTest, TestSingle) {
+    const evs::Vector omega(0.3, -1.2, 0.5);
+    const evs::RotationExponential exponential(omega);
+    EXPECT_DOUBLE_EQ(exponential.rate(), omega.magnitude());
+    const evs::Vector axis = exponential.axis();
+    const evs::Vector expected_axis = omega.norm();
+    COMPARE_VECTOR_NEAR(axis, expected_axis, "RotationExponential axis", 1e-15);
+
+    const double times[] = { 0.0, 0.25, -1.7, 3.0, 40.0 };
+    for (double t : times) {
+        const evs::Matrix expected = evs::compute_rotation_matrix(omega.magnitude() * t, omega);
+        EXPECT_TRUE(exponential.at(t).compare_to(expected, 0.0, 1e-14)) << "time " << t;
+        EXPECT_TRUE(evs::compute_rotation_exponential(omega, t).compare_to(expected, 0.0, 1e-14)) << "time " << t;
+    }
+
+    // a rotation of the body by omega * t, so rotating omega leaves it
+    const evs::Vector rotated = exponential.at(2.3) * omega;
+    COMPARE_VECTOR_NEAR(rotated, omega, "RotationExponential fixed axis", 1e-15);
+
+    // exponentials of the same angular velocity compose by adding times
+    EXPECT_TRUE((exponential.at(0.6) * exponential.at(1.1)).compare_to(exponential.at(1.7), 0.0, 1e-15));
+
+    // small angles keep their precision, where 1 - cos(angle) would not
+    const evs::Matrix small = exponential.at(1e-9);
+    const double angle = omega.magnitude() * 1e-9;
+    EXPECT_NEAR(small(0, 1), -angle * expected_axis[2] + angle * angle / 2.0 * expected_axis[0] * expected_axis[1],
+                1e-24);
+
+    // a zero angular velocity is the identity at every time
+    const evs::RotationExponential zero;
+    EXPECT_EQ(zero.rate(), 0.0);
+    EXPECT_TRUE(zero.at(5.0).compare_to(evs::Matrix::IDENTITY, 0.0, 0.0));
+    EXPECT_TRUE(evs::RotationExponential(evs::Vector()).at(5.0).compare_to(evs::Matrix::IDENTITY, 0.0, 0.0));
+}
+
+TEST(RotationExponentialUnitTest, TestBatch) {
+    // more than one chunk, with a partial last chunk
+    const std::size_t count = 601;
+    std::vector<double> times;
+    std::vector<evs::Vector> omegas;
+    for (std::size_t i = 0; i < count; i++) {
+        const double t = static_cast<double>(i);
+        times.push_back(-3.0 + 0.01 * t);
+        omegas.push_back(i % 50 == 9 ? evs::Vector() : evs::Vector(std::sin(t), -0.4 + 0.001 * t, std::cos(0.3 * t)));
+    }
+    const evs::VectorArray omega_array(omegas);
+
+    const evs::RotationExponential exponential(omegas[1]);
+    evs::MatrixArray at_times, elementwise;
+    exponential.at(times, at_times);
+    evs::compute_rotation_exponential(omega_array, times, elementwise);
+    ASSERT_EQ(at_times.size(), count);
+    ASSERT_EQ(elementwise.size(), count);
+    for (std::size_t i = 0; i < count; i++) {
+        const std::string msg = "batch element " + std::to_string(i);
+        EXPECT_TRUE(at_times.get(i).compare_to(exponential.at(times[i]), 0.0, 1e-15)) << msg;
+        const evs::Matrix expected = evs::compute_rotation_exponential(omegas[i], times[i]);
+        EXPECT_TRUE(elementwise.get(i).compare_to(expected, 0.0, 1e-15)) << msg;
+    }
+
+    EXPECT_THROW(evs::compute_rotation_exponential(evs::VectorArray(3), times, elementwise), std::out_of_range);
+}
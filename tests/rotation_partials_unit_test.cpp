@@ -0,0 +1,165 @@
+/**
+* Test files are built using cmake precompiled headers which are made
+* visible to this file when building tests and are not explicitly
+* included.
+*
+*/
+
+#include <angles.hpp>
+#include <matrix.hpp>
+#include <vector.hpp>
+#include <matrix_array.hpp>
+#include <vector_array.hpp>
+#include <rotation.hpp>
+#include <dual.hpp>
+#include <rotation_partials.hpp>
+#include <array>        // std::array
+#include <cmath>        // std::sin, std::cos
+#include <stdexcept>    // std::out_of_range
+#include <string>       // std::string, std::to_string
+#include <vector>       // std::vector
+#include <gtest/gtest.h>
+#include <helpers.hpp>
+
+namespace evs = evspace;
+
+namespace {
+
+    const double pi = 3.14159265358979323846;
+
+    // Checks the closed form partials of one order and type against dual
+    // numbers, which differentiate the rotation code itself.
+    template<typename rotation_order, typename rotation_type>
+    void check_partials(const evs::EulerAngles& angles, const std::string& msg) {
+        evs::Matrix rotation, partials[3];
+        evs::compute_rotation_partials<rotation_order, rotation_type>(angles, rotation, partials[0], partials[1],
+                                                                      partials[2]);
+        const evs::Matrix expected = evs::compute_rotation_matrix<rotation_order, rotation_type>(angles);
+        EXPECT_TRUE(rotation.compare_to(expected, 0.0, 1e-15)) << msg;
+
+        const std::array<evs::Dual<3>, 3> dual_angles = { evs::Dual<3>(angles[0], 0), evs::Dual<3>(angles[1], 1),
+                                                          evs::Dual<3>(angles[2], 2) };
+        const std::array<evs::Dual<3>, 9> dual =
+            evs::compute_rotation_matrix<rotation_order, rotation_type>(dual_angles);
+        for (std::size_t n = 0; n < 3; n++) {
+            for (std::size_t k = 0; k < 9; k++) {
+                EXPECT_NEAR(partials[n](k / 3, k % 3), dual[k].derivative(n), 1e-15)
+                    << msg << " partial " << n << " component " << k;
+            }
+        }
+
+        const evs::Vector vector(0.3, -1.2, 2.0);
+        evs::Matrix jacobian, dual_jacobian, vector_jacobian;
+        const evs::Vector from = evs::rotate_from_partials<rotation_order, rotation_type>(angles, vector, jacobian);
+        const evs::Vector expected_from = evs::rotate_from<rotation_order, rotation_type>(angles, vector);
+        COMPARE_VECTOR_NEAR(from, expected_from, msg + " rotate_from value", 1e-15);
+        evs::rotate_from_jacobian<rotation_order, rotation_type>(angles, vector, dual_jacobian, vector_jacobian);
+        EXPECT_TRUE(jacobian.compare_to(dual_jacobian, 0.0, 1e-15)) << msg << " rotate_from";
+
+        const evs::Vector to = evs::rotate_to_partials<rotation_order, rotation_type>(angles, vector, jacobian);
+        const evs::Vector expected_to = evs::rotate_to<rotation_order, rotation_type>(angles, vector);
+        COMPARE_VECTOR_NEAR(to, expected_to, msg + " rotate_to value", 1e-15);
+        evs::rotate_to_jacobian<rotation_order, rotation_type>(angles, vector, dual_jacobian, vector_jacobian);
+        EXPECT_TRUE(jacobian.compare_to(dual_jacobian, 0.0, 1e-15)) << msg << " rotate_to";
+    }
+
+    template<typename rotation_order>
+    void check_order(const std::string& name) {
+        const evs::EulerAngles cases[] = {
+            evs::EulerAngles(0.4, -1.1, 2.6),
+            evs::EulerAngles(-2.9, 0.2, -0.7),
+            // gimbal lock doesn't trouble the partials
+            evs::EulerAngles(0.5, pi / 2.0, 1.0),
+            evs::EulerAngles(0.5, 0.0, -1.0),
+        };
+        for (std::size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+            check_partials<rotation_order, evs::IntrinsicRotation>(cases[i], name + " intrinsic " + std::to_string(i));
+            check_partials<rotation_order, evs::ExtrinsicRotation>(cases[i], name + " extrinsic " + std::to_string(i));
+        }
+    }
+
+}
+
+TEST(RotationPartialsUnitTest, TestAllOrders) {
+    check_order<evs::XYZ>("XYZ");
+    check_order<evs::XZY>("XZY");
+    check_order<evs::YXZ>("YXZ");
+    check_order<evs::YZX>("YZX");
+    check_order<evs::ZXY>("ZXY");
+    check_order<evs::ZYX>("ZYX");
+    check_order<evs::XYX>("XYX");
+    check_order<evs::XZX>("XZX");
+    check_order<evs::YXY>("YXY");
+    check_order<evs::YZY>("YZY");
+    check_order<evs::ZXZ>("ZXZ");
+    check_order<evs::ZYZ>("ZYZ");
+}
+
+TEST(RotationPartialsUnitTest, TestBatch) {
+    // more than one chunk, with a partial last chunk
+    const std::size_t count = 601;
+    std::vector<double> alphas, betas, gammas;
+    std::vector<evs::Vector> vectors;
+    for (std::size_t i = 0; i < count; i++) {
+        const double t = static_cast<double>(i);
+        alphas.push_back(std::sin(0.1 * t) * 3.0);
+        betas.push_back(std::cos(0.23 * t) * 1.5);
+        gammas.push_back(-2.0 + 0.01 * t);
+        vectors.push_back(evs::Vector(1.0 + std::sin(t), -0.5, std::cos(0.7 * t)));
+    }
+    const evs::VectorArray vector_array(vectors);
+
+    evs::MatrixArray rotations, d_alpha, d_beta, d_gamma;
+    evs::compute_rotation_partials<evs::ZYX, evs::ExtrinsicRotation>(alphas, betas, gammas, rotations,
+                                                                     d_alpha, d_beta, d_gamma);
+    evs::VectorArray from, from_alpha, from_beta, from_gamma, to, to_alpha, to_beta, to_gamma;
+    evs::rotate_from_partials<evs::ZYX, evs::ExtrinsicRotation>(alphas, betas, gammas, vector_array,
+                                                                from, from_alpha, from_beta, from_gamma);
+    evs::rotate_to_partials<evs::ZYX, evs::ExtrinsicRotation>(alphas, betas, gammas, vector_array,
+                                                              to, to_alpha, to_beta, to_gamma);
+    ASSERT_EQ(rotations.size(), count);
+    ASSERT_EQ(d_gamma.size(), count);
+    ASSERT_EQ(from.size(), count);
+    ASSERT_EQ(to_gamma.size(), count);
+
+    for (std::size_t i = 0; i < count; i++) {
+        const std::string msg = "batch element " + std::to_string(i);
+        const evs::EulerAngles angles(alphas[i], betas[i], gammas[i]);
+        evs::Matrix rotation, partials[3];
+        evs::compute_rotation_partials<evs::ZYX, evs::ExtrinsicRotation>(angles, rotation, partials[0], partials[1],
+                                                                         partials[2]);
+        EXPECT_TRUE(rotations.get(i).compare_to(rotation, 0.0, 1e-15)) << msg;
+        EXPECT_TRUE(d_alpha.get(i).compare_to(partials[0], 0.0, 1e-15)) << msg;
+        EXPECT_TRUE(d_beta.get(i).compare_to(partials[1], 0.0, 1e-15)) << msg;
+        EXPECT_TRUE(d_gamma.get(i).compare_to(partials[2], 0.0, 1e-15)) << msg;
+
+        evs::Matrix jacobian;
+        const evs::Vector expected_from = evs::rotate_from_partials<evs::ZYX, evs::ExtrinsicRotation>(
+            angles, vectors[i], jacobian);
+        const evs::Vector batch_from = from.get(i);
+        COMPARE_VECTOR_NEAR(batch_from, expected_from, msg, 1e-14);
+        const evs::Vector from_columns[3] = { from_alpha.get(i), from_beta.get(i), from_gamma.get(i) };
+        for (std::size_t n = 0; n < 3; n++) {
+            for (std::size_t r = 0; r < 3; r++) {
+                EXPECT_NEAR(from_columns[n][r], jacobian(r, n), 1e-14) << msg;
+            }
+        }
+
+        const evs::Vector expected_to = evs::rotate_to_partials<evs::ZYX, evs::ExtrinsicRotation>(
+            angles, vectors[i], jacobian);
+        const evs::Vector batch_to = to.get(i);
+        COMPARE_VECTOR_NEAR(batch_to, expected_to, msg, 1e-14);
+        const evs::Vector to_columns[3] = { to_alpha.get(i), to_beta.get(i), to_gamma.get(i) };
+        for (std::size_t n = 0; n < 3; n++) {
+            for (std::size_t r = 0; r < 3; r++) {
+                EXPECT_NEAR(to_columns[n][r], jacobian(r, n), 1e-14) << msg;
+            }
+        }
+    }
+
+    std::vector<double> short_gammas(gammas.begin(), gammas.end() - 1);
+    EXPECT_THROW((evs::compute_rotation_partials<evs::ZYX>(alphas, betas, short_gammas, rotations, d_alpha, d_beta,
+                                                           d_gamma)), std::out_of_range);
+    EXPECT_THROW((evs::rotate_to_partials<evs::ZYX>(alphas, betas, gammas, evs::VectorArray(3), to, to_alpha,
+                                                    to_beta, to_gamma)), std::out_of_range);
+}
@@ -390,4 +390,128 @@ TEST(RotationUnitTest, TestEulerFromToVectors) {
     result = evs::rotate_between<evs::ZXZ, evs::YZY, evs::ExtrinsicRotation, evs::IntrinsicRotation>(angles_from, angles_to, test_vector, offset_from, offset_to);
     answer = create_array(FROM_OFFSET_ZXZ_TO_OFFSET_YZY_ROTATION);
     _COMPARE_VECTOR_NEAR(result, answer, "rotate vector from offset extrinsic ZXZ to offset YZY error");
-}
\ No newline at end of file
+}
+
+template<typename order, typename type>
+void check_euler_angles(const evs::EulerAngles& angles, const char* name) {
+    evs::Matrix matrix = evs::compute_rotation_matrix<order, type>(angles);
+    evs::EulerAngles result = evs::compute_euler_angles<order, type>(matrix);
+    EXPECT_NEAR(result[0], angles[0], ABS_ERROR) << name << " alpha angle error";
+    EXPECT_NEAR(result[1], angles[1], ABS_ERROR) << name << " beta angle error";
+    EXPECT_NEAR(result[2], angles[2], ABS_ERROR) << name << " gamma angle error";
+}
+
+template<typename order, typename type>
+void check_euler_gimbal_lock(double beta, const char* name) {
+    evs::Matrix matrix = evs::compute_rotation_matrix<order, type>(evs::EulerAngles(0.3, beta, 0.2));
+    evs::EulerAngles result = evs::compute_euler_angles<order, type>(matrix);
+    evs::Matrix answer = evs::compute_rotation_matrix<order, type>(result);
+    EXPECT_TRUE(answer.compare_to(matrix, 1e-9, 1e-9)) << name << " gimbal lock angles error";
+}
+
+template<typename order>
+void check_euler_order(const char* name, bool proper) {
+    const evs::EulerAngles angles = proper ? evs::EulerAngles(-2.5, 1.2, 0.7) : evs::EulerAngles(-2.5, -0.9, 0.7);
+    check_euler_angles<order, evs::IntrinsicRotation>(angles, name);
+    check_euler_angles<order, evs::ExtrinsicRotation>(angles, name);
+    check_euler_gimbal_lock<order, evs::IntrinsicRotation>(proper ? 0.0 : EVSPACE_PI_2, name);
+    check_euler_gimbal_lock<order, evs::ExtrinsicRotation>(proper ? EVSPACE_PI : -EVSPACE_PI_2, name);
+}
+
+TEST(RotationUnitTest, TestComputeEulerAngles) {
+    check_euler_order<evs::XYZ>("XYZ", false);
+    check_euler_order<evs::XZY>("XZY", false);
+    check_euler_order<evs::YXZ>("YXZ", false);
+    check_euler_order<evs::YZX>("YZX", false);
+    check_euler_order<evs::ZXY>("ZXY", false);
+    check_euler_order<evs::ZYX>("ZYX", false);
+    check_euler_order<evs::XYX>("XYX", true);
+    check_euler_order<evs::XZX>("XZX", true);
+    check_euler_order<evs::YXY>("YXY", true);
+    check_euler_order<evs::YZY>("YZY", true);
+    check_euler_order<evs::ZXZ>("ZXZ", true);
+    check_euler_order<evs::ZYZ>("ZYZ", true);
+}
+
+template<typename order, typename type>
+void check_closed_form_matrix(const char* name) {
+    const double angles[3] = { 0.4, -1.1, 2.7 };
+    double cosines[3], sines[3], result[9];
+    for (int i = 0; i < 3; i++) {
+        cosines[i] = std::cos(angles[i]);
+        sines[i] = std::sin(angles[i]);
+    }
+
+    evs::_EulerAngleDelegate<order, type>::derive_matrix(cosines, sines, result);
+    evs::Matrix answer = evs::_EulerAngleDelegate<order, type>::derive_matrix(angles[0], angles[1], angles[2]);
+    for (int i = 0; i < 9; i++) {
+        EXPECT_NEAR(result[i], answer.data()[i], 1e-15) << name << " closed form matrix error at " << i;
+    }
+}
+
+template<typename order>
+void check_closed_form_order(const char* name) {
+    check_closed_form_matrix<order, evs::IntrinsicRotation>(name);
+    check_closed_form_matrix<order, evs::ExtrinsicRotation>(name);
+}
+
+TEST(RotationUnitTest, TestClosedFormEulerMatrix) {
+    check_closed_form_order<evs::XYZ>("XYZ");
+    check_closed_form_order<evs::XZY>("XZY");
+    check_closed_form_order<evs::YXZ>("YXZ");
+    check_closed_form_order<evs::YZX>("YZX");
+    check_closed_form_order<evs::ZXY>("ZXY");
+    check_closed_form_order<evs::ZYX>("ZYX");
+    check_closed_form_order<evs::XYX>("XYX");
+    check_closed_form_order<evs::XZX>("XZX");
+    check_closed_form_order<evs::YXY>("YXY");
+    check_closed_form_order<evs::YZY>("YZY");
+    check_closed_form_order<evs::ZXZ>("ZXZ");
+    check_closed_form_order<evs::ZYZ>("ZYZ");
+}
+
+template<typename order, typename type>
+void check_fused_euler_rotation(const char* name) {
+    SCOPED_TRACE(name);
+    const evs::EulerAngles angles = evs::EulerAngles(0.4, -1.1, 2.7);
+    const evs::EulerAngles other_angles = evs::EulerAngles(-2.2, 0.3, 1.4);
+    const evs::Vector vector = evs::Vector(1, -2, 3);
+    const evs::Vector offset = evs::Vector(10, 20, 30);
+    const evs::Vector other_offset = evs::Vector(-5, 7, 2);
+    const evs::Matrix matrix = evs::compute_rotation_matrix<order, type>(angles);
+    const evs::Matrix other_matrix = evs::compute_rotation_matrix<evs::ZXZ, type>(other_angles);
+
+    _COMPARE_VECTOR_NEAR((evs::rotate_from<order, type>(angles, vector)), evs::rotate_from(matrix, vector),
+        "fused rotate from error");
+    _COMPARE_VECTOR_NEAR((evs::rotate_to<order, type>(angles, vector)), evs::rotate_to(matrix, vector),
+        "fused rotate to error");
+    _COMPARE_VECTOR_NEAR((evs::rotate_from<order, type>(angles, vector, offset)), evs::rotate_from(matrix, vector, offset),
+        "fused rotate from offset error");
+    _COMPARE_VECTOR_NEAR((evs::rotate_to<order, type>(angles, vector, offset)), evs::rotate_to(matrix, vector, offset),
+        "fused rotate to offset error");
+
+    evs::Vector between = evs::rotate_between<order, evs::ZXZ, type, type>(angles, other_angles, vector, offset, other_offset);
+    _COMPARE_VECTOR_NEAR(between, evs::rotate_to(other_matrix, evs::rotate_from(matrix, vector, offset), other_offset),
+        "fused rotate between error");
+}
+
+template<typename order>
+void check_fused_euler_order(const char* name) {
+    check_fused_euler_rotation<order, evs::IntrinsicRotation>(name);
+    check_fused_euler_rotation<order, evs::ExtrinsicRotation>(name);
+}
+
+TEST(RotationUnitTest, TestFusedEulerRotation) {
+    check_fused_euler_order<evs::XYZ>("XYZ");
+    check_fused_euler_order<evs::XZY>("XZY");
+    check_fused_euler_order<evs::YXZ>("YXZ");
+    check_fused_euler_order<evs::YZX>("YZX");
+    check_fused_euler_order<evs::ZXY>("ZXY");
+    check_fused_euler_order<evs::ZYX>("ZYX");
+    check_fused_euler_order<evs::XYX>("XYX");
+    check_fused_euler_order<evs::XZX>("XZX");
+    check_fused_euler_order<evs::YXY>("YXY");
+    check_fused_euler_order<evs::YZY>("YZY");
+    check_fused_euler_order<evs::ZXZ>("ZXZ");
+    check_fused_euler_order<evs::ZYZ>("ZYZ");
+}
@@ -0,0 +1,74 @@
+/**
+* Test files are built using cmake precompiled headers which are made
+* visible to this file when building tests and are not explicitly
+* included.
+*
+*/
+
+#include <sincos.hpp>
+#include <cmath>        // std::sin, std::cos, std::isfinite, std::isnan
+#include <limits>       // std::numeric_limits
+#include <vector>       // std::vector
+#include <gtest/gtest.h>
+#include <helpers.hpp>
+
+namespace evs = evspace;
+
+TEST(SinCosUnitTest, TestScalar) {
+    // sweep several periods in both directions, including quadrant boundaries
+    for (int i = -2000; i <= 2000; i++) {
+        // explicit fma, the compiler may otherwise contract the expression
+        // differently for the two calls below when targeting FMA
+        const double angle = std::fma(i, EVSPACE_PI / 256.0, 1e-3 * (i % 7));
+        double sine, cosine;
+        evs::sincos(angle, sine, cosine);
+        EXPECT_NEAR(sine, std::sin(angle), 4e-16) << "sincos sine error at " << angle;
+        EXPECT_NEAR(cosine, std::cos(angle), 4e-16) << "sincos cosine error at " << angle;
+    }
+
+    // exact values of the reduced range
+    double sine, cosine;
+    evs::sincos(0.0, sine, cosine);
+    EXPECT_EQ(sine, 0.0) << "sincos zero sine error";
+    EXPECT_EQ(cosine, 1.0) << "sincos zero cosine error";
+
+    // large arguments use the library fallback
+    evs::sincos(1e7 + 0.5, sine, cosine);
+    EXPECT_DOUBLE_EQ(sine, std::sin(1e7 + 0.5)) << "sincos large argument sine error";
+    EXPECT_DOUBLE_EQ(cosine, std::cos(1e7 + 0.5)) << "sincos large argument cosine error";
+}
+
+TEST(SinCosUnitTest, TestBatch) {
+    std::vector<double> angles{ -3e5, -10.0, -EVSPACE_PI_2, -0.5, 0.0, 0.25, EVSPACE_PI_4, 3.0, 99.9, 5e6 };
+    std::vector<double> sines(angles.size()), cosines(angles.size());
+    evs::sincos(angles, sines, cosines);
+
+    for (std::size_t i = 0; i < angles.size(); i++) {
+        EXPECT_NEAR(sines[i], std::sin(angles[i]), 1e-15) << "batch sincos sine error at " << angles[i];
+        EXPECT_NEAR(cosines[i], std::cos(angles[i]), 1e-15) << "batch sincos cosine error at " << angles[i];
+    }
+
+    std::vector<double> short_output(2);
+    EXPECT_THROW(evs::sincos(angles, short_output, cosines), std::out_of_range) << "batch sincos size mismatch";
+}
+
+TEST(SinCosUnitTest, TestBatchNonFinite) {
+    // non-finite and huge angles mixed in with reducible ones, past a vector
+    // width on either side
+    const double infinity = std::numeric_limits<double>::infinity();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<double> angles{ 0.5, nan, -1.0, infinity, 2.0, -infinity, 1e300, -1e300, 3.0, 1e10, -4e9, 0.75 };
+    std::vector<double> sines(angles.size()), cosines(angles.size());
+    evs::sincos(angles, sines, cosines);
+
+    for (std::size_t i = 0; i < angles.size(); i++) {
+        if (std::isfinite(angles[i])) {
+            EXPECT_NEAR(sines[i], std::sin(angles[i]), 1e-15) << "batch sincos sine error at " << angles[i];
+            EXPECT_NEAR(cosines[i], std::cos(angles[i]), 1e-15) << "batch sincos cosine error at " << angles[i];
+        }
+        else {
+            EXPECT_TRUE(std::isnan(sines[i])) << "batch sincos non-finite sine error at " << angles[i];
+            EXPECT_TRUE(std::isnan(cosines[i])) << "batch sincos non-finite cosine error at " << angles[i];
+        }
+    }
+}
@@ -0,0 +1,88 @@
+/**
+* Test files are built using cmake precompiled headers which are made
+* visible to this file when building tests and are not explicitly
+* included.
+*
+*/
+
+#include <vector.hpp>
+#include <matrix.hpp>
+#include <rotation.hpp>
+#include <single_axis_rotation.hpp>
+#include <gtest/gtest.h>
+#include <helpers.hpp>
+
+namespace evs = evspace;
+
+template<typename axis>
+void check_single_axis_rotation(const char* name) {
+    SCOPED_TRACE(name);
+    const double angle = 0.7;
+    const evs::Vector vector = evs::Vector(1, -2, 3);
+    const evs::Matrix dense = evs::compute_rotation_matrix<axis>(angle);
+    const evs::Matrix matrix = evs::Matrix({ {1, 2, 3}, {4, 5, 6}, {7, 8, 10} });
+    const evs::SingleAxisRotation<axis> rotation(angle);
+
+    EXPECT_EQ(rotation.get_angle(), angle) << "get angle error";
+    EXPECT_TRUE(rotation.to_matrix().compare_to(dense, 0.0, ABS_ERROR)) << "to_matrix error";
+    EXPECT_TRUE((matrix * rotation).compare_to(matrix * dense, 0.0, ABS_ERROR)) << "matrix * rotation error";
+    EXPECT_TRUE((rotation * matrix).compare_to(dense * matrix, 0.0, ABS_ERROR)) << "rotation * matrix error";
+    evs::Matrix in_place = matrix;
+    in_place *= rotation;
+    EXPECT_TRUE(in_place.compare_to(matrix * dense, 0.0, ABS_ERROR)) << "matrix *= rotation error";
+
+    _COMPARE_VECTOR_NEAR((rotation * vector), (dense * vector), "rotation * vector error");
+    _COMPARE_VECTOR_NEAR(rotation.rotate_from(vector), evs::rotate_from(dense, vector), "rotate from error");
+    _COMPARE_VECTOR_NEAR(rotation.rotate_to(vector), evs::rotate_to(dense, vector), "rotate to error");
+    _COMPARE_VECTOR_NEAR((evs::rotate_from<axis>(angle, vector)), evs::rotate_from(dense, vector),
+        "sparse rotate from error");
+    _COMPARE_VECTOR_NEAR((evs::rotate_to<axis>(angle, vector)), evs::rotate_to(dense, vector),
+        "sparse rotate to error");
+
+    // composition about the same axis and inverses
+    evs::SingleAxisRotation<axis> composed = rotation * evs::SingleAxisRotation<axis>(-1.9);
+    EXPECT_EQ(composed.get_angle(), angle - 1.9) << "composed angle error";
+    EXPECT_TRUE(composed.to_matrix().compare_to(evs::compute_rotation_matrix<axis>(angle - 1.9), 0.0, ABS_ERROR))
+        << "composed matrix error";
+    _COMPARE_VECTOR_NEAR(rotation.inverse().rotate_from(vector), rotation.rotate_to(vector), "inverse error");
+}
+
+TEST(SingleAxisRotationUnitTest, TestSparseRotation) {
+    check_single_axis_rotation<evs::XAxis>("XAxis");
+    check_single_axis_rotation<evs::YAxis>("YAxis");
+    check_single_axis_rotation<evs::ZAxis>("ZAxis");
+}
+
+TEST(SingleAxisRotationUnitTest, TestQuarterTurns) {
+    const evs::Vector vector = evs::Vector(1, 2, 3);
+
+    // exact matrices, no sin/cos noise in the zero entries
+    COMPARE_MATRIX(evs::compute_rotation_matrix<evs::ZAxis>(EVSPACE_PI_2),
+        create_array({ {0, -1, 0}, {1, 0, 0}, {0, 0, 1} }), "quarter turn matrix error");
+    COMPARE_MATRIX(evs::compute_rotation_matrix<evs::XAxis>(-EVSPACE_PI),
+        create_array({ {1, 0, 0}, {0, -1, 0}, {0, 0, -1} }), "half turn matrix error");
+    COMPARE_MATRIX(evs::SingleAxisRotation<evs::YAxis>(3 * EVSPACE_PI / 2).to_matrix(),
+        create_array({ {0, 0, -1}, {0, 1, 0}, {1, 0, 0} }), "three quarter turn matrix error");
+    COMPARE_MATRIX((evs::compute_rotation_matrix<evs::XYZ>(evs::EulerAngles(EVSPACE_PI_2, 0, -EVSPACE_PI_2))),
+        create_array({ {0, 1, 0}, {0, 0, -1}, {-1, 0, 0} }), "quarter turn euler matrix error");
+
+    // exact vectors, each quarter turn direction on every axis
+    COMPARE_VECTOR(evs::rotate_from<evs::XAxis>(EVSPACE_PI_2, vector), create_array({ 1, -3, 2 }),
+        "x quarter turn rotate from error");
+    COMPARE_VECTOR(evs::rotate_to<evs::XAxis>(EVSPACE_PI_2, vector), create_array({ 1, 3, -2 }),
+        "x quarter turn rotate to error");
+    COMPARE_VECTOR(evs::rotate_from<evs::YAxis>(EVSPACE_PI, vector), create_array({ -1, 2, -3 }),
+        "y half turn rotate from error");
+    COMPARE_VECTOR(evs::rotate_to<evs::ZAxis>(-EVSPACE_PI_2, vector), create_array({ -2, 1, 3 }),
+        "z negative quarter turn rotate to error");
+    COMPARE_VECTOR(evs::rotate_from<evs::ZAxis>(4 * EVSPACE_PI, vector), create_array({ 1, 2, 3 }),
+        "z full turns rotate from error");
+    COMPARE_VECTOR(evs::rotate_from<evs::YAxis>(EVSPACE_PI_2, vector, vector), create_array({ 4, 4, 2 }),
+        "y quarter turn rotate from offset error");
+
+    // angles near but not at a quarter turn take the general path
+    const double near = std::nextafter(EVSPACE_PI_2, 0.0);
+    _COMPARE_VECTOR_NEAR(evs::rotate_from<evs::XAxis>(near, vector),
+        evs::rotate_from(evs::compute_rotation_matrix<evs::XAxis>(near), vector), "near quarter turn error");
+    EXPECT_NE(evs::compute_rotation_matrix<evs::XAxis>(near)(1, 1), 0.0) << "near quarter turn treated as exact";
+}
@@ -0,0 +1,142 @@
+/**
+* Test files are built using cmake precompiled headers which are made
+* visible to this file when building tests and are not explicitly
+* included.
+*
+*/
+
+#include <angles.hpp>
+#include <vector.hpp>
+#include <matrix.hpp>
+#include <matrix_array.hpp>
+#include <rotation.hpp>
+#include <small_angle.hpp>
+#include <gtest/gtest.h>
+#include <helpers.hpp>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace evs = evspace;
+
+// Rounding allowance on top of the truncation tolerance.
+constexpr double ROUNDING = 4 * std::numeric_limits<double>::epsilon();
+
+// Angles covering the valid domain, uniformly and geometrically down to 1e-12.
+static std::vector<double> domain_angles() {
+    std::vector<double> angles;
+    for (int i = -10000; i <= 10000; i++) {
+        angles.push_back(i * 1e-4);
+    }
+    for (double magnitude = 1e-12; magnitude < 1.0; magnitude *= 1.07) {
+        angles.push_back(magnitude);
+        angles.push_back(-magnitude);
+    }
+
+    return angles;
+}
+
+TEST(SmallAngleUnitTest, TestTermSelection) {
+    EXPECT_EQ(evs::small_angle_terms(0.0, 1e-15), 1) << "zero angle terms error";
+    // x^2 / 2 = 5e-9 > 1e-15, x^4 / 24 < 1e-15
+    EXPECT_EQ(evs::small_angle_terms(1e-4, 1e-15), 2) << "1e-4 rad terms error";
+    EXPECT_EQ(evs::small_angle_terms(-1e-4, 1e-6), 1) << "negative angle terms error";
+    EXPECT_EQ(evs::small_angle_terms(0.5, 1e-12), 6) << "largest order terms error";
+
+    // exact trig fallbacks
+    EXPECT_EQ(evs::small_angle_terms(0.9, 1e-16), 0) << "tolerance too small for any order";
+    EXPECT_EQ(evs::small_angle_terms(1.5, 1.0), 0) << "angle outside of the domain";
+    EXPECT_EQ(evs::small_angle_terms(1e-3, 0.0), 0) << "zero tolerance";
+    EXPECT_EQ(evs::small_angle_terms(std::nan(""), 1.0), 0) << "NaN angle";
+
+    double sine, cosine;
+    evs::small_angle_sincos(2.5, 1e-6, sine, cosine);
+    EXPECT_DOUBLE_EQ(sine, std::sin(2.5)) << "fallback sine error";
+    EXPECT_DOUBLE_EQ(cosine, std::cos(2.5)) << "fallback cosine error";
+}
+
+TEST(SmallAngleUnitTest, TestErrorBounds) {
+    const std::vector<double> angles = domain_angles();
+
+    for (double tolerance : { 1e-4, 1e-8, 1e-12, 1e-15 }) {
+        SCOPED_TRACE(tolerance);
+        double worst_sine = 0.0, worst_cosine = 0.0;
+        for (double angle : angles) {
+            double sine, cosine;
+            evs::small_angle_sincos(angle, tolerance, sine, cosine);
+            worst_sine = std::max(worst_sine, std::fabs(sine - std::sin(angle)));
+            worst_cosine = std::max(worst_cosine, std::fabs(cosine - std::cos(angle)));
+
+            // the chosen order is the fewest that meets the tolerance
+            const std::size_t terms = evs::small_angle_terms(angle, tolerance);
+            if (terms > 1) {
+                double bound = 1.0;
+                for (std::size_t n = 1; n < terms; n++) {
+                    bound *= angle * angle / static_cast<double>((2 * n - 1) * (2 * n));
+                }
+                EXPECT_GT(bound, tolerance) << "more terms than needed at " << angle;
+            }
+        }
+
+        EXPECT_LE(worst_sine, tolerance + ROUNDING) << "sine error bound exceeded";
+        EXPECT_LE(worst_cosine, tolerance + ROUNDING) << "cosine error bound exceeded";
+    }
+}
+
+TEST(SmallAngleUnitTest, TestBatch) {
+    const double tolerance = 1e-10;
+    std::vector<double> small{ 1e-4, -3e-5, 2e-4, 0.0 }, mixed{ 1e-4, 0.7, -2.0, 1e-9 };
+    std::vector<double> sines(4), cosines(4);
+
+    for (const std::vector<double>* angles : { &small, &mixed }) {
+        evs::small_angle_sincos(*angles, tolerance, sines, cosines);
+        for (std::size_t i = 0; i < angles->size(); i++) {
+            EXPECT_NEAR(sines[i], std::sin((*angles)[i]), tolerance + ROUNDING) << "batch sine error at " << i;
+            EXPECT_NEAR(cosines[i], std::cos((*angles)[i]), tolerance + ROUNDING) << "batch cosine error at " << i;
+        }
+    }
+
+    std::vector<double> short_output(3);
+    EXPECT_THROW(evs::small_angle_sincos(small, tolerance, short_output, cosines), std::out_of_range);
+
+    std::vector<double> alphas{ 1e-4, -2e-4, 0.3 }, betas{ 5e-5, 1e-3, -0.01 }, gammas{ -1e-4, 0.0, 1e-6 };
+    evs::MatrixArray output;
+    evs::compute_small_angle_matrices<evs::ZYX>(alphas, betas, gammas, tolerance, output);
+    ASSERT_EQ(output.size(), alphas.size()) << "batch matrices size error";
+    for (std::size_t i = 0; i < alphas.size(); i++) {
+        const evs::EulerAngles angles(alphas[i], betas[i], gammas[i]);
+        EXPECT_TRUE(output.get(i).compare_to(evs::compute_rotation_matrix<evs::ZYX>(angles), 0.0, 3 * tolerance + ROUNDING))
+            << "batch matrix error at " << i;
+    }
+    short_output.resize(2);
+    EXPECT_THROW((evs::compute_small_angle_matrices<evs::ZYX>(alphas, betas, short_output, tolerance, output)),
+        std::out_of_range);
+}
+
+TEST(SmallAngleUnitTest, TestRotations) {
+    const double tolerance = 1e-12;
+    const evs::Vector vector(1, -2, 3), axis(1, 2, 2);
+
+    for (double angle : { 0.0, 1e-6, -1e-4, 3e-3, 0.2, 1.3 }) {
+        SCOPED_TRACE(angle);
+        EXPECT_TRUE(evs::compute_small_angle_matrix<evs::YAxis>(angle, tolerance).compare_to(
+            evs::compute_rotation_matrix<evs::YAxis>(angle), 0.0, tolerance + ROUNDING)) << "single axis matrix error";
+        COMPARE_VECTOR_NEAR(evs::small_angle_rotate_from<evs::ZAxis>(angle, vector, tolerance),
+            evs::rotate_from<evs::ZAxis>(angle, vector), "small angle rotate from error", 4 * (tolerance + ROUNDING));
+        COMPARE_VECTOR_NEAR(evs::small_angle_rotate_to<evs::XAxis>(angle, vector, tolerance),
+            evs::rotate_to<evs::XAxis>(angle, vector), "small angle rotate to error", 4 * (tolerance + ROUNDING));
+        EXPECT_TRUE(evs::compute_small_angle_matrix(angle, axis, tolerance).compare_to(
+            evs::compute_rotation_matrix(angle, axis), 0.0, 2 * tolerance + ROUNDING)) << "Rodrigues matrix error";
+
+        const evs::EulerAngles angles(angle, -0.5 * angle, 0.25 * angle);
+        EXPECT_TRUE((evs::compute_small_angle_matrix<evs::XYX, evs::ExtrinsicRotation>(angles, tolerance)).compare_to(
+            evs::compute_rotation_matrix<evs::XYX, evs::ExtrinsicRotation>(angles), 0.0, 3 * tolerance + ROUNDING))
+            << "Euler angle matrix error";
+    }
+
+    // the versine keeps its precision where 1 - cos(angle) rounds to zero
+    const double angle = 1e-9;
+    const double versine = 2.0 * std::sin(angle / 2) * std::sin(angle / 2);
+    const evs::Matrix about_diagonal = evs::compute_small_angle_matrix(angle, evs::Vector(1, 1, 0), tolerance);
+    EXPECT_NEAR(about_diagonal(0, 1), 0.5 * versine, 1e-33) << "Rodrigues off diagonal versine error";
+}
@@ -0,0 +1,126 @@
+/**
+* Test files are built using cmake precompiled headers which are made
+* visible to this file when building tests and are not explicitly
+* included.
+*
+*/
+
+#include <matrix.hpp>
+#include <vector.hpp>
+#include <matrix_array.hpp>
+#include <vector_array.hpp>
+#include <rotation.hpp>
+#include <symmetric_matrix.hpp>
+#include <symmetric_matrix_array.hpp>
+#include <symmetric_eigen.hpp>
+#include <string>       // std::string, std::to_string
+#include <vector>       // std::vector
+#include <gtest/gtest.h>
+#include <helpers.hpp>
+
+namespace evs = evspace;
+
+namespace {
+
+    // Checks values and vectors are an eigendecomposition of tensor: the
+    // values ascend, vectors is a proper rotation and rotating the
+    // diagonal values from it gives back the tensor.
+    void check_decomposition(const evs::SymmetricMatrix& tensor, const evs::Vector& values,
+                             const evs::Matrix& vectors, const std::string& msg)
+    {
+        EXPECT_LE(values[0], values[1]) << msg;
+        EXPECT_LE(values[1], values[2]) << msg;
+        EXPECT_NEAR(vectors.determinate(), 1.0, 1e-14) << msg;
+        EXPECT_TRUE((vectors.transpose() * vectors).compare_to(evs::Matrix::IDENTITY, 0.0, 1e-14)) << msg;
+
+        const evs::SymmetricMatrix diagonal(values[0], 0.0, 0.0, values[1], 0.0, values[2]);
+        EXPECT_TRUE(evs::rotate_from(vectors, diagonal).compare_to(tensor, 0.0, 1e-14)) << msg;
+    }
+
+}
+
+TEST(SymmetricEigenUnitTest, TestDiagonal) {
+    const evs::SymmetricMatrix tensor(3.0, 0.0, 0.0, 1.0, 0.0, 2.0);
+    evs::Vector values;
+    evs::Matrix vectors;
+    evs::eigen_decomposition(tensor, values, vectors);
+
+    COMPARE_VECTOR(values, create_array({ 1.0, 2.0, 3.0 }), "diagonal eigenvalues");
+    for (std::size_t row = 0; row < 3; row++) {
+        for (std::size_t col = 0; col < 3; col++) {
+            EXPECT_DOUBLE_EQ(std::fabs(vectors(row, col)), (row == 1 && col == 0) || (row == 2 && col == 1)
+                             || (row == 0 && col == 2) ? 1.0 : 0.0) << "diagonal eigenvector permutation";
+        }
+    }
+    check_decomposition(tensor, values, vectors, "diagonal");
+
+    evs::eigen_decomposition(evs::SymmetricMatrix(), values, vectors);
+    COMPARE_VECTOR(values, create_array({ 0.0, 0.0, 0.0 }), "zero eigenvalues");
+    COMPARE_MATRIX(vectors, create_array({ { 1.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0 }, { 0.0, 0.0, 1.0 } }),
+                   "zero eigenvectors");
+}
+
+TEST(SymmetricEigenUnitTest, TestRotatedTensors) {
+    const double cases[][3] = {
+        { -1.5, 0.25, 4.0 },
+        // repeated and nearly repeated eigenvalues
+        { 2.0, 2.0, 5.0 },
+        { 1.0, 3.0, 3.0 },
+        { 7.0, 7.0, 7.0 },
+        { 1.0, 1.0 + 1e-12, 2.0 },
+        { 1.0, 1.0 + 1e-9, 1.0 + 2e-9 },
+        // widely spread magnitudes
+        { 1e-8, 1.0, 1e8 },
+        { -1e150, 1e-150, 1e150 },
+    };
+
+    for (std::size_t n = 0; n < sizeof(cases) / sizeof(cases[0]); n++) {
+        const double* expected = cases[n];
+        const double scale = std::fabs(expected[0]) > std::fabs(expected[2]) ? std::fabs(expected[0])
+                                                                             : std::fabs(expected[2]);
+        const evs::Matrix rotation = evs::compute_rotation_matrix<evs::ZYX>(
+            evs::EulerAngles(0.4 + 0.3 * n, -0.9 + 0.1 * n, 2.1 - 0.2 * n));
+        const evs::SymmetricMatrix tensor = evs::rotate_from(rotation,
+            evs::SymmetricMatrix(expected[2], 0.0, 0.0, expected[0], 0.0, expected[1]));
+
+        evs::Vector values;
+        evs::Matrix vectors;
+        evs::eigen_decomposition(tensor, values, vectors);
+        for (std::size_t k = 0; k < 3; k++) {
+            EXPECT_NEAR(values[k], expected[k], 1e-14 * scale) << "eigenvalue " << k << " of case " << n;
+        }
+        check_decomposition(tensor * (1.0 / scale), values * (1.0 / scale), vectors, "case " + std::to_string(n));
+    }
+}
+
+TEST(SymmetricEigenUnitTest, TestBatch) {
+    // not a multiple of the lane widths, so the remainder is covered
+    const std::size_t count = 103;
+    std::vector<evs::SymmetricMatrix> tensors;
+    for (std::size_t i = 0; i < count; i++) {
+        const double t = static_cast<double>(i);
+        tensors.push_back(evs::SymmetricMatrix(2.0 + std::sin(t), 0.4 * std::cos(0.3 * t), 0.1,
+                                               1.0 + 0.5 * std::cos(t), -0.2 * std::sin(0.7 * t),
+                                               i % 5 == 0 ? 2.0 + std::sin(t) : 3.0));
+    }
+    tensors[10] = evs::SymmetricMatrix();
+    tensors[11] = evs::SymmetricMatrix(4.0, 0.0, 0.0, 4.0, 0.0, 4.0);
+
+    const evs::SymmetricMatrixArray array(tensors);
+    evs::VectorArray values;
+    evs::MatrixArray vectors;
+    evs::eigen_decomposition(array, values, vectors);
+    ASSERT_EQ(values.size(), count);
+    ASSERT_EQ(vectors.size(), count);
+
+    for (std::size_t i = 0; i < count; i++) {
+        const std::string msg = "batch element " + std::to_string(i);
+        evs::Vector expected_values;
+        evs::Matrix expected_vectors;
+        evs::eigen_decomposition(tensors[i], expected_values, expected_vectors);
+
+        const evs::Vector batch_values = values.get(i);
+        COMPARE_VECTOR_NEAR(batch_values, expected_values, msg, 1e-14);
+        check_decomposition(tensors[i], batch_values, vectors.get(i), msg);
+    }
+}
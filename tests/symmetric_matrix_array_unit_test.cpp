@@ -0,0 +1,166 @@
+/**
+* Test files are built using cmake precompiled headers which are made
+* visible to this file when building tests and are not explicitly
+* included.
+*
+*/
+
+#include <matrix.hpp>
+#include <matrix_array.hpp>
+#include <rotation.hpp>
+#include <reference_frame_array.hpp>
+#include <symmetric_matrix.hpp>
+#include <symmetric_matrix_array.hpp>
+#include <vector>       // std::vector
+#include <gtest/gtest.h>
+#include <helpers.hpp>
+
+namespace evs = evspace;
+
+namespace {
+
+    // Tensors and rotations spanning more than one chunk, with a partial
+    // last chunk.
+    std::vector<evs::SymmetricMatrix> create_tensors(std::size_t count) {
+        std::vector<evs::SymmetricMatrix> tensors;
+        for (std::size_t i = 0; i < count; i++) {
+            const double t = static_cast<double>(i);
+            tensors.push_back(evs::SymmetricMatrix(3.0 + std::sin(t), 0.2 * std::cos(t), 0.1, 2.0,
+                                                   -0.3 * std::sin(0.5 * t), 1.0 + 0.01 * t));
+        }
+
+        return tensors;
+    }
+
+    std::vector<evs::Matrix> create_rotations(std::size_t count) {
+        std::vector<evs::Matrix> rotations;
+        for (std::size_t i = 0; i < count; i++) {
+            const double t = static_cast<double>(i);
+            rotations.push_back(evs::compute_rotation_matrix<evs::XYZ>(evs::EulerAngles(0.1 * t, -0.05 * t, 0.7)));
+        }
+
+        return rotations;
+    }
+
+}
+
+TEST(SymmetricMatrixArrayUnitTest, TestAccess) {
+    evs::SymmetricMatrixArray empty;
+    EXPECT_EQ(empty.size(), 0) << "Default SymmetricMatrixArray size error";
+
+    const std::vector<evs::SymmetricMatrix> tensors{ evs::SymmetricMatrix(1, 2, 3, 4, 5, 6) };
+    evs::SymmetricMatrixArray array(tensors);
+    EXPECT_EQ(array.size(), 1) << "SymmetricMatrixArray from span size error";
+    EXPECT_TRUE(array.get(0) == tensors[0]) << "SymmetricMatrixArray from span error";
+    EXPECT_EQ(array.plane(2, 1), array.plane(1, 2)) << "SymmetricMatrixArray shared plane error";
+    EXPECT_EQ(array.plane(2, 1)[0], 5) << "SymmetricMatrixArray plane value error";
+
+    array.resize(3);
+    EXPECT_TRUE(array.get(0) == tensors[0]) << "SymmetricMatrixArray grow preserved value error";
+    EXPECT_TRUE(array.get(2) == evs::SymmetricMatrix()) << "SymmetricMatrixArray grow new value error";
+    array.set(2, tensors[0] * 2.0);
+    EXPECT_TRUE(array.get(2) == tensors[0] * 2.0) << "SymmetricMatrixArray set error";
+
+    EXPECT_THROW(array.get(3), std::out_of_range) << "SymmetricMatrixArray get out of range";
+    EXPECT_THROW(array.set(3, tensors[0]), std::out_of_range) << "SymmetricMatrixArray set out of range";
+    EXPECT_THROW(array.plane(3, 0), std::out_of_range) << "SymmetricMatrixArray plane out of range";
+}
+
+TEST(SymmetricMatrixArrayUnitTest, TestGrowth) {
+    // growing one matrix at a time reallocates geometrically and carries
+    // every earlier matrix over
+    const std::vector<evs::SymmetricMatrix> tensors = create_tensors(600);
+    evs::SymmetricMatrixArray array;
+    std::size_t growths = 0;
+    for (std::size_t i = 0; i < tensors.size(); i++) {
+        const std::size_t capacity = array.capacity();
+        array.resize(i + 1);
+        array.set(i, tensors[i]);
+        if (array.capacity() != capacity) {
+            growths++;
+            for (std::size_t j = 0; j <= i; j++) {
+                EXPECT_TRUE(array.get(j) == tensors[j]) << "SymmetricMatrixArray growth preserved value error at " << j;
+            }
+        }
+    }
+    EXPECT_LE(growths, 11u) << "SymmetricMatrixArray growth is not geometric";
+
+    // slots reused after a shrink start over as zero
+    const std::size_t capacity = array.capacity();
+    array.resize(10);
+    array.resize(20);
+    EXPECT_EQ(array.capacity(), capacity) << "SymmetricMatrixArray shrink released capacity";
+    EXPECT_TRUE(array.get(9) == tensors[9]) << "SymmetricMatrixArray regrown preserved value error";
+    EXPECT_TRUE(array.get(10) == evs::SymmetricMatrix()) << "SymmetricMatrixArray regrown new value error";
+
+    evs::SymmetricMatrixArray reserved;
+    reserved.reserve(50);
+    EXPECT_EQ(reserved.size(), 0) << "SymmetricMatrixArray reserve size error";
+    EXPECT_EQ(reserved.capacity(), 50) << "SymmetricMatrixArray reserve capacity error";
+    reserved.resize(50);
+    EXPECT_EQ(reserved.capacity(), 50) << "SymmetricMatrixArray reserved resize reallocated";
+}
+
+TEST(SymmetricMatrixArrayUnitTest, TestRotation) {
+    const std::size_t count = 600;
+    const std::vector<evs::SymmetricMatrix> tensors = create_tensors(count);
+    const std::vector<evs::Matrix> rotations = create_rotations(count);
+    const evs::SymmetricMatrixArray tensor_array(tensors);
+    const evs::MatrixArray rotation_array(rotations);
+
+    // one rotation per tensor
+    evs::SymmetricMatrixArray from, to;
+    evs::rotate_from(rotation_array, tensor_array, from);
+    evs::rotate_to(rotation_array, tensor_array, to);
+    ASSERT_EQ(from.size(), count) << "batch rotate_from output size error";
+    for (std::size_t i = 0; i < count; i++) {
+        EXPECT_TRUE(from.get(i).compare_to(evs::rotate_from(rotations[i], tensors[i]), 0.0, 1e-14))
+            << "batch rotate_from error at " << i;
+        EXPECT_TRUE(to.get(i).compare_to(evs::rotate_to(rotations[i], tensors[i]), 0.0, 1e-14))
+            << "batch rotate_to error at " << i;
+    }
+
+    // one rotation for every tensor, in place
+    const evs::Matrix& rotation = rotations[17];
+    evs::SymmetricMatrixArray in_place = tensor_array;
+    evs::rotate_from(rotation, in_place, in_place);
+    for (std::size_t i = 0; i < count; i++) {
+        EXPECT_TRUE(in_place.get(i).compare_to(evs::rotate_from(rotation, tensors[i]), 0.0, 1e-14))
+            << "batch single rotation rotate_from error at " << i;
+    }
+    evs::rotate_to(rotation, in_place, in_place);
+    for (std::size_t i = 0; i < count; i++) {
+        EXPECT_TRUE(in_place.get(i).compare_to(tensors[i], 0.0, 1e-14))
+            << "batch single rotation round trip error at " << i;
+    }
+
+    evs::SymmetricMatrixArray short_array(count - 1);
+    EXPECT_THROW(evs::rotate_from(rotation_array, short_array, from), std::out_of_range)
+        << "batch rotate_from size mismatch";
+    EXPECT_THROW(evs::rotate_to(rotation_array, short_array, to), std::out_of_range)
+        << "batch rotate_to size mismatch";
+}
+
+TEST(SymmetricMatrixArrayUnitTest, TestFrameRotation) {
+    const std::size_t count = 300;
+    const std::vector<evs::SymmetricMatrix> tensors = create_tensors(count);
+    const evs::SymmetricMatrixArray tensor_array(tensors);
+
+    const evs::ReferenceFrame<evs::ZYX> frame(evs::EulerAngles(0.4, 0.5, -0.6));
+    evs::SymmetricMatrixArray output;
+    evs::rotate_to(frame, tensor_array, output);
+    for (std::size_t i = 0; i < count; i++) {
+        EXPECT_TRUE(output.get(i).compare_to(evs::rotate_to(frame.get_matrix(), tensors[i]), 0.0, 1e-14))
+            << "batch frame rotate_to error at " << i;
+    }
+
+    evs::ReferenceFrameArray<evs::ZYX> frames;
+    for (std::size_t i = 0; i < count; i++) {
+        frames.push_back(evs::EulerAngles(0.01 * i, 0.2, -0.03 * i), evs::Vector());
+    }
+    evs::rotate_from(frames, tensor_array, output);
+    for (std::size_t i = 0; i < count; i++) {
+        EXPECT_TRUE(output.get(i).compare_to(evs::rotate_from(frames[i].get_matrix(), tensors[i]), 0.0, 1e-14))
+            << "batch frame array rotate_from error at " << i;
+    }
+}
@@ -0,0 +1,70 @@
+/**
+* Test files are built using cmake precompiled headers which are made
+* visible to this file when building tests and are not explicitly
+* included.
+*
+*/
+
+#include <matrix.hpp>
+#include <rotation.hpp>
+#include <symmetric_matrix.hpp>
+#include <gtest/gtest.h>
+#include <helpers.hpp>
+
+namespace evs = evspace;
+
+TEST(SymmetricMatrixUnitTest, TestCreation) {
+    const evs::SymmetricMatrix zero;
+    for (std::size_t i = 0; i < 6; i++) {
+        EXPECT_EQ(zero.data()[i], 0.0) << "SymmetricMatrix default value error";
+    }
+
+    const evs::SymmetricMatrix tensor(1, 2, 3, 4, 5, 6);
+    COMPARE_MATRIX(tensor.to_matrix(), create_array({ {1, 2, 3}, {2, 4, 5}, {3, 5, 6} }),
+                   "SymmetricMatrix to_matrix error");
+    EXPECT_EQ(tensor(2, 1), 5) << "SymmetricMatrix lower triangle access error";
+    EXPECT_EQ(tensor(1, 2), 5) << "SymmetricMatrix upper triangle access error";
+    EXPECT_EQ(tensor.trace(), 11) << "SymmetricMatrix trace error";
+
+    // the symmetric part of a general matrix
+    const evs::Matrix matrix(create_array({ {1, 2, 3}, {4, 5, 6}, {7, 8, 9} }));
+    COMPARE_MATRIX(evs::SymmetricMatrix(matrix).to_matrix(), create_array({ {1, 3, 5}, {3, 5, 7}, {5, 7, 9} }),
+                   "SymmetricMatrix from Matrix error");
+    EXPECT_TRUE(evs::SymmetricMatrix(tensor.to_matrix()) == tensor) << "SymmetricMatrix round trip error";
+
+    evs::SymmetricMatrix mutable_tensor = tensor;
+    mutable_tensor(2, 0) = 10;
+    EXPECT_EQ(mutable_tensor(0, 2), 10) << "SymmetricMatrix set shares storage error";
+    EXPECT_THROW(mutable_tensor(3, 0), std::out_of_range) << "SymmetricMatrix row out of range";
+    EXPECT_THROW(tensor(0, 3), std::out_of_range) << "SymmetricMatrix column out of range";
+}
+
+TEST(SymmetricMatrixUnitTest, TestArithmetic) {
+    const evs::SymmetricMatrix lhs(1, 2, 3, 4, 5, 6), rhs(6, 5, 4, 3, 2, 1);
+    EXPECT_TRUE(lhs + rhs == evs::SymmetricMatrix(7, 7, 7, 7, 7, 7)) << "SymmetricMatrix addition error";
+    EXPECT_TRUE(lhs - rhs == evs::SymmetricMatrix(-5, -3, -1, 1, 3, 5)) << "SymmetricMatrix subtraction error";
+    EXPECT_TRUE(lhs * 2.0 == evs::SymmetricMatrix(2, 4, 6, 8, 10, 12)) << "SymmetricMatrix scaling error";
+    EXPECT_TRUE(lhs != rhs) << "SymmetricMatrix inequality error";
+}
+
+TEST(SymmetricMatrixUnitTest, TestRotation) {
+    const evs::SymmetricMatrix tensor(4.0, 0.3, -0.2, 2.5, 0.1, 1.5);
+    const evs::EulerAngles angles(0.3, -1.2, 2.1);
+    const evs::Matrix rotation = evs::compute_rotation_matrix<evs::ZXZ>(angles);
+    const evs::Matrix full = tensor.to_matrix();
+
+    const evs::SymmetricMatrix from = evs::rotate_from(rotation, tensor);
+    const evs::SymmetricMatrix to = evs::rotate_to(rotation, tensor);
+    EXPECT_TRUE(from.to_matrix().compare_to(rotation * full * rotation.transpose(), 0.0, 1e-14))
+        << "SymmetricMatrix rotate_from error";
+    EXPECT_TRUE(to.to_matrix().compare_to(rotation.transpose() * full * rotation, 0.0, 1e-14))
+        << "SymmetricMatrix rotate_to error";
+    EXPECT_NEAR(from.trace(), tensor.trace(), 1e-14) << "SymmetricMatrix rotation trace error";
+    EXPECT_TRUE(evs::rotate_to(rotation, from).compare_to(tensor, 0.0, 1e-14))
+        << "SymmetricMatrix rotation round trip error";
+
+    // frames ignore their offset, like the principal axes of a tensor
+    const evs::ReferenceFrame<evs::ZXZ> frame(angles, evs::Vector(1, 2, 3));
+    EXPECT_TRUE(evs::rotate_from(frame, tensor).compare_to(from, 0.0, 0.0)) << "SymmetricMatrix frame rotate_from error";
+    EXPECT_TRUE(evs::rotate_to(frame, tensor).compare_to(to, 0.0, 0.0)) << "SymmetricMatrix frame rotate_to error";
+}
@@ -0,0 +1,60 @@
+/**
+* Test files are built using cmake precompiled headers which are made
+* visible to this file when building tests and are not explicitly
+* included.
+*
+*/
+
+#include <vector.hpp>
+#include <vector_array.hpp>
+#include <vector>       // std::vector
+#include <gtest/gtest.h>
+#include <helpers.hpp>
+
+namespace evs = evspace;
+
+TEST(VectorArrayUnitTest, TestCreation) {
+    evs::VectorArray empty;
+    EXPECT_EQ(empty.size(), 0) << "Default VectorArray size error";
+
+    evs::VectorArray zeros(4);
+    EXPECT_EQ(zeros.size(), 4) << "Sized VectorArray size error";
+    for (std::size_t i = 0; i < zeros.size(); i++) {
+        COMPARE_VECTOR(zeros.get(i), create_array({ 0, 0, 0 }), "Sized VectorArray initial value error");
+    }
+
+    std::vector<evs::Vector> vectors{ evs::Vector(1, 2, 3), evs::Vector(4, 5, 6) };
+    evs::VectorArray array(vectors);
+    EXPECT_EQ(array.size(), 2) << "VectorArray from span size error";
+    COMPARE_VECTOR(array.get(0), create_array({ 1, 2, 3 }), "VectorArray from span first vector error");
+    COMPARE_VECTOR(array.get(1), create_array({ 4, 5, 6 }), "VectorArray from span second vector error");
+
+    // components are stored in planes
+    EXPECT_EQ(array.x()[1], 4) << "VectorArray x plane error";
+    EXPECT_EQ(array.y()[0], 2) << "VectorArray y plane error";
+    EXPECT_EQ(array.z()[1], 6) << "VectorArray z plane error";
+}
+
+TEST(VectorArrayUnitTest, TestAccess) {
+    evs::VectorArray array(2);
+    array.set(1, evs::Vector(7, 8, 9));
+    COMPARE_VECTOR(array.get(1), create_array({ 7, 8, 9 }), "VectorArray set error");
+
+    EXPECT_THROW(array.get(2), std::out_of_range) << "VectorArray get out of range";
+    EXPECT_THROW(array.set(2, evs::Vector()), std::out_of_range) << "VectorArray set out of range";
+}
+
+TEST(VectorArrayUnitTest, TestResize) {
+    std::vector<evs::Vector> vectors{ evs::Vector(1, 2, 3), evs::Vector(4, 5, 6) };
+    evs::VectorArray array(vectors);
+
+    array.resize(3);
+    EXPECT_EQ(array.size(), 3) << "VectorArray grow size error";
+    COMPARE_VECTOR(array.get(0), create_array({ 1, 2, 3 }), "VectorArray grow preserved value error");
+    COMPARE_VECTOR(array.get(1), create_array({ 4, 5, 6 }), "VectorArray grow preserved value error");
+    COMPARE_VECTOR(array.get(2), create_array({ 0, 0, 0 }), "VectorArray grow new value error");
+
+    array.resize(1);
+    EXPECT_EQ(array.size(), 1) << "VectorArray shrink size error";
+    COMPARE_VECTOR(array.get(0), create_array({ 1, 2, 3 }), "VectorArray shrink preserved value error");
+}